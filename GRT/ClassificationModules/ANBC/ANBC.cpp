@@ -51,7 +51,7 @@ bool ANBC::train(LabelledClassificationData &trainingData){
 /* double predict(vector<double> x)
  This method returns the ID of the most likely class given the observation x and the trained models
  */
-bool ANBC::predict(vector< double > inputVector){
+bool ANBC::predict(const vector< double > &inputVector){
     
     if( !trained ){
         errorLog << "predict(vector< double > inputVector) - ANBC Model Not Trained!" << endl;
@@ -68,19 +68,101 @@ bool ANBC::predict(vector< double > inputVector){
 		return false;
 	}
     
+    const vector< double > *x = &inputVector;
     if( useScaling ){
+        scaledInputVector.resize( numFeatures );
         for(UINT n=0; n<numFeatures; n++){
-            inputVector[n] = scale(inputVector[n], ranges[n].minValue, ranges[n].maxValue, MIN_SCALE_VALUE, MAX_SCALE_VALUE);
+            scaledInputVector[n] = scale(inputVector[n], ranges[n].minValue, ranges[n].maxValue, MIN_SCALE_VALUE, MAX_SCALE_VALUE);
         }
+        x = &scaledInputVector;
     }
     
     if( classLikelihoods.size() != numClasses ) classLikelihoods.resize(numClasses,0);
     if( classDistances.size() != numClasses ) classDistances.resize(numClasses,0);
     
+	for(UINT k=0; k<numClasses; k++){
+		classDistances[k] = models[k].predict( *x );
+    }
+    
+    return predictFromClassDistances();
+}
+    
+bool ANBC::predictBatch(const Matrix<double> &inputData,vector< UINT > &predictedClassLabels,Matrix<double> &likelihoods,Matrix<double> &distances){
+    
+    if( !trained ){
+        errorLog << "predictBatch(const Matrix<double> &inputData,...) - ANBC Model Not Trained!" << endl;
+        return false;
+    }
+    
+    if( inputData.getNumCols() != numFeatures ){
+        errorLog << "predictBatch(const Matrix<double> &inputData,...) - The number of columns in the input data (" << inputData.getNumCols() << ") does not match the num features in the model (" << numFeatures << endl;
+        return false;
+    }
+    
+    const UINT M = inputData.getNumRows();
+    predictedClassLabels.resize( M );
+    likelihoods.resize( M, numClasses );
+    distances.resize( M, numClasses );
+    
+    //Scale all the rows in one pass
+    const Matrix<double> *X = &inputData;
+    Matrix<double> scaledInputData;
+    if( useScaling ){
+        scaledInputData.resize( M, numFeatures );
+        for(UINT i=0; i<M; i++){
+            for(UINT n=0; n<numFeatures; n++){
+                scaledInputData[i][n] = scale(inputData[i][n], ranges[n].minValue, ranges[n].maxValue, MIN_SCALE_VALUE, MAX_SCALE_VALUE);
+            }
+        }
+        X = &scaledInputData;
+    }
+    
+    //Compute the class distances one model at a time, this is the same sum as ANBC_Model::predict but the constants of each
+    //Gaussian are computed once for all the rows rather than once per row
+    vector< UINT > activeDimensions( numFeatures );
+    vector< double > logConstants( numFeatures );
+    vector< double > logScales( numFeatures );
+    for(UINT k=0; k<numClasses; k++){
+        const ANBC_Model &model = models[k];
+        UINT numActiveDimensions = 0;
+        for(UINT j=0; j<numFeatures; j++){
+            if( model.weights[j] > 0 ){
+                activeDimensions[ numActiveDimensions ] = j;
+                logConstants[ numActiveDimensions ] = model.logGaussConstant(j);
+                logScales[ numActiveDimensions ] = model.logGaussScale(j);
+                numActiveDimensions++;
+            }
+        }
+        for(UINT i=0; i<M; i++){
+            const double *x = (*X)[i];
+            double prediction = 0.0;
+            for(UINT n=0; n<numActiveDimensions; n++){
+                const UINT j = activeDimensions[n];
+                const double d = x[j] - model.mu[j];
+                prediction += logConstants[n] - (d*d)*logScales[n];
+            }
+            distances[i][k] = prediction;
+        }
+    }
+    
+    if( classLikelihoods.size() != numClasses ) classLikelihoods.resize(numClasses,0);
+    if( classDistances.size() != numClasses ) classDistances.resize(numClasses,0);
+    
+    for(UINT i=0; i<M; i++){
+        std::copy(distances[i],distances[i]+numClasses,classDistances.begin());
+        predictFromClassDistances();
+        storeBatchPrediction(i,predictedClassLabels,likelihoods,distances);
+    }
+    
+    return true;
+}
+    
+bool ANBC::predictFromClassDistances(){
+    
+    predictedClassLabel = 0;
     double classLikelihoodsSum = 0;
     double minDist = -99e+99;
 	for(UINT k=0; k<numClasses; k++){
-		classDistances[k] = models[k].predict( inputVector );
         
         //At this point the class likelihoods and class distances are the same thing
         classLikelihoods[k] = classDistances[k];
@@ -120,7 +120,20 @@ public:
      @param vector< double > inputVector: the input vector to classify
      @return returns true if the prediction was performed, false otherwise
     */
-    virtual bool predict(vector< double > inputVector);
+    virtual bool predict(const vector< double > &inputVector);
+    
+    /**
+     This predicts the class of each row of the inputData.  The rows are scaled in one pass, then the class distances are computed one
+     model at a time so the constants of each Gaussian are only computed once for all the rows.
+     This overrides the predictBatch function in the Classifier base class.
+     
+     @param const Matrix<double> &inputData: the input vectors to classify, with one vector per row
+     @param vector< UINT > &predictedClassLabels: returns the predicted class label of each row
+     @param Matrix<double> &likelihoods: returns the class likelihoods of each row
+     @param Matrix<double> &distances: returns the class distances of each row
+     @return returns true if the prediction was performed, false otherwise
+    */
+    virtual bool predictBatch(const Matrix<double> &inputData,vector< UINT > &predictedClassLabels,Matrix<double> &likelihoods,Matrix<double> &distances);
     
     /**
      This saves the trained ANBC model to a file.
@@ -212,9 +225,12 @@ public:
     bool clearWeights(){ weightsDataSet = false; weightsData.clear(); return true; }
 
 private:
+    bool predictFromClassDistances();
+    
     bool weightsDataSet;                  //A flag to indicate if the user has manually set the weights buffer
     LabelledClassificationData weightsData; //The weights of each feature for each class for training the algorithm
 	vector< ANBC_Model > models;            //A buffer to hold all the models
+    vector< double > scaledInputVector;     //A buffer to hold the scaled input vector
     
     static RegisterClassifierModule< ANBC > registerModule;
 };
@@ -108,11 +108,13 @@ bool ANBC_Model::train(UINT classLabel,Matrix<double> &trainingData, vector<doub
 	return true;
 }
 
-double ANBC_Model::predict(vector<double> x){
+double ANBC_Model::predict(const vector< double > &x){
+	//The log of each weighted Gaussian is computed directly, rather than the log of the Gaussian, so this does not need an exp and a log
+	//for each dimension and a sample that is far from the mean does not underflow to -inf
 	double prediction = 0.0;
 	for(UINT j=0; j<N; j++){
 		if(weights[j]>0)
-			prediction += log(gauss(x[j],mu[j],sigma[j]) * weights[j]);
+			prediction += logGaussConstant(j) - SQR(x[j]-mu[j])*logGaussScale(j);
 	}
 	return prediction;
 }
@@ -30,7 +30,7 @@ public:
 	~ANBC_Model(void){};
 
 	bool train(UINT classLabel,Matrix<double> &trainingData, vector<double> weightsVector);
-	double predict(vector<double> observation);
+	double predict(const vector< double > &observation);
 	double predictUnnormed(vector<double> x);
 	inline double gauss(double x,double mu,double sigma);
 	inline double unnormedGauss(double x,double mu,double sigma);
@@ -39,6 +39,10 @@ public:
 public:
     inline double SQR(double x){ return x*x; }
     
+    //The log of the weighted Gaussian for dimension j is logGaussConstant(j) - SQR(x-mu[j])*logGaussScale(j)
+    inline double logGaussConstant(UINT j) const{ return log( weights[j] / (sigma[j]*sqrt(TWO_PI)) ); }
+    inline double logGaussScale(UINT j) const{ return 1.0/(2*(sigma[j]*sigma[j])); }
+    
 	UINT	N;					//The number of dimensions in the problem
     UINT classLabel;            //The label of the class this model represents
 	double threshold;			//The classification threshold value
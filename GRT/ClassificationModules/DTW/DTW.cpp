@@ -42,6 +42,15 @@ DTW::DTW(bool useScaling,bool useNullRejection,double nullRejectionCoeff,UINT re
 
 	crossValidationAccuracy=0.0;
 	zNormConstrainThreshold=0.2;
+	radius=0;
+    useLowerBoundPruning = false;
+    useSymmetricTrainingDistances = false;
+    useStreamingPrediction = false;
+    numTrainingThreads = 0;
+    streamingSmoothingCount = 0;
+    streamingTime = 0;
+    matchStartTime = 0;
+    matchEndTime = 0;
 
 	numTemplates=0;
 	distanceMethod=EUCLIDEAN_DIST;
@@ -71,8 +80,8 @@ bool DTW::_train(LabelledTimeSeriesClassificationData &labelledTrainingData){
 	UINT bestIndex = 0;
 	UINT worstIndex = 0;
 
-	//Cleanup Memory
-	templatesBuffer.clear();
+	//Cleanup Memory, any copies of this DTW keep the previous templates
+	templatesBuffer.reset();
     classLabels.clear();
 	trained = false;
     continuousInputDataBuffer.clear();
@@ -94,7 +103,8 @@ bool DTW::_train(LabelledTimeSeriesClassificationData &labelledTrainingData){
     numClasses = labelledTrainingData.getNumClasses();
 	numTemplates = labelledTrainingData.getNumClasses();
     numFeatures = labelledTrainingData.getNumDimensions();
-	templatesBuffer.resize(numTemplates);
+	vector< DTWTemplate > &templates = templatesBuffer.edit();
+	templates.resize(numTemplates);
     classLabels.resize(numClasses);
 	averageTemplateLength = 0;
 
@@ -116,7 +126,7 @@ bool DTW::_train(LabelledTimeSeriesClassificationData &labelledTrainingData){
 	    worstIndex = 0;
 
         //Set the class label of this template
-        templatesBuffer[k].classLabel = classLabel;
+        templates[k].classLabel = classLabel;
 
         //Set the kth class label
         classLabels[k] = classLabel;
@@ -131,10 +141,10 @@ bool DTW::_train(LabelledTimeSeriesClassificationData &labelledTrainingData){
             bestIndex = 0;
             worstIndex = 0;
 
-            templatesBuffer[k].threshold = 0.0;//TODO-We might need a better way of calculating this!
+            templates[k].threshold = 0.0;//TODO-We might need a better way of calculating this!
             warningLog << "_train(LabelledTimeSeriesClassificationData &labelledTrainingData) - Can't compute reject thresholds for class " << classLabel << " as there is only 1 training example" << endl;
 		}else{//Search for the best training example for this class
-			if( !_train_NDDTW(classData,templatesBuffer[k],bestIndex) ){
+			if( !_train_NDDTW(classData,templates[k],bestIndex) ){
                 errorLog << "_train(LabelledTimeSeriesClassificationData &labelledTrainingData) - Failed to train template for class with label: " << classLabel << endl;
                 return false;
             }
@@ -146,11 +156,11 @@ bool DTW::_train(LabelledTimeSeriesClassificationData &labelledTrainingData){
 
 		switch (trainingMethod) {
 			case(0)://Standard Training
-				templatesBuffer[k].timeSeries = classData[bestIndex].getData();
+				templates[k].timeSeries = classData[bestIndex].getData();
 				break;
 			case(1)://Training using Smoothing
 				//Smooth the data, reducing its size by a factor set by smoothFactor
-				smoothData(classData[ bestIndex ].getData(),smoothingFactor,templatesBuffer[k].timeSeries);
+				smoothData(classData[ bestIndex ].getData(),smoothingFactor,templates[k].timeSeries);
 				break;
 			default:
 				cout<<"Can not train model: Unknown training method \n";
@@ -158,8 +168,11 @@ bool DTW::_train(LabelledTimeSeriesClassificationData &labelledTrainingData){
 				break;
 		}
 
+		//Compute the cost statistics used to reject matches in the streaming prediction
+		computeStreamingThresholds(classData,templates[k],bestIndex);
+
 		//Add the average length of the training examples for this template to the overall averageTemplateLength
-		averageTemplateLength += templatesBuffer[k].averageTemplateLength;
+		averageTemplateLength += templates[k].averageTemplateLength;
 
 	}
 
@@ -170,9 +183,13 @@ bool DTW::_train(LabelledTimeSeriesClassificationData &labelledTrainingData){
     //Recompute the null rejection thresholds
     recomputeNullRejectionThresholds();
 
+    //Compute the lower bound envelopes used to prune the templates during prediction
+    computeTemplateEnvelopes();
+
     //Resize the prediction results to make sure it is setup for realtime prediction
     continuousInputDataBuffer.clear();
     continuousInputDataBuffer.resize(averageTemplateLength,vector<double>(numFeatures,0));
+    resetStreamingStates();
     classLikelihoods.resize(numTemplates,DEFAULT_NULL_LIKELIHOOD_VALUE);
     classDistances.resize(numTemplates,0);
     predictedClassLabel = 0;
@@ -182,35 +199,73 @@ bool DTW::_train(LabelledTimeSeriesClassificationData &labelledTrainingData){
 	return trained;
 }
 
+//Computes the DTW distances between the training examples of one class, the rows of the distance matrix are shared out between the threads
+class DTWTrainingDistanceJob : public ParallelJob{
+public:
+    DTWTrainingDistanceJob(DTW *dtw,vector< Matrix<double>* > &examples,Matrix<double> &distanceResults,vector< DTWWorkspace > &workspaces,bool symmetric):
+        dtw(dtw),examples(examples),distanceResults(distanceResults),workspaces(workspaces),symmetric(symmetric){}
+
+    UINT getNumTasks(){
+        //If the matrix is symmetric then row m is paired with row numExamples-1-m so every task computes the same number of distances
+        const UINT numExamples = (UINT)examples.size();
+        return symmetric ? (numExamples+1)/2 : numExamples;
+    }
+
+    virtual void run(unsigned int threadIndex,unsigned int startIndex,unsigned int endIndex){
+        const UINT numExamples = (UINT)examples.size();
+        for(UINT t=startIndex; t<endIndex; t++){
+            if( !symmetric ){
+                computeRow(t,0,threadIndex);
+                continue;
+            }
+            computeRow(t,t+1,threadIndex);
+            if( numExamples-1-t != t ) computeRow(numExamples-1-t,numExamples-t,threadIndex);
+        }
+    }
+
+private:
+    void computeRow(UINT m,UINT startColumn,UINT threadIndex){
+        for(UINT n=startColumn; n<examples.size(); n++){
+            if( m == n ) continue;
+            double dist = dtw->computeDistance(*examples[m],*examples[n],workspaces[threadIndex],INFINITY);
+            distanceResults[m][n] = dist;
+            if( symmetric ) distanceResults[n][m] = dist;
+        }
+    }
+
+    DTW *dtw;
+    vector< Matrix<double>* > &examples;
+    Matrix<double> &distanceResults;
+    vector< DTWWorkspace > &workspaces;
+    bool symmetric;
+};
+
 bool DTW::_train_NDDTW(LabelledTimeSeriesClassificationData &trainingData,DTWTemplate &dtwTemplate,UINT &bestIndex){
 
    UINT numExamples = trainingData.getNumSamples();
    vector<double> results(numExamples,0.0);
    Matrix<double> distanceResults(numExamples,numExamples);
    dtwTemplate.averageTemplateLength = 0;
+
+   //Smooth each example once, if smoothing is not used then the training data is used directly
+   vector< Matrix<double> > smoothedExamples( useSmoothing ? numExamples : 0 );
+   vector< Matrix<double>* > examples(numExamples);
    for(UINT m=0; m<numExamples; m++){
-	   Matrix<double> templateA; //The m'th template
-	   Matrix<double> templateB; //The n'th template
 	   dtwTemplate.averageTemplateLength += trainingData[m].getLength();
+	   if( useSmoothing ){
+		   smoothData(trainingData[m].getData(),smoothingFactor,smoothedExamples[m]);
+		   examples[m] = &smoothedExamples[m];
+	   }else examples[m] = &trainingData[m].getData();
+   }
 
-	   //Smooth the data if required
-	   if( useSmoothing ) smoothData(trainingData[m].getData(),smoothingFactor,templateA);
-	   else templateA = trainingData[m].getData();
+   //Compute the distance between every pair of examples, spread across the training threads
+   vector< DTWWorkspace > workspaces( numTrainingThreads > 0 ? numTrainingThreads : ParallelFor::getNumCPUCores() );
+   DTWTrainingDistanceJob job(this,examples,distanceResults,workspaces,useSymmetricTrainingDistances);
+   ParallelFor::run(job,job.getNumTasks(),(UINT)workspaces.size());
 
+   for(UINT m=0; m<numExamples; m++){
 	   for(UINT n=0; n<numExamples; n++){
-		if(m!=n){
-		    //Smooth the data if required
-		    if( useSmoothing ) smoothData(trainingData[n].getData(),smoothingFactor,templateB);
-		    else templateB = trainingData[n].getData();
-
-			//Compute the distance between the two time series
-			double dist = 0.0;
-			dist = computeDistance(templateA,templateB);
-
-			//Update the results values
-			distanceResults[m][n] = dist;
-			results[m] += dist;
-		}
+		   if( m != n ) results[m] += distanceResults[m][n];
 	   }
    }
 
@@ -300,14 +355,64 @@ bool DTW::predict(Matrix<double> &inputTimeSeries){
 	}
 
 	//Make the prediction by finding the closest template
+    const vector< DTWTemplate > &templates = *templatesBuffer;
+    
+    //If the predicted class only depends on the closest template then the lower bounds are used to skip any template that can not
+    //beat the best distance found so far. The classDistances of a skipped template is set to its lower bound rather than its distance,
+    //so it is not used to compute the class likelihoods
+    //The original warping window can not be bounded, so the pruning is only used with the Sakoe-Chiba band or an unconstrained path
+    const bool pruneTemplates = useLowerBoundPruning && !getUseWarpingWindow() && (!useNullRejection || rejectionMode == TEMPLATE_THRESHOLDS);
+    if( exactClassDistances.size() != numTemplates ) exactClassDistances.resize( numTemplates );
+    
+    if( pruneTemplates ){
+        //Visit the templates in order of their LB_Kim bound, so a close template is likely to be found first
+        const UINT N = timeSeriesPtr->getNumRows();
+        if( templateSearchOrder.size() != numTemplates ) templateSearchOrder.resize( numTemplates );
+        for(UINT k=0; k<numTemplates; k++){
+            templateSearchOrder[k].index = k;
+            templateSearchOrder[k].value = computeLowerBoundKim(templates[k].timeSeries,*timeSeriesPtr);
+        }
+        std::sort(templateSearchOrder.begin(),templateSearchOrder.end(),IndexedDouble::sortIndexedDoubleByValueDescending);
+        
+        double bestDistanceSoFar = INFINITY;
+        for(UINT n=0; n<numTemplates; n++){
+            const UINT k = templateSearchOrder[n].index;
+            
+            //Cascade the lower bounds, starting with the cheapest
+            double lowerBound = templateSearchOrder[n].value;
+            if( lowerBound <= bestDistanceSoFar ){
+                //The shared envelopes are for the length of the continuous prediction, any other length uses this DTW's own envelopes
+                const DTWEnvelope *envelope = &templates[k].envelope;
+                if( envelope->envelopeLength != N ){
+                    if( envelopeCache.size() != numTemplates ) envelopeCache.resize( numTemplates );
+                    if( envelopeCache[k].envelopeLength != N ) computeTemplateEnvelope(templates[k].timeSeries,N,envelopeCache[k]);
+                    envelope = &envelopeCache[k];
+                }
+                lowerBound = computeLowerBoundKeogh(templates[k],*envelope,*timeSeriesPtr);
+            }
+            if( lowerBound > bestDistanceSoFar ){
+                classDistances[k] = lowerBound;
+                exactClassDistances[k] = false;
+                continue;
+            }
+            
+            //Perform DTW, abandoning it as soon as the template can not beat the best distance
+            classDistances[k] = computeDistance(templates[k].timeSeries,*timeSeriesPtr,distanceWorkspace,bestDistanceSoFar);
+            exactClassDistances[k] = !distanceWorkspace.abandoned;
+            if( classDistances[k] < bestDistanceSoFar ) bestDistanceSoFar = classDistances[k];
+        }
+    }else{
+        //Test the timeSeries against all the templates in the timeSeries buffer
+        for(UINT k=0; k<numTemplates; k++){
+            //Perform DTW
+            classDistances[k] = computeDistance(templates[k].timeSeries,*timeSeriesPtr);
+            exactClassDistances[k] = true;
+        }
+    }
+    
     double sum = 0;
-	//Test the timeSeries against all the templates in the timeSeries buffer
 	for(UINT k=0; k<numTemplates; k++){
-		//Perform DTW
-		classDistances[k] = computeDistance(templatesBuffer[k].timeSeries,*timeSeriesPtr);
-
-        classLikelihoods[k] = exp( 1.0 - (classDistances[k]) );
-
+        classLikelihoods[k] = exactClassDistances[k] ? exp( 1.0 - (classDistances[k]) ) : 0;
         sum += classLikelihoods[k];
 	}
 
@@ -319,7 +424,7 @@ bool DTW::predict(Matrix<double> &inputTimeSeries){
         }cout << endl;
         cout << "Thresholds: ";
         for(UINT k=0; k<numTemplates; k++){
-            cout << templatesBuffer[k].threshold << "\t";
+            cout << templates[k].threshold << "\t";
         }cout << endl;
         cout << "Likelihoods: ";
         for(UINT k=0; k<numTemplates; k++){
@@ -367,16 +472,16 @@ bool DTW::predict(Matrix<double> &inputTimeSeries){
 
         switch( rejectionMode ){
             case TEMPLATE_THRESHOLDS:
-                if( bestDistance <= templatesBuffer[ closestTemplateIndex ].threshold ) predictedClassLabel = templatesBuffer[ closestTemplateIndex ].classLabel;
+                if( bestDistance <= templates[ closestTemplateIndex ].threshold ) predictedClassLabel = templates[ closestTemplateIndex ].classLabel;
                 else predictedClassLabel = 0;
                 break;
             case CLASS_LIKELIHOODS:
-                if( maxLikelihood >= 0.99 )  predictedClassLabel = templatesBuffer[ maxLikelihoodIndex ].classLabel;
+                if( maxLikelihood >= 0.99 )  predictedClassLabel = templates[ maxLikelihoodIndex ].classLabel;
                 else predictedClassLabel = 0;
                 break;
             case THRESHOLDS_AND_LIKELIHOODS:
-                if( bestDistance <= templatesBuffer[ closestTemplateIndex ].threshold && maxLikelihood >= 0.99 )
-                    predictedClassLabel = templatesBuffer[ closestTemplateIndex ].classLabel;
+                if( bestDistance <= templates[ closestTemplateIndex ].threshold && maxLikelihood >= 0.99 )
+                    predictedClassLabel = templates[ closestTemplateIndex ].classLabel;
                 else predictedClassLabel = 0;
                 break;
             default:
@@ -385,12 +490,12 @@ bool DTW::predict(Matrix<double> &inputTimeSeries){
                 break;
         }
 
-	}else predictedClassLabel = templatesBuffer[ closestTemplateIndex ].classLabel;
+	}else predictedClassLabel = templates[ closestTemplateIndex ].classLabel;
 
     return true;
 }
 
-bool DTW::predict(vector<double> inputVector){
+bool DTW::predict(const vector< double > &inputVector){
 
     if( !trained ){
         errorLog << "predict(vector<double> inputVector) - The model has not been trained!" << endl;
@@ -407,6 +512,10 @@ bool DTW::predict(vector<double> inputVector){
         return false;
     }
 
+    if( useStreamingPrediction ){
+        return predictStreaming( inputVector );
+    }
+
     //Add the new input to the circular buffer
     continuousInputDataBuffer.push_back( inputVector );
 
@@ -433,20 +542,228 @@ bool DTW::reset(){
     if( trained ){
         continuousInputDataBuffer.resize(averageTemplateLength,vector<double>(numFeatures,0));
         recomputeNullRejectionThresholds();
+        resetStreamingStates();
     }
     return true;
 }
 
+bool DTW::predictStreaming(const vector< double > &inputVector){
+
+    if( useZNormalisation ){
+        errorLog << "predictStreaming(const vector< double > &inputVector) - Z-normalisation needs the whole time series, so it can not be used with the streaming prediction!" << endl;
+        return false;
+    }
+
+    if( streamingStates.size() != numTemplates ) resetStreamingStates();
+
+    //Scale the input if required, the input is copied into a buffer that is reused for every sample
+    streamingInputVector = inputVector;
+    if( useScaling ){
+        for(UINT j=0; j<numFeatures; j++){
+            streamingInputVector[j] = scale(streamingInputVector[j],rangesBuffer[j].minValue,rangesBuffer[j].maxValue,0.0,1.0);
+        }
+    }
+
+    //If smoothing is used then the templates have a lower sample rate, so the input is averaged over blocks of smoothingFactor samples
+    if( useSmoothing && smoothingFactor > 1 ){
+        for(UINT j=0; j<numFeatures; j++) streamingSmoothingBuffer[j] += streamingInputVector[j];
+        if( ++streamingSmoothingCount < smoothingFactor ){
+            //The block is not complete yet so there is nothing to match
+            return true;
+        }
+        for(UINT j=0; j<numFeatures; j++){
+            streamingInputVector[j] = streamingSmoothingBuffer[j] / smoothingFactor;
+            streamingSmoothingBuffer[j] = 0;
+        }
+        streamingSmoothingCount = 0;
+    }
+
+    //Update the SPRING state of each template, if several templates report a match at this time step then the lowest cost wins
+    const UINT t = streamingTime++;
+    bool matchFound = false;
+    UINT bestMatchIndex = 0;
+    double bestMatchCost = INFINITY;
+    UINT bestMatchStart = 0;
+    UINT bestMatchEnd = 0;
+    bestDistance = INFINITY;
+    const vector< DTWTemplate > &templates = *templatesBuffer;
+    for(UINT k=0; k<numTemplates; k++){
+        const double threshold = useNullRejection ? templates[k].streamingThreshold : INFINITY;
+        double matchCost = 0;
+        UINT matchStart = 0;
+        UINT matchEnd = 0;
+        if( updateStreamingState(templates[k],streamingStates[k],streamingInputVector,t,threshold,matchCost,matchStart,matchEnd) ){
+            if( !matchFound || matchCost < bestMatchCost ){
+                matchFound = true;
+                bestMatchIndex = k;
+                bestMatchCost = matchCost;
+                bestMatchStart = matchStart;
+                bestMatchEnd = matchEnd;
+            }
+        }
+
+        //The class distance is the cost of the best match that ends at this time step
+        classDistances[k] = streamingStates[k].cost[ templates[k].timeSeries.getNumRows()-1 ];
+        if( classDistances[k] < bestDistance ) bestDistance = classDistances[k];
+    }
+
+    //Compute the class likelihoods in the same way as the batch prediction
+    double sum = 0;
+    for(UINT k=0; k<numTemplates; k++){
+        classLikelihoods[k] = exp( 1.0 - classDistances[k] );
+        sum += classLikelihoods[k];
+    }
+    maxLikelihood = 0;
+    if( sum > 0 ){
+        for(UINT k=0; k<numTemplates; k++){
+            classLikelihoods[k] /= sum;
+            if( classLikelihoods[k] > maxLikelihood ) maxLikelihood = classLikelihoods[k];
+        }
+    }
+
+    if( matchFound ){
+        predictedClassLabel = templates[ bestMatchIndex ].classLabel;
+        bestDistance = bestMatchCost;
+        matchStartTime = bestMatchStart;
+        matchEndTime = bestMatchEnd;
+    }
+
+    return true;
+}
+
+bool DTW::updateStreamingState(const DTWTemplate &dtwTemplate,DTWStreamingState &state,const vector< double > &inputVector,const UINT t,double threshold,double &matchCost,UINT &matchStart,UINT &matchEnd){
+
+    const UINT M = dtwTemplate.timeSeries.getNumRows();
+    bool matchReported = false;
+
+    //The costs from the last time step become the previous costs, then the new cost column is computed in one pass over the template
+    std::swap(state.cost,state.previousCost);
+    std::swap(state.startTime,state.previousStartTime);
+
+    for(UINT i=0; i<M; i++){
+        //A new path can start at the first sample of the template at any time step
+        double minCost = 0;
+        UINT start = t;
+        if( i > 0 ){
+            minCost = state.cost[i-1];
+            start = state.startTime[i-1];
+            if( state.previousCost[i] < minCost ){ minCost = state.previousCost[i]; start = state.previousStartTime[i]; }
+            if( state.previousCost[i-1] < minCost ){ minCost = state.previousCost[i-1]; start = state.previousStartTime[i-1]; }
+        }
+        state.cost[i] = computeLocalDistance(dtwTemplate.timeSeries[i],&inputVector[0],numFeatures,M) + minCost;
+        state.startTime[i] = start;
+    }
+
+    //Report the best match once none of the paths that overlap it can still beat it, then clear those paths
+    if( state.bestMatchCost < INFINITY ){
+        bool canReport = true;
+        for(UINT i=0; i<M; i++){
+            if( state.cost[i] < state.bestMatchCost && state.startTime[i] <= state.bestMatchEnd ){
+                canReport = false;
+                break;
+            }
+        }
+        if( canReport ){
+            matchCost = state.bestMatchCost;
+            matchStart = state.bestMatchStart;
+            matchEnd = state.bestMatchEnd;
+            matchReported = true;
+            for(UINT i=0; i<M; i++){
+                if( state.startTime[i] <= state.bestMatchEnd ) state.cost[i] = INFINITY;
+            }
+            state.bestMatchCost = INFINITY;
+        }
+    }
+
+    //Check if the path that ends at the last sample of the template is a new best match
+    if( state.cost[M-1] <= threshold && state.cost[M-1] < state.bestMatchCost ){
+        state.bestMatchCost = state.cost[M-1];
+        state.bestMatchStart = state.startTime[M-1];
+        state.bestMatchEnd = t;
+    }
+
+    return matchReported;
+}
+
+bool DTW::resetStreamingStates(){
+
+    const vector< DTWTemplate > &templates = *templatesBuffer;
+    streamingStates.resize( templates.size() );
+    for(UINT k=0; k<templates.size(); k++){
+        const UINT M = templates[k].timeSeries.getNumRows();
+        streamingStates[k].cost.assign(M,INFINITY);
+        streamingStates[k].startTime.assign(M,0);
+        streamingStates[k].previousCost.assign(M,INFINITY);
+        streamingStates[k].previousStartTime.assign(M,0);
+        streamingStates[k].bestMatchCost = INFINITY;
+        streamingStates[k].bestMatchStart = 0;
+        streamingStates[k].bestMatchEnd = 0;
+    }
+    streamingSmoothingBuffer.assign(numFeatures,0);
+    streamingSmoothingCount = 0;
+    streamingTime = 0;
+    matchStartTime = 0;
+    matchEndTime = 0;
+
+    return true;
+}
+
+bool DTW::computeStreamingThresholds(LabelledTimeSeriesClassificationData &classData,DTWTemplate &dtwTemplate,UINT bestIndex){
+
+    //The streaming prediction compares the accumulated cost of a match with the template, rather than the distance used by the batch
+    //prediction, so the mean and sigma of the accumulated cost of the other training examples are computed here
+    const UINT numExamples = classData.getNumSamples();
+    dtwTemplate.streamingTrainingMu = 0.0;
+    dtwTemplate.streamingTrainingSigma = 0.0;
+    if( numExamples < 2 ) return false;
+
+    vector< double > costs;
+    Matrix< double > smoothedExample;
+    for(UINT n=0; n<numExamples; n++){
+        if( n == bestIndex ) continue;
+        Matrix< double > *example = &classData[n].getData();
+        if( useSmoothing ){
+            smoothData(*example,smoothingFactor,smoothedExample);
+            example = &smoothedExample;
+        }
+        costs.push_back( computeAccumulatedDistance(dtwTemplate.timeSeries,*example) );
+        dtwTemplate.streamingTrainingMu += costs.back();
+    }
+    dtwTemplate.streamingTrainingMu /= costs.size();
+
+    if( costs.size() > 1 ){
+        for(UINT n=0; n<costs.size(); n++){
+            dtwTemplate.streamingTrainingSigma += SQR( costs[n]-dtwTemplate.streamingTrainingMu );
+        }
+        dtwTemplate.streamingTrainingSigma = sqrt( dtwTemplate.streamingTrainingSigma / (costs.size()-1) );
+    }
+
+    return true;
+}
+
 bool DTW::recomputeNullRejectionThresholds(){
 	if(!trained) return false;
 
     //Copy the null rejection thresholds into one buffer so they can easily be accessed from the base class
     nullRejectionThresholds.resize(numTemplates);
 
+    //The thresholds are stored in the shared templates, so they are only edited (which copies the templates if another DTW shares
+    //them) if the null rejection coeff has changed them
+    bool thresholdsChanged = false;
+    for(UINT k=0; k<numTemplates && !thresholdsChanged; k++){
+        const DTWTemplate &dtwTemplate = (*templatesBuffer)[k];
+        thresholdsChanged = dtwTemplate.threshold != dtwTemplate.trainingMu + (dtwTemplate.trainingSigma * nullRejectionCoeff) ||
+                            dtwTemplate.streamingThreshold != dtwTemplate.streamingTrainingMu + (dtwTemplate.streamingTrainingSigma * nullRejectionCoeff);
+    }
+
 	for(UINT k=0; k<numTemplates; k++){
 		//The threshold is set as the mean distance plus gamma standard deviations
-		templatesBuffer[k].threshold = templatesBuffer[k].trainingMu + (templatesBuffer[k].trainingSigma * nullRejectionCoeff);
-        nullRejectionThresholds[k] = templatesBuffer[k].threshold;
+		if( thresholdsChanged ){
+			DTWTemplate &dtwTemplate = templatesBuffer.edit()[k];
+			dtwTemplate.threshold = dtwTemplate.trainingMu + (dtwTemplate.trainingSigma * nullRejectionCoeff);
+			dtwTemplate.streamingThreshold = dtwTemplate.streamingTrainingMu + (dtwTemplate.streamingTrainingSigma * nullRejectionCoeff);
+		}
+        nullRejectionThresholds[k] = (*templatesBuffer)[k].threshold;
 	}
 
 	return true;
@@ -455,237 +772,433 @@ bool DTW::recomputeNullRejectionThresholds(){
 
 ////////////////////////// computeDistance ///////////////////////////////////////////
 
-double DTW::computeDistance(Matrix<double> &timeSeriesA,Matrix<double> &timeSeriesB){
+double DTW::computeDistance(const Matrix<double> &timeSeriesA,const Matrix<double> &timeSeriesB,double abandonDistance){
+	return computeDistance(timeSeriesA,timeSeriesB,distanceWorkspace,abandonDistance);
+}
+
+double DTW::computeDistance(const Matrix<double> &timeSeriesA,const Matrix<double> &timeSeriesB,DTWWorkspace &workspace,double abandonDistance){
 
-	double** distMatrix = NULL;
-	vector< IndexDist > WarpPath;
-	IndexDist tempW;
 	const UINT M = timeSeriesA.getNumRows();
 	const UINT N = timeSeriesB.getNumRows();
 	const UINT C = timeSeriesA.getNumCols();
-	UINT i,j,k,index = 0;
+	int i,j = 0;
+	UINT index = 0;
 	double totalDist,v,normFactor = 0.;
+	workspace.abandoned = false;
 
-    radius = ceil( min(M,N)/2.0 );
+	if( distanceMethod != ABSOLUTE_DIST && distanceMethod != EUCLIDEAN_DIST && distanceMethod != NORM_ABSOLUTE_DIST ){
+		errorLog<<"ERROR: Unknown distance method: "<<distanceMethod<<endl;
+		return -1;
+	}
 
-	//Construct the Distance Matrix
-	distMatrix = new double*[M];
-	for(i=0; i<M; i++) distMatrix[i] = new double[N];
+	if( M == 0 || N == 0 ){
+		warningLog << "DTW computeDistance(...) - One of the time series is empty!" << endl;
+		return INFINITY;
+	}
 
-	switch (distanceMethod) {
-		case (ABSOLUTE_DIST):
-			for(i=0; i<M; i++){
-				for(j=0; j<N; j++){
-					distMatrix[i][j] = 0.0;
-					for(k=0; k< C; k++){
-					   distMatrix[i][j] += fabs(timeSeriesA[i][k]-timeSeriesB[j][k]);
-					}
+	if( getUseWarpingWindow() ){
+		//Fill the cost matrix with the original warping window, this can not be abandoned early
+		computeWindowedCosts(timeSeriesA,timeSeriesB,workspace);
+	}else{
+		//Work out which cells are inside the warping band, the accumulated cost is only stored for these cells
+		const UINT numCells = computeWarpingBand(M,N,workspace);
+		if( workspace.accumulatedCosts.size() < numCells ) workspace.accumulatedCosts.resize( numCells );
+
+		//Fill the accumulated cost matrix row by row, any cell outside of the warping band has an infinite cost
+		const double maxPathLength = M+N-1;
+		for(i=0; i<int(M); i++){
+			double *costs = &workspace.accumulatedCosts[ workspace.bandOffset[i] ];
+			double rowMinCost = INFINITY;
+			for(j=workspace.bandStart[i]; j<=int(workspace.bandEnd[i]); j++){
+				double minCost = 0;
+				if( i > 0 || j > 0 ){
+					minCost = MIN_( getAccumulatedCost(workspace,i-1,j-1), getAccumulatedCost(workspace,i-1,j), getAccumulatedCost(workspace,i,j-1) );
 				}
+				costs[ j-workspace.bandStart[i] ] = computeLocalDistance(timeSeriesA[i],timeSeriesB[j],C,N) + minCost;
+				if( costs[ j-workspace.bandStart[i] ] < rowMinCost ) rowMinCost = costs[ j-workspace.bandStart[i] ];
 			}
-			break;
-		case (EUCLIDEAN_DIST):
-			//Calculate Euclidean Distance for all possible values
-			for(i=0; i<M; i++){
-				for(j=0; j<N; j++){
-					distMatrix[i][j] = 0.0;
-					for(k=0; k< C; k++){
-						distMatrix[i][j] += SQR(timeSeriesA[i][k]-timeSeriesB[j][k]);
-					}
-					distMatrix[i][j] = sqrt(distMatrix[i][j]);
-				}
+
+			//Every cell on the warp path from row i onwards costs at least rowMinCost, and there are at least M-i of them on a path
+			//of at most M+N-1 cells, so stop if the distance can no longer be below the abandon distance
+			const double lowerBound = (M-i) * rowMinCost / maxPathLength;
+			if( lowerBound > abandonDistance ){
+				workspace.abandoned = true;
+				return lowerBound;
 			}
-			break;
-		case (NORM_ABSOLUTE_DIST):
-			for(i=0; i<M; i++){
-				for(j=0; j<N; j++){
-					distMatrix[i][j] = 0.0;
-					for(k=0; k< C; k++){
-					   distMatrix[i][j] += fabs(timeSeriesA[i][k]-timeSeriesB[j][k]);
-					}
-					distMatrix[i][j]/=N;
+		}
+	}
+
+	if( isinf( getAccumulatedCost(workspace,M-1,N-1) ) ){
+		warningLog << "DTW computeDistance(...) - Distance Matrix Values are INF!" << endl;
+		return INFINITY;
+	}
+
+	//Now walk the warp path back through the cost matrix, starting at the end
+	i=M-1;
+	j=N-1;
+	totalDist = getAccumulatedCost(workspace,i,j);
+
+	//Use dynamic programming to navigate through the cost matrix until [0][0] has been reached
+	normFactor = 1;
+	while( i != 0 && j != 0 ) {
+		//Find the minimum cell to move to
+		v = 99e+99;
+		index = 0;
+		if( getAccumulatedCost(workspace,i-1,j) < v ){ v = getAccumulatedCost(workspace,i-1,j); index = 1; }
+		if( getAccumulatedCost(workspace,i,j-1) < v ){ v = getAccumulatedCost(workspace,i,j-1); index = 2; }
+		if( getAccumulatedCost(workspace,i-1,j-1) < v ){ v = getAccumulatedCost(workspace,i-1,j-1); index = 3; }
+		switch(index){
+			case(1):
+				i--;
+				break;
+			case(2):
+				j--;
+				break;
+			case(3):
+				i--;
+				j--;
+				break;
+			default:
+				warningLog << "DTW computeDistance(...) - Could not compute a warping path for the input matrix!" << endl;
+				return INFINITY;
+				break;
+		}
+		normFactor++;
+		totalDist += getAccumulatedCost(workspace,i,j);
+	}
+
+	return totalDist/normFactor;
+
+}
+
+double DTW::computeAccumulatedDistance(const Matrix<double> &timeSeriesA,const Matrix<double> &timeSeriesB){
+
+	const UINT M = timeSeriesA.getNumRows();
+	const UINT N = timeSeriesB.getNumRows();
+	const UINT C = timeSeriesA.getNumCols();
+
+	if( distanceMethod != ABSOLUTE_DIST && distanceMethod != EUCLIDEAN_DIST && distanceMethod != NORM_ABSOLUTE_DIST ){
+		errorLog << "computeAccumulatedDistance(...) - Unknown distance method: " << distanceMethod << endl;
+		return -1;
+	}
+
+	if( M == 0 || N == 0 ) return INFINITY;
+
+	computeWarpingBand(M,N,distanceWorkspace);
+	if( distanceWorkspace.previousCostRow.size() < N ) distanceWorkspace.previousCostRow.resize( N );
+	if( distanceWorkspace.currentCostRow.size() < N ) distanceWorkspace.currentCostRow.resize( N );
+
+	//Only two rows of the cost matrix are needed as the warp path is not required
+	for(UINT i=0; i<M; i++){
+		for(UINT j=distanceWorkspace.bandStart[i]; j<=distanceWorkspace.bandEnd[i]; j++){
+			double minCost = 0;
+			if( i > 0 || j > 0 ){
+				double diagonal = INFINITY;
+				double up = INFINITY;
+				double left = INFINITY;
+				if( i > 0 ){
+					if( j > distanceWorkspace.bandStart[i-1] && j-1 <= distanceWorkspace.bandEnd[i-1] ) diagonal = distanceWorkspace.previousCostRow[j-1];
+					if( j >= distanceWorkspace.bandStart[i-1] && j <= distanceWorkspace.bandEnd[i-1] ) up = distanceWorkspace.previousCostRow[j];
 				}
+				if( j > distanceWorkspace.bandStart[i] ) left = distanceWorkspace.currentCostRow[j-1];
+				minCost = MIN_(diagonal,up,left);
 			}
-			break;
-		default:
-			errorLog<<"ERROR: Unknown distance method: "<<distanceMethod<<endl;
-			//Cleanup Memory
-			for(i=0; i<M; i++){
-				delete[] distMatrix[i];
-				distMatrix[i] = NULL;
-			}
-			delete[] distMatrix;
-			distMatrix = NULL;
-			return -1;
-			break;
+			distanceWorkspace.currentCostRow[j] = computeLocalDistance(timeSeriesA[i],timeSeriesB[j],C,M) + minCost;
+		}
+		std::swap(distanceWorkspace.previousCostRow,distanceWorkspace.currentCostRow);
 	}
 
-    double distance = sqrt( d(M-1,N-1,distMatrix,M,N) );
+	return distanceWorkspace.previousCostRow[N-1];
+}
 
-    if( isinf(distance) ){
-        warningLog << "DTW computeDistance(...) - Distance Matrix Values are INF!" << endl;
-        return INFINITY;
-    }
+double DTW::computeLowerBoundKim(const Matrix<double> &timeSeriesA,const Matrix<double> &timeSeriesB){
 
-    //The distMatrix values are negative so make them positive
-    for(i=0; i<M; i++){
-        for(j=0; j<N; j++){
-            distMatrix[i][j] = fabs( distMatrix[i][j] );
-        }
-    }
+	const UINT M = timeSeriesA.getNumRows();
+	const UINT N = timeSeriesB.getNumRows();
+	const UINT C = timeSeriesA.getNumCols();
 
-	//Now Create the Warp Path through the cost matrix, starting at the end
-    i=M-1;
-	j=N-1;
-	tempW.x = i;
-	tempW.y = j;
-    tempW.dist = distMatrix[tempW.x][tempW.y];
-	totalDist = distMatrix[tempW.x][tempW.y];
-    WarpPath.push_back(tempW);
-    
-	//Use dynamic programming to navigate through the cost matrix until [0][0] has been reached
-    normFactor = 1;
-	while( i != 0 && j != 0 ) {
-		if(i==0) j--;
-		else if(j==0) i--;
-		else{
-            //Find the minimum cell to move to
-			v = 99e+99;
-			index = 0;
-			if( distMatrix[i-1][j] < v ){ v = distMatrix[i-1][j]; index = 1; }
-			if( distMatrix[i][j-1] < v ){ v = distMatrix[i][j-1]; index = 2; }
-			if( distMatrix[i-1][j-1] < v ){ v = distMatrix[i-1][j-1]; index = 3; }
-			switch(index){
-				case(1):
-					i--;
-					break;
-				case(2):
-					j--;
-					break;
-				case(3):
-					i--;
-					j--;
-					break;
-				default:
-                    warningLog << "DTW computeDistance(...) - Could not compute a warping path for the input matrix!" << endl;
-					return INFINITY;
-					break;
+	if( M == 0 || N == 0 ) return 0;
+
+	//Every warp path starts at [0][0] and ends at [M-1][N-1], so every cell on the path costs at least the first cell and the last
+	//cell costs at least the first plus the last. Averaged over a path of at most M+N-1 cells this gives the bound below
+	const double firstCost = computeLocalDistance(timeSeriesA[0],timeSeriesB[0],C,N);
+	if( M == 1 && N == 1 ) return firstCost;
+	const double lastCost = computeLocalDistance(timeSeriesA[M-1],timeSeriesB[N-1],C,N);
+
+	return firstCost + lastCost / (M+N-1);
+}
+
+double DTW::computeLowerBoundKeogh(const DTWTemplate &dtwTemplate,const DTWEnvelope &envelope,const Matrix<double> &timeSeries){
+
+	const UINT M = dtwTemplate.timeSeries.getNumRows();
+	const UINT N = timeSeries.getNumRows();
+	const UINT C = timeSeries.getNumCols();
+
+	if( M == 0 || N == 0 || envelope.envelopeLength != N ) return 0;
+	if( columnLowerBounds.size() < N ) columnLowerBounds.resize( N );
+
+	//The cost of matching column j of the time series is at least the distance from that column to the template envelope.
+	//columnLowerBounds[j] stores the sum of these bounds for columns 0 to j, which bounds the cost of any cell in column j
+	double sum = 0;
+	for(UINT j=0; j<N; j++){
+		double dist = 0;
+		for(UINT k=0; k<C; k++){
+			double d = 0;
+			if( timeSeries[j][k] > envelope.upperEnvelope[j][k] ) d = timeSeries[j][k] - envelope.upperEnvelope[j][k];
+			else if( timeSeries[j][k] < envelope.lowerEnvelope[j][k] ) d = envelope.lowerEnvelope[j][k] - timeSeries[j][k];
+			dist += distanceMethod == EUCLIDEAN_DIST ? d*d : d;
+		}
+		if( distanceMethod == EUCLIDEAN_DIST ) dist = sqrt( dist );
+		if( distanceMethod == NORM_ABSOLUTE_DIST ) dist /= N;
+
+		//Every path starts at [0][0] so the first column costs at least that cell
+		if( j == 0 ){
+			const double firstCost = computeLocalDistance(dtwTemplate.timeSeries[0],timeSeries[0],C,N);
+			if( firstCost > dist ) dist = firstCost;
+		}
+		sum += dist;
+		columnLowerBounds[j] = sum;
+	}
+
+	//The warp path ends in some column j and covers every column from j to N-1 at least once, with any extra cells costing at
+	//least columnLowerBounds[j]. The distance is the average over at most M+N-1 cells, so take the smallest bound over all j
+	const double maxPathLength = M+N-1;
+	double lowerBound = INFINITY;
+	double tailSum = 0;
+	for(int j=N-1; j>=0; j--){
+		tailSum += columnLowerBounds[j];
+		const double bound = columnLowerBounds[j] + (tailSum - (N-j)*columnLowerBounds[j]) / maxPathLength;
+		if( bound < lowerBound ) lowerBound = bound;
+	}
+
+	return lowerBound;
+}
+
+bool DTW::computeTemplateEnvelope(const Matrix<double> &templateTimeSeries,const UINT N,DTWEnvelope &envelope){
+
+	const UINT M = templateTimeSeries.getNumRows();
+	const UINT C = templateTimeSeries.getNumCols();
+
+	envelope.envelopeLength = 0;
+	if( M == 0 || N == 0 ) return false;
+
+	envelope.lowerEnvelope.resize(N,C);
+	envelope.upperEnvelope.resize(N,C);
+	envelope.lowerEnvelope.setAllValues( INFINITY );
+	envelope.upperEnvelope.setAllValues( -INFINITY );
+
+	//The envelope for column j is the min and max of the template samples that can be warped to column j
+	computeWarpingBand(M,N,distanceWorkspace);
+	for(UINT i=0; i<M; i++){
+		for(UINT j=distanceWorkspace.bandStart[i]; j<=distanceWorkspace.bandEnd[i]; j++){
+			for(UINT k=0; k<C; k++){
+				if( templateTimeSeries[i][k] < envelope.lowerEnvelope[j][k] ) envelope.lowerEnvelope[j][k] = templateTimeSeries[i][k];
+				if( templateTimeSeries[i][k] > envelope.upperEnvelope[j][k] ) envelope.upperEnvelope[j][k] = templateTimeSeries[i][k];
 			}
 		}
-        normFactor++;
-		tempW.x = i;
-		tempW.y = j;
-        tempW.dist = distMatrix[tempW.x][tempW.y];
-		totalDist += distMatrix[tempW.x][tempW.y];
-		WarpPath.push_back(tempW);
 	}
 
-	//Cleanup Memory
-	for(i=0; i<M; i++){
-		delete[] distMatrix[i];
-		distMatrix[i] = NULL;
+	envelope.envelopeLength = N;
+	return true;
+}
+
+bool DTW::computeTemplateEnvelopes(){
+
+	//The envelopes are computed for the length of the time series built by the continuous prediction
+	UINT N = averageTemplateLength;
+	if( useSmoothing && smoothingFactor > 1 && N >= smoothingFactor ){
+		N = (N / smoothingFactor) + (N % smoothingFactor != 0 ? 1 : 0);
 	}
-	delete[] distMatrix;
-	distMatrix = NULL;
 
-	return totalDist/normFactor;
+	//Any envelopes computed for other lengths depend on the same settings, so they are computed again when they are next used
+	envelopeCache.clear();
 
+	vector< DTWTemplate > &templates = templatesBuffer.edit();
+	for(UINT k=0; k<templates.size(); k++){
+		computeTemplateEnvelope(templates[k].timeSeries,N,templates[k].envelope);
+	}
+	return true;
 }
 
-double DTW::d(int m,int n,double **distMatrix,const int M,const int N){
-    double dist = 0;
-    //The following is based on Matlab the DTW code by Eamonn Keogh and Michael Pazzani
-
-    if( dtwConstrain ){
-        //Test to see if the current cell is outside of the warping window
-        if( m > 0 ){
-            if( fabs( double( n-(N/(M/m)) ) ) > radius ){
-
-                //Test to see if the current cell is above the warping window
-                if( n-(N/(M/m)) > 0 ){
-                    //Set all the values above and to the right to NAN
-                    for(int i=0; i<m; i++)
-                        for(int j=n; j<N; j++)
-                            distMatrix[i][j] = NAN;
-                }else{
-                    //Set all the values below and to the left to NAN
-                    for(int i=m; i<M; i++)
-                        for(int j=0; j<n; j++)
-                            distMatrix[i][j] = NAN;
-                }
+UINT DTW::computeWarpingBand(const UINT M,const UINT N,DTWWorkspace &workspace){
 
-            }
-        }
-    }
+	if( workspace.bandStart.size() < M ){
+		workspace.bandStart.resize(M);
+		workspace.bandEnd.resize(M);
+		workspace.bandOffset.resize(M);
+	}
 
-    //If this cell contains a negative value then it has already been searched
-    //The cost is therefore the absolute value of the negative value so return it
-    if( distMatrix[m][n] < 0 || isnan( distMatrix[m][n] ) ){
-        dist = fabs( distMatrix[m][n] );
-        return dist;
-    }
+	//If the path is not constrained, or one of the series only has one sample, then every cell is in the band
+	if( !dtwConstrain || M == 1 || N == 1 ){
+		for(UINT i=0; i<M; i++){
+			workspace.bandStart[i] = 0;
+			workspace.bandEnd[i] = N-1;
+			workspace.bandOffset[i] = i*N;
+		}
+		return M*N;
+	}
 
-    //Case 1: A warping path has reached the end
-    //Return the contribution of distance
-    //Negate the value, to record the fact that this cell has been visited
-    //End of recursion
-    if( m == 0 && n == 0 ){
-        dist = distMatrix[0][0];
-        distMatrix[0][0] = -distMatrix[0][0];
-        return dist;
-    }
+	//The band is centered on the diagonal between [0][0] and [M-1][N-1]. If the radius has not been set then it defaults
+	//to half the length of the shortest time series. The radius must be at least (slope+1)/2 to keep the band connected
+	const double slope = double(N-1)/double(M-1);
+	double warpingRadius = radius > 0 ? radius : ceil( min(M,N)/2.0 );
+	if( warpingRadius < (slope+1.0)/2.0 ) warpingRadius = (slope+1.0)/2.0;
+
+	UINT numCells = 0;
+	for(UINT i=0; i<M; i++){
+		const double center = i*slope;
+		const double lower = ceil( center - warpingRadius );
+		const double upper = floor( center + warpingRadius );
+		workspace.bandStart[i] = lower > 0 ? (UINT)lower : 0;
+		workspace.bandEnd[i] = upper < N-1 ? (UINT)upper : N-1;
+		workspace.bandOffset[i] = numCells;
+		numCells += workspace.bandEnd[i] - workspace.bandStart[i] + 1;
+	}
 
-    //Case 2: we are somewhere in the top row of the matrix
-    //Only need to consider moving left
-    if( m == 0 ){
-        double contribDist = d(m,n-1,distMatrix,M,N);
+	return numCells;
+}
 
-        dist = distMatrix[m][n] + contribDist;
+void DTW::computeWindowedCosts(const Matrix<double> &timeSeriesA,const Matrix<double> &timeSeriesB,DTWWorkspace &workspace){
 
-        distMatrix[m][n] = -dist;
-        return dist;
-    }else{
-        //Case 3: we are somewhere in the left column of the matrix
-        //Only need to consider moving down
-        if ( n == 0) {
-            double contribDist = d(m-1,n,distMatrix,M,N);
-
-            dist = distMatrix[m][n] + contribDist;
-
-            distMatrix[m][n] = -dist;
-            return dist;
-        }else{
-            //Case 4: We are somewhere away from the edges so consider moving in the three main directions
-            double contribDist1 = d(m-1,n-1,distMatrix,M,N);
-            double contribDist2 = d(m-1,n,distMatrix,M,N);
-            double contribDist3 = d(m,n-1,distMatrix,M,N);
-            double minValue = 99e+99;
-            int index = 0;
-            if( contribDist1 < minValue ){ minValue = contribDist1; index = 1; }
-			if( contribDist2 < minValue ){ minValue = contribDist2; index = 2; }
-			if( contribDist3 < minValue ){ minValue = contribDist3; index = 3; }
-
-            switch ( index ) {
-                case 1:
-                    dist = distMatrix[m][n] + minValue;
-                    break;
-                case 2:
-                    dist = distMatrix[m][n] + minValue;
-                    break;
-                case 3:
-                    dist = distMatrix[m][n] + minValue;
-                    break;
-
-                default:
-                    break;
-            }
+	const int M = (int)timeSeriesA.getNumRows();
+	const int N = (int)timeSeriesB.getNumRows();
+	const UINT C = timeSeriesA.getNumCols();
+	const double windowRadius = ceil( min(M,N)/2.0 );
 
-            distMatrix[m][n] = -dist; //Negate the value to record that it has been visited
-            return dist;
-        }
-    }
+	//Every cell is stored, the band covers the full matrix
+	if( workspace.bandStart.size() < UINT(M) ){
+		workspace.bandStart.resize(M);
+		workspace.bandEnd.resize(M);
+		workspace.bandOffset.resize(M);
+	}
+	for(int i=0; i<M; i++){
+		workspace.bandStart[i] = 0;
+		workspace.bandEnd[i] = N-1;
+		workspace.bandOffset[i] = i*N;
+	}
+	if( workspace.accumulatedCosts.size() < UINT(M*N) ) workspace.accumulatedCosts.resize( M*N );
+	double *costs = &workspace.accumulatedCosts[0];
+	for(int i=0; i<M; i++){
+		for(int j=0; j<N; j++){
+			costs[i*N+j] = computeLocalDistance(timeSeriesA[i],timeSeriesB[j],C,N);
+		}
+	}
+
+	//This follows the recursive search of the cost matrix (based on the Matlab DTW code by Eamonn Keogh and Michael Pazzani) that
+	//this DTW has always used, with an explicit stack so a long time series can not overflow the call stack. A visited cell is
+	//negated, and a cell outside of the window marks every cell above and to the right of it (or below and to the left of it) as
+	//NAN, which the search then ignores. The marked cells (and so the distance) depend on the order the cells are searched in, so
+	//this is the same order as the recursion. The marked cells always form a staircase in each corner of the matrix, so rather than
+	//writing NAN to them the edge of each staircase is stored for every row
+	vector< int > &aboveStart = workspace.windowAboveStart;
+	vector< int > &belowEnd = workspace.windowBelowEnd;
+	aboveStart.assign( M, N );
+	belowEnd.assign( M, 0 );
+	vector< DTWSearchCell > &stack = workspace.searchStack;
+	stack.clear();
+	stack.push_back( DTWSearchCell(M-1,N-1) );
+	double returnCost = 0;                  //The cost returned by the last cell that was finished
+
+	while( !stack.empty() ){
+		DTWSearchCell &cell = stack.back();
+		const int m = cell.m;
+		const int n = cell.n;
+		double &cost = costs[m*N+n];
+
+		if( cell.numSearched < 0 ){
+			//Test to see if the current cell is outside of the warping window
+			if( m > 0 ){
+				const int windowCenter = N/(M/m);
+				if( fabs( double( n-windowCenter ) ) > windowRadius ){
+					if( n-windowCenter > 0 ){
+						//Mark all the values above and to the right as NAN
+						for(int i=m-1; i>=0 && aboveStart[i] > n; i--) aboveStart[i] = n;
+					}else{
+						//Mark all the values below and to the left as NAN
+						for(int i=m; i<M && belowEnd[i] < n; i++) belowEnd[i] = n;
+					}
+				}
+			}
+
+			//A cell that has already been searched returns its cost, a NAN cell returns NAN
+			if( n >= aboveStart[m] || n < belowEnd[m] ){
+				returnCost = NAN;
+				stack.pop_back();
+				continue;
+			}
+			if( cost < 0 ){
+				returnCost = fabs( cost );
+				stack.pop_back();
+				continue;
+			}
+
+			//The path has reached the start
+			if( m == 0 && n == 0 ){
+				returnCost = cost;
+				cost = -cost;
+				stack.pop_back();
+				continue;
+			}
 
-    //This should not happen!
-    return dist;
+			cell.numSearched = 0;
+			cell.minCost = 99e+99;
+		}else{
+			//A cell in the top row or the left column only has one neighbour, any other cell waits for all three
+			cell.numSearched++;
+			if( m == 0 || n == 0 ){
+				returnCost = cost + returnCost;
+				cost = -returnCost;
+				stack.pop_back();
+				continue;
+			}
+			if( returnCost < cell.minCost ) cell.minCost = returnCost;
+			if( cell.numSearched == 3 ){
+				//If no neighbour had a cost (they were all NAN) then the cost is 0, as it was in the recursion
+				returnCost = cell.minCost < 99e+99 ? cost + cell.minCost : 0;
+				cost = -returnCost;
+				stack.pop_back();
+				continue;
+			}
+		}
+
+		//Search the next neighbour, the diagonal cell first, then the cell above, then the cell to the left
+		if( m == 0 ) stack.push_back( DTWSearchCell(0,n-1) );
+		else if( n == 0 ) stack.push_back( DTWSearchCell(m-1,0) );
+		else if( cell.numSearched == 0 ) stack.push_back( DTWSearchCell(m-1,n-1) );
+		else if( cell.numSearched == 1 ) stack.push_back( DTWSearchCell(m-1,n) );
+		else stack.push_back( DTWSearchCell(m,n-1) );
+	}
+
+	//The visited cells are negative so make them positive
+	for(int i=0; i<M; i++){
+		for(int j=0; j<N; j++){
+			costs[i*N+j] = j >= aboveStart[i] || j < belowEnd[i] ? NAN : fabs( costs[i*N+j] );
+		}
+	}
+}
+
+inline double DTW::getAccumulatedCost(DTWWorkspace &workspace,const int i,const int j){
+	if( i < 0 || j < 0 ) return INFINITY;
+	if( j < int(workspace.bandStart[i]) || j > int(workspace.bandEnd[i]) ) return INFINITY;
+	return workspace.accumulatedCosts[ workspace.bandOffset[i] + (j-workspace.bandStart[i]) ];
+}
+
+inline double DTW::computeLocalDistance(const double *a,const double *b,const UINT C,const UINT N){
+	double dist = 0;
+	switch( distanceMethod ){
+		case (ABSOLUTE_DIST):
+			for(UINT k=0; k<C; k++) dist += fabs(a[k]-b[k]);
+			break;
+		case (EUCLIDEAN_DIST):
+			for(UINT k=0; k<C; k++) dist += SQR(a[k]-b[k]);
+			dist = sqrt(dist);
+			break;
+		case (NORM_ABSOLUTE_DIST):
+			for(UINT k=0; k<C; k++) dist += fabs(a[k]-b[k]);
+			dist /= N;
+			break;
+	}
+	return dist;
 }
 
 inline double DTW::MIN_(double a,double b, double c){
@@ -695,6 +1208,33 @@ inline double DTW::MIN_(double a,double b, double c){
 	return v;
 }
 
+bool DTW::enableConstrainWarpingPath(bool dtwConstrain){
+	this->dtwConstrain = dtwConstrain;
+	if( trained ) computeTemplateEnvelopes();
+	return true;
+}
+
+bool DTW::enableStreamingPrediction(bool useStreamingPrediction){
+	this->useStreamingPrediction = useStreamingPrediction;
+	if( trained ) resetStreamingStates();
+	return true;
+}
+
+bool DTW::setNumTrainingThreads(UINT numTrainingThreads){
+	this->numTrainingThreads = numTrainingThreads;
+	return true;
+}
+
+bool DTW::setWarpingRadius(double radius){
+	if( radius >= 0 ){
+		this->radius = radius;
+		if( trained ) computeTemplateEnvelopes();
+		return true;
+	}
+	errorLog << "setWarpingRadius(double radius) - The radius must be greater than or equal to zero!" << endl;
+	return false;
+}
+
 
 ////////////////////////// SCALING AND NORMALISATION FUNCTIONS //////////////////////////
 
@@ -897,18 +1437,21 @@ bool DTW::saveModelToFile( fstream &file ){
     file << "NullRejectionCoeff: "<<nullRejectionCoeff<<endl;
     file << "OverallAverageTemplateLength: "<<averageTemplateLength<<endl;
     //Save each template
+    const vector< DTWTemplate > &templates = *templatesBuffer;
     for(UINT i=0; i<numTemplates; i++){
         file<<"Template: "<<i+1<<endl;
-        file<<"ClassLabel: "<<templatesBuffer[i].classLabel<<endl;
-        file<<"TimeSeriesLength: "<<templatesBuffer[i].timeSeries.getNumRows()<<endl;
-        file<<"TemplateThreshold: "<<templatesBuffer[i].threshold<<endl;
-        file<<"TrainingMu: "<<templatesBuffer[i].trainingMu<<endl;
-        file<<"TrainingSigma: "<<templatesBuffer[i].trainingSigma<<endl;
-        file<<"AverageTemplateLength: "<<templatesBuffer[i].averageTemplateLength<<endl;
+        file<<"ClassLabel: "<<templates[i].classLabel<<endl;
+        file<<"TimeSeriesLength: "<<templates[i].timeSeries.getNumRows()<<endl;
+        file<<"TemplateThreshold: "<<templates[i].threshold<<endl;
+        file<<"TrainingMu: "<<templates[i].trainingMu<<endl;
+        file<<"TrainingSigma: "<<templates[i].trainingSigma<<endl;
+        file<<"AverageTemplateLength: "<<templates[i].averageTemplateLength<<endl;
+        file<<"StreamingTrainingMu: "<<templates[i].streamingTrainingMu<<endl;
+        file<<"StreamingTrainingSigma: "<<templates[i].streamingTrainingSigma<<endl;
         file<<"TimeSeries: \n";
-        for(UINT k=0; k<templatesBuffer[i].timeSeries.getNumRows(); k++){
-            for(UINT j=0; j<templatesBuffer[i].timeSeries.getNumCols(); j++){
-                file << templatesBuffer[i].timeSeries[k][j] << "\t";
+        for(UINT k=0; k<templates[i].timeSeries.getNumRows(); k++){
+            for(UINT j=0; j<templates[i].timeSeries.getNumCols(); j++){
+                file << templates[i].timeSeries[k][j] << "\t";
             }file << endl;
         }
         file<<"***************************"<<endl;
@@ -1049,8 +1592,9 @@ bool DTW::loadModelFromFile( fstream &file ){
     }
     file >> averageTemplateLength;
     
-    //Clean and reset the memory
-    templatesBuffer.resize(numTemplates);
+    //Clean and reset the memory, any copies of this DTW keep the previous templates
+    vector< DTWTemplate > &templates = templatesBuffer.reset();
+    templates.resize(numTemplates);
     classLabels.resize(numTemplates);
     
     //Load each template
@@ -1078,8 +1622,8 @@ bool DTW::loadModelFromFile( fstream &file ){
             errorLog << "loadDTWModelFromFile( string fileName ) - Failed to find ClassLabel!" << endl;
             return false;
         }
-        file >> templatesBuffer[i].classLabel;
-        classLabels[i] = templatesBuffer[i].classLabel;
+        file >> templates[i].classLabel;
+        classLabels[i] = templates[i].classLabel;
         
         //Get the time series length
         file >> word;
@@ -1092,7 +1636,7 @@ bool DTW::loadModelFromFile( fstream &file ){
         file >> timeSeriesLength;
         
         //Resize the buffers
-        templatesBuffer[i].timeSeries.resize(timeSeriesLength,numFeatures);
+        templates[i].timeSeries.resize(timeSeriesLength,numFeatures);
         
         //Get the template threshold
         file >> word;
@@ -1102,7 +1646,7 @@ bool DTW::loadModelFromFile( fstream &file ){
             errorLog << "loadDTWModelFromFile( string fileName ) - Failed to find TemplateThreshold!" << endl;
             return false;
         }
-        file >> templatesBuffer[i].threshold;
+        file >> templates[i].threshold;
         
         //Get the mu values
         file >> word;
@@ -1112,7 +1656,7 @@ bool DTW::loadModelFromFile( fstream &file ){
             errorLog << "loadDTWModelFromFile( string fileName ) - Failed to find TrainingMu!" << endl;
             return false;
         }
-        file >> templatesBuffer[i].trainingMu;
+        file >> templates[i].trainingMu;
         
         //Get the sigma values
         file >> word;
@@ -1122,7 +1666,7 @@ bool DTW::loadModelFromFile( fstream &file ){
             errorLog << "loadDTWModelFromFile( string fileName ) - Failed to find TrainingSigma!" << endl;
             return false;
         }
-        file >> templatesBuffer[i].trainingSigma;
+        file >> templates[i].trainingSigma;
         
         //Get the AverageTemplateLength value
         file >> word;
@@ -1132,10 +1676,26 @@ bool DTW::loadModelFromFile( fstream &file ){
             errorLog << "loadDTWModelFromFile( string fileName ) - Failed to find AverageTemplateLength!" << endl;
             return false;
         }
-        file >> templatesBuffer[i].averageTemplateLength;
+        file >> templates[i].averageTemplateLength;
         
-        //Get the data
+        //Get the streaming cost statistics, these are not in files saved before the streaming prediction was added
         file >> word;
+        templates[i].streamingTrainingMu = 0.0;
+        templates[i].streamingTrainingSigma = 0.0;
+        if(word == "StreamingTrainingMu:"){
+            file >> templates[i].streamingTrainingMu;
+            file >> word;
+            if(word != "StreamingTrainingSigma:"){
+                numTemplates=0;
+                trained = false;
+                errorLog << "loadDTWModelFromFile( string fileName ) - Failed to find StreamingTrainingSigma!" << endl;
+                return false;
+            }
+            file >> templates[i].streamingTrainingSigma;
+            file >> word;
+        }
+        
+        //Get the data
         if(word != "TimeSeries:"){
             numTemplates=0;
             trained = false;
@@ -1144,7 +1704,7 @@ bool DTW::loadModelFromFile( fstream &file ){
         }
         for(UINT k=0; k<timeSeriesLength; k++)
             for(UINT j=0; j<numFeatures; j++)
-                file >> templatesBuffer[i].timeSeries[k][j];
+                file >> templates[i].timeSeries[k][j];
         
         //Check for the footer
         file >> word;
@@ -1158,19 +1718,137 @@ bool DTW::loadModelFromFile( fstream &file ){
         }
     }
     
+    return setupLoadedModel();
+}
+    
+bool DTW::saveModelToBinaryFile( fstream &file ){
+    
+    if(!file.is_open()){
+        errorLog << "saveModelToBinaryFile( fstream &file ) - Could not open file to save data" << endl;
+        return false;
+    }
+    
+    BinaryWriter writer( file );
+    writer.write( string("GRT_DTW_Model_Binary_V1.0") );
+    writer.write( numFeatures );
+    writer.write( numClasses );
+    writer.write( numTemplates );
+    writer.write( distanceMethod == EUCLIDEAN_DIST ? (UINT)EUCLIDEAN_DIST : (UINT)ABSOLUTE_DIST );
+    writer.write( useNullRejection );
+    writer.write( useSmoothing );
+    writer.write( smoothingFactor );
+    writer.write( useScaling );
+    writer.write( useZNormalisation );
+    writer.write( rejectionMode );
+    writer.write( nullRejectionCoeff );
+    writer.write( averageTemplateLength );
+    const vector< DTWTemplate > &templates = *templatesBuffer;
+    for(UINT i=0; i<numTemplates; i++){
+        const Matrix<double> &timeSeries = templates[i].timeSeries;
+        writer.write( templates[i].classLabel );
+        writer.write( timeSeries.getNumRows() );
+        writer.write( templates[i].threshold );
+        writer.write( templates[i].trainingMu );
+        writer.write( templates[i].trainingSigma );
+        writer.write( templates[i].averageTemplateLength );
+        writer.write( templates[i].streamingTrainingMu );
+        writer.write( templates[i].streamingTrainingSigma );
+        writer.writeArray( timeSeries.getData(), (unsigned long long)timeSeries.getNumRows()*timeSeries.getNumCols() );
+    }
+    
+    if( !writer.good() ){
+        errorLog << "saveModelToBinaryFile( fstream &file ) - Failed to write the model!" << endl;
+        return false;
+    }
+    
+    return true;
+}
+    
+bool DTW::loadModelFromBinaryData( const char *data,unsigned long long size ){
+    
+    trained = false;
+    
+    BinaryReader reader(data,size);
+    string header;
+    reader.read( header );
+    if( header != "GRT_DTW_Model_Binary_V1.0" ){
+        errorLog << "loadModelFromBinaryData( const char *data,unsigned long long size ) - Unknown file header!" << endl;
+        return false;
+    }
+    
+    reader.read( numFeatures );
+    reader.read( numClasses );
+    reader.read( numTemplates );
+    reader.read( distanceMethod );
+    reader.read( useNullRejection );
+    reader.read( useSmoothing );
+    reader.read( smoothingFactor );
+    reader.read( useScaling );
+    reader.read( useZNormalisation );
+    reader.read( rejectionMode );
+    reader.read( nullRejectionCoeff );
+    reader.read( averageTemplateLength );
+    
+    //Each template takes at least 48 bytes, so a corrupt template count is caught before the buffers are resized
+    if( !reader.good() || numTemplates > size / 48 ){
+        numTemplates = 0;
+        errorLog << "loadModelFromBinaryData( const char *data,unsigned long long size ) - The model is truncated or corrupt!" << endl;
+        return false;
+    }
+    
+    vector< DTWTemplate > &templates = templatesBuffer.reset();
+    templates.resize(numTemplates);
+    classLabels.resize(numTemplates);
+    for(UINT i=0; i<numTemplates && reader.good(); i++){
+        UINT timeSeriesLength = 0;
+        reader.read( templates[i].classLabel );
+        reader.read( timeSeriesLength );
+        reader.read( templates[i].threshold );
+        reader.read( templates[i].trainingMu );
+        reader.read( templates[i].trainingSigma );
+        reader.read( templates[i].averageTemplateLength );
+        reader.read( templates[i].streamingTrainingMu );
+        reader.read( templates[i].streamingTrainingSigma );
+        const double *timeSeries = reader.readArray( (unsigned long long)timeSeriesLength*numFeatures );
+        if( timeSeries == NULL ) break;
+        
+        //Copy the time series straight from the data
+        templates[i].timeSeries.resize(timeSeriesLength,numFeatures);
+        std::copy(timeSeries,timeSeries+(unsigned long long)timeSeriesLength*numFeatures,templates[i].timeSeries.getData());
+        classLabels[i] = templates[i].classLabel;
+    }
+    
+    if( !reader.good() ){
+        numTemplates = 0;
+        numClasses = 0;
+        numFeatures = 0;
+        errorLog << "loadModelFromBinaryData( const char *data,unsigned long long size ) - The model is truncated or corrupt!" << endl;
+        return false;
+    }
+    
+    return setupLoadedModel();
+}
+    
+bool DTW::setupLoadedModel(){
+    
+    //Flag that the model is trained first, as the null rejection thresholds are only computed for a trained model
+    trained = true;
+    
     //Recompute the null rejection thresholds
     recomputeNullRejectionThresholds( );
     
+    //Compute the lower bound envelopes used to prune the templates during prediction
+    computeTemplateEnvelopes();
+    
     //Resize the prediction results to make sure it is setup for realtime prediction
     continuousInputDataBuffer.clear();
     continuousInputDataBuffer.resize(averageTemplateLength,vector<double>(numFeatures,0));
+    resetStreamingStates();
     maxLikelihood = DEFAULT_NULL_LIKELIHOOD_VALUE;
     bestDistance = DEFAULT_NULL_DISTANCE_VALUE;
     classLikelihoods.resize(numClasses,DEFAULT_NULL_LIKELIHOOD_VALUE);
     classDistances.resize(numClasses,DEFAULT_NULL_DISTANCE_VALUE);
     
-    trained = true;
-    
     return true;
 }
 bool DTW::setRejectionMode(UINT rejectionMode){
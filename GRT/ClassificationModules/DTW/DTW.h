@@ -43,6 +43,55 @@ public:
     double dist;
 };
 
+///////////////// DTW Search Cell /////////////////
+//A cell waiting on the stack of DTW::computeWindowedCosts for the costs of its neighbours
+class DTWSearchCell{
+public:
+	DTWSearchCell(int m=0,int n=0):m(m),n(n),numSearched(-1),minCost(0){}
+	~DTWSearchCell(){}
+
+	int m;                  //The row of the cell
+	int n;                  //The column of the cell
+	int numSearched;        //The number of neighbours that have been searched, -1 if the cell has not been entered yet
+	double minCost;         //The smallest cost returned by the neighbours searched so far
+};
+
+///////////////// DTW Workspace /////////////////
+//The buffers used to compute the distance between two time series. These are reused between calls, so the cost matrix is not
+//reallocated for every template, which means each thread that computes distances at the same time needs its own workspace
+class DTWWorkspace{
+public:
+	DTWWorkspace(){
+		abandoned = false;
+	}
+	~DTWWorkspace(){}
+
+	vector< double > accumulatedCosts;          //The accumulated cost of each cell inside the warping band, stored row by row
+	vector< UINT > bandStart;                   //The first column of the warping band for each row
+	vector< UINT > bandEnd;                     //The last column of the warping band for each row
+	vector< UINT > bandOffset;                  //The index in accumulatedCosts of the first cell of each row
+	vector< double > previousCostRow;           //The rolling rows used by computeAccumulatedDistance
+	vector< double > currentCostRow;
+	vector< DTWSearchCell > searchStack;        //The cells waiting to be finished by computeWindowedCosts
+	vector< int > windowAboveStart;             //For each row, computeWindowedCosts treats the columns from this one onwards as NAN
+	vector< int > windowBelowEnd;               //For each row, computeWindowedCosts treats the columns before this one as NAN
+	bool abandoned;                             //Set by computeDistance if it stopped before the full distance was computed
+};
+
+///////////////// DTW Envelope /////////////////
+//The LB_Keogh envelope of a template for a time series of one length
+class DTWEnvelope{
+public:
+	DTWEnvelope(){
+		envelopeLength=0;
+	}
+	~DTWEnvelope(){}
+
+	Matrix<double> lowerEnvelope;       //The min value of the template inside the warping band, for each sample of a time series of length envelopeLength
+	Matrix<double> upperEnvelope;       //The max value of the template inside the warping band, for each sample of a time series of length envelopeLength
+	UINT envelopeLength;                //The length of the time series the envelopes were computed for (0 if they have not been computed)
+};
+
 ///////////////// DTW Template /////////////////
 class DTWTemplate{
 public:
@@ -52,6 +101,9 @@ public:
 		trainingSigma = 0.0;
 		threshold=0.0;
 		averageTemplateLength=0;
+		streamingTrainingMu=0.0;
+		streamingTrainingSigma=0.0;
+		streamingThreshold=0.0;
 	}
 	~DTWTemplate(){};
 
@@ -61,6 +113,31 @@ public:
 	double trainingSigma;               //The sigma of the distance value of the training data with the trained template 
 	double threshold;                   //The classification threshold
 	UINT averageTemplateLength;          //The average length of the examples used to train this template
+	DTWEnvelope envelope;               //The envelope for the length of the time series built by the continuous prediction
+	double streamingTrainingMu;         //The mean accumulated cost of the training data with the trained template, used by the streaming prediction
+	double streamingTrainingSigma;      //The sigma of the accumulated cost of the training data with the trained template
+	double streamingThreshold;          //The accumulated cost a streaming match must be below to be reported
+};
+
+///////////////// DTW Streaming State /////////////////
+//The SPRING subsequence matching state for one template. For each sample i of the template this stores the cost of the best warp
+//path that ends at sample i at the current time step, and the time step that path started at
+class DTWStreamingState{
+public:
+	DTWStreamingState(){
+		bestMatchCost = INFINITY;
+		bestMatchStart = 0;
+		bestMatchEnd = 0;
+	}
+	~DTWStreamingState(){}
+
+	vector< double > cost;              //The accumulated cost of the best path ending at each sample of the template at the current time step
+	vector< UINT > startTime;           //The time step each of those paths started at
+	vector< double > previousCost;      //The costs at the previous time step
+	vector< UINT > previousStartTime;   //The start times at the previous time step
+	double bestMatchCost;               //The cost of the best match found that has not been reported yet (INFINITY if there is none)
+	UINT bestMatchStart;                //The time step the best match started at
+	UINT bestMatchEnd;                  //The time step the best match ended at
 };
 
 class DTW : public Classifier
@@ -88,6 +165,17 @@ public:
         this->distanceMethod = rhs.distanceMethod;
         this->rejectionMode = rhs.rejectionMode;
         this->averageTemplateLength = rhs.averageTemplateLength;
+        this->useLowerBoundPruning = rhs.useLowerBoundPruning;
+        this->useSymmetricTrainingDistances = rhs.useSymmetricTrainingDistances;
+        this->numTrainingThreads = rhs.numTrainingThreads;
+        this->useStreamingPrediction = rhs.useStreamingPrediction;
+        this->streamingStates = rhs.streamingStates;
+        this->envelopeCache = rhs.envelopeCache;
+        this->streamingSmoothingBuffer = rhs.streamingSmoothingBuffer;
+        this->streamingSmoothingCount = rhs.streamingSmoothingCount;
+        this->streamingTime = rhs.streamingTime;
+        this->matchStartTime = rhs.matchStartTime;
+        this->matchEndTime = rhs.matchEndTime;
         
         //Copy the classifier variables
         copyBaseVariables(this, (Classifier*)&rhs);
@@ -100,7 +188,7 @@ public:
         if( this->getClassifierType() == classifier->getClassifierType() ){
             
             DTW *ptr = (DTW*)classifier;
-            //Clone the NDDTW values 
+            //Clone the NDDTW values, the templates are shared rather than copied so each DTW only has its own prediction buffers
             this->templatesBuffer = ptr->templatesBuffer;
             this->rangesBuffer = ptr->rangesBuffer;
             this->continuousInputDataBuffer = ptr->continuousInputDataBuffer;
@@ -118,6 +206,17 @@ public:
             this->distanceMethod = ptr->distanceMethod;
             this->rejectionMode = ptr->rejectionMode;
             this->averageTemplateLength = ptr->averageTemplateLength;
+            this->useLowerBoundPruning = ptr->useLowerBoundPruning;
+            this->useSymmetricTrainingDistances = ptr->useSymmetricTrainingDistances;
+            this->numTrainingThreads = ptr->numTrainingThreads;
+            this->useStreamingPrediction = ptr->useStreamingPrediction;
+            this->streamingStates = ptr->streamingStates;
+            this->envelopeCache = ptr->envelopeCache;
+            this->streamingSmoothingBuffer = ptr->streamingSmoothingBuffer;
+            this->streamingSmoothingCount = ptr->streamingSmoothingCount;
+            this->streamingTime = ptr->streamingTime;
+            this->matchStartTime = ptr->matchStartTime;
+            this->matchEndTime = ptr->matchEndTime;
             
             //Clone the classifier variables
             return copyBaseVariables(this, ptr);
@@ -125,22 +224,65 @@ public:
         return false;
     }
     virtual bool train(LabelledTimeSeriesClassificationData &trainingData);
-    virtual bool predict(vector< double > inputVector);
+    virtual bool predict(const vector< double > &inputVector);
     virtual bool reset();
     virtual bool recomputeNullRejectionThresholds();
     virtual bool saveModelToFile(string filename);
     virtual bool saveModelToFile( fstream &file );
     virtual bool loadModelFromFile(string filename);
     virtual bool loadModelFromFile( fstream &file );
+    
+    //Saves and loads the model in the binary pipeline format, the time series of each template is stored as one block of values
+    virtual bool saveModelToBinaryFile( fstream &file );
+    virtual bool loadModelFromBinaryData( const char *data,unsigned long long size );
+    virtual bool getSupportsBinaryModel() const{ return true; }
     UINT getNumTemplates(){ return numTemplates; }
 
 	//NDDTW Public Methods
     bool predict(Matrix<double> &timeSeries);
     
+    //Computes the total accumulated cost between the two time series without building the warp path, this only needs O(N) memory.
+    //The NORM_ABSOLUTE_DIST local distances are normalized by the length of timeSeriesA (the template), as in the streaming prediction
+    double computeAccumulatedDistance(const Matrix<double> &timeSeriesA,const Matrix<double> &timeSeriesB);
+    
     bool setRejectionMode(UINT rejectionMode);
     UINT getRejectionMode(){ return rejectionMode; }
     
     bool enableZNormalization(bool useZNormalisation){ this->useZNormalisation = useZNormalisation; return true; }
+    bool enableConstrainWarpingPath(bool dtwConstrain);
+    
+    //If enabled, templates that can not beat the closest template found so far are skipped during prediction. This is only used
+    //when the prediction depends on just the closest template (no null rejection, or the TEMPLATE_THRESHOLDS rejection mode).
+    //The predicted class label and the distance of the closest template are the same as without pruning, but the class distance of
+    //any other template may be a lower bound rather than its distance. The class likelihoods of a pruned prediction are only computed
+    //from the templates whose full distance was computed (any template that was skipped or abandoned has a likelihood of 0), so the
+    //likelihoods, including the maximum likelihood, differ from an unpruned prediction. The pruning is disabled by default
+    bool enableLowerBoundPruning(bool useLowerBoundPruning){ this->useLowerBoundPruning = useLowerBoundPruning; return true; }
+    
+    //If enabled, the distance between two training examples is only computed once during training (rather than once in each direction)
+    bool enableSymmetricTrainingDistances(bool useSymmetricTrainingDistances){ this->useSymmetricTrainingDistances = useSymmetricTrainingDistances; return true; }
+    
+    //Sets the number of threads used to compute the distances between the training examples, 0 uses one thread per CPU core
+    bool setNumTrainingThreads(UINT numTrainingThreads);
+    UINT getNumTrainingThreads(){ return numTrainingThreads; }
+    
+    //If enabled, predict(vector< double >) matches each template against the input stream using SPRING subsequence DTW, which
+    //updates one cost column per template for each new sample instead of rerunning DTW over a window of the input. A match is
+    //reported (by setting the predicted class label) on the first sample at which no overlapping match can beat it
+    bool enableStreamingPrediction(bool useStreamingPrediction);
+    bool getStreamingPredictionEnabled(){ return useStreamingPrediction; }
+    
+    //Gets the time steps the last reported streaming match started and ended at, counted from the last reset
+    UINT getMatchStartTime(){ return matchStartTime; }
+    UINT getMatchEndTime(){ return matchEndTime; }
+    
+    //Sets the radius of the Sakoe-Chiba band used if dtwConstrain is true. A radius of 0 (the default) keeps the original warping window
+    //of the DTW, which has a radius of half the length of the shortest time series but whose distances depend on the order the cost
+    //matrix is searched in. Any radius above 0 uses a Sakoe-Chiba band of that radius instead, which changes the constrained distances
+    //(and so the predicted labels) compared with the original window. The lower bound pruning is only used with the Sakoe-Chiba band
+    //or an unconstrained warping path, as the original window can not be bounded
+    bool setWarpingRadius(double radius);
+    double getWarpingRadius(){ return radius; }
 
 private:
 	//Public training and prediction methods
@@ -148,8 +290,28 @@ private:
 	bool _train_NDDTW(LabelledTimeSeriesClassificationData &trainingData,DTWTemplate &dtwTemplate,UINT &bestIndex);
 
 	//The actual DTW function
-	double computeDistance(Matrix<double> &timeSeriesA,Matrix<double> &timeSeriesB);
-    double d(int m,int n,double **AccMatrix,const int M,const int N);
+	double computeDistance(const Matrix<double> &timeSeriesA,const Matrix<double> &timeSeriesB,double abandonDistance = INFINITY);
+	double computeDistance(const Matrix<double> &timeSeriesA,const Matrix<double> &timeSeriesB,DTWWorkspace &workspace,double abandonDistance);
+	UINT computeWarpingBand(const UINT M,const UINT N,DTWWorkspace &workspace);
+	void computeWindowedCosts(const Matrix<double> &timeSeriesA,const Matrix<double> &timeSeriesB,DTWWorkspace &workspace);
+	bool getUseWarpingWindow() const{ return dtwConstrain && radius == 0; }
+	
+	//Lower bounds on computeDistance, used to prune templates during prediction
+	double computeLowerBoundKim(const Matrix<double> &timeSeriesA,const Matrix<double> &timeSeriesB);
+	double computeLowerBoundKeogh(const DTWTemplate &dtwTemplate,const DTWEnvelope &envelope,const Matrix<double> &timeSeries);
+	bool computeTemplateEnvelope(const Matrix<double> &templateTimeSeries,const UINT N,DTWEnvelope &envelope);
+	bool computeTemplateEnvelopes();
+	
+	//Sets up the envelopes, thresholds and prediction buffers once the templates have been loaded
+	bool setupLoadedModel();
+	
+	//Streaming (SPRING) prediction
+	bool predictStreaming(const vector< double > &inputVector);
+	bool updateStreamingState(const DTWTemplate &dtwTemplate,DTWStreamingState &state,const vector< double > &inputVector,const UINT t,double threshold,double &matchCost,UINT &matchStart,UINT &matchEnd);
+	bool resetStreamingStates();
+	bool computeStreamingThresholds(LabelledTimeSeriesClassificationData &classData,DTWTemplate &dtwTemplate,UINT bestIndex);
+	inline double getAccumulatedCost(DTWWorkspace &workspace,const int i,const int j);
+	inline double computeLocalDistance(const double *a,const double *b,const UINT C,const UINT N);
 	double inline MIN_(double a,double b, double c);
 
 	//Private Scaling and Utility Functions
@@ -161,9 +323,24 @@ private:
 	void smoothData(Matrix<double> &data,UINT smoothFactor,Matrix<double> &resultsData);
     
     static RegisterClassifierModule< DTW > registerModule;
+    
+    friend class DTWTrainingDistanceJob;
+    
+    DTWWorkspace distanceWorkspace;             //The workspace used to compute distances on the calling thread
+    vector< double > columnLowerBounds;         //The cumulative LB_Keogh bound for each sample of the input time series
+    vector< IndexedDouble > templateSearchOrder; //The order the templates are searched in during a pruned prediction
+    vector< bool > exactClassDistances;         //Flags which classDistances are full DTW distances (rather than the lower bound of a pruned template)
+    vector< DTWEnvelope > envelopeCache;        //The envelopes for a time series length other than the one the shared envelopes were computed for
+    vector< DTWStreamingState > streamingStates; //The SPRING state for each template, used if useStreamingPrediction is true
+    vector< double > streamingSmoothingBuffer;  //The sum of the input samples in the current smoothing block, used by the streaming prediction
+    vector< double > streamingInputVector;      //A buffer for the scaled (and smoothed) input sample, used by the streaming prediction
+    UINT streamingSmoothingCount;               //The number of samples in the current smoothing block
+    UINT streamingTime;                         //The number of time steps processed by the streaming prediction since the last reset
+    UINT matchStartTime;                        //The time step the last reported streaming match started at
+    UINT matchEndTime;                          //The time step the last reported streaming match ended at
 
 public:
-	vector< DTWTemplate > templatesBuffer;		//A buffer to store the templates for each time series
+	SharedModel< vector< DTWTemplate > > templatesBuffer;//The templates for each time series, shared by every copy of this DTW until one of them is retrained
 	vector< MinMax >	rangesBuffer;			//A buffer to store the min-max ranges for scaling each channel
     CircularBuffer< vector< double > > continuousInputDataBuffer;
 	UINT				numTemplates;			//The number of templates in our buffer
@@ -175,14 +352,18 @@ public:
 	bool				constrainZNorm;			//A flag to check if we need to constrain zNorm (only zNorm if stdDev > zNormConstrainThreshold)
 	bool				dtwConstrain;			//A flag to check if we need to constrain the dtw cost matrix and search
     bool                trimTrainingData;       //A flag to check if we need to trim the training data first before training
+    bool                useLowerBoundPruning;   //A flag to check if templates can be pruned using their lower bounds during prediction
+    bool                useSymmetricTrainingDistances;//A flag to check if the training distance matrix can be treated as symmetric
+    bool                useStreamingPrediction; //A flag to check if predict(vector< double >) should use SPRING subsequence matching
 
 	double				crossValidationAccuracy;//The cross validation result
 	double				zNormConstrainThreshold;//The threshold value to be used if constrainZNorm is turned on
-	double				radius;					//The radius value to use if dtwConstrain is turned on
+	double				radius;					//The radius value to use if dtwConstrain is turned on (0 = half the length of the shortest time series)
 	
 	UINT				smoothingFactor;		//The smoothing factor if smoothing is used
 	UINT				distanceMethod;			//The distance method to be used (should be of enum DISTANCE_METHOD)
 	UINT				averageTemplateLength;	//The overall average template length (over all the templates)
+	UINT				numTrainingThreads;		//The number of threads used to compute the training distances (0 = one per CPU core)
 	
 	enum DistanceMethods{ABSOLUTE_DIST=0,EUCLIDEAN_DIST,NORM_ABSOLUTE_DIST};
     enum RejectionModes{TEMPLATE_THRESHOLDS=0,CLASS_LIKELIHOODS,THRESHOLDS_AND_LIKELIHOODS};
@@ -42,13 +42,14 @@ GMM::GMM(UINT numMixtureModels,bool useScaling,bool useNullRejection,double null
 
 GMM::~GMM(){}
 
-bool GMM::predict(vector<double> x){
+bool GMM::predict(const vector< double > &inputVector){
 
 	predictedClassLabel = 0;
 	
-    if( classDistances.size() != numClasses || classLikelihoods.size() != numClasses ){
+    if( classDistances.size() != numClasses || classLikelihoods.size() != numClasses || classLogLikelihoods.size() != numClasses ){
         classDistances.resize(numClasses);
         classLikelihoods.resize(numClasses);
+        classLogLikelihoods.resize(numClasses);
     }
     
     if( !trained ){
@@ -56,43 +57,106 @@ bool GMM::predict(vector<double> x){
         return false;
     }
     
-    if( x.size() != numFeatures ){
-        errorLog << "predict(vector<double> x) - The size of the input vector (" << x.size() << ") does not match that of the number of features the model was trained with (" << numFeatures << ")." << endl;
+    if( inputVector.size() != numFeatures ){
+        errorLog << "predict(vector<double> x) - The size of the input vector (" << inputVector.size() << ") does not match that of the number of features the model was trained with (" << numFeatures << ")." << endl;
         return false;
     }
     
+    const vector< double > *x = &inputVector;
     if( useScaling ){
+        scaledInputVector.resize( numFeatures );
         for(UINT i=0; i<numFeatures; i++){
-            x[i] = scale(x[i], ranges[i].minValue, ranges[i].maxValue, GMM_MIN_SCALE_VALUE, GMM_MAX_SCALE_VALUE);
+            scaledInputVector[i] = scale(inputVector[i], ranges[i].minValue, ranges[i].maxValue, GMM_MIN_SCALE_VALUE, GMM_MAX_SCALE_VALUE);
         }
+        x = &scaledInputVector;
     }
 
+	for(UINT k=0; k<numClasses; k++){
+        classLogLikelihoods[k] = models[k].computeMixtureLogLikelihood( &(*x)[0] );
+    }
+    
+    return predictFromClassLogLikelihoods();
+}
+    
+bool GMM::predictBatch(const Matrix<double> &inputData,vector< UINT > &predictedClassLabels,Matrix<double> &likelihoods,Matrix<double> &distances){
+    
+    if( !trained ){
+        errorLog << "predictBatch(const Matrix<double> &inputData,...) - Mixture Models have not been trained!" << endl;
+        return false;
+    }
+    
+    if( inputData.getNumCols() != numFeatures ){
+        errorLog << "predictBatch(const Matrix<double> &inputData,...) - The number of columns in the input data (" << inputData.getNumCols() << ") does not match that of the number of features the model was trained with (" << numFeatures << ")." << endl;
+        return false;
+    }
+    
+    const UINT M = inputData.getNumRows();
+    Matrix<double> logLikelihoods( M, numClasses );
+    predictedClassLabels.resize( M );
+    likelihoods.resize( M, numClasses );
+    distances.resize( M, numClasses );
+    
+    //Scale all the rows in one pass
+    const Matrix<double> *X = &inputData;
+    Matrix<double> scaledInputData;
+    if( useScaling ){
+        scaledInputData.resize( M, numFeatures );
+        for(UINT i=0; i<M; i++){
+            for(UINT j=0; j<numFeatures; j++){
+                scaledInputData[i][j] = scale(inputData[i][j], ranges[j].minValue, ranges[j].maxValue, GMM_MIN_SCALE_VALUE, GMM_MAX_SCALE_VALUE);
+            }
+        }
+        X = &scaledInputData;
+    }
+    
+    for(UINT k=0; k<numClasses; k++){
+        models[k].computeMixtureLogLikelihoods(*X,logLikelihoods,k);
+    }
+    
+    if( classDistances.size() != numClasses || classLikelihoods.size() != numClasses || classLogLikelihoods.size() != numClasses ){
+        classDistances.resize(numClasses);
+        classLikelihoods.resize(numClasses);
+        classLogLikelihoods.resize(numClasses);
+    }
+    
+    for(UINT i=0; i<M; i++){
+        std::copy(logLikelihoods[i],logLikelihoods[i]+numClasses,classLogLikelihoods.begin());
+        predictFromClassLogLikelihoods();
+        storeBatchPrediction(i,predictedClassLabels,likelihoods,distances);
+    }
+    
+    return true;
+}
+    
+bool GMM::predictFromClassLogLikelihoods(){
+    
+    predictedClassLabel = 0;
 	UINT bestIndex = 0;
-	maxLikelihood = 0;
-    bestDistance = 0;
+	for(UINT k=1; k<numClasses; k++){
+		if( classLogLikelihoods[k] > classLogLikelihoods[bestIndex] ){
+			bestIndex = k;
+		}
+	}
+    
+    //The class distances are the mixture likelihoods, the class likelihoods are normalized relative to the best class so they do not
+    //underflow to zero when all the mixture likelihoods are too small to be represented
+    const double maxLogLikelihood = classLogLikelihoods[bestIndex];
     double sum = 0;
 	for(UINT k=0; k<numClasses; k++){
-        classDistances[k] = computeMixtureLikelihood(x,k);
-        
-        //cout << "K: " << k << " Dist: " << classDistances[k] << endl;
-        classLikelihoods[k] = classDistances[k];
+        classDistances[k] = exp( classLogLikelihoods[k] );
+        classLikelihoods[k] = exp( classLogLikelihoods[k] - maxLogLikelihood );
         sum += classLikelihoods[k];
-		if( classLikelihoods[k] > bestDistance ){
-			bestDistance = classLikelihoods[k];
-			bestIndex = k;
-		}
 	}
     
     //Normalize the likelihoods
-    for(unsigned int k=0; k<numClasses; k++){
+    for(UINT k=0; k<numClasses; k++){
         classLikelihoods[k] /= sum;
     }
     maxLikelihood = classLikelihoods[bestIndex];
+    bestDistance = classDistances[bestIndex];
     
     if( useNullRejection ){
         
-        //cout << "Dist: " << classDistances[bestIndex] << " RejectionThreshold: " << models[bestIndex].getRejectionThreshold() << endl;
-        
         //If the best distance is below the modles rejection threshold then set the predicted class label as the best class label
         //Otherwise set the predicted class label as the default null rejection class label of 0
         if( classDistances[bestIndex] >= models[bestIndex].getNullRejectionThreshold() ){
@@ -178,6 +242,13 @@ bool GMM::train(LabelledClassificationData &trainingData){
             models[k][j].det = ludcmp.det();
         }
         
+        //Precompute the Cholesky factors used for the realtime prediction
+        if( !models[k].computeCholeskyFactors() ){
+            models.clear();
+            errorLog << "train(LabelledClassificationData &trainingData) - Failed to compute the Cholesky decomposition of Sigma for class " << classLabel << "!" << endl;
+            return false;
+        }
+        
         //Compute the normalize factor
         models[k].recomputeNormalizationFactor();
         
@@ -186,8 +257,7 @@ bool GMM::train(LabelledClassificationData &trainingData){
         double sigma = 0;
         vector< double > predictionResults(classData.getNumSamples(),0);
         for(UINT i=0; i<classData.getNumSamples(); i++){
-            vector< double > sample = classData[i].getSample();
-            predictionResults[i] = models[k].computeMixtureLikelihood( sample );
+            predictionResults[i] = models[k].computeMixtureLikelihood( classData[i].getSample() );
             mu += predictionResults[i];
         }
         
@@ -228,7 +298,7 @@ bool GMM::train(LabelledClassificationData &trainingData){
     return true;
 }
     
-double GMM::computeMixtureLikelihood(vector<double> &x,UINT k){
+double GMM::computeMixtureLikelihood(const vector<double> &x,UINT k){
     if( k >= numClasses ){
         errorLog << "computeMixtureLikelihood(vector<double> x,UINT k) - Invalid k value!" << endl;
         return 0;
@@ -558,6 +628,12 @@ bool GMM::loadModelFromFile(fstream &file){
             
         }
         
+        //Precompute the Cholesky factors used for the realtime prediction
+        if( !models[k].computeCholeskyFactors() ){
+            errorLog << "loadModelFromFile(fstream &file) - Failed to compute the Cholesky decomposition of Sigma for model " << k+1 << endl;
+            return false;
+        }
+        
     }
     
     //Set the null rejection thresholds
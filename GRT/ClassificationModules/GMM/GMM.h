@@ -118,7 +118,20 @@ public:
      @param vector< double > inputVector: the input vector to classify
      @return returns true if the prediction was performed, false otherwise
      */
-    virtual bool predict(vector< double > inputVector);
+    virtual bool predict(const vector< double > &inputVector);
+    
+    /**
+     This predicts the class of each row of the inputData.  The rows are scaled in one pass, then the log likelihoods are computed one
+     mixture model at a time so the Cholesky factors of each mixture model stay in the cache for all the rows.
+     This overrides the predictBatch function in the Classifier base class.
+     
+     @param const Matrix<double> &inputData: the input vectors to classify, with one vector per row
+     @param vector< UINT > &predictedClassLabels: returns the predicted class label of each row
+     @param Matrix<double> &likelihoods: returns the class likelihoods of each row
+     @param Matrix<double> &distances: returns the class distances of each row
+     @return returns true if the prediction was performed, false otherwise
+     */
+    virtual bool predictBatch(const Matrix<double> &inputData,vector< UINT > &predictedClassLabels,Matrix<double> &likelihoods,Matrix<double> &distances);
     
     /**
      This saves the trained GMM model to a file.
@@ -185,12 +198,15 @@ public:
     }
     
 protected:
-    double computeMixtureLikelihood(vector<double> &x,UINT k);
+    double computeMixtureLikelihood(const vector<double> &x,UINT k);
+    bool predictFromClassLogLikelihoods();
     
     UINT numMixtureModels;
     UINT maxIter;
     double minChange;
     vector< MixtureModel > models;
+    vector< double > scaledInputVector;
+    vector< double > classLogLikelihoods;
     
     DebugLog debugLog;
     ErrorLog errorLog;
@@ -34,6 +34,7 @@ class GuassModel{
 public:
     GuassModel(){
         det = 0;
+        logNormalizationConstant = 0;
     }
     ~GuassModel(){
         
@@ -64,10 +65,27 @@ public:
         
         return true;
     }
+    
+    //Computes the lower triangular Cholesky factor of sigma and the log of the Gaussian normalization constant, these are used to
+    //compute the log likelihood of the Gaussian without inverting sigma or evaluating the normalization constant for each input
+    bool computeCholeskyFactor(){
+        const UINT N = sigma.getNumRows();
+        if( N == 0 || sigma.getNumCols() != N ) return false;
+        
+        Cholesky cholesky( sigma );
+        if( !cholesky.getSuccess() ) return false;
+        
+        choleskyFactor = cholesky.el;
+        logNormalizationConstant = -0.5 * ( N*log(TWO_PI) + cholesky.logdet() );
+        return true;
+    }
+    
         double det;
+        double logNormalizationConstant;        //The log of 1/sqrt( (2pi)^N det(sigma) )
         vector< double > mu;
         Matrix< double > sigma;
         Matrix< double > invSigma;
+        Matrix< double > choleskyFactor;        //The lower triangular matrix L, where sigma = L L'
 };
     
 class MixtureModel{
@@ -76,6 +94,7 @@ class MixtureModel{
         classLabel = 0;
         K = 0;
         normFactor = 1;
+        logNormFactor = 0;
         nullRejectionThreshold = 0;
         trainingMu = 0;
         trainingSigma = 0;
@@ -89,13 +108,47 @@ class MixtureModel{
         return gaussModels[i];
 	}
     
-    double computeMixtureLikelihood(vector<double> &x){
+    double computeMixtureLikelihood(const vector<double> &x){
+        return exp( computeMixtureLogLikelihood( &x[0] ) );
+    }
+    
+    //Computes the log of the normalized mixture likelihood of x, the Gaussians are combined with a log-sum-exp so the result does not
+    //underflow when the likelihood of each Gaussian is too small to be represented. computeCholeskyFactors must have been called first
+    double computeMixtureLogLikelihood(const double *x){
+        double maxValue = 0;
         double sum = 0;
         for(UINT k=0; k<K; k++){
-            sum += gauss(x,gaussModels[k].det,gaussModels[k].mu,gaussModels[k].invSigma);
+            const double logLikelihood = gaussLogLikelihood(x,gaussModels[k]);
+            if( k == 0 || logLikelihood > maxValue ){
+                //Rescale the running sum to the new maximum
+                sum = k == 0 ? 1.0 : sum * exp( maxValue - logLikelihood ) + 1.0;
+                maxValue = logLikelihood;
+            }else sum += exp( logLikelihood - maxValue );
         }
         //Normalize the mixture likelihood
-        return sum/normFactor;
+        return maxValue + log( sum ) - logNormFactor;
+    }
+    
+    //Computes the mixture log likelihood of each row of X and stores it in the column of logLikelihoods
+    void computeMixtureLogLikelihoods(const Matrix<double> &X,Matrix<double> &logLikelihoods,const UINT column){
+        const UINT M = X.getNumRows();
+        for(UINT i=0; i<M; i++){
+            logLikelihoods[i][column] = computeMixtureLogLikelihood( X[i] );
+        }
+    }
+    
+    //Precomputes the Cholesky factor of each Gaussian, this must be called once the Gaussians have been trained or loaded
+    bool computeCholeskyFactors(){
+        for(UINT k=0; k<K; k++){
+            if( !gaussModels[k].computeCholeskyFactor() ) return false;
+        }
+        buffer.resize( K > 0 ? gaussModels[0].mu.size() : 0 );
+        
+        //Use the stored normalization factor if it is valid, otherwise compute it in log space
+        if( normFactor > 0 && !isinf( normFactor ) ){
+            logNormFactor = log( normFactor );
+        }else logNormFactor = computeLogNormalizationFactor();
+        return true;
     }
     
     bool resize(UINT K){
@@ -121,11 +174,11 @@ class MixtureModel{
         return false;
     }
     
+    //Recomputes the normalization factor, this is the sum of the likelihood of each Gaussian at its own mean. computeCholeskyFactors
+    //must have been called first
     bool recomputeNormalizationFactor(){
-        normFactor = 0;
-        for(UINT k=0; k<K; k++){
-            normFactor += gauss(gaussModels[k].mu,gaussModels[k].det,gaussModels[k].mu,gaussModels[k].invSigma);
-        }
+        logNormFactor = computeLogNormalizationFactor();
+        normFactor = exp( logNormFactor );
         return true;
     }
     
@@ -158,6 +211,10 @@ class MixtureModel{
         return normFactor;
     }
     
+    double getLogNormalizationFactor(){
+        return logNormFactor;
+    }
+    
     bool setClassLabel(UINT classLabel){
         this->classLabel = classLabel;
         return true;
@@ -179,29 +236,33 @@ class MixtureModel{
         return true;
     }
     
-private:    
-    double gauss(vector<double> x,double det,vector<double> &mu,Matrix<double> &invSigma){
-        
-        double y = 0;
+private:
+    //Computes the log likelihood of x given the Gaussian, the Mahalanobis distance is computed by solving L y = x - mu with forward
+    //substitution, so sigma is never inverted and y is stored in the buffer so no memory is allocated
+    inline double gaussLogLikelihood(const double *x,const GuassModel &model){
+        const UINT N = (UINT)model.mu.size();
+        const Matrix< double > &L = model.choleskyFactor;
+        double *y = &buffer[0];
         double sum = 0;
-        const UINT N = (UINT)x.size();
-        vector< double > temp(N,0);
-        
-        //Compute the first part of the equation
-        y = (1.0/pow(TWO_PI,N/2.0)) * (1.0/pow(det,0.5));
-        
-        //Mean subtract x
-        for(UINT j=0; j<N; j++) x[j] -= mu[j];
-        
-        //Compute the later half    
         for(UINT i=0; i<N; i++){
-            for(UINT j=0; j<N; j++){
-                temp[i] += x[j] * invSigma[j][i];
-            }
-            sum += x[i] * temp[i];
+            y[i] = ( x[i] - model.mu[i] - DistanceKernels::dot(L[i],y,i) ) / L[i][i];
+            sum += y[i]*y[i];
         }
-        
-        return ( y*exp( -0.5*sum ) );
+        return model.logNormalizationConstant - 0.5*sum;
+    }
+    
+    //Computes the log of the normalization factor with a log-sum-exp, the likelihood of each Gaussian at its own mean is its normalization constant
+    double computeLogNormalizationFactor() const{
+        if( K == 0 ) return 0;
+        double maxValue = gaussModels[0].logNormalizationConstant;
+        for(UINT k=1; k<K; k++){
+            maxValue = std::max( maxValue, gaussModels[k].logNormalizationConstant );
+        }
+        double sum = 0;
+        for(UINT k=0; k<K; k++){
+            sum += exp( gaussModels[k].logNormalizationConstant - maxValue );
+        }
+        return maxValue + log( sum );
     }
     
     UINT classLabel;
@@ -211,7 +272,9 @@ private:
 	double trainingMu;                      //The average confidence value in the training data
 	double trainingSigma;                   //The simga confidence value in the training data
     double normFactor;
+    double logNormFactor;                   //The log of the normalization factor
     vector< GuassModel > gaussModels;
+    vector< double > buffer;                //Holds the forward substitution of the current input, so the log likelihoods can be computed without allocating memory
     
 };
     
@@ -0,0 +1,421 @@
+/*
+GRT MIT License
+Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "KDTree.h"
+
+namespace GRT{
+
+//Orders the sample indexes by the value of one dimension (of the unit length sample for the cosine distance), this is used to
+//find the median when a node is split
+class KDTreeSplitComparator{
+public:
+    KDTreeSplitComparator(const KDTreeSamples &data,bool normalize,UINT splitDimension):data(data){
+        this->normalize = normalize;
+        this->splitDimension = splitDimension;
+    }
+    double getValue(UINT i) const{
+        const double value = data.getSample(i)[ splitDimension ];
+        return normalize ? value / data.sampleNorms[i] : value;
+    }
+    bool operator()(UINT a,UINT b) const{
+        return getValue(a) < getValue(b);
+    }
+    const KDTreeSamples &data;
+    bool normalize;
+    UINT splitDimension;
+};
+
+KDTree::KDTree(){
+    numDimensions = 0;
+    distanceMethod = EUCLIDEAN_DISTANCE;
+    leafSize = DEFAULT_LEAF_SIZE;
+}
+
+KDTree::~KDTree(){
+}
+
+bool KDTree::build(const KDTreeSamples &data,UINT distanceMethod,UINT leafSize){
+
+    clear();
+
+    if( data.numSamples == 0 || data.numDimensions == 0 ) return false;
+
+    this->numDimensions = data.numDimensions;
+    this->distanceMethod = distanceMethod;
+    this->leafSize = leafSize > 0 ? leafSize : 1;
+
+    //A zero length sample can not be normalized for the cosine distance, so it is kept out of the tree
+    sampleIndexes.reserve( data.numSamples );
+    for(UINT i=0; i<data.numSamples; i++){
+        if( distanceMethod == COSINE_DISTANCE && data.sampleNorms[i] == 0 ) zeroSampleIndexes.push_back( i );
+        else sampleIndexes.push_back( i );
+    }
+
+    if( sampleIndexes.size() == 0 ){
+        clear();
+        return true;
+    }
+
+    //Build the tree, this reorders the sample indexes so each node holds a contiguous block of samples
+    const UINT numTreeSamples = (UINT)sampleIndexes.size();
+    nodes.reserve( 2*(numTreeSamples/this->leafSize) + 1 );
+    buildNode(data,0,numTreeSamples);
+
+    computeBounds( data );
+
+    return true;
+}
+
+bool KDTree::search(const KDTreeSamples &data,const double *query,double queryNorm,UINT K,vector< IndexedDouble > &neighbours) const{
+
+    neighbours.clear();
+
+    if( nodes.size() == 0 || data.numDimensions != numDimensions || K == 0 ) return false;
+
+    //The neighbours are kept in a max-heap, so the furthest of the current K neighbours is always at the front
+    neighbours.reserve( K );
+    if( distanceMethod == COSINE_DISTANCE ){
+        if( queryNorm == 0 ){
+            //A zero length query has a distance of 1 to every sample, so the nearest neighbours are the first K samples
+            for(UINT i=0; i<K && i<data.numSamples; i++) addNeighbour(neighbours,IndexedDouble(i,1.0),K);
+        }else{
+            //The zero length samples are not in the tree, they all have a distance of 1 to the query
+            for(UINT i=0; i<zeroSampleIndexes.size(); i++) addNeighbour(neighbours,IndexedDouble(zeroSampleIndexes[i],1.0),K);
+            searchNode(data,0,query,queryNorm,K,neighbours);
+        }
+    }else searchNode(data,0,query,queryNorm,K,neighbours);
+    std::sort_heap(neighbours.begin(),neighbours.end(),compareNeighbours);
+
+    //The Euclidean search uses the squared distance, so convert it to the actual distance
+    if( distanceMethod == EUCLIDEAN_DISTANCE ){
+        for(UINT k=0; k<neighbours.size(); k++){
+            neighbours[k].value = sqrt( neighbours[k].value );
+        }
+    }
+
+    return true;
+}
+
+bool KDTree::saveToFile(fstream &file) const{
+
+    if( !file.is_open() ) return false;
+
+    //The sample indexes are saved in tree order, followed by any zero length samples that were kept out of the tree
+    file << "KDTreeLeafSize: " << leafSize << endl;
+    file << "KDTreeNumNodes: " << nodes.size() << endl;
+    file << "KDTreeNodes: \n";
+    for(UINT i=0; i<nodes.size(); i++){
+        file << nodes[i].startIndex << "\t" << nodes[i].endIndex << "\t" << nodes[i].leftChild << "\t" << nodes[i].rightChild << endl;
+    }
+    file << "KDTreeSampleIndexes: \n";
+    for(UINT i=0; i<sampleIndexes.size(); i++){
+        file << sampleIndexes[i] << "\t";
+    }
+    for(UINT i=0; i<zeroSampleIndexes.size(); i++){
+        file << zeroSampleIndexes[i] << "\t";
+    }
+    file << endl;
+
+    return true;
+}
+
+bool KDTree::loadFromFile(fstream &file,const KDTreeSamples &data,UINT distanceMethod){
+
+    clear();
+
+    if( !file.is_open() ) return false;
+
+    const UINT numSamples = data.numSamples;
+    std::string word;
+    UINT numNodes = 0;
+
+    file >> word;
+    if( word != "KDTreeLeafSize:" ) return false;
+    file >> leafSize;
+
+    file >> word;
+    if( word != "KDTreeNumNodes:" ) return false;
+    file >> numNodes;
+
+    //A tree can not have more nodes than samples in its leaves and splits
+    if( numNodes > 2*numSamples ) return false;
+
+    file >> word;
+    if( word != "KDTreeNodes:" ) return false;
+    nodes.resize( numNodes );
+    for(UINT i=0; i<numNodes; i++){
+        file >> nodes[i].startIndex;
+        file >> nodes[i].endIndex;
+        file >> nodes[i].leftChild;
+        file >> nodes[i].rightChild;
+    }
+
+    file >> word;
+    if( word != "KDTreeSampleIndexes:" ){
+        clear();
+        return false;
+    }
+    vector< UINT > savedSampleIndexes( numSamples );
+    for(UINT i=0; i<numSamples; i++){
+        file >> savedSampleIndexes[i];
+    }
+
+    return setupLoadedTree(data,distanceMethod,savedSampleIndexes);
+}
+
+bool KDTree::saveToBinaryFile(BinaryWriter &writer) const{
+
+    writer.write( leafSize );
+    writer.write( (UINT)nodes.size() );
+    for(UINT i=0; i<nodes.size(); i++){
+        writer.write( nodes[i].startIndex );
+        writer.write( nodes[i].endIndex );
+        writer.write( nodes[i].leftChild );
+        writer.write( nodes[i].rightChild );
+    }
+    vector< UINT > savedSampleIndexes( sampleIndexes );
+    savedSampleIndexes.insert(savedSampleIndexes.end(),zeroSampleIndexes.begin(),zeroSampleIndexes.end());
+    writer.write( savedSampleIndexes );
+
+    return writer.good();
+}
+
+bool KDTree::loadFromBinaryData(BinaryReader &reader,const KDTreeSamples &data,UINT distanceMethod){
+
+    clear();
+
+    UINT numNodes = 0;
+    reader.read( leafSize );
+    reader.read( numNodes );
+    if( !reader.good() || numNodes > 2*data.numSamples ) return false;
+
+    nodes.resize( numNodes );
+    for(UINT i=0; i<numNodes; i++){
+        reader.read( nodes[i].startIndex );
+        reader.read( nodes[i].endIndex );
+        reader.read( nodes[i].leftChild );
+        reader.read( nodes[i].rightChild );
+    }
+    vector< UINT > savedSampleIndexes;
+    reader.read( savedSampleIndexes );
+
+    if( !reader.good() ){
+        clear();
+        return false;
+    }
+
+    return setupLoadedTree(data,distanceMethod,savedSampleIndexes);
+}
+
+bool KDTree::setupLoadedTree(const KDTreeSamples &data,UINT distanceMethod,const vector< UINT > &savedSampleIndexes){
+
+    const UINT numSamples = data.numSamples;
+    const UINT numNodes = (UINT)nodes.size();
+
+    //The root holds all the samples in the tree, any samples after these are the zero length samples kept out of the tree
+    if( numNodes == 0 || data.numDimensions == 0 || nodes[0].startIndex != 0 || nodes[0].endIndex > numSamples || savedSampleIndexes.size() != numSamples ){
+        clear();
+        return false;
+    }
+    const UINT numTreeSamples = nodes[0].endIndex;
+
+    //Make sure each node is valid, the children are always stored after their parent
+    for(UINT i=0; i<numNodes; i++){
+        if( nodes[i].startIndex >= nodes[i].endIndex || nodes[i].endIndex > numTreeSamples ||
+           (!nodes[i].isLeaf() && (nodes[i].leftChild <= i || nodes[i].rightChild <= i || nodes[i].leftChild >= numNodes || nodes[i].rightChild >= numNodes)) ){
+            clear();
+            return false;
+        }
+    }
+
+    //Make sure every sample is saved once, and that only the zero length samples of a cosine tree were kept out of the tree
+    vector< bool > sampleFound( numSamples, false );
+    for(UINT i=0; i<numSamples; i++){
+        const UINT index = savedSampleIndexes[i];
+        if( index >= numSamples || sampleFound[index] ){
+            clear();
+            return false;
+        }
+        sampleFound[index] = true;
+        const bool isZeroSample = distanceMethod == COSINE_DISTANCE && data.sampleNorms[index] == 0;
+        if( isZeroSample != (i >= numTreeSamples) ){
+            clear();
+            return false;
+        }
+    }
+
+    this->numDimensions = data.numDimensions;
+    this->distanceMethod = distanceMethod;
+    sampleIndexes.assign(savedSampleIndexes.begin(),savedSampleIndexes.begin()+numTreeSamples);
+    zeroSampleIndexes.assign(savedSampleIndexes.begin()+numTreeSamples,savedSampleIndexes.end());
+
+    //Recompute the bounding boxes from the training samples
+    computeBounds( data );
+
+    return true;
+}
+
+void KDTree::clear(){
+    numDimensions = 0;
+    sampleIndexes.clear();
+    zeroSampleIndexes.clear();
+    nodes.clear();
+    nodeBounds.clear();
+}
+
+UINT KDTree::buildNode(const KDTreeSamples &data,UINT startIndex,UINT endIndex){
+
+    const UINT nodeIndex = (UINT)nodes.size();
+    nodes.push_back( KDTreeNode() );
+    nodes[nodeIndex].startIndex = startIndex;
+    nodes[nodeIndex].endIndex = endIndex;
+
+    if( endIndex - startIndex <= leafSize ) return nodeIndex;
+
+    //Split the node along the dimension with the largest spread
+    UINT splitDimension = 0;
+    double maxSpread = 0;
+    for(UINT j=0; j<numDimensions; j++){
+        double minValue = getTreeValue(data,sampleIndexes[startIndex],j);
+        double maxValue = minValue;
+        for(UINT i=startIndex+1; i<endIndex; i++){
+            const double value = getTreeValue(data,sampleIndexes[i],j);
+            if( value < minValue ) minValue = value;
+            else if( value > maxValue ) maxValue = value;
+        }
+        if( maxValue - minValue > maxSpread ){
+            maxSpread = maxValue - minValue;
+            splitDimension = j;
+        }
+    }
+
+    //If all the samples are the same then there is nothing to split
+    if( maxSpread <= 0 ) return nodeIndex;
+
+    const UINT medianIndex = startIndex + (endIndex-startIndex)/2;
+    std::nth_element(sampleIndexes.begin()+startIndex,sampleIndexes.begin()+medianIndex,sampleIndexes.begin()+endIndex,
+                     KDTreeSplitComparator(data,distanceMethod == COSINE_DISTANCE,splitDimension));
+
+    const UINT leftChild = buildNode(data,startIndex,medianIndex);
+    const UINT rightChild = buildNode(data,medianIndex,endIndex);
+    nodes[nodeIndex].leftChild = leftChild;
+    nodes[nodeIndex].rightChild = rightChild;
+
+    return nodeIndex;
+}
+
+void KDTree::computeBounds(const KDTreeSamples &data){
+
+    //The children are always stored after their parent, so the bounds can be computed bottom-up in a single pass over the nodes
+    nodeBounds.resize( nodes.size()*2*numDimensions );
+    for(UINT n=(UINT)nodes.size(); n-- > 0;){
+        double *minValues = &nodeBounds[ n*2*numDimensions ];
+        double *maxValues = minValues + numDimensions;
+        if( nodes[n].isLeaf() ){
+            for(UINT j=0; j<numDimensions; j++) minValues[j] = maxValues[j] = getTreeValue(data,sampleIndexes[ nodes[n].startIndex ],j);
+            for(UINT i=nodes[n].startIndex+1; i<nodes[n].endIndex; i++){
+                for(UINT j=0; j<numDimensions; j++){
+                    const double value = getTreeValue(data,sampleIndexes[i],j);
+                    if( value < minValues[j] ) minValues[j] = value;
+                    if( value > maxValues[j] ) maxValues[j] = value;
+                }
+            }
+        }else{
+            const double *leftBounds = &nodeBounds[ nodes[n].leftChild*2*numDimensions ];
+            const double *rightBounds = &nodeBounds[ nodes[n].rightChild*2*numDimensions ];
+            for(UINT j=0; j<numDimensions; j++){
+                minValues[j] = leftBounds[j] < rightBounds[j] ? leftBounds[j] : rightBounds[j];
+                maxValues[j] = leftBounds[numDimensions+j] > rightBounds[numDimensions+j] ? leftBounds[numDimensions+j] : rightBounds[numDimensions+j];
+            }
+        }
+    }
+}
+
+void KDTree::searchNode(const KDTreeSamples &data,UINT nodeIndex,const double *query,double queryNorm,UINT K,vector< IndexedDouble > &heap) const{
+
+    const KDTreeNode &node = nodes[ nodeIndex ];
+
+    if( node.isLeaf() ){
+        for(UINT i=node.startIndex; i<node.endIndex; i++){
+            addNeighbour(heap,IndexedDouble(sampleIndexes[i],computeDistance(data,query,queryNorm,sampleIndexes[i])),K);
+        }
+        return;
+    }
+
+    //Search the closest child first, the other child is only searched if it could still hold a closer neighbour
+    UINT firstChild = node.leftChild;
+    UINT secondChild = node.rightChild;
+    double firstDistance = computeBoundsDistance(firstChild,query,queryNorm);
+    double secondDistance = computeBoundsDistance(secondChild,query,queryNorm);
+    if( secondDistance < firstDistance ){
+        std::swap(firstChild,secondChild);
+        std::swap(firstDistance,secondDistance);
+    }
+
+    //The bounds distance is not computed the same way as the sample distances, so it is allowed to round slightly above them.
+    //This keeps a sample with the same distance as the current K-th neighbour (but a lower index) from being skipped
+    const double ROUNDING_TOLERANCE = 1.0e-12;
+    if( heap.size() < K || firstDistance <= heap.front().value + ROUNDING_TOLERANCE*(1.0+heap.front().value) ){
+        searchNode(data,firstChild,query,queryNorm,K,heap);
+    }
+    if( heap.size() < K || secondDistance <= heap.front().value + ROUNDING_TOLERANCE*(1.0+heap.front().value) ){
+        searchNode(data,secondChild,query,queryNorm,K,heap);
+    }
+}
+
+inline double KDTree::getTreeValue(const KDTreeSamples &data,UINT i,UINT j) const{
+    //The tree is built from the unit length samples for the cosine distance
+    const double value = data.getSample(i)[j];
+    return distanceMethod == COSINE_DISTANCE ? value / data.sampleNorms[i] : value;
+}
+
+inline double KDTree::computeDistance(const KDTreeSamples &data,const double *query,double queryNorm,UINT i) const{
+    //The distances are computed exactly as in the linear search of the KNN, the Euclidean search uses the squared distance
+    const double *sample = data.getSample(i);
+    switch( distanceMethod ){
+        case COSINE_DISTANCE:{
+            const double magnitude = queryNorm * data.sampleNorms[i];
+            return magnitude > 0 ? 1.0 - DistanceKernels::dot(query,sample,data.sampleStride) / magnitude : 1.0;
+        }
+        case MANHATTAN_DISTANCE:
+            return DistanceKernels::manhattan(query,sample,data.sampleStride);
+        default:
+            return DistanceKernels::squaredEuclidean(query,sample,data.sampleStride);
+    }
+}
+
+inline double KDTree::computeBoundsDistance(UINT nodeIndex,const double *query,double queryNorm) const{
+    //Computes the distance from the query to the closest point in the bounding box of the node, in the same units as computeDistance.
+    //For the cosine distance this is half the squared distance from the unit length query to the box of the unit length samples
+    const double *minValues = &nodeBounds[ nodeIndex*2*numDimensions ];
+    const double *maxValues = minValues + numDimensions;
+    const bool normalize = distanceMethod == COSINE_DISTANCE;
+    double dist = 0;
+    for(UINT j=0; j<numDimensions; j++){
+        const double value = normalize ? query[j] / queryNorm : query[j];
+        double d = 0;
+        if( value < minValues[j] ) d = minValues[j] - value;
+        else if( value > maxValues[j] ) d = value - maxValues[j];
+        dist += distanceMethod == MANHATTAN_DISTANCE ? d : d*d;
+    }
+    return normalize ? dist * 0.5 : dist;
+}
+
+} //End of namespace GRT
@@ -0,0 +1,214 @@
+/**
+ @file
+ @author  Nicholas Gillian <ngillian@media.mit.edu>
+ @version 1.0
+
+ @section LICENSE
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ @section DESCRIPTION
+ This class implements the KD-tree used by the KNN classifier to find the K nearest neighbours of an input vector without
+ scanning every training sample.  Each node of the tree holds a contiguous block of the training samples and the bounding
+ box of that block, the children split the block at the median of the dimension with the largest spread.  A search visits
+ the closest child first and skips any node whose bounding box is further away than the current K-th nearest neighbour.
+
+ The tree does not keep a copy of the training samples, it holds the indexes of the rows of the packed training samples of the
+ KNN model, which are passed to each search as a KDTreeSamples.  The distances are computed from these rows in the same way as
+ the linear search of the KNN, so both searches find the same neighbours with the same distances.
+
+ The Euclidean and Manhattan distances are searched directly.  The cosine distance (1 - cos(a,b)) is searched with the bounding
+ boxes of the unit length training samples, as the squared Euclidean distance between two unit vectors is 2*(1 - cos(a,b)).  A zero
+ length sample can not be normalized, so these are kept out of the tree and, as in the linear search, their cosine distance is 1.
+ */
+
+#pragma once
+
+#include "../../DataStructures/LabelledClassificationData.h"
+#include "../../Util/IndexedDouble.h"
+
+namespace GRT{
+
+class KDTreeNode{
+public:
+    KDTreeNode(){
+        startIndex = 0;
+        endIndex = 0;
+        leftChild = 0;
+        rightChild = 0;
+    }
+    ~KDTreeNode(){}
+
+    bool isLeaf() const { return leftChild == 0; }
+
+    UINT startIndex;                    ///> The index of the first sample in this node
+    UINT endIndex;                      ///> The index one past the last sample in this node
+    UINT leftChild;                     ///> The index of the left child node, this is 0 for a leaf (the root can never be a child)
+    UINT rightChild;                    ///> The index of the right child node
+};
+
+//The training samples a KDTree is built from and searched in, these are owned by the KNN model
+class KDTreeSamples{
+public:
+    KDTreeSamples(const double *samples,const double *sampleNorms,UINT numSamples,UINT numDimensions,UINT sampleStride){
+        this->samples = samples;
+        this->sampleNorms = sampleNorms;
+        this->numSamples = numSamples;
+        this->numDimensions = numDimensions;
+        this->sampleStride = sampleStride;
+    }
+    ~KDTreeSamples(){}
+
+    const double* getSample(UINT i) const { return samples + (unsigned long long)i*sampleStride; }
+
+    const double *samples;              ///> The samples, stored as one row-major block with sampleStride values in each row (any padding must be zero)
+    const double *sampleNorms;          ///> The magnitude of each sample
+    UINT numSamples;                    ///> The number of samples
+    UINT numDimensions;                 ///> The number of dimensions of each sample
+    UINT sampleStride;                  ///> The number of values in each row of samples
+};
+
+class KDTree{
+public:
+    /**
+     Default Constructor
+    */
+    KDTree();
+
+    /**
+     Default Destructor
+    */
+    ~KDTree();
+
+    /**
+     Builds the tree from the training samples.  If none of the samples can be put in the tree (every sample has a length of zero
+     and the cosine distance is used) then the tree is left empty, and getBuilt() returns false.
+
+     @param const KDTreeSamples &data: the (already scaled) training samples
+     @param UINT distanceMethod: the distance method the tree will be searched with, this uses the KNN::DistanceMethods values
+     @param UINT leafSize: the maximum number of samples in a leaf node
+     @return returns true if the tree was built (or left empty), false otherwise
+    */
+    bool build(const KDTreeSamples &data,UINT distanceMethod,UINT leafSize = DEFAULT_LEAF_SIZE);
+
+    /**
+     Finds the K nearest neighbours of the query.  The index of each neighbour is the index of the sample in the training data
+     and the value is its distance to the query.  The neighbours are sorted by distance, ties are broken by the sample index.
+     As the tree is not modified by the search, several threads can search the same tree at once.
+
+     @param const KDTreeSamples &data: the training samples the tree was built from
+     @param const double *query: the query, this should have the same scaling and the same padding as the rows of the training samples
+     @param double queryNorm: the magnitude of the query
+     @param UINT K: the number of neighbours to find
+     @param vector< IndexedDouble > &neighbours: returns the K nearest neighbours
+     @return returns true if the search was performed, false otherwise
+    */
+    bool search(const KDTreeSamples &data,const double *query,double queryNorm,UINT K,vector< IndexedDouble > &neighbours) const;
+
+    /**
+     Saves the structure of the tree to the file, the samples themselves are not saved as they are part of the KNN model.
+
+     @param fstream &file: the file to save the tree to
+     @return returns true if the tree was saved, false otherwise
+    */
+    bool saveToFile(fstream &file) const;
+
+    /**
+     Loads the structure of the tree from the file.  Only the bounding boxes are recomputed, which takes a single linear pass over the training samples.
+
+     @param fstream &file: the file to load the tree from
+     @param const KDTreeSamples &data: the training samples the tree was built from
+     @param UINT distanceMethod: the distance method the tree will be searched with
+     @return returns true if the tree was loaded, false otherwise
+    */
+    bool loadFromFile(fstream &file,const KDTreeSamples &data,UINT distanceMethod);
+
+    /**
+     Saves the structure of the tree to a binary file, the samples themselves are not saved as they are part of the KNN model.
+
+     @param BinaryWriter &writer: the writer for the binary file
+     @return returns true if the tree was saved, false otherwise
+    */
+    bool saveToBinaryFile(BinaryWriter &writer) const;
+
+    /**
+     Loads the structure of the tree saved by saveToBinaryFile.  Only the bounding boxes are recomputed, as with loadFromFile.
+
+     @param BinaryReader &reader: the reader for the binary data
+     @param const KDTreeSamples &data: the training samples the tree was built from
+     @param UINT distanceMethod: the distance method the tree will be searched with
+     @return returns true if the tree was loaded, false otherwise
+    */
+    bool loadFromBinaryData(BinaryReader &reader,const KDTreeSamples &data,UINT distanceMethod);
+
+    /**
+     Clears the tree.
+    */
+    void clear();
+
+    /**
+     Adds the neighbour to the max-heap of the K nearest neighbours found so far, if the heap is full the neighbour replaces the
+     furthest one if it is closer.  Once the search is done, std::sort_heap with compareNeighbours sorts the neighbours by distance.
+
+     @param vector< IndexedDouble > &heap: the heap of the nearest neighbours
+     @param const IndexedDouble &neighbour: the neighbour to add, the value is its distance
+     @param UINT K: the maximum number of neighbours to keep
+    */
+    static inline void addNeighbour(vector< IndexedDouble > &heap,const IndexedDouble &neighbour,UINT K){
+        if( heap.size() < K ){
+            heap.push_back( neighbour );
+            std::push_heap(heap.begin(),heap.end(),compareNeighbours);
+        }else if( compareNeighbours(neighbour,heap.front()) ){
+            std::pop_heap(heap.begin(),heap.end(),compareNeighbours);
+            heap.back() = neighbour;
+            std::push_heap(heap.begin(),heap.end(),compareNeighbours);
+        }
+    }
+
+    static bool compareNeighbours(const IndexedDouble &a,const IndexedDouble &b){
+        //Orders the neighbours by distance, then by sample index, so the result does not depend on the order the samples are searched in
+        if( a.value != b.value ) return a.value < b.value;
+        return a.index < b.index;
+    }
+
+    bool getBuilt() const { return nodes.size() > 0; }
+    UINT getNumNodes() const { return (UINT)nodes.size(); }
+    UINT getLeafSize() const { return leafSize; }
+
+    enum DistanceMethods{EUCLIDEAN_DISTANCE=0,COSINE_DISTANCE,MANHATTAN_DISTANCE};
+    static const UINT DEFAULT_LEAF_SIZE = 16;
+
+protected:
+    UINT buildNode(const KDTreeSamples &data,UINT startIndex,UINT endIndex);
+    bool setupLoadedTree(const KDTreeSamples &data,UINT distanceMethod,const vector< UINT > &savedSampleIndexes);
+    void computeBounds(const KDTreeSamples &data);
+    void searchNode(const KDTreeSamples &data,UINT nodeIndex,const double *query,double queryNorm,UINT K,vector< IndexedDouble > &heap) const;
+    inline double getTreeValue(const KDTreeSamples &data,UINT i,UINT j) const;
+    inline double computeDistance(const KDTreeSamples &data,const double *query,double queryNorm,UINT i) const;
+    inline double computeBoundsDistance(UINT nodeIndex,const double *query,double queryNorm) const;
+
+    UINT numDimensions;                 ///> The number of dimensions of the training data
+    UINT distanceMethod;                ///> The distance method the tree was built for
+    UINT leafSize;                      ///> The maximum number of samples in a leaf node
+    vector< UINT > sampleIndexes;       ///> The index in the training data of each sample in the tree, in tree order
+    vector< UINT > zeroSampleIndexes;   ///> The index of each zero length sample, these are kept out of the tree for the cosine distance
+    vector< KDTreeNode > nodes;         ///> The nodes of the tree, the root is node 0
+    vector< double > nodeBounds;        ///> The min and max of each dimension for each node, stored as [min_0..min_N-1 max_0..max_N-1] per node
+};
+
+} //End of namespace GRT
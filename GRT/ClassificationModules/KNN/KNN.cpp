@@ -34,6 +34,8 @@ KNN::KNN(unsigned int K,bool useScaling,bool useNullRejection,double nullRejecti
     this->searchForBestKValue = searchForBestKValue;
     this->minKSearchValue = minKSearchValue;
     this->maxKSearchValue = maxKSearchValue;
+    this->useSpatialIndex = true;
+    this->numTrainingThreads = 0;
     classifierType = "KNN";
     classifierMode = STANDARD_CLASSIFIER_MODE;
     distanceMethod = EUCLIDEAN_DISTANCE;
@@ -55,10 +57,12 @@ KNN& KNN::operator=(const KNN &rhs){
         this->searchForBestKValue = rhs.searchForBestKValue;
         this->minKSearchValue = rhs.minKSearchValue;
         this->maxKSearchValue = rhs.maxKSearchValue;
-        this->trainingData = rhs.trainingData;
+        this->useSpatialIndex = rhs.useSpatialIndex;
+        this->numTrainingThreads = rhs.numTrainingThreads;
         this->trainingMu = rhs.trainingMu;
         this->trainingSigma = rhs.trainingSigma;
         this->rejectionThresholds = rhs.rejectionThresholds;
+        this->model = rhs.model;
         
         //Classifier variables
         copyBaseVariables(this,(Classifier*)&rhs);
@@ -75,14 +79,18 @@ bool KNN::clone(const Classifier *classifier){
         //Clone the KNN values 
         this->K = ptr->K;
         this->distanceMethod = ptr->distanceMethod;
-        this->trainingData = ptr->trainingData;
         this->searchForBestKValue = ptr->searchForBestKValue;
         this->minKSearchValue = ptr->minKSearchValue;
         this->maxKSearchValue = ptr->maxKSearchValue;
+        this->useSpatialIndex = ptr->useSpatialIndex;
+        this->numTrainingThreads = ptr->numTrainingThreads;
         this->trainingMu = ptr->trainingMu;
         this->trainingSigma = ptr->trainingSigma;
         this->rejectionThresholds = ptr->rejectionThresholds;
         
+        //The trained model is shared rather than copied, each KNN only has its own prediction buffers
+        this->model = ptr->model;
+        
         //Clone the classifier variables
         copyBaseVariables(this, classifier);
         return true;
@@ -90,82 +98,122 @@ bool KNN::clone(const Classifier *classifier){
     return false;
 }
 
-bool KNN::train(LabelledClassificationData &trainingData){
+//Scores the validation samples for the K search, each validation sample is searched once for its maxKSearchValue nearest neighbours
+//and the vote for every K is taken from the first K of those neighbours
+class KNNKSearchJob : public ParallelJob{
+public:
+    KNNKSearchJob(KNN *knn,LabelledClassificationData &testSet,UINT numThreads):
+        knn(knn),testSet(testSet),correctCounts(numThreads,vector< UINT >(knn->maxKSearchValue-knn->minKSearchValue+1,0)),searchFailed(numThreads,false){}
+
+    virtual void run(unsigned int threadIndex,unsigned int startIndex,unsigned int endIndex){
+        const UINT numClasses = knn->numClasses;
+        const UINT minK = knn->minKSearchValue;
+        const UINT maxK = knn->maxKSearchValue;
+        vector< IndexedDouble > neighbours;
+        vector< double > queryBuffer;
+        vector< UINT > classCounts( numClasses );
+
+        for(UINT i=startIndex; i<endIndex; i++){
+            vector< double > sample = testSet[i].getSample();
+            if( knn->useScaling ){
+                for(UINT j=0; j<sample.size(); j++){
+                    sample[j] = knn->scale(sample[j], knn->ranges[j].minValue, knn->ranges[j].maxValue, 0, 1);
+                }
+            }
+            if( !knn->searchNeighbours(sample,maxK,neighbours,queryBuffer) ){
+                searchFailed[threadIndex] = true;
+                return;
+            }
 
-	if( !searchForBestKValue ){
-        return train_(trainingData,K);
+            //Add the neighbours one at a time, the vote after adding the k'th neighbour is the prediction for that K (this uses the same
+            //rule as predictFromNeighbours, so ties go to the class with the lowest index)
+            std::fill(classCounts.begin(),classCounts.end(),0);
+            UINT maxIndex = 0;
+            for(UINT k=1; k<=neighbours.size(); k++){
+                const UINT classLabel = knn->model->trainingData[ neighbours[k-1].index ].getClassLabel();
+                for(UINT c=0; c<numClasses; c++){
+                    if( knn->classLabels[c] == classLabel ){
+                        classCounts[c]++;
+                        break;
+                    }
+                }
+                maxIndex = 0;
+                for(UINT c=1; c<numClasses; c++){
+                    if( classCounts[c] > classCounts[maxIndex] ) maxIndex = c;
+                }
+                if( k >= minK && knn->classLabels[maxIndex] == testSet[i].getClassLabel() ){
+                    correctCounts[threadIndex][k-minK]++;
+                }
+            }
+        }
     }
 
-    UINT bestIndex = 0;
-    UINT index = 0;
-    double bestAccuracy = 0;
-    vector< IndexedDouble > trainingAccuracyLog;
+    KNN *knn;
+    LabelledClassificationData &testSet;
+    vector< vector< UINT > > correctCounts;
+    vector< bool > searchFailed;
+};
 
-    for(UINT k=minKSearchValue; k<=maxKSearchValue; k++){
-        //Randomly spilt the data and use 80% to train the algorithm and 20% to test it
-        LabelledClassificationData trainingSet(trainingData);
-        LabelledClassificationData testSet = trainingSet.partition(80,true);
+bool KNN::train(LabelledClassificationData &trainingData){
 
-        if( !train_(trainingSet, k) ){
-            errorLog << "Failed to train model for a k value of " << k << endl;
-        }else{
+	if( !searchForBestKValue ){
+        return train_(trainingData,K);
+    }
 
-            //Compute the classification error
-            double accuracy = 0;
-            for(UINT i=0; i<testSet.getNumSamples(); i++){
+    if( minKSearchValue == 0 || minKSearchValue > maxKSearchValue ){
+        errorLog << "train(LabelledClassificationData &trainingData) - The K search range [" << minKSearchValue << " " << maxKSearchValue << "] is not valid!" << endl;
+        return false;
+    }
 
-                vector< double > sample = testSet[i].getSample();
+    //Randomly spilt the data once and use 80% to train the algorithm and 20% to test it for every K value
+    LabelledClassificationData trainingSet(trainingData);
+    LabelledClassificationData testSet = trainingSet.partition(80,true);
 
-                if( !predict( sample ) ){
-                    errorLog << "Failed to predict label for test sample with a k value of " << k << endl;
-                    return false;
-                }
+    if( testSet.getNumSamples() == 0 || trainingSet.getNumSamples() < maxKSearchValue ){
+        errorLog << "train(LabelledClassificationData &trainingData) - There is not enough training data to search for K values up to " << maxKSearchValue << endl;
+        return false;
+    }
 
-                if( testSet[i].getClassLabel() == predictedClassLabel ){
-                    accuracy++;
-                }
-            }
+    //Train a model with the training set, null rejection is not used for the search so the rejection thresholds are not computed
+    const bool tempUseNullRejection = useNullRejection;
+    useNullRejection = false;
+    bool trainingResult = train_(trainingSet,maxKSearchValue);
+    useNullRejection = tempUseNullRejection;
+    if( !trainingResult ){
+        errorLog << "train(LabelledClassificationData &trainingData) - Failed to train model for the K search!" << endl;
+        return false;
+    }
 
-            accuracy = accuracy /double( testSet.getNumSamples() ) * 100.0;
-            trainingAccuracyLog.push_back( IndexedDouble(k,accuracy) );
-			
-			trainingLog << "K:\t" << k << "\tAccuracy:\t" << accuracy << endl;
+    //Score the test set for every K value, the test samples are split between the threads
+    KNNKSearchJob job(this,testSet,ParallelFor::getNumThreads(testSet.getNumSamples(),numTrainingThreads));
+    ParallelFor::run(job,testSet.getNumSamples(),(UINT)job.correctCounts.size());
 
-            if( accuracy > bestAccuracy ){
-                bestIndex = index;
-                bestAccuracy = accuracy;
+    UINT bestK = 0;
+    double bestAccuracy = 0;
+    for(UINT k=minKSearchValue; k<=maxKSearchValue; k++){
+        UINT numCorrect = 0;
+        for(UINT t=0; t<job.correctCounts.size(); t++){
+            if( job.searchFailed[t] ){
+                errorLog << "train(LabelledClassificationData &trainingData) - Failed to search the nearest neighbours of the test samples!" << endl;
+                return false;
             }
+            numCorrect += job.correctCounts[t][k-minKSearchValue];
+        }
+        double accuracy = numCorrect / double( testSet.getNumSamples() ) * 100.0;
 
-            index++;
+		trainingLog << "K:\t" << k << "\tAccuracy:\t" << accuracy << endl;
 
+        //Only a strictly better accuracy replaces the best K, so the minimum K value is used if several K values give the best accuracy
+        if( accuracy > bestAccuracy ){
+            bestK = k;
+            bestAccuracy = accuracy;
         }
-
     }
 
     if( bestAccuracy > 0 ){
-        //Sort the training log by value
-        std::sort(trainingAccuracyLog.begin(),trainingAccuracyLog.end(),IndexedDouble::sortIndexedDoubleByValueAscending);
+		trainingLog << "Best K Value: " << bestK << "\tAccuracy:\t" << bestAccuracy << endl;
 
-        //Copy the top matching values into a temporary buffer
-        vector< IndexedDouble > tempLog;
-
-        //Add the first value
-        tempLog.push_back( trainingAccuracyLog[0] );
-
-        //Keep adding values until the value changes
-        for(UINT i=1; i<trainingAccuracyLog.size(); i++){
-            if( trainingAccuracyLog[i].value == tempLog[0].value ){
-                tempLog.push_back( trainingAccuracyLog[i] );
-            }else break;
-        }
-
-        //Sort the temp values by index
-        std::sort(tempLog.begin(),tempLog.end(),IndexedDouble::sortIndexedDoubleByIndexDescending);
-
-		trainingLog << "Best K Value: " << tempLog[0].index << "\tAccuracy:\t" << tempLog[0].value << endl;
-
-        //Use the minimum index, this should give us the best accuracy with the minimum K value
-        return train_(trainingData,tempLog[0].index);
+        return train_(trainingData,bestK);
     }
 
     return false;
@@ -186,12 +234,22 @@ bool KNN::train_(LabelledClassificationData &trainingData,UINT K){
     this->numFeatures = trainingData.getNumDimensions();
     this->numClasses = trainingData.getNumClasses();
 
-    //TODO: In the future need to build a kdtree from the training data to allow better realtime prediction
-    this->trainingData = trainingData;
+    //The model was replaced by clear, so it is not shared and can be changed in place
+    KNNModel &trainedModel = model.edit();
+    trainedModel.trainingData = trainingData;
 
     if( useScaling ){
-        ranges = this->trainingData.getRanges();
-        this->trainingData.scale(ranges, 0, 1);
+        ranges = trainedModel.trainingData.getRanges();
+        trainedModel.trainingData.scale(ranges, 0, 1);
+    }
+
+    //Pack the scaled training samples for the search, and build the KD-tree over them if it is used
+    packTrainingSamples( trainedModel );
+    if( useSpatialIndex ){
+        if( !trainedModel.spatialIndex.build(trainedModel.getTreeSamples(),distanceMethod) ){
+            errorLog << "train_(LabelledClassificationData &trainingData,UINT K) - Failed to build the spatial index!" << endl;
+            return false;
+        }
     }
 
     //Set the class labels
@@ -287,15 +345,17 @@ bool KNN::train_(LabelledClassificationData &trainingData,UINT K){
         useNullRejection = tempUseNullRejection;
         
     }else{
-        //Resize the rejection thresholds but set the values to 0
+        //Resize the rejection thresholds but set the values to 0, the training mu and sigma are also saved with the model so they need one value per class
         rejectionThresholds.clear();
         rejectionThresholds.resize( numClasses, 0 );
+        trainingMu.resize( numClasses, 0 );
+        trainingSigma.resize( numClasses, 0 );
     }
 
     return true;
 }
 
-bool KNN::predict(vector< double > inputVector){
+bool KNN::predict(const vector< double > &inputVector){
 
     if( !trained ){
         errorLog << "predict(vector< double > inputVector) - KNN model has not been trained" << endl;
@@ -310,7 +370,7 @@ bool KNN::predict(vector< double > inputVector){
     return predict(inputVector,K);
 }
 
-bool KNN::predict(vector< double > inputVector,UINT K){
+bool KNN::predict(const vector< double > &inputVector,UINT K){
 
     if( !trained ){
         errorLog << "predict(vector< double > inputVector,UINT K) - KNN model has not been trained" << endl;
@@ -322,71 +382,66 @@ bool KNN::predict(vector< double > inputVector,UINT K){
         return false;
     }
 
-    if( K > trainingData.getNumSamples() ){
+    if( K > model->trainingData.getNumSamples() ){
         errorLog << "predict(vector< double > inputVector,UINT K) - K Is Greater Than The Number Of Training Samples" << endl;
         return false;
     }
 
+    const vector< double > *x = &inputVector;
     if( useScaling ){
-        for(UINT i=0; i<inputVector.size(); i++){
-            inputVector[i] = scale(inputVector[i], ranges[i].minValue, ranges[i].maxValue, 0, 1);
+        scaledInputVector.resize( numFeatures );
+        for(UINT i=0; i<numFeatures; i++){
+            scaledInputVector[i] = scale(inputVector[i], ranges[i].minValue, ranges[i].maxValue, 0, 1);
         }
+        x = &scaledInputVector;
     }
 
-    //TODO - need to build a kdtree of the training data to allow better realtime prediction
-    const UINT M = trainingData.getNumSamples();
-    vector< IndexedDouble > neighbours;
+    //Find the K nearest neighbours
+    if( !searchNeighbours(*x,K,neighbours,queryBuffer) ){
+        return false;
+    }
 
-    for(UINT i=0; i<M; i++){
-        double dist = 0;
-        UINT classLabel = trainingData[i].getClassLabel();
-        vector< double > trainingSample = trainingData[i].getSample();
-
-        switch( distanceMethod ){
-            case EUCLIDEAN_DISTANCE:
-                dist = computeEuclideanDistance(inputVector,trainingSample);
-                break;
-            case COSINE_DISTANCE:
-                dist = computeCosineDistance(inputVector,trainingSample);
-                break;
-            case MANHATTAN_DISTANCE:
-                dist = computeManhattanDistance(inputVector, trainingSample);
-                break;
-            default:
-                errorLog << "predict(vector< double > inputVector) - unkown distance measure!" << endl;
-                return false;
-                break;
-        }
+    return predictFromNeighbours( neighbours );
+}
 
-        if( neighbours.size() < K ){
-            neighbours.push_back( IndexedDouble(classLabel,dist) );
-        }else{
-            //Find the maximum value in the neighbours buffer
-            double maxValue = neighbours[0].value;
-            UINT maxIndex = 0;
-            for(UINT n=1; n<neighbours.size(); n++){
-                if( neighbours[n].value > maxValue ){
-                    maxValue = neighbours[n].value;
-                    maxIndex = n;
-                }
-            }
+bool KNN::searchNeighbours(const vector< double > &inputVector,UINT K,vector< IndexedDouble > &neighbours,vector< double > &queryBuffer){
 
-            //If the dist is less than the maximum value in the buffer, then replace that value with the new dist
-            if( dist < maxValue ){
-                neighbours[ maxIndex ] = IndexedDouble(classLabel,dist);
-            }
+    //Finds the K nearest neighbours of the (scaled) input vector, sorted by distance.  This does not change the state of the KNN, so it
+    //can be called from several threads at once as long as each thread has its own neighbours and queryBuffer
+    neighbours.clear();
+
+    //Copy the input into a padded row so it matches the layout of the packed training samples
+    queryBuffer.assign( model->trainingSampleStride, 0 );
+    std::copy(inputVector.begin(),inputVector.end(),queryBuffer.begin());
+    const double queryNorm = sqrt( DistanceKernels::dot(&queryBuffer[0],&queryBuffer[0],model->trainingSampleStride) );
+
+    if( model->spatialIndex.getBuilt() ){
+        if( !model->spatialIndex.search(model->getTreeSamples(),&queryBuffer[0],queryNorm,K,neighbours) ){
+            errorLog << "searchNeighbours(...) - Failed to search the spatial index!" << endl;
+            return false;
         }
+        return true;
     }
 
+    if( !searchTrainingSamples(&queryBuffer[0],queryNorm,0,model->trainingData.getNumSamples(),K,neighbours) ){
+        return false;
+    }
+    sortNeighbours( neighbours );
+
+    return true;
+}
+
+bool KNN::predictFromNeighbours(vector< IndexedDouble > &neighbours){
+
     //Predict the class ID using the labels of the K nearest neighbours
     if( classLikelihoods.size() != numClasses ) classLikelihoods.resize(numClasses,0);
     else for(UINT i=0; i<classLikelihoods.size(); i++){ classLikelihoods[i] = 0; }
     if( classDistances.size() != numClasses ) classDistances.resize(numClasses,0);
     else for(UINT i=0; i<classDistances.size(); i++){ classDistances[i] = 0; }
 
-    //Count the classes
+    //Count the classes, the index of each neighbour is the index of the training sample
     for(UINT k=0; k<neighbours.size(); k++){
-        UINT classLabel = neighbours[k].index;
+        UINT classLabel = model->trainingData[ neighbours[k].index ].getClassLabel();
         if( classLabel == 0 ){
             errorLog << "predict(vector< double > inputVector) - Class label of training example can not be zero!" << endl;
             return false;
@@ -441,6 +496,141 @@ bool KNN::predict(vector< double > inputVector,UINT K){
     return true;
 }
 
+bool KNN::predictBatch(const Matrix<double> &inputData,vector< UINT > &predictedClassLabels,Matrix<double> &likelihoods,Matrix<double> &distances){
+
+    if( !trained ){
+        errorLog << "predictBatch(const Matrix<double> &inputData,...) - KNN model has not been trained" << endl;
+        return false;
+    }
+
+    if( inputData.getNumCols() != numFeatures ){
+        errorLog << "predictBatch(const Matrix<double> &inputData,...) - the number of columns in the input data " << inputData.getNumCols() << " does not match the number of features " << numFeatures <<  endl;
+        return false;
+    }
+
+    if( K > model->trainingData.getNumSamples() ){
+        errorLog << "predictBatch(const Matrix<double> &inputData,...) - K Is Greater Than The Number Of Training Samples" << endl;
+        return false;
+    }
+
+    const UINT numQueries = inputData.getNumRows();
+    predictedClassLabels.resize( numQueries );
+    likelihoods.resize( numQueries, numClasses );
+    distances.resize( numQueries, numClasses );
+
+    //The KD-tree search does not gain anything from batching, so each row is predicted in turn
+    if( model->spatialIndex.getBuilt() ){
+        for(UINT q=0; q<numQueries; q++){
+            if( !predict( inputData.getRowVector(q), K ) ) return false;
+            storeBatchPrediction(q,predictedClassLabels,likelihoods,distances);
+        }
+        return true;
+    }
+
+    //The queries are scored in tiles against blocks of the training samples that fit in the L1 cache, so each block is loaded
+    //from memory once per tile of queries rather than once per query
+    const UINT QUERY_TILE_SIZE = 8;
+    const UINT SAMPLE_TILE_BYTES = 32768;
+    const UINT M = model->trainingData.getNumSamples();
+    const UINT sampleTileSize = SAMPLE_TILE_BYTES / (model->trainingSampleStride*sizeof(double)) > 0 ? SAMPLE_TILE_BYTES / (model->trainingSampleStride*sizeof(double)) : 1;
+    vector< double > queries( QUERY_TILE_SIZE*model->trainingSampleStride );
+    vector< double > queryNorms( QUERY_TILE_SIZE );
+    vector< vector< IndexedDouble > > tileNeighbours( QUERY_TILE_SIZE );
+
+    for(UINT tileStart=0; tileStart<numQueries; tileStart+=QUERY_TILE_SIZE){
+        const UINT tileSize = tileStart + QUERY_TILE_SIZE <= numQueries ? QUERY_TILE_SIZE : numQueries - tileStart;
+
+        //Scale the queries and copy them into padded rows
+        std::fill(queries.begin(),queries.end(),0);
+        for(UINT q=0; q<tileSize; q++){
+            double *query = &queries[ q*model->trainingSampleStride ];
+            for(UINT j=0; j<numFeatures; j++){
+                query[j] = useScaling ? scale(inputData[tileStart+q][j], ranges[j].minValue, ranges[j].maxValue, 0, 1) : inputData[tileStart+q][j];
+            }
+            queryNorms[q] = sqrt( DistanceKernels::dot(query,query,model->trainingSampleStride) );
+            tileNeighbours[q].clear();
+        }
+
+        for(UINT sampleStart=0; sampleStart<M; sampleStart+=sampleTileSize){
+            const UINT sampleEnd = sampleStart + sampleTileSize <= M ? sampleStart + sampleTileSize : M;
+            for(UINT q=0; q<tileSize; q++){
+                if( !searchTrainingSamples(&queries[ q*model->trainingSampleStride ],queryNorms[q],sampleStart,sampleEnd,K,tileNeighbours[q]) ){
+                    return false;
+                }
+            }
+        }
+
+        for(UINT q=0; q<tileSize; q++){
+            sortNeighbours( tileNeighbours[q] );
+            if( !predictFromNeighbours( tileNeighbours[q] ) ) return false;
+            storeBatchPrediction(tileStart+q,predictedClassLabels,likelihoods,distances);
+        }
+    }
+
+    return true;
+}
+
+bool KNN::packTrainingSamples(KNNModel &trainedModel){
+
+    //Pack the training samples into one row-major block, each row is padded to an even number of values so every row starts on
+    //a 16 byte boundary and the padding (which is zero) does not change any of the distances
+    const UINT M = trainedModel.trainingData.getNumSamples();
+    const UINT stride = numFeatures + (numFeatures % 2);
+    trainedModel.trainingSampleStride = stride;
+    trainedModel.trainingSamples.assign( M*stride, 0 );
+    trainedModel.trainingSampleNorms.resize( M );
+    for(UINT i=0; i<M; i++){
+        double *sample = &trainedModel.trainingSamples[ i*stride ];
+        for(UINT j=0; j<numFeatures; j++){
+            sample[j] = trainedModel.trainingData[i][j];
+        }
+        trainedModel.trainingSampleNorms[i] = sqrt( DistanceKernels::dot(sample,sample,stride) );
+    }
+
+    return true;
+}
+
+bool KNN::searchTrainingSamples(const double *query,double queryNorm,UINT startIndex,UINT endIndex,UINT K,vector< IndexedDouble > &neighbours){
+
+    //Adds the training samples [startIndex endIndex-1] to the max-heap of the K nearest neighbours, the Euclidean search uses
+    //the squared distance which is converted to the actual distance by sortNeighbours
+    const UINT N = model->trainingSampleStride;
+    switch( distanceMethod ){
+        case EUCLIDEAN_DISTANCE:
+            for(UINT i=startIndex; i<endIndex; i++){
+                KDTree::addNeighbour(neighbours,IndexedDouble(i,DistanceKernels::squaredEuclidean(query,&model->trainingSamples[i*N],N)),K);
+            }
+            break;
+        case COSINE_DISTANCE:
+            for(UINT i=startIndex; i<endIndex; i++){
+                const double magnitude = queryNorm * model->trainingSampleNorms[i];
+                const double dist = magnitude > 0 ? 1.0 - DistanceKernels::dot(query,&model->trainingSamples[i*N],N) / magnitude : 1.0;
+                KDTree::addNeighbour(neighbours,IndexedDouble(i,dist),K);
+            }
+            break;
+        case MANHATTAN_DISTANCE:
+            for(UINT i=startIndex; i<endIndex; i++){
+                KDTree::addNeighbour(neighbours,IndexedDouble(i,DistanceKernels::manhattan(query,&model->trainingSamples[i*N],N)),K);
+            }
+            break;
+        default:
+            errorLog << "searchTrainingSamples(...) - unkown distance measure!" << endl;
+            return false;
+            break;
+    }
+
+    return true;
+}
+
+void KNN::sortNeighbours(vector< IndexedDouble > &neighbours){
+    std::sort_heap(neighbours.begin(),neighbours.end(),KDTree::compareNeighbours);
+    if( distanceMethod == EUCLIDEAN_DISTANCE ){
+        for(UINT k=0; k<neighbours.size(); k++){
+            neighbours[k].value = sqrt( neighbours[k].value );
+        }
+    }
+}
+
 bool KNN::saveModelToFile(string filename){
 
     if( !trained ) return false;
@@ -466,7 +656,7 @@ bool KNN::saveModelToFile(fstream &file){
     }
     
     //Write the header info
-    file<<"GRT_KNN_MODEL_FILE_V1.0\n";
+    file<<"GRT_KNN_MODEL_FILE_V2.0\n";
     file<<"NumFeatures: " << numFeatures << endl;
     file<<"NumClasses: " << numClasses << endl;
     file<<"K: "<<K<<endl;
@@ -477,6 +667,7 @@ bool KNN::saveModelToFile(fstream &file){
     file<<"UseScaling: " << useScaling << endl;
     file<<"UseNullRejection: " << useNullRejection << endl;
     file<<"NullRejectionCoeff: " << nullRejectionCoeff << endl;
+    file<<"UseSpatialIndex: " << model->spatialIndex.getBuilt() << endl;
     
     if( useScaling ){
         file << "Ranges: \n";
@@ -495,6 +686,7 @@ bool KNN::saveModelToFile(fstream &file){
         file << trainingSigma[j] << "\t";
     }file << endl;
     
+    const LabelledClassificationData &trainingData = model->trainingData;
     file <<"NumTrainingSamples: " << trainingData.getNumSamples() << endl;
     file <<"TrainingData: \n";
     
@@ -508,6 +700,14 @@ bool KNN::saveModelToFile(fstream &file){
         file << endl;
     }
     
+    //Save the KD-tree so it does not need to be rebuilt when the model is loaded
+    if( model->spatialIndex.getBuilt() ){
+        if( !model->spatialIndex.saveToFile( file ) ){
+            errorLog << "saveModelToFile(fstream &file) - Failed to save the spatial index!" << endl;
+            return false;
+        }
+    }
+    
     return true;
 }
 
@@ -538,12 +738,13 @@ bool KNN::loadModelFromFile(fstream &file){
     
     std::string word;
     
-    //Find the file type header
+    //Find the file type header, the V1.0 files do not have the spatial index
     file >> word;
-    if(word != "GRT_KNN_MODEL_FILE_V1.0"){
+    if(word != "GRT_KNN_MODEL_FILE_V1.0" && word != "GRT_KNN_MODEL_FILE_V2.0"){
         errorLog << "loadModelFromFile(fstream &file) - Could not find Model File Header!" << endl;
         return false;
     }
+    const bool fileHasSpatialIndex = word == "GRT_KNN_MODEL_FILE_V2.0";
     
     //Find the file type header
     file >> word;
@@ -616,6 +817,16 @@ bool KNN::loadModelFromFile(fstream &file){
     }
     file >> nullRejectionCoeff;
     
+    bool spatialIndexSaved = false;
+    if( fileHasSpatialIndex ){
+        file >> word;
+        if(word != "UseSpatialIndex:"){
+            errorLog << "loadModelFromFile(fstream &file) - Could not find UseSpatialIndex!" << endl;
+            return false;
+        }
+        file >> spatialIndexSaved;
+    }
+    
     ///Read the ranges if needed
     if( useScaling ){
         //Resize the ranges buffer
@@ -673,7 +884,9 @@ bool KNN::loadModelFromFile(fstream &file){
         return false;
     }
     
-    //Load the training data
+    //Load the training data into a new model, any copies of this KNN keep the previous model
+    KNNModel &loadedModel = model.reset();
+    LabelledClassificationData &trainingData = loadedModel.trainingData;
     trainingData.setNumDimensions(numFeatures);
     unsigned int classLabel = 0;
     vector< double > sample(numFeatures,0);
@@ -690,6 +903,173 @@ bool KNN::loadModelFromFile(fstream &file){
         trainingData.addSample(classLabel, sample);
     }
     
+    //Set the class labels
+    classLabels.resize(numClasses);
+    for(UINT k=0; k<numClasses; k++){
+        classLabels[k] = trainingData.getClassTracker()[k].classLabel;
+    }
+    
+    //Load the KD-tree, older model files do not have one so it is built from the training data
+    packTrainingSamples( loadedModel );
+    if( spatialIndexSaved ){
+        if( !loadedModel.spatialIndex.loadFromFile(file,loadedModel.getTreeSamples(),distanceMethod) ){
+            errorLog << "loadModelFromFile(fstream &file) - Failed to load the spatial index!" << endl;
+            return false;
+        }
+    }else if( useSpatialIndex && !fileHasSpatialIndex ){
+        loadedModel.spatialIndex.build(loadedModel.getTreeSamples(),distanceMethod);
+    }
+    
+    //Flag that the model has been trained
+    trained = true;
+    
+    //Compute the null rejection thresholds
+    recomputeNullRejectionThresholds();
+    
+    return true;
+}
+    
+bool KNN::saveModelToBinaryFile(fstream &file){
+    
+    if(!file.is_open())
+    {
+        errorLog << "saveModelToBinaryFile(fstream &file) - Could not open file to save model!" << endl;
+        return false;
+    }
+    
+    const LabelledClassificationData &trainingData = model->trainingData;
+    const UINT numTrainingSamples = trainingData.getNumSamples();
+    BinaryWriter writer( file );
+    writer.write( string("GRT_KNN_MODEL_BINARY_V1.0") );
+    writer.write( numFeatures );
+    writer.write( numClasses );
+    writer.write( K );
+    writer.write( distanceMethod );
+    writer.write( searchForBestKValue );
+    writer.write( minKSearchValue );
+    writer.write( maxKSearchValue );
+    writer.write( useScaling );
+    writer.write( useNullRejection );
+    writer.write( nullRejectionCoeff );
+    writer.write( model->spatialIndex.getBuilt() );
+    
+    if( useScaling ){
+        for(UINT n=0; n<ranges.size(); n++){
+            writer.write( ranges[n].minValue );
+            writer.write( ranges[n].maxValue );
+        }
+    }
+    writer.write( trainingMu );
+    writer.write( trainingSigma );
+    
+    //Write the class labels, then all the samples as one block
+    vector< UINT > sampleLabels( numTrainingSamples );
+    vector< double > samples( (unsigned long long)numTrainingSamples*numFeatures );
+    for(UINT i=0; i<numTrainingSamples; i++){
+        sampleLabels[i] = trainingData[i].getClassLabel();
+        for(UINT j=0; j<numFeatures; j++){
+            samples[ (unsigned long long)i*numFeatures+j ] = trainingData[i][j];
+        }
+    }
+    writer.write( sampleLabels );
+    writer.writeArray( samples.size() > 0 ? &samples[0] : NULL, samples.size() );
+    
+    if( model->spatialIndex.getBuilt() ){
+        if( !model->spatialIndex.saveToBinaryFile( writer ) ){
+            errorLog << "saveModelToBinaryFile(fstream &file) - Failed to save the spatial index!" << endl;
+            return false;
+        }
+    }
+    
+    if( !writer.good() ){
+        errorLog << "saveModelToBinaryFile(fstream &file) - Failed to write the model!" << endl;
+        return false;
+    }
+    
+    return true;
+}
+    
+bool KNN::loadModelFromBinaryData(const char *data,unsigned long long size){
+    
+    clear();
+    
+    BinaryReader reader(data,size);
+    string header;
+    reader.read( header );
+    if( header != "GRT_KNN_MODEL_BINARY_V1.0" ){
+        errorLog << "loadModelFromBinaryData(const char *data,unsigned long long size) - Could not find Model File Header!" << endl;
+        return false;
+    }
+    
+    bool spatialIndexSaved = false;
+    reader.read( numFeatures );
+    reader.read( numClasses );
+    reader.read( K );
+    reader.read( distanceMethod );
+    reader.read( searchForBestKValue );
+    reader.read( minKSearchValue );
+    reader.read( maxKSearchValue );
+    reader.read( useScaling );
+    reader.read( useNullRejection );
+    reader.read( nullRejectionCoeff );
+    reader.read( spatialIndexSaved );
+    
+    if( useScaling && reader.good() ){
+        ranges.resize( numFeatures );
+        for(UINT n=0; n<ranges.size(); n++){
+            reader.read( ranges[n].minValue );
+            reader.read( ranges[n].maxValue );
+        }
+    }
+    reader.read( trainingMu );
+    reader.read( trainingSigma );
+    
+    vector< UINT > sampleLabels;
+    reader.read( sampleLabels );
+    const UINT numTrainingSamples = (UINT)sampleLabels.size();
+    const double *samples = reader.readArray( (unsigned long long)numTrainingSamples*numFeatures );
+    
+    if( !reader.good() || trainingMu.size() != numClasses || trainingSigma.size() != numClasses ){
+        errorLog << "loadModelFromBinaryData(const char *data,unsigned long long size) - The model is truncated or corrupt!" << endl;
+        clear();
+        return false;
+    }
+    
+    //Copy the samples straight from the data, clear replaced the model so it is not shared
+    KNNModel &loadedModel = model.edit();
+    LabelledClassificationData &trainingData = loadedModel.trainingData;
+    trainingData.setNumDimensions(numFeatures);
+    vector< double > sample(numFeatures,0);
+    for(UINT i=0; i<numTrainingSamples; i++){
+        std::copy(samples + (unsigned long long)i*numFeatures,samples + (unsigned long long)(i+1)*numFeatures,sample.begin());
+        if( !trainingData.addSample(sampleLabels[i], sample) ){
+            errorLog << "loadModelFromBinaryData(const char *data,unsigned long long size) - Failed to add training sample " << i << "!" << endl;
+            clear();
+            return false;
+        }
+    }
+    
+    if( trainingData.getNumClasses() != numClasses ){
+        errorLog << "loadModelFromBinaryData(const char *data,unsigned long long size) - The number of classes does not match the training data!" << endl;
+        clear();
+        return false;
+    }
+    
+    //Set the class labels
+    classLabels.resize(numClasses);
+    for(UINT k=0; k<numClasses; k++){
+        classLabels[k] = trainingData.getClassTracker()[k].classLabel;
+    }
+    
+    packTrainingSamples( loadedModel );
+    if( spatialIndexSaved ){
+        if( !loadedModel.spatialIndex.loadFromBinaryData(reader,loadedModel.getTreeSamples(),distanceMethod) ){
+            errorLog << "loadModelFromBinaryData(const char *data,unsigned long long size) - Failed to load the spatial index!" << endl;
+            clear();
+            return false;
+        }
+    }
+    
     //Flag that the model has been trained
     trained = true;
     
@@ -746,6 +1126,16 @@ bool KNN::setNullRejectionCoeff(double nullRejectionCoeff){
     return false;
 }
 
+bool KNN::setNumTrainingThreads(UINT numTrainingThreads){
+    this->numTrainingThreads = numTrainingThreads;
+    return true;
+}
+
+bool KNN::enableSpatialIndex(bool useSpatialIndex){
+    this->useSpatialIndex = useSpatialIndex;
+    return true;
+}
+
 bool KNN::setDistanceMethod(UINT distanceMethod){
     if( distanceMethod == EUCLIDEAN_DISTANCE || distanceMethod == COSINE_DISTANCE || distanceMethod == MANHATTAN_DISTANCE ){
         this->distanceMethod = distanceMethod;
@@ -761,6 +1151,7 @@ void KNN::clear(){
     trainingMu.clear();
     trainingSigma.clear();
     rejectionThresholds.clear();
+    model.reset();
 }
 
 double KNN::computeEuclideanDistance(vector< double > &a,vector< double > &b){
@@ -784,7 +1175,8 @@ double KNN::computeCosineDistance(vector< double > &a,vector< double > &b){
         magB += SQR(b[j]);
     }
 
-    dist = dotAB / (sqrt(magA) * sqrt(magB));
+    //The cosine similarity is 1 for vectors that point in the same direction, so it is converted to a distance
+    dist = 1.0 - dotAB / (sqrt(magA) * sqrt(magB));
 
     return dist;
 }
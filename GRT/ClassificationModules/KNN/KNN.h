@@ -39,11 +39,33 @@
 #pragma once
 
 #include "../../GestureRecognitionPipeline/Classifier.h"
+#include "KDTree.h"
 
 namespace GRT{
     
 #define BIG_DISTANCE 99e+99
 
+/**
+ The trained part of a KNN model. This is held in a SharedModel, so copies of a trained KNN (such as the classifier of each copy of a
+ GestureRecognitionPipeline) share one copy of the training data until one of them is retrained or loaded.
+*/
+class KNNModel{
+public:
+    KNNModel(){ trainingSampleStride = 0; }
+
+    //Returns the packed training samples, which are searched by both the KD-tree and the linear search
+    KDTreeSamples getTreeSamples() const{
+        return KDTreeSamples(trainingSamples.size() > 0 ? &trainingSamples[0] : NULL,trainingSampleNorms.size() > 0 ? &trainingSampleNorms[0] : NULL,
+                             trainingData.getNumSamples(),trainingData.getNumDimensions(),trainingSampleStride);
+    }
+
+    LabelledClassificationData trainingData;    ///> Holds the trainingData to perform the predictions
+    KDTree spatialIndex;                        ///> The KD-tree of the (scaled) training data, this indexes the rows of trainingSamples
+    UINT trainingSampleStride;                  ///> The number of values in each row of trainingSamples, this is numFeatures rounded up to an even number
+    vector< double > trainingSamples;           ///> The (scaled) training samples packed into one row-major block
+    vector< double > trainingSampleNorms;       ///> The magnitude of each training sample, used by the cosine distance
+};
+
 class KNN : public Classifier
 {
 public:
@@ -98,7 +120,20 @@ public:
      @param vector< double > inputVector: the input vector to classify
      @return returns true if the prediction was performed, false otherwise
     */
-    virtual bool predict(vector< double > inputVector);
+    virtual bool predict(const vector< double > &inputVector);
+    
+    /**
+     This predicts the class of each row of the inputData.  If the spatial index is not used then the rows are scored in tiles
+     against blocks of the training samples, so each block is read from memory once per tile of rows rather than once per row.
+     This overrides the predictBatch function in the Classifier base class.
+     
+     @param const Matrix<double> &inputData: the input vectors to classify, with one vector per row
+     @param vector< UINT > &predictedClassLabels: returns the predicted class label of each row
+     @param Matrix<double> &likelihoods: returns the class likelihoods of each row
+     @param Matrix<double> &distances: returns the class distances of each row
+     @return returns true if the prediction was performed, false otherwise
+    */
+    virtual bool predictBatch(const Matrix<double> &inputData,vector< UINT > &predictedClassLabels,Matrix<double> &likelihoods,Matrix<double> &distances);
     
     /**
      This saves the trained KNN model to a file.
@@ -136,6 +171,27 @@ public:
      */
     virtual bool loadModelFromFile(fstream &file);
     
+    /**
+     This saves the trained KNN model to a binary file, the training samples are written as one block so they are not parsed when loaded.
+     This overrides the saveModelToBinaryFile function in the MLBase base class.
+     
+     @param fstream &file: a reference to the binary file the KNN model will be saved to
+     @return returns true if the model was saved successfully, false otherwise
+     */
+    virtual bool saveModelToBinaryFile(fstream &file);
+    
+    /**
+     This loads a trained KNN model saved by saveModelToBinaryFile.
+     This overrides the loadModelFromBinaryData function in the MLBase base class.
+     
+     @param const char *data: a pointer to the start of the model
+     @param unsigned long long size: the size of the model in bytes
+     @return returns true if the model was loaded successfully, false otherwise
+     */
+    virtual bool loadModelFromBinaryData(const char *data,unsigned long long size);
+    
+    virtual bool getSupportsBinaryModel() const{ return true; }
+    
     /**
      This recomputes the null rejection thresholds for each of the classes in the KNN model.
      This will be called automatically if the setGamma(double gamma) function is called.
@@ -162,6 +218,13 @@ public:
     */
     UINT getDistanceMethod(){ return distanceMethod; }
     
+    /**
+     Returns true if a KD-tree of the training data will be used to find the nearest neighbours.
+     
+     @return returns true if the spatial index is enabled, false otherwise
+    */
+    bool getSpatialIndexEnabled(){ return useSpatialIndex; }
+    
     //Setters
     /**
      Sets the K nearest neighbours that will be searched for by the algorithm during prediction.
@@ -196,6 +259,21 @@ public:
      */
     bool enableBestKValueSearch(bool searchForBestKValue);
     
+    /**
+     Sets the number of threads used to score the test samples when searching for the best K value.
+     If numTrainingThreads is 0 then one thread is used per CPU core.
+     
+     @return returns true if the number of training threads was set successfully, false otherwise
+     */
+    bool setNumTrainingThreads(UINT numTrainingThreads);
+    
+    /**
+     Gets the number of threads used to score the test samples when searching for the best K value, 0 means one thread per CPU core.
+     
+     @return returns the number of training threads
+     */
+    UINT getNumTrainingThreads(){ return numTrainingThreads; }
+    
     /**
      Sets the nullRejectionCoeff parameter.
      The nullRejectionCoeff parameter is a multipler controlling the null rejection threshold for each class.
@@ -213,10 +291,25 @@ public:
      @return returns true if the distance method was updated successfully, false otherwise
      */
     bool setDistanceMethod(UINT distanceMethod);
+    
+    /**
+     Sets if a KD-tree of the training data should be built when the model is trained.  The KD-tree lets the prediction find the
+     K nearest neighbours without computing the distance to every training sample, and is saved with the model so it is not
+     rebuilt when the model is loaded.  If disabled, the prediction scans all the training samples.
+     This should be called prior to training a KNN model.  The spatial index is enabled by default.
+     
+     @return returns true if the spatial index option was updated successfully, false otherwise
+     */
+    bool enableSpatialIndex(bool useSpatialIndex);
 
 protected:
     bool train_(LabelledClassificationData &trainingData,UINT K);
-    bool predict(vector< double > inputVector,UINT K);
+    bool predict(const vector< double > &inputVector,UINT K);
+    bool predictFromNeighbours(vector< IndexedDouble > &neighbours);
+    bool searchNeighbours(const vector< double > &inputVector,UINT K,vector< IndexedDouble > &neighbours,vector< double > &queryBuffer);
+    bool packTrainingSamples(KNNModel &trainedModel);
+    bool searchTrainingSamples(const double *query,double queryNorm,UINT startIndex,UINT endIndex,UINT K,vector< IndexedDouble > &neighbours);
+    void sortNeighbours(vector< IndexedDouble > &neighbours);
     void clear();
     double computeEuclideanDistance(vector< double > &a,vector< double > &b);
     double computeCosineDistance(vector< double > &a,vector< double > &b);
@@ -227,13 +320,20 @@ protected:
     bool searchForBestKValue;                   ///> Sets if the best K value should be searched for or if the model should be trained with K
     UINT minKSearchValue;                       ///> The minimum K value to start the search from
     UINT maxKSearchValue;                       ///> The maximum K value to end the search at
-    LabelledClassificationData trainingData;    ///> Holds the trainingData to perform the predictions
+    UINT numTrainingThreads;                    ///> The number of threads used by the K search (0 = one per CPU core)
+    bool useSpatialIndex;                       ///> Sets if a KD-tree should be built to find the nearest neighbours
     vector< double > trainingMu;                ///> Holds the average max-class distance of the training data for each of classes
     vector< double > trainingSigma;             ///> Holds the stddev of the max-class distance of the training data for each of classes
     vector< double > rejectionThresholds;       ///> Holds the rejection threshold for each of the classes
+    SharedModel< KNNModel > model;              ///> The training data, KD-tree and packed training samples, shared with any copies of this KNN
+    vector< double > queryBuffer;               ///> A padded copy of the input vector for the linear search
+    vector< double > scaledInputVector;         ///> A buffer for the scaled input vector
+    vector< IndexedDouble > neighbours;         ///> A buffer for the K nearest neighbours found by the prediction
     
     static RegisterClassifierModule< KNN > registerModule;
     
+    friend class KNNKSearchJob;
+    
 public:
     enum DistanceMethods{EUCLIDEAN_DISTANCE=0,COSINE_DISTANCE,MANHATTAN_DISTANCE};
 	
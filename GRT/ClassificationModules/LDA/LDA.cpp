@@ -184,7 +184,7 @@ bool LDA::train(LabelledClassificationData &trainingData){
 /* double predict(vector<double> x)
  This method returns the ID of the most likely class given the observation x and the trained models
  */
-bool LDA::predict(vector< double > inputVector){
+bool LDA::predict(const vector< double > &inputVector){
     
     if( !trained ){
         errorLog << "predict(vector< double > inputVector) - LDA Model Not Trained!" << endl;
@@ -207,17 +207,60 @@ bool LDA::predict(vector< double > inputVector){
         classDistances.resize(numClasses);
     }
     
-    //Compute the linear scores for each class
+    //Compute the linear scores for each class, the first weight is the bias
+    for(UINT k=0; k<numClasses; k++){
+        classDistances[k] = models[k].weights[0] + DistanceKernels::dot(&inputVector[0],&models[k].weights[1],numFeatures);
+    }
+    
+    return predictFromClassDistances();
+}
+    
+bool LDA::predictBatch(const Matrix<double> &inputData,vector< UINT > &predictedClassLabels,Matrix<double> &likelihoods,Matrix<double> &distances){
+    
+    if( !trained ){
+        errorLog << "predictBatch(const Matrix<double> &inputData,...) - LDA Model Not Trained!" << endl;
+        return false;
+    }
+    
+    if( inputData.getNumCols() != numFeatures ){
+        errorLog << "predictBatch(const Matrix<double> &inputData,...) - The number of columns in the input data (" << inputData.getNumCols() << ") does not match the num features in the model (" << numFeatures << endl;
+        return false;
+    }
+    
+    const UINT M = inputData.getNumRows();
+    predictedClassLabels.resize( M );
+    likelihoods.resize( M, numClasses );
+    distances.resize( M, numClasses );
+    
+    for(UINT k=0; k<numClasses; k++){
+        const double bias = models[k].weights[0];
+        const double *weights = &models[k].weights[1];
+        for(UINT i=0; i<M; i++){
+            distances[i][k] = bias + DistanceKernels::dot(inputData[i],weights,numFeatures);
+        }
+    }
+    
+    if( classLikelihoods.size() != numClasses || classDistances.size() != numClasses ){
+        classLikelihoods.resize(numClasses);
+        classDistances.resize(numClasses);
+    }
+    
+    for(UINT i=0; i<M; i++){
+        std::copy(distances[i],distances[i]+numClasses,classDistances.begin());
+        predictFromClassDistances();
+        storeBatchPrediction(i,predictedClassLabels,likelihoods,distances);
+    }
+    
+    return true;
+}
+    
+bool LDA::predictFromClassDistances(){
+    
     bestDistance = 0;
     maxLikelihood = 0;
     UINT bestIndex = 0;
     double sum = 0;
     for(UINT k=0; k<numClasses; k++){
-        
-        for(UINT j=0; j<numFeatures+1; j++){
-            if( j==0 ) classDistances[k] = models[k].weights[j];
-            else classDistances[k] += inputVector[j-1] * models[k].weights[j];
-        }
         classLikelihoods[k] = exp( classDistances[k] );
         sum += classLikelihoods[k];
         
@@ -31,6 +31,7 @@
 
 #include "../../GestureRecognitionPipeline/Classifier.h"
 #include "../../Util/LUdcmp.h"
+#include "../../Util/DistanceKernels.h"
 
 namespace GRT{
     
@@ -122,7 +123,20 @@ public:
      @param vector< double > inputVector: the input vector to classify
      @return returns true if the prediction was performed, false otherwise
     */
-    virtual bool predict(vector< double > inputVector);
+    virtual bool predict(const vector< double > &inputVector);
+    
+    /**
+     This predicts the class of each row of the inputData.  The linear score of each class is computed for all the rows before
+     moving on to the next class, so the weights of each class are only loaded into the cache once.
+     This overrides the predictBatch function in the Classifier base class.
+     
+     @param const Matrix<double> &inputData: the input vectors to classify, with one vector per row
+     @param vector< UINT > &predictedClassLabels: returns the predicted class label of each row
+     @param Matrix<double> &likelihoods: returns the class likelihoods of each row
+     @param Matrix<double> &distances: returns the class distances of each row
+     @return returns true if the prediction was performed, false otherwise
+    */
+    virtual bool predictBatch(const Matrix<double> &inputData,vector< UINT > &predictedClassLabels,Matrix<double> &likelihoods,Matrix<double> &distances);
     
     /**
      This saves the trained LDA model to a file.
@@ -167,6 +181,8 @@ public:
 
 
 private:
+    bool predictFromClassDistances();
+    
     vector< LDAClassModel > models;
 };
 
@@ -1,9 +1,20 @@
 
 #include "libsvm.h"
+#include "../../../Util/ParallelFor.h"
 
 int libsvm_version = LIBSVM_VERSION;
 typedef float Qfloat;
 typedef signed char schar;
+
+// A small LCG used in place of rand() by the random shuffles, each shuffle gets its own seed (drawn from rand() before the
+// sub-problems are trained) so the shuffles do not depend on the order in which the threads run
+static inline int svm_rand(unsigned int &seed)
+{
+	seed = seed*1103515245u + 12345u;
+	int hi = (seed >> 16) & 0x7fff;
+	seed = seed*1103515245u + 12345u;
+	return (hi << 15) | ((seed >> 16) & 0x7fff);
+}
 #ifndef min
 template <class T> static inline T min(T x,T y) { return (x<y)?x:y; }
 #endif
@@ -210,6 +221,14 @@ protected:
 
 	double (Kernel::*kernel_function)(int i, int j) const;
 
+	// number of threads used to compute a kernel column (0 = one per core)
+	const int nr_thread;
+
+	// the fewest kernel evaluations worth giving a thread when a column is computed in parallel
+	unsigned int column_min_tasks_per_thread;
+
+	void compute_column(int i, int start, int len, Qfloat *data, const schar *y) const;
+
 private:
 	const svm_node **x;
 	double *x_square;
@@ -244,7 +263,7 @@ private:
 };
 
 Kernel::Kernel(int l, svm_node * const * x_, const svm_parameter& param)
-:kernel_type(param.kernel_type), degree(param.degree),
+:nr_thread(param.nr_thread), kernel_type(param.kernel_type), degree(param.degree),
  gamma(param.gamma), coef0(param.coef0)
 {
 	switch(kernel_type)
@@ -268,6 +287,15 @@ Kernel::Kernel(int l, svm_node * const * x_, const svm_parameter& param)
 
 	clone(x,x_,l);
 
+	// a kernel evaluation walks the features of both samples, so the work in each entry of a column is about twice the
+	// average number of features, this sets how long a column has to be before it is split over several threads
+	unsigned long long nr_node = 0;
+	if(kernel_type != PRECOMPUTED)
+		for(int i=0;i<l;i++)
+			for(const svm_node *px = x[i]; px->index != -1; px++)
+				nr_node++;
+	column_min_tasks_per_thread = GRT::ParallelFor::getMinTasksPerThread(l > 0 ? 2*nr_node/l + 1 : 1);
+
 	if(kernel_type == RBF)
 	{
 		x_square = new double[l];
@@ -284,6 +312,42 @@ Kernel::~Kernel()
 	delete[] x_square;
 }
 
+// Computes data[j] = y[i]*y[j]*K(i,j) for one block of a kernel column
+class KernelColumnJob : public GRT::ParallelJob
+{
+public:
+	KernelColumnJob(const Kernel *kernel, double (Kernel::*kernel_function)(int i, int j) const, int i, int start, Qfloat *data, const schar *y)
+	:kernel(kernel), kernel_function(kernel_function), i(i), start(start), data(data), y(y) {}
+
+	void run(unsigned int /*threadIndex*/, unsigned int startIndex, unsigned int endIndex)
+	{
+		int end = start + (int)endIndex;
+		for(int j=start+(int)startIndex;j<end;j++)
+			data[j] = (Qfloat)(y[i]*y[j]*(kernel->*kernel_function)(i,j));
+	}
+
+private:
+	const Kernel *kernel;
+	double (Kernel::*kernel_function)(int i, int j) const;
+	int i, start;
+	Qfloat *data;
+	const schar *y;
+};
+
+// The kernel functions only read x and x_square, so the entries of a column can be computed by several threads at once
+void Kernel::compute_column(int i, int start, int len, Qfloat *data, const schar *y) const
+{
+	unsigned int nr_column_thread = nr_thread == 1 || len <= start ? 1 : GRT::ParallelFor::getNumThreads((unsigned int)(len-start),(unsigned int)nr_thread,column_min_tasks_per_thread);
+	if(nr_column_thread > 1)
+	{
+		KernelColumnJob job(this,kernel_function,i,start,data,y);
+		GRT::ParallelFor::run(job,(unsigned int)(len-start),nr_column_thread);
+		return;
+	}
+	for(int j=start;j<len;j++)
+		data[j] = (Qfloat)(y[i]*y[j]*(this->*kernel_function)(i,j));
+}
+
 double Kernel::dot(const svm_node *px, const svm_node *py)
 {
 	double sum = 0;
@@ -1272,12 +1336,9 @@ public:
 	Qfloat *get_Q(int i, int len) const
 	{
 		Qfloat *data;
-		int start, j;
+		int start;
 		if((start = cache->get_data(i,&data,len)) < len)
-		{
-			for(j=start;j<len;j++)
-				data[j] = (Qfloat)(y[i]*y[j]*(this->*kernel_function)(i,j));
-		}
+			compute_column(i,start,len,data,y);
 		return data;
 	}
 
@@ -1819,28 +1880,26 @@ static double sigmoid_predict(double decision_value, double A, double B)
 }
 
 // Method 2 from the multiclass_prob paper by Wu, Lin, and Weng
-static void multiclass_probability(int k, double **r, double *p)
+// r and Q are k*k row major arrays and Qp holds k values, all are owned by the caller
+static void multiclass_probability(int k, const double *r, double *p, double *Q, double *Qp)
 {
 	int t,j;
 	int iter = 0, max_iter=std::max(100,k);
-	double **Q=Malloc(double *,k);
-	double *Qp=Malloc(double,k);
 	double pQp, eps=0.005/k;
 	
 	for (t=0;t<k;t++)
 	{
 		p[t]=1.0/k;  // Valid if k = 1
-		Q[t]=Malloc(double,k);
-		Q[t][t]=0;
+		Q[t*k+t]=0;
 		for (j=0;j<t;j++)
 		{
-			Q[t][t]+=r[j][t]*r[j][t];
-			Q[t][j]=Q[j][t];
+			Q[t*k+t]+=r[j*k+t]*r[j*k+t];
+			Q[t*k+j]=Q[j*k+t];
 		}
 		for (j=t+1;j<k;j++)
 		{
-			Q[t][t]+=r[j][t]*r[j][t];
-			Q[t][j]=-r[j][t]*r[t][j];
+			Q[t*k+t]+=r[j*k+t]*r[j*k+t];
+			Q[t*k+j]=-r[j*k+t]*r[t*k+j];
 		}
 	}
 	for (iter=0;iter<max_iter;iter++)
@@ -1851,7 +1910,7 @@ static void multiclass_probability(int k, double **r, double *p)
 		{
 			Qp[t]=0;
 			for (j=0;j<k;j++)
-				Qp[t]+=Q[t][j]*p[j];
+				Qp[t]+=Q[t*k+j]*p[j];
 			pQp+=p[t]*Qp[t];
 		}
 		double max_error=0;
@@ -1865,27 +1924,26 @@ static void multiclass_probability(int k, double **r, double *p)
 		
 		for (t=0;t<k;t++)
 		{
-			double diff=(-Qp[t]+pQp)/Q[t][t];
+			double diff=(-Qp[t]+pQp)/Q[t*k+t];
 			p[t]+=diff;
-			pQp=(pQp+diff*(diff*Q[t][t]+2*Qp[t]))/(1+diff)/(1+diff);
+			pQp=(pQp+diff*(diff*Q[t*k+t]+2*Qp[t]))/(1+diff)/(1+diff);
 			for (j=0;j<k;j++)
 			{
-				Qp[j]=(Qp[j]+diff*Q[t][j])/(1+diff);
+				Qp[j]=(Qp[j]+diff*Q[t*k+j])/(1+diff);
 				p[j]/=(1+diff);
 			}
 		}
 	}
 	if (iter>=max_iter)
 		info("Exceeds max_iter in multiclass_prob\n");
-	for(t=0;t<k;t++) free(Q[t]);
-	free(Q);
-	free(Qp);
 }
 
+static svm_model *svm_train_seeded(const svm_problem *prob, const svm_parameter *param, unsigned int train_seed);
+
 // Cross-validation decision values for probability estimates
 static void svm_binary_svc_probability(
 	const svm_problem *prob, const svm_parameter *param,
-	double Cp, double Cn, double& probA, double& probB)
+	double Cp, double Cn, double& probA, double& probB, unsigned int seed)
 {
 	int i;
 	int nr_fold = 5;
@@ -1896,7 +1954,7 @@ static void svm_binary_svc_probability(
 	for(i=0;i<prob->l;i++) perm[i]=i;
 	for(i=0;i<prob->l;i++)
 	{
-		int j = i+rand()%(prob->l-i);
+		int j = i+svm_rand(seed)%(prob->l-i);
 		std::swap(perm[i],perm[j]);
 	}
 	for(i=0;i<nr_fold;i++)
@@ -1951,7 +2009,7 @@ static void svm_binary_svc_probability(
 			subparam.weight_label[1]=-1;
 			subparam.weight[0]=Cp;
 			subparam.weight[1]=Cn;
-			struct svm_model *submodel = svm_train(&subprob,&subparam);
+			struct svm_model *submodel = svm_train_seeded(&subprob,&subparam,seed);
 			for(j=begin;j<end;j++)
 			{
 				svm_predict_values(submodel,prob->x[perm[j]],&(dec_values[perm[j]])); 
@@ -2064,7 +2122,60 @@ static void svm_group_classes(const svm_problem *prob, int *nr_class_ret, int **
 //
 // Interface functions
 //
-svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
+// Trains the one-vs-one sub-problems [startIndex endIndex), each sub-problem only writes its own f, probA and probB entries
+class SVCPairJob : public GRT::ParallelJob
+{
+public:
+	SVCPairJob(svm_node **x, const int *start, const int *count, const double *weighted_C, const int *pair_i, const int *pair_j,
+		const unsigned int *seed, const svm_parameter *param, decision_function *f, double *probA, double *probB)
+	:x(x), start(start), count(count), weighted_C(weighted_C), pair_i(pair_i), pair_j(pair_j), seed(seed), param(param),
+	 f(f), probA(probA), probB(probB) {}
+
+	void run(unsigned int /*threadIndex*/, unsigned int startIndex, unsigned int endIndex)
+	{
+		for(unsigned int p=startIndex;p<endIndex;p++)
+		{
+			int i = pair_i[p], j = pair_j[p];
+			svm_problem sub_prob;
+			int si = start[i], sj = start[j];
+			int ci = count[i], cj = count[j];
+			sub_prob.l = ci+cj;
+			sub_prob.x = Malloc(svm_node *,sub_prob.l);
+			sub_prob.y = Malloc(double,sub_prob.l);
+			int k;
+			for(k=0;k<ci;k++)
+			{
+				sub_prob.x[k] = x[si+k];
+				sub_prob.y[k] = +1;
+			}
+			for(k=0;k<cj;k++)
+			{
+				sub_prob.x[ci+k] = x[sj+k];
+				sub_prob.y[ci+k] = -1;
+			}
+
+			if(param->probability)
+				svm_binary_svc_probability(&sub_prob,param,weighted_C[i],weighted_C[j],probA[p],probB[p],seed[p]);
+
+			f[p] = svm_train_one(&sub_prob,param,weighted_C[i],weighted_C[j]);
+			free(sub_prob.x);
+			free(sub_prob.y);
+		}
+	}
+
+private:
+	svm_node **x;
+	const int *start, *count;
+	const double *weighted_C;
+	const int *pair_i, *pair_j;
+	const unsigned int *seed;
+	const svm_parameter *param;
+	decision_function *f;
+	double *probA, *probB;
+};
+
+// train_seed is used to draw the shuffle seed of each sub-problem, so the training is deterministic for any number of threads
+static svm_model *svm_train_seeded(const svm_problem *prob, const svm_parameter *param, unsigned int train_seed)
 {
 	svm_model *model = Malloc(svm_model,1);
 	model->param = *param;
@@ -2162,43 +2273,49 @@ svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
 			probB=Malloc(double,nr_class*(nr_class-1)/2);
 		}
 
+		// the sub-problems are independent, so they are trained by up to nr_thread threads, each thread gets an equal
+		// share of the kernel cache and computes its kernel columns itself
+		int nr_pair = nr_class*(nr_class-1)/2;
+		unsigned int nr_pair_thread = GRT::ParallelFor::getNumThreads(nr_pair,param->nr_thread);
+		svm_parameter pair_param = *param;
+		if(nr_pair_thread > 1)
+		{
+			pair_param.nr_thread = 1;
+			pair_param.cache_size = param->cache_size/nr_pair_thread;
+		}
+
+		int *pair_i = Malloc(int,nr_pair);
+		int *pair_j = Malloc(int,nr_pair);
+		unsigned int *seed = Malloc(unsigned int,nr_pair);
 		int p = 0;
 		for(i=0;i<nr_class;i++)
 			for(int j=i+1;j<nr_class;j++)
 			{
-				svm_problem sub_prob;
-				int si = start[i], sj = start[j];
-				int ci = count[i], cj = count[j];
-				sub_prob.l = ci+cj;
-				sub_prob.x = Malloc(svm_node *,sub_prob.l);
-				sub_prob.y = Malloc(double,sub_prob.l);
-				int k;
-				for(k=0;k<ci;k++)
-				{
-					sub_prob.x[k] = x[si+k];
-					sub_prob.y[k] = +1;
-				}
-				for(k=0;k<cj;k++)
-				{
-					sub_prob.x[ci+k] = x[sj+k];
-					sub_prob.y[ci+k] = -1;
-				}
-
-				if(param->probability)
-					svm_binary_svc_probability(&sub_prob,param,weighted_C[i],weighted_C[j],probA[p],probB[p]);
-
-				f[p] = svm_train_one(&sub_prob,param,weighted_C[i],weighted_C[j]);
-				for(k=0;k<ci;k++)
-					if(!nonzero[si+k] && fabs(f[p].alpha[k]) > 0)
-						nonzero[si+k] = true;
-				for(k=0;k<cj;k++)
-					if(!nonzero[sj+k] && fabs(f[p].alpha[ci+k]) > 0)
-						nonzero[sj+k] = true;
-				free(sub_prob.x);
-				free(sub_prob.y);
+				pair_i[p] = i;
+				pair_j[p] = j;
+				seed[p] = (unsigned int)svm_rand(train_seed);
 				++p;
 			}
 
+		SVCPairJob job(x,start,count,weighted_C,pair_i,pair_j,seed,&pair_param,f,probA,probB);
+		GRT::ParallelFor::run(job,nr_pair,nr_pair_thread);
+
+		for(p=0;p<nr_pair;p++)
+		{
+			int si = start[pair_i[p]], sj = start[pair_j[p]];
+			int ci = count[pair_i[p]], cj = count[pair_j[p]];
+			int k;
+			for(k=0;k<ci;k++)
+				if(!nonzero[si+k] && fabs(f[p].alpha[k]) > 0)
+					nonzero[si+k] = true;
+			for(k=0;k<cj;k++)
+				if(!nonzero[sj+k] && fabs(f[p].alpha[ci+k]) > 0)
+					nonzero[sj+k] = true;
+		}
+		free(pair_i);
+		free(pair_j);
+		free(seed);
+
 		// build output
 
 		model->nr_class = nr_class;
@@ -2303,6 +2420,71 @@ svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
 	return model;
 }
 
+svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
+{
+	return svm_train_seeded(prob,param,(unsigned int)rand());
+}
+
+// Trains the cross validation folds [startIndex endIndex) and predicts the held out samples of each fold into target
+class CrossValidationFoldJob : public GRT::ParallelJob
+{
+public:
+	CrossValidationFoldJob(const svm_problem *prob, const svm_parameter *param, const int *fold_start, const int *perm, const unsigned int *seed, double *target)
+	:prob(prob), param(param), fold_start(fold_start), perm(perm), seed(seed), target(target) {}
+
+	void run(unsigned int /*threadIndex*/, unsigned int startIndex, unsigned int endIndex)
+	{
+		int l = prob->l;
+		for(unsigned int i=startIndex;i<endIndex;i++)
+		{
+			int begin = fold_start[i];
+			int end = fold_start[i+1];
+			int j,k;
+			struct svm_problem subprob;
+
+			subprob.l = l-(end-begin);
+			subprob.x = Malloc(struct svm_node*,subprob.l);
+			subprob.y = Malloc(double,subprob.l);
+
+			k=0;
+			for(j=0;j<begin;j++)
+			{
+				subprob.x[k] = prob->x[perm[j]];
+				subprob.y[k] = prob->y[perm[j]];
+				++k;
+			}
+			for(j=end;j<l;j++)
+			{
+				subprob.x[k] = prob->x[perm[j]];
+				subprob.y[k] = prob->y[perm[j]];
+				++k;
+			}
+			struct svm_model *submodel = svm_train_seeded(&subprob,param,seed[i]);
+			if(param->probability && 
+			   (param->svm_type == C_SVC || param->svm_type == NU_SVC))
+			{
+				double *prob_estimates=Malloc(double,svm_get_nr_class(submodel));
+				for(j=begin;j<end;j++)
+					target[perm[j]] = svm_predict_probability(submodel,prob->x[perm[j]],prob_estimates);
+				free(prob_estimates);
+			}
+			else
+				for(j=begin;j<end;j++)
+					target[perm[j]] = svm_predict(submodel,prob->x[perm[j]]);
+			svm_free_and_destroy_model(&submodel);
+			free(subprob.x);
+			free(subprob.y);
+		}
+	}
+
+private:
+	const svm_problem *prob;
+	const svm_parameter *param;
+	const int *fold_start, *perm;
+	const unsigned int *seed;
+	double *target;
+};
+
 // Stratified cross validation
 void svm_cross_validation(const svm_problem *prob, const svm_parameter *param, int nr_fold, double *target)
 {
@@ -2375,46 +2557,20 @@ void svm_cross_validation(const svm_problem *prob, const svm_parameter *param, i
 			fold_start[i]=i*l/nr_fold;
 	}
 
-	for(i=0;i<nr_fold;i++)
+	// the folds are independent, so they are trained by up to nr_thread threads, each with an equal share of the kernel cache
+	unsigned int nr_fold_thread = GRT::ParallelFor::getNumThreads(nr_fold,param->nr_thread);
+	svm_parameter fold_param = *param;
+	if(nr_fold_thread > 1)
 	{
-		int begin = fold_start[i];
-		int end = fold_start[i+1];
-		int j,k;
-		struct svm_problem subprob;
-
-		subprob.l = l-(end-begin);
-		subprob.x = Malloc(struct svm_node*,subprob.l);
-		subprob.y = Malloc(double,subprob.l);
-			
-		k=0;
-		for(j=0;j<begin;j++)
-		{
-			subprob.x[k] = prob->x[perm[j]];
-			subprob.y[k] = prob->y[perm[j]];
-			++k;
-		}
-		for(j=end;j<l;j++)
-		{
-			subprob.x[k] = prob->x[perm[j]];
-			subprob.y[k] = prob->y[perm[j]];
-			++k;
-		}
-		struct svm_model *submodel = svm_train(&subprob,param);
-		if(param->probability && 
-		   (param->svm_type == C_SVC || param->svm_type == NU_SVC))
-		{
-			double *prob_estimates=Malloc(double,svm_get_nr_class(submodel));
-			for(j=begin;j<end;j++)
-				target[perm[j]] = svm_predict_probability(submodel,prob->x[perm[j]],prob_estimates);
-			free(prob_estimates);			
-		}
-		else
-			for(j=begin;j<end;j++)
-				target[perm[j]] = svm_predict(submodel,prob->x[perm[j]]);
-		svm_free_and_destroy_model(&submodel);
-		free(subprob.x);
-		free(subprob.y);
-	}		
+		fold_param.nr_thread = 1;
+		fold_param.cache_size = param->cache_size/nr_fold_thread;
+	}
+	unsigned int *seed = Malloc(unsigned int,nr_fold);
+	for(i=0;i<nr_fold;i++)
+		seed[i] = (unsigned int)rand();
+	CrossValidationFoldJob job(prob,&fold_param,fold_start,perm,seed,target);
+	GRT::ParallelFor::run(job,nr_fold,nr_fold_thread);
+	free(seed);
 	free(fold_start);
 	free(perm);	
 }
@@ -2449,6 +2605,73 @@ double svm_get_svr_probability(const svm_model *model)
 	}
 }
 
+void svm_predict_kernel_values(const svm_model *model, const svm_node *x, double *kvalue)
+{
+	for(int i=0;i<model->l;i++)
+		kvalue[i] = Kernel::k_function(x,model->SV[i],model->param);
+}
+
+double svm_predict_values_from_kernel_values(const svm_model *model, const double *kvalue, double *dec_values, int *vote)
+{
+	int i;
+	int nr_class = model->nr_class;
+
+	int p=0;
+	int si = 0;
+	for(i=0;i<nr_class;i++)
+	{
+		int ci = model->nSV[i];
+		int sj = si+ci;
+		for(int j=i+1;j<nr_class;j++)
+		{
+			double sum = 0;
+			int cj = model->nSV[j];
+			
+			int k;
+			double *coef1 = model->sv_coef[j-1];
+			double *coef2 = model->sv_coef[i];
+			for(k=0;k<ci;k++)
+				sum += coef1[si+k] * kvalue[si+k];
+			for(k=0;k<cj;k++)
+				sum += coef2[sj+k] * kvalue[sj+k];
+			sum -= model->rho[p];
+			dec_values[p] = sum;
+			p++;
+			sj += cj;
+		}
+		si += ci;
+	}
+
+	return svm_predict_label_from_decision_values(model,dec_values,vote);
+}
+
+double svm_predict_label_from_decision_values(const svm_model *model, const double *dec_values, int *vote)
+{
+	int i;
+	int nr_class = model->nr_class;
+
+	for(i=0;i<nr_class;i++)
+		vote[i] = 0;
+
+	int p=0;
+	for(i=0;i<nr_class;i++)
+		for(int j=i+1;j<nr_class;j++)
+		{
+			if(dec_values[p] > 0)
+				++vote[i];
+			else
+				++vote[j];
+			p++;
+		}
+
+	int vote_max_idx = 0;
+	for(i=1;i<nr_class;i++)
+		if(vote[i] > vote[vote_max_idx])
+			vote_max_idx = i;
+
+	return model->label[vote_max_idx];
+}
+
 double svm_predict_values(const svm_model *model, const svm_node *x, double* dec_values)
 {
 	int i;
@@ -2470,58 +2693,15 @@ double svm_predict_values(const svm_model *model, const svm_node *x, double* dec
 	}
 	else
 	{
-		int nr_class = model->nr_class;
-		int l = model->l;
-		
-		double *kvalue = Malloc(double,l);
-		for(i=0;i<l;i++)
-			kvalue[i] = Kernel::k_function(x,model->SV[i],model->param);
-
-		int *start = Malloc(int,nr_class);
-		start[0] = 0;
-		for(i=1;i<nr_class;i++)
-			start[i] = start[i-1]+model->nSV[i-1];
-
-		int *vote = Malloc(int,nr_class);
-		for(i=0;i<nr_class;i++)
-			vote[i] = 0;
-
-		int p=0;
-		for(i=0;i<nr_class;i++)
-			for(int j=i+1;j<nr_class;j++)
-			{
-				double sum = 0;
-				int si = start[i];
-				int sj = start[j];
-				int ci = model->nSV[i];
-				int cj = model->nSV[j];
-				
-				int k;
-				double *coef1 = model->sv_coef[j-1];
-				double *coef2 = model->sv_coef[i];
-				for(k=0;k<ci;k++)
-					sum += coef1[si+k] * kvalue[si+k];
-				for(k=0;k<cj;k++)
-					sum += coef2[sj+k] * kvalue[sj+k];
-				sum -= model->rho[p];
-				dec_values[p] = sum;
+		double *kvalue = Malloc(double,model->l);
+		int *vote = Malloc(int,model->nr_class);
 
-				if(dec_values[p] > 0)
-					++vote[i];
-				else
-					++vote[j];
-				p++;
-			}
-
-		int vote_max_idx = 0;
-		for(i=1;i<nr_class;i++)
-			if(vote[i] > vote[vote_max_idx])
-				vote_max_idx = i;
+		svm_predict_kernel_values(model,x,kvalue);
+		double pred_result = svm_predict_values_from_kernel_values(model,kvalue,dec_values,vote);
 
 		free(kvalue);
-		free(start);
 		free(vote);
-		return model->label[vote_max_idx];
+		return pred_result;
 	}
 }
 
@@ -2540,40 +2720,52 @@ double svm_predict(const svm_model *model, const svm_node *x)
 	return pred_result;
 }
 
+int svm_probability_workspace_size(const svm_model *model)
+{
+	int nr_class = model->nr_class;
+	return 2*nr_class*nr_class + nr_class;
+}
+
+double svm_predict_probability_from_decision_values(
+	const svm_model *model, const double *dec_values, double *prob_estimates, double *workspace)
+{
+	int i;
+	int nr_class = model->nr_class;
+	double min_prob=1e-7;
+	double *pairwise_prob=workspace;
+	double *Q=pairwise_prob+nr_class*nr_class;
+	double *Qp=Q+nr_class*nr_class;
+	int k=0;
+	for(i=0;i<nr_class;i++)
+		for(int j=i+1;j<nr_class;j++)
+		{
+			pairwise_prob[i*nr_class+j]=std::min(std::max(sigmoid_predict(dec_values[k],model->probA[k],model->probB[k]),min_prob),1-min_prob);
+			pairwise_prob[j*nr_class+i]=1-pairwise_prob[i*nr_class+j];
+			k++;
+		}
+	multiclass_probability(nr_class,pairwise_prob,prob_estimates,Q,Qp);
+
+	int prob_max_idx = 0;
+	for(i=1;i<nr_class;i++)
+		if(prob_estimates[i] > prob_estimates[prob_max_idx])
+			prob_max_idx = i;
+	return model->label[prob_max_idx];
+}
+
 double svm_predict_probability(
 	const svm_model *model, const svm_node *x, double *prob_estimates)
 {
 	if ((model->param.svm_type == C_SVC || model->param.svm_type == NU_SVC) &&
 	    model->probA!=NULL && model->probB!=NULL)
 	{
-		int i;
 		int nr_class = model->nr_class;
 		double *dec_values = Malloc(double, nr_class*(nr_class-1)/2);
+		double *workspace = Malloc(double, svm_probability_workspace_size(model));
 		svm_predict_values(model, x, dec_values);
-
-		double min_prob=1e-7;
-		double **pairwise_prob=Malloc(double *,nr_class);
-		for(i=0;i<nr_class;i++)
-			pairwise_prob[i]=Malloc(double,nr_class);
-		int k=0;
-		for(i=0;i<nr_class;i++)
-			for(int j=i+1;j<nr_class;j++)
-			{
-				pairwise_prob[i][j]=std::min(std::max(sigmoid_predict(dec_values[k],model->probA[k],model->probB[k]),min_prob),1-min_prob);
-				pairwise_prob[j][i]=1-pairwise_prob[i][j];
-				k++;
-			}
-		multiclass_probability(nr_class,pairwise_prob,prob_estimates);
-
-		int prob_max_idx = 0;
-		for(i=1;i<nr_class;i++)
-			if(prob_estimates[i] > prob_estimates[prob_max_idx])
-				prob_max_idx = i;
-		for(i=0;i<nr_class;i++)
-			free(pairwise_prob[i]);
+		double pred_result = svm_predict_probability_from_decision_values(model, dec_values, prob_estimates, workspace);
 		free(dec_values);
-		free(pairwise_prob);	     
-		return model->label[prob_max_idx];
+		free(workspace);
+		return pred_result;
 	}
 	else 
 		return svm_predict(model, x);
@@ -2716,6 +2908,7 @@ svm_model *svm_load_model(const char *model_file_name)
 
 	svm_model *model = Malloc(svm_model,1);
 	svm_parameter& param = model->param;
+	param.nr_thread = 0;
 	model->rho = NULL;
 	model->probA = NULL;
 	model->probB = NULL;
@@ -2919,6 +3112,87 @@ svm_model *svm_load_model(const char *model_file_name)
 	return model;
 }
 
+svm_model *svm_copy_model(const svm_model *model)
+{
+	if(model == NULL) return NULL;
+
+	int i;
+	int l = model->l;
+	int nr_class = model->nr_class;
+	int nr_coef = (model->param.svm_type == ONE_CLASS ||
+		       model->param.svm_type == EPSILON_SVR ||
+		       model->param.svm_type == NU_SVR) ? 1 : nr_class*(nr_class-1)/2;
+
+	svm_model *copy = Malloc(svm_model,1);
+	*copy = *model;
+	copy->SV = NULL;
+	copy->sv_coef = NULL;
+	copy->rho = NULL;
+	copy->probA = NULL;
+	copy->probB = NULL;
+	copy->label = NULL;
+	copy->nSV = NULL;
+
+	// The SVs are copied into one block (as svm_load_model does) so the copy always owns its SVs
+	if(model->SV != NULL)
+	{
+		int num_nodes = 0;
+		for(i=0;i<l;i++)
+		{
+			const svm_node *p = model->SV[i];
+			while(p->index != -1) { ++p; ++num_nodes; }
+			++num_nodes;
+		}
+		copy->SV = Malloc(svm_node*,l);
+		svm_node *x_space = l > 0 ? Malloc(svm_node,num_nodes) : NULL;
+		for(i=0;i<l;i++)
+		{
+			const svm_node *p = model->SV[i];
+			copy->SV[i] = x_space;
+			while(p->index != -1) *x_space++ = *p++;
+			*x_space++ = *p;
+		}
+		copy->free_sv = 1;
+	}
+
+	if(model->sv_coef != NULL)
+	{
+		copy->sv_coef = Malloc(double *,nr_class-1);
+		for(i=0;i<nr_class-1;i++)
+		{
+			copy->sv_coef[i] = Malloc(double,l);
+			memcpy(copy->sv_coef[i],model->sv_coef[i],sizeof(double)*l);
+		}
+	}
+	if(model->rho != NULL)
+	{
+		copy->rho = Malloc(double,nr_coef);
+		memcpy(copy->rho,model->rho,sizeof(double)*nr_coef);
+	}
+	if(model->probA != NULL)
+	{
+		copy->probA = Malloc(double,nr_coef);
+		memcpy(copy->probA,model->probA,sizeof(double)*nr_coef);
+	}
+	if(model->probB != NULL)
+	{
+		copy->probB = Malloc(double,nr_coef);
+		memcpy(copy->probB,model->probB,sizeof(double)*nr_coef);
+	}
+	if(model->label != NULL)
+	{
+		copy->label = Malloc(int,nr_class);
+		memcpy(copy->label,model->label,sizeof(int)*nr_class);
+	}
+	if(model->nSV != NULL)
+	{
+		copy->nSV = Malloc(int,nr_class);
+		memcpy(copy->nSV,model->nSV,sizeof(int)*nr_class);
+	}
+
+	return copy;
+}
+
 void svm_free_model_content(svm_model* model_ptr)
 {
 	if(model_ptr->free_sv && model_ptr->l > 0 && model_ptr->SV != NULL)
@@ -3000,6 +3274,9 @@ const char *svm_check_parameter(const svm_problem *prob, const svm_parameter *pa
 	if(param->cache_size <= 0)
 		return "cache_size <= 0";
 
+	if(param->nr_thread < 0)
+		return "nr_thread < 0";
+
 	if(param->eps <= 0)
 		return "eps <= 0";
 
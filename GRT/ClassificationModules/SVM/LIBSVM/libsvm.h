@@ -55,6 +55,7 @@ struct svm_parameter
 	double p;	/* for EPSILON_SVR */
 	int shrinking;	/* use the shrinking heuristics */
 	int probability; /* do probability estimates */
+	int nr_thread;	/* number of training threads, 0 = one per CPU core */
 };
 
 //
@@ -96,6 +97,16 @@ double svm_predict_values(const struct svm_model *model, const struct svm_node *
 double svm_predict(const struct svm_model *model, const struct svm_node *x);
 double svm_predict_probability(const struct svm_model *model, const struct svm_node *x, double* prob_estimates);
 
+/* Prediction in steps with memory owned by the caller, kvalue holds model->l values, dec_values nr_class*(nr_class-1)/2, vote nr_class
+   and workspace svm_probability_workspace_size(model) values. These do not allocate so they can be used for every frame of a stream */
+void svm_predict_kernel_values(const struct svm_model *model, const struct svm_node *x, double *kvalue);
+double svm_predict_values_from_kernel_values(const struct svm_model *model, const double *kvalue, double *dec_values, int *vote);
+double svm_predict_label_from_decision_values(const struct svm_model *model, const double *dec_values, int *vote);
+int svm_probability_workspace_size(const struct svm_model *model);
+double svm_predict_probability_from_decision_values(const struct svm_model *model, const double *dec_values, double *prob_estimates, double *workspace);
+
+struct svm_model *svm_copy_model(const struct svm_model *model);
+
 void svm_free_model_content(struct svm_model *model_ptr);
 void svm_free_and_destroy_model(struct svm_model **model_ptr_ptr);
 void svm_destroy_param(struct svm_parameter *param);
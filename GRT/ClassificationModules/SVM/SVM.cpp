@@ -33,6 +33,8 @@ SVM::SVM(UINT kernelType,UINT svmType,bool useScaling,bool useNullRejection,bool
 	param.weight = NULL;
 	trained = false;
 	problemSet = false;
+    useDenseKernel = false;
+    useLinearWeights = false;
 	param.svm_type = C_SVC;
 	param.kernel_type = LINEAR_KERNEL;
 	param.degree = 3;
@@ -40,6 +42,7 @@ SVM::SVM(UINT kernelType,UINT svmType,bool useScaling,bool useNullRejection,bool
 	param.coef0 = 0;
 	param.nu = 0.5;
 	param.cache_size = 100;
+	param.nr_thread = 0;
 	param.C = 1;
 	param.eps = 1e-3;
 	param.p = 0.1;
@@ -67,21 +70,16 @@ SVM::SVM(UINT kernelType,UINT svmType,bool useScaling,bool useNullRejection,bool
     
 SVM::SVM(const SVM &rhs){
     classifierType = "SVM";
-    
-    //Copy the SVM variables
-    this->problemSet = rhs.problemSet;
-    this->model = rhs.model;
-    this->param = rhs.param;
-    this->prob = rhs.prob;
-    this->numFeatures = rhs.numFeatures;
-    this->kFoldValue = rhs.kFoldValue;
-    this->classificationThreshold = rhs.classificationThreshold;
-    this->crossValidationResult = rhs.crossValidationResult;
-    this->useAutoGamma = rhs.useAutoGamma;
-    this->useCrossValidation = rhs.useCrossValidation;
-    
-    //Copy the base class variables
-    copyBaseVariables(this,(Classifier*)&rhs);
+    classifierMode = STANDARD_CLASSIFIER_MODE;
+    model = NULL;
+    param.weight_label = NULL;
+    param.weight = NULL;
+    trained = false;
+    problemSet = false;
+    useDenseKernel = false;
+    useLinearWeights = false;
+    
+    *this = rhs;
 }
 
 
@@ -91,11 +89,12 @@ SVM::~SVM(){
     
 SVM& SVM::operator=(const SVM &rhs){
     if( this != &rhs ){
+        //Free any previous model, the model is deep copied so both SVMs can be trained or deleted independently
+        clear();
+        
         //SVM variables
-        this->problemSet = rhs.problemSet;
-        this->model = rhs.model;
+        this->model = svm_copy_model( rhs.model );
         this->param = rhs.param;
-        this->prob = rhs.prob;
         this->numFeatures = rhs.numFeatures;
         this->kFoldValue = rhs.kFoldValue;
         this->classificationThreshold = rhs.classificationThreshold;
@@ -105,6 +104,8 @@ SVM& SVM::operator=(const SVM &rhs){
         
         //Classifier variables
         copyBaseVariables(this,(Classifier*)&rhs);
+        
+        if( trained ) setupPredictionBuffers();
     }
     return *this;
 }
@@ -114,22 +115,8 @@ bool SVM::clone(const Classifier *classifier){
     
     if( this->getClassifierType() == classifier->getClassifierType() ){
         
-        SVM *ptr = (SVM*)classifier;
         //Clone the SVM values 
-        this->problemSet = ptr->problemSet;
-        this->model = ptr->model;
-        this->param = ptr->param;
-        this->prob = ptr->prob;
-        this->numFeatures = ptr->numFeatures;
-        this->kFoldValue = ptr->kFoldValue;
-        this->classificationThreshold = ptr->classificationThreshold;
-        this->crossValidationResult = ptr->crossValidationResult;
-        this->useAutoGamma = ptr->useAutoGamma;
-        this->useCrossValidation = ptr->useCrossValidation;
-        
-        //Clone the classifier variables
-        //Classifier variables
-        copyBaseVariables(this,classifier);
+        *this = *(const SVM*)classifier;
         return true;
     }
     return false;
@@ -166,7 +153,7 @@ bool SVM::train(LabelledClassificationData &trainingData){
     return true;
 }
 
-bool SVM::predict(vector< double > inputVector){
+bool SVM::predict(const vector< double > &inputVector){
     
     if( !trained ){
         errorLog << "predict(vector< double > inputVector) - The SVM model has not been trained!" << endl;
@@ -178,16 +165,40 @@ bool SVM::predict(vector< double > inputVector){
         return false;
     }
     
-    if( param.probability == 1 ){
-        if( !predict_( inputVector, maxLikelihood, classLikelihoods ) ){
-            errorLog << "predict(vector< double > inputVector) - Prediction Failed!" << endl;
-            return false;
-        }
-    }else{
-        if( !predict_( inputVector ) ){
-            errorLog << "predict(vector< double > inputVector) - Prediction Failed!" << endl;
+    if( !predict_( &inputVector[0] ) ){
+        errorLog << "predict(vector< double > inputVector) - Prediction Failed!" << endl;
+        return false;
+    }
+    
+    return true;
+}
+    
+bool SVM::predictBatch(const Matrix<double> &inputData,vector< UINT > &predictedClassLabels,Matrix<double> &likelihoods,Matrix<double> &distances){
+    
+    if( !trained ){
+        errorLog << "predictBatch(const Matrix<double> &inputData,...) - The SVM model has not been trained!" << endl;
+        return false;
+    }
+    
+    if( inputData.getNumCols() != numFeatures ){
+        errorLog << "predictBatch(const Matrix<double> &inputData,...) - The number of columns in the input data (" << inputData.getNumCols() << ") does not match the number of features of the model (" << numFeatures << ")" << endl;
+        return false;
+    }
+    
+    const UINT M = inputData.getNumRows();
+    const UINT K = getNumClasses();
+    predictedClassLabels.resize( M );
+    likelihoods.resize( M, K );
+    distances.resize( M, K );
+    likelihoods.setAllValues( 0 );
+    distances.setAllValues( 0 );
+    
+    for(UINT i=0; i<M; i++){
+        if( !predict_( inputData[i] ) ){
+            errorLog << "predictBatch(const Matrix<double> &inputData,...) - Prediction Failed for row: " << i << endl;
             return false;
         }
+        storeBatchPrediction(i,predictedClassLabels,likelihoods,distances);
     }
     
     return true;
@@ -197,7 +208,11 @@ void SVM::clear(){
 
 	crossValidationResult = 0;
 	trained = false;
+	useDenseKernel = false;
+	useLinearWeights = false;
 	svm_free_and_destroy_model(&model);
+	denseSupportVectors.clear();
+	linearWeights.clear();
 	svm_destroy_param(&param);
 	deleteProblemSet();
 	ranges.clear();
@@ -273,6 +288,7 @@ void SVM::initDefaultSVMSettings(){
 	param.coef0 = 0;
 	param.nu = 0.5;
 	param.cache_size = 100;
+	param.nr_thread = 0;
 	param.C = 1;
 	param.eps = 1e-3;
 	param.p = 0.1;
@@ -369,98 +385,189 @@ bool SVM::trainSVM(){
             for(UINT k=0; k<getNumClasses(); k++){
                 classLabels[k] = model->label[k];
             }
+            
+            setupPredictionBuffers();
 		}
 
 		return trained;
 }
     
-bool SVM::predict_(vector<double> inputVector){
+bool SVM::predict_(const double *inputVector){
 
-		if( !trained || inputVector.size() != numFeatures ) return false;
+		if( !trained ) return false;
 
-		svm_node *x = NULL;
-
-		//Copy the input data into the SVM format
-		x = new svm_node[numFeatures+1];
+		//Scale the input data if required, the kernels are then computed from the scaled input
 		for(UINT j=0; j<numFeatures; j++){
-			x[j].index = (int)j+1;
-			x[j].value = inputVector[j];
+			if( useScaling ) predictionInput[j] = scale(inputVector[j],ranges[j].minValue,ranges[j].maxValue,SVM_MIN_SCALE_RANGE,SVM_MAX_SCALE_RANGE);
+			else predictionInput[j] = inputVector[j];
 		}
-		//The last value in the input vector must be set to -1
-		x[numFeatures].index = -1;
-		x[numFeatures].value = 0;
 
-		//Scale the input data if required
-		if( useScaling ){
-			for(UINT i=0; i<numFeatures; i++)
-				x[i].value = scale(x[i].value,ranges[i].minValue,ranges[i].maxValue,SVM_MIN_SCALE_RANGE,SVM_MAX_SCALE_RANGE);
+		//The one class and regression models are not split into one-vs-one sub-problems, so they are predicted by LIBSVM directly
+		if( model->param.svm_type != C_SVC && model->param.svm_type != NU_SVC ){
+			for(UINT j=0; j<numFeatures; j++) predictionNodes[j].value = predictionInput[j];
+			predictedClassLabel = (UINT)svm_predict(model,&predictionNodes[0]);
+			return true;
 		}
 
-		//Perform the SVM prediction
-		double predict_label = svm_predict(model,x);
+		double predict_label = 0;
+		if( useLinearWeights ){
+			//Each one-vs-one decision value is a single dot product with the collapsed weights
+			for(UINT p=0; p<linearWeights.getNumRows(); p++){
+				decisionValues[p] = DistanceKernels::dot(&predictionInput[0],linearWeights[p],numFeatures) - model->rho[p];
+			}
+			predict_label = svm_predict_label_from_decision_values(model,&decisionValues[0],&votes[0]);
+		}else{
+			//Compute the kernel value for each support vector, then the one-vs-one decision values and votes
+			if( useDenseKernel ){
+				computeDenseKernelValues();
+			}else{
+				for(UINT j=0; j<numFeatures; j++) predictionNodes[j].value = predictionInput[j];
+				svm_predict_kernel_values(model,&predictionNodes[0],&kernelValues[0]);
+			}
+			predict_label = svm_predict_values_from_kernel_values(model,&kernelValues[0],&decisionValues[0],&votes[0]);
+		}
 
-        //We can't do null rejection without the probabilities, so just set the predicted class
-        predictedClassLabel = (UINT)predict_label;
+		//We can't do null rejection without the probabilities, so just set the predicted class
+		if( param.probability == 0 || model->probA == NULL || model->probB == NULL ){
+			predictedClassLabel = (UINT)predict_label;
+			return true;
+		}
+
+		predict_label = svm_predict_probability_from_decision_values(model,&decisionValues[0],&probabilityEstimates[0],&probabilityWorkspace[0]);
+
+		predictedClassLabel = 0;
+		maxLikelihood = 0;
+		classLikelihoods.resize(model->nr_class);
+		for(int k=0; k<model->nr_class; k++){
+			if( maxLikelihood < probabilityEstimates[k] ){
+				maxLikelihood = probabilityEstimates[k];
+				predictedClassLabel = k+1;
+			}
+			classLikelihoods[k] = probabilityEstimates[k];
+		}
 
-		//Clean up the memory
-		delete[] x;
+		if( !useNullRejection ) predictedClassLabel = (UINT)predict_label;
+		else{
+			if( maxLikelihood >= classificationThreshold ){
+				predictedClassLabel = (UINT)predict_label;
+			}else predictedClassLabel = 0;
+		}
 
 		return true;
 }
 
-bool SVM::predict_(vector<double> inputVector,double &maxProbability, vector<double> &probabilites){
+bool SVM::setupPredictionBuffers(){
 
-		if( !trained || param.probability == 0 || inputVector.size() != numFeatures ) return false;
+		if( model == NULL ) return false;
 
-		double *prob_estimates = NULL;
-		svm_node *x = NULL;
+		const UINT numSV = (UINT)model->l;
+		const UINT nr_class = (UINT)model->nr_class;
 
-		//Setup the memory for the probability estimates
-		prob_estimates = new double[model->nr_class];
-
-		//Copy the input data into the SVM format
-		x = new svm_node[numFeatures+1];
+		predictionInput.resize( numFeatures );
+		predictionNodes.resize( numFeatures+1 );
 		for(UINT j=0; j<numFeatures; j++){
-			x[j].index = (int)j+1;
-			x[j].value = inputVector[j];
+			predictionNodes[j].index = (int)j+1;
+			predictionNodes[j].value = 0;
 		}
-		//The last value in the input vector must be set to -1
-		x[numFeatures].index = -1;
-		x[numFeatures].value = 0;
+		//The last node must have an index of -1
+		predictionNodes[numFeatures].index = -1;
+		predictionNodes[numFeatures].value = 0;
 
-		//Scale the input data if required
-		if( useScaling ){
-			for(UINT j=0; j<numFeatures; j++)
-				x[j].value = scale(x[j].value,ranges[j].minValue,ranges[j].maxValue,SVM_MIN_SCALE_RANGE,SVM_MAX_SCALE_RANGE);
-		}
+		kernelValues.resize( numSV > 0 ? numSV : 1 );
+		decisionValues.resize( nr_class > 1 ? nr_class*(nr_class-1)/2 : 1 );
+		votes.resize( nr_class > 0 ? nr_class : 1 );
+		probabilityEstimates.resize( nr_class > 0 ? nr_class : 1 );
+		probabilityWorkspace.resize( svm_probability_workspace_size(model) );
 
-		//Perform the SVM prediction
-		double predict_label = svm_predict_probability(model,x,prob_estimates);
+		//Our feature vectors are dense, so the support vectors are unpacked into dense rows once and the kernels are then computed without
+		//walking the node indexs. The precomputed kernel indexes the input by the support vector value so it always uses the LIBSVM nodes
+		useDenseKernel = model->param.kernel_type != PRECOMPUTED_KERNEL && model->SV != NULL;
+		denseSupportVectors.clear();
+		if( useDenseKernel ){
+			denseSupportVectors.resize( numSV, numFeatures );
+			denseSupportVectors.setAllValues( 0 );
+			for(UINT i=0; i<numSV && useDenseKernel; i++){
+				double *sv = denseSupportVectors[i];
+				for(const svm_node *node = model->SV[i]; node->index != -1; ++node){
+					if( node->index < 1 || node->index > (int)numFeatures ){
+						useDenseKernel = false;
+						break;
+					}
+					sv[ node->index-1 ] = node->value;
+				}
+			}
+			if( !useDenseKernel ) denseSupportVectors.clear();
+		}
 
-		predictedClassLabel = 0;
-		maxProbability = 0;
-		probabilites.resize(model->nr_class);
-		for(int k=0; k<model->nr_class; k++){
-			if( maxProbability < prob_estimates[k] ){
-				maxProbability = prob_estimates[k];
-                predictedClassLabel = k+1;
-                maxLikelihood = maxProbability;
-            }
-			probabilites[k] = prob_estimates[k];
+		//With a linear kernel each one-vs-one decision function is a weighted sum of dot products with its support vectors, so the support
+		//vectors are collapsed into one weight vector per sub-problem and the prediction cost no longer depends on the number of support vectors
+		useLinearWeights = useDenseKernel && model->nSV != NULL && model->param.kernel_type == LINEAR_KERNEL && (model->param.svm_type == C_SVC || model->param.svm_type == NU_SVC);
+		linearWeights.clear();
+		if( useLinearWeights ){
+			linearWeights.resize( nr_class*(nr_class-1)/2, numFeatures );
+			linearWeights.setAllValues( 0 );
+			UINT p = 0;
+			UINT si = 0;
+			for(UINT i=0; i<nr_class; i++){
+				const UINT ci = (UINT)model->nSV[i];
+				UINT sj = si+ci;
+				for(UINT j=i+1; j<nr_class; j++){
+					const UINT cj = (UINT)model->nSV[j];
+					const double *coef1 = model->sv_coef[j-1];
+					const double *coef2 = model->sv_coef[i];
+					double *w = linearWeights[p];
+					for(UINT k=0; k<ci; k++){
+						const double *sv = denseSupportVectors[si+k];
+						for(UINT n=0; n<numFeatures; n++) w[n] += coef1[si+k] * sv[n];
+					}
+					for(UINT k=0; k<cj; k++){
+						const double *sv = denseSupportVectors[sj+k];
+						for(UINT n=0; n<numFeatures; n++) w[n] += coef2[sj+k] * sv[n];
+					}
+					p++;
+					sj += cj;
+				}
+				si += ci;
+			}
+			//The kernel values are no longer needed
+			denseSupportVectors.clear();
 		}
 
-        if( !useNullRejection ) predictedClassLabel = (UINT)predict_label;
-        else{
-            if( maxProbability >= classificationThreshold ){
-                predictedClassLabel = (UINT)predict_label;
-            }else predictedClassLabel = 0;
-        }
+		return true;
+}
 
-		//Clean up the memory
-		delete[] prob_estimates;
-		delete[] x;
+void SVM::computeDenseKernelValues(){
 
-		return true;
+		const UINT numSV = (UINT)model->l;
+		const double *x = &predictionInput[0];
+		const double gamma = model->param.gamma;
+		const double coef0 = model->param.coef0;
+
+		switch( model->param.kernel_type ){
+			case LINEAR_KERNEL:
+				for(UINT i=0; i<numSV; i++) kernelValues[i] = DistanceKernels::dot(x,denseSupportVectors[i],numFeatures);
+				break;
+			case POLY_KERNEL:
+				for(UINT i=0; i<numSV; i++){
+					//Raise the base to the degree by squaring, as LIBSVM does
+					double base = gamma*DistanceKernels::dot(x,denseSupportVectors[i],numFeatures)+coef0;
+					double value = 1;
+					for(int t=model->param.degree; t>0; t/=2){
+						if( t%2 == 1 ) value *= base;
+						base *= base;
+					}
+					kernelValues[i] = value;
+				}
+				break;
+			case RBF_KERNEL:
+				for(UINT i=0; i<numSV; i++) kernelValues[i] = exp( -gamma*DistanceKernels::squaredEuclidean(x,denseSupportVectors[i],numFeatures) );
+				break;
+			case SIGMOID_KERNEL:
+				for(UINT i=0; i<numSV; i++) kernelValues[i] = tanh( gamma*DistanceKernels::dot(x,denseSupportVectors[i],numFeatures)+coef0 );
+				break;
+			default:
+				break;
+		}
 }
     
 bool SVM::convertLabelledClassificationDataToLIBSVMFormat(LabelledClassificationData &trainingData){
@@ -669,8 +776,8 @@ bool SVM::loadModelFromFile(fstream &file){
             return false;
         }
         
-        //Init the memory for the model
-        model = new svm_model;
+        //Init the memory for the model, this is allocated with malloc as the model is freed by LIBSVM
+        model = (svm_model*)malloc( sizeof(svm_model) );
         model->nr_class = 0;
         model->l = 0;
         model->SV = NULL;
@@ -691,6 +798,7 @@ bool SVM::loadModelFromFile(fstream &file){
         model->param.gamma = 0;
         model->param.coef0 = 0;
         model->param.cache_size = 0;
+        model->param.nr_thread = 0;
         model->param.eps = 0;
         model->param.C = 0;
         model->param.nr_weight = 0;
@@ -883,7 +991,7 @@ bool SVM::loadModelFromFile(fstream &file){
             clear();
             return false;
         }
-        model->rho = new double[ halfNumClasses ];
+        model->rho = (double*)malloc( sizeof(double)*halfNumClasses );
         for(UINT i=0;i<numClasses*(numClasses-1)/2;i++) file >> model->rho[i];
         
         //See if we can load the Labels
@@ -891,7 +999,7 @@ bool SVM::loadModelFromFile(fstream &file){
         if(word != "Label:"){
             model->label = NULL;
         }else{
-            model->label = new int[ numClasses ];
+            model->label = (int*)malloc( sizeof(int)*numClasses );
             for(UINT i=0;i<numClasses;i++) file >> model->label[i];
             //We only need to read a new line if we found the label!
             file >> word;
@@ -902,7 +1010,7 @@ bool SVM::loadModelFromFile(fstream &file){
         if(word != "ProbA:"){
             model->probA = NULL;
         }else{
-            model->probA = new double[ halfNumClasses ];
+            model->probA = (double*)malloc( sizeof(double)*halfNumClasses );
             for(UINT i=0;i<numClasses*(numClasses-1)/2;i++) file >> model->probA[i];
             //We only need to read a new line if we found the label!
             file >> word;
@@ -913,7 +1021,7 @@ bool SVM::loadModelFromFile(fstream &file){
         if(word != "ProbB:"){
             model->probB = NULL;
         }else{
-            model->probB = new double[ halfNumClasses ];
+            model->probB = (double*)malloc( sizeof(double)*halfNumClasses );
             for(UINT i=0;i<numClasses*(numClasses-1)/2;i++) file >> model->probB[i];
             //We only need to read a new line if we found the label!
             file >> word;
@@ -924,7 +1032,7 @@ bool SVM::loadModelFromFile(fstream &file){
         if(word != "NumSupportVectorsPerClass:"){
             model->nSV = NULL;
         }else{
-            model->nSV = new int[ numClasses ];
+            model->nSV = (int*)malloc( sizeof(int)*numClasses );
             for(UINT i=0;i<numClasses;i++) file >> model->nSV[i];
             //We only need to read a new line if we found the label!
             file >> word;
@@ -938,20 +1046,24 @@ bool SVM::loadModelFromFile(fstream &file){
             return NULL;
         }
         
-        //Setup the memory
-        model->sv_coef = new double*[numClasses-1];
-        for(UINT j=0;j<numClasses-1;j++) model->sv_coef[j] = new double[numSV];
-        model->SV = new svm_node*[numSV];
+        //Setup the memory, the SVs are stored in one block (as svm_load_model does) as LIBSVM only frees the first SV
+        model->sv_coef = (double**)malloc( sizeof(double*)*(numClasses-1) );
+        for(UINT j=0;j<numClasses-1;j++) model->sv_coef[j] = (double*)malloc( sizeof(double)*numSV );
+        model->SV = (svm_node**)malloc( sizeof(svm_node*)*numSV );
+        svm_node *x_space = (svm_node*)malloc( sizeof(svm_node)*numSV*(numFeatures+1) );
         
         for(UINT i=0; i<numSV; i++){
             for(UINT j=0; j<numClasses-1; j++){
                 file >> model->sv_coef[j][i];
             }
             
-            model->SV[i] = new svm_node[numFeatures+1];
+            model->SV[i] = x_space + i*(numFeatures+1);
             
-            if(model->param.kernel_type == PRECOMPUTED) file >> model->SV[i][0].value;
-            else{
+            if(model->param.kernel_type == PRECOMPUTED){
+                model->SV[i][0].index = 0;
+                file >> model->SV[i][0].value;
+                model->SV[i][1].index = -1;
+            }else{
                 for(UINT j=0; j<numFeatures; j++){
                     file >> model->SV[i][j].index;
                     file >> model->SV[i][j].value;
@@ -972,10 +1084,237 @@ bool SVM::loadModelFromFile(fstream &file){
         
         //Finally, flag that the model has been trained to show it has been loaded and can be used for prediction
         trained = true;
+        setupPredictionBuffers();
         
         return true;
 }
 
+bool SVM::saveModelToBinaryFile(fstream &file){
+    
+    if( !file.is_open() ){
+        errorLog << "saveModelToBinaryFile(fstream &file) - Could not open file to save model!" << endl;
+        return false;
+    }
+    
+    if( !trained || model == NULL ){
+        errorLog << "saveModelToBinaryFile(fstream &file) - The model has not been trained!" << endl;
+        return false;
+    }
+    
+    const svm_parameter &param = model->param;
+    const UINT numClasses = (UINT)model->nr_class;
+    const UINT halfNumClasses = numClasses*(numClasses-1)/2;
+    const UINT numSV = (UINT)model->l;
+    
+    //The precomputed kernel only stores the index of each support vector, every other kernel stores the support vectors as dense rows
+    const UINT svLength = param.kernel_type == PRECOMPUTED ? 1 : numFeatures;
+    vector< double > supportVectors( (unsigned long long)numSV*svLength, 0 );
+    for(UINT i=0; i<numSV; i++){
+        double *sv = &supportVectors[ (unsigned long long)i*svLength ];
+        if( param.kernel_type == PRECOMPUTED ){
+            sv[0] = model->SV[i][0].value;
+            continue;
+        }
+        for(const svm_node *node = model->SV[i]; node->index != -1; ++node){
+            if( node->index < 1 || node->index > (int)numFeatures ){
+                errorLog << "saveModelToBinaryFile(fstream &file) - Support vector " << i << " has an invalid feature index: " << node->index << endl;
+                return false;
+            }
+            sv[ node->index-1 ] = node->value;
+        }
+    }
+    
+    vector< double > rangeValues;
+    for(UINT n=0; n<ranges.size(); n++){
+        rangeValues.push_back( ranges[n].minValue );
+        rangeValues.push_back( ranges[n].maxValue );
+    }
+    
+    BinaryWriter writer( file );
+    writer.write( string("GRT_SVM_MODEL_BINARY_V1.0") );
+    writer.write( (UINT)param.svm_type );
+    writer.write( (UINT)param.kernel_type );
+    writer.write( (UINT)param.degree );
+    writer.write( param.gamma );
+    writer.write( param.coef0 );
+    writer.write( numClasses );
+    writer.write( numSV );
+    writer.write( numFeatures );
+    writer.write( param.shrinking != 0 );
+    writer.write( param.probability != 0 );
+    writer.write( useScaling );
+    writer.write( rangeValues );
+    writer.write( vector< double >(model->rho,model->rho+halfNumClasses) );
+    writer.write( model->label != NULL );
+    if( model->label ) writer.write( vector< UINT >(model->label,model->label+numClasses) );
+    writer.write( model->probA != NULL );
+    if( model->probA ) writer.write( vector< double >(model->probA,model->probA+halfNumClasses) );
+    writer.write( model->probB != NULL );
+    if( model->probB ) writer.write( vector< double >(model->probB,model->probB+halfNumClasses) );
+    writer.write( model->nSV != NULL );
+    if( model->nSV ) writer.write( vector< UINT >(model->nSV,model->nSV+numClasses) );
+    
+    //Write the coefficients of each class, then all the support vectors as one block
+    for(UINT j=0; j+1<numClasses; j++){
+        writer.writeArray( model->sv_coef[j], numSV );
+    }
+    writer.writeArray( supportVectors.size() > 0 ? &supportVectors[0] : NULL, supportVectors.size() );
+    
+    if( !writer.good() ){
+        errorLog << "saveModelToBinaryFile(fstream &file) - Failed to write the model!" << endl;
+        return false;
+    }
+    
+    return true;
+}
+    
+bool SVM::loadModelFromBinaryData(const char *data,unsigned long long size){
+    
+    //Clear any previous models, parameters or problems
+    clear();
+    numFeatures = 0;
+    
+    BinaryReader reader(data,size);
+    string header;
+    reader.read( header );
+    if( header != "GRT_SVM_MODEL_BINARY_V1.0" ){
+        errorLog << "loadModelFromBinaryData(const char *data,unsigned long long size) - Could not find Model File Header!" << endl;
+        return false;
+    }
+    
+    UINT svmType = 0;
+    UINT kernelType = 0;
+    UINT degree = 0;
+    double gamma = 0;
+    double coef0 = 0;
+    UINT numClasses = 0;
+    UINT numSV = 0;
+    bool useShrinking = false;
+    bool useProbability = false;
+    bool hasLabel = false;
+    bool hasProbA = false;
+    bool hasProbB = false;
+    bool hasNumSV = false;
+    vector< double > rangeValues, rho, probA, probB;
+    vector< UINT > label, nSV;
+    reader.read( svmType );
+    reader.read( kernelType );
+    reader.read( degree );
+    reader.read( gamma );
+    reader.read( coef0 );
+    reader.read( numClasses );
+    reader.read( numSV );
+    reader.read( numFeatures );
+    reader.read( useShrinking );
+    reader.read( useProbability );
+    reader.read( useScaling );
+    reader.read( rangeValues );
+    reader.read( rho );
+    reader.read( hasLabel );
+    if( hasLabel ) reader.read( label );
+    reader.read( hasProbA );
+    if( hasProbA ) reader.read( probA );
+    reader.read( hasProbB );
+    if( hasProbB ) reader.read( probB );
+    reader.read( hasNumSV );
+    if( hasNumSV ) reader.read( nSV );
+    
+    const UINT halfNumClasses = numClasses > 0 ? numClasses*(numClasses-1)/2 : 0;
+    const UINT svLength = kernelType == PRECOMPUTED ? 1 : numFeatures;
+    vector< const double* > svCoef( numClasses > 0 ? numClasses-1 : 0 );
+    for(UINT j=0; j<svCoef.size(); j++) svCoef[j] = reader.readArray( numSV );
+    const double *supportVectors = reader.readArray( (unsigned long long)numSV*svLength );
+    
+    if( !reader.good() || numClasses == 0 || !validateSVMType( svmType ) || !validateKernelType( kernelType ) || rho.size() != halfNumClasses ||
+        (rangeValues.size() != 0 && rangeValues.size() != 2*numFeatures) || (hasLabel && label.size() != numClasses) ||
+        (hasProbA && probA.size() != halfNumClasses) || (hasProbB && probB.size() != halfNumClasses) || (hasNumSV && nSV.size() != numClasses) ){
+        errorLog << "loadModelFromBinaryData(const char *data,unsigned long long size) - The model is truncated or corrupt!" << endl;
+        clear();
+        return false;
+    }
+    
+    ranges.resize( rangeValues.size()/2 );
+    for(UINT n=0; n<ranges.size(); n++){
+        ranges[n].minValue = rangeValues[n*2];
+        ranges[n].maxValue = rangeValues[n*2+1];
+    }
+    
+    //Init the memory for the model, this is allocated with malloc as the model is freed by LIBSVM
+    model = (svm_model*)malloc( sizeof(svm_model) );
+    model->param.svm_type = (int)svmType;
+    model->param.kernel_type = (int)kernelType;
+    model->param.degree = (int)degree;
+    model->param.gamma = gamma;
+    model->param.coef0 = coef0;
+    model->param.cache_size = 0;
+    model->param.nr_thread = 0;
+    model->param.eps = 0;
+    model->param.C = 0;
+    model->param.nr_weight = 0;
+    model->param.weight_label = NULL;
+    model->param.weight = NULL;
+    model->param.nu = 0;
+    model->param.p = 0;
+    model->param.shrinking = useShrinking ? 1 : 0;
+    model->param.probability = useProbability ? 1 : 0;
+    model->nr_class = (int)numClasses;
+    model->l = (int)numSV;
+    model->rho = (double*)malloc( sizeof(double)*halfNumClasses );
+    std::copy(rho.begin(),rho.end(),model->rho);
+    model->label = NULL;
+    if( hasLabel ){
+        model->label = (int*)malloc( sizeof(int)*numClasses );
+        std::copy(label.begin(),label.end(),model->label);
+    }
+    model->probA = NULL;
+    if( hasProbA ){
+        model->probA = (double*)malloc( sizeof(double)*halfNumClasses );
+        std::copy(probA.begin(),probA.end(),model->probA);
+    }
+    model->probB = NULL;
+    if( hasProbB ){
+        model->probB = (double*)malloc( sizeof(double)*halfNumClasses );
+        std::copy(probB.begin(),probB.end(),model->probB);
+    }
+    model->nSV = NULL;
+    if( hasNumSV ){
+        model->nSV = (int*)malloc( sizeof(int)*numClasses );
+        std::copy(nSV.begin(),nSV.end(),model->nSV);
+    }
+    
+    //Copy the coefficients and the support vectors straight from the data, the SVs are stored in one block (as svm_load_model does) as
+    //LIBSVM only frees the first SV
+    model->sv_coef = (double**)malloc( sizeof(double*)*(numClasses-1) );
+    for(UINT j=0; j<numClasses-1; j++){
+        model->sv_coef[j] = (double*)malloc( sizeof(double)*numSV );
+        std::copy(svCoef[j],svCoef[j]+numSV,model->sv_coef[j]);
+    }
+    model->SV = (svm_node**)malloc( sizeof(svm_node*)*numSV );
+    svm_node *x_space = (svm_node*)malloc( sizeof(svm_node)*(unsigned long long)numSV*(svLength+1) );
+    for(UINT i=0; i<numSV; i++){
+        const double *sv = supportVectors + (unsigned long long)i*svLength;
+        model->SV[i] = x_space + (unsigned long long)i*(svLength+1);
+        for(UINT j=0; j<svLength; j++){
+            model->SV[i][j].index = kernelType == PRECOMPUTED ? 0 : (int)j+1;
+            model->SV[i][j].value = sv[j];
+        }
+        model->SV[i][svLength].index = -1; //Assign the final node value
+        model->SV[i][svLength].value = 0;
+    }
+    
+    //The SV have now been loaded so flag that they should be deleted
+    model->free_sv = 1;
+    
+    //Set the class labels
+    classLabels.assign( label.begin(), label.end() );
+    
+    //Flag that the model has been trained to show it has been loaded and can be used for prediction
+    trained = true;
+    setupPredictionBuffers();
+    
+    return true;
+}
+
 string SVM::getSVMType(){
 
 	struct svm_parameter *paramPtr = NULL;
@@ -1140,6 +1479,11 @@ bool SVM::enableCrossValidationTraining(bool useCrossValidation){
     this->useCrossValidation = useCrossValidation;
     return true;
 }
+
+bool SVM::setNumTrainingThreads(UINT numTrainingThreads){
+    param.nr_thread = (int)numTrainingThreads;
+    return true;
+}
     
 bool SVM::validateSVMType(UINT svmType){
     if( svmType == C_SVC ){
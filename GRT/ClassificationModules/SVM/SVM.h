@@ -33,6 +33,7 @@
 #pragma once
 
 #include "../../GestureRecognitionPipeline/Classifier.h"
+#include "../../Util/DistanceKernels.h"
 #include "LIBSVM/libsvm.h"
 
 namespace GRT {
@@ -107,7 +108,20 @@ public:
      @param vector< double > inputVector: the input vector to classify
      @return returns true if the prediction was performed, false otherwise
      */
-    virtual bool predict(vector< double > inputVector);
+    virtual bool predict(const vector< double > &inputVector);
+    
+    /**
+     This predicts the class of each row of the inputData.  Each row is predicted with the same prediction buffers used by predict(...),
+     so no memory is allocated for each row.
+     This overrides the predictBatch function in the Classifier base class.
+     
+     @param const Matrix<double> &inputData: the input vectors to classify, with one vector per row
+     @param vector< UINT > &predictedClassLabels: returns the predicted class label of each row
+     @param Matrix<double> &likelihoods: returns the class likelihoods of each row, these are only set if the probability estimates are enabled
+     @param Matrix<double> &distances: returns the class distances of each row, these are not used by the SVM and are set to zero
+     @return returns true if the prediction was performed, false otherwise
+     */
+    virtual bool predictBatch(const Matrix<double> &inputData,vector< UINT > &predictedClassLabels,Matrix<double> &likelihoods,Matrix<double> &distances);
     
     /**
      This saves the trained SVM model to a file.
@@ -145,6 +159,27 @@ public:
      */
     virtual bool loadModelFromFile(fstream &file);
     
+    /**
+     This saves the trained SVM model to a binary file, the support vectors are written as one dense block so they are not parsed when loaded.
+     This overrides the saveModelToBinaryFile function in the MLBase base class.
+     
+     @param fstream &file: a reference to the binary file the SVM model will be saved to
+     @return returns true if the model was saved successfully, false otherwise
+     */
+    virtual bool saveModelToBinaryFile(fstream &file);
+    
+    /**
+     This loads a trained SVM model saved by saveModelToBinaryFile.
+     This overrides the loadModelFromBinaryData function in the MLBase base class.
+     
+     @param const char *data: a pointer to the start of the model
+     @param unsigned long long size: the size of the model in bytes
+     @return returns true if the model was loaded successfully, false otherwise
+     */
+    virtual bool loadModelFromBinaryData(const char *data,unsigned long long size);
+    
+    virtual bool getSupportsBinaryModel() const{ return true; }
+    
     
     /**
      This initializes the SVM settings and parameters.  Any previous model, settings, or problems will be cleared.
@@ -258,6 +293,13 @@ public:
      */
     double getCrossValidationResult(){ return crossValidationResult; }
     
+    /**
+     Gets the number of threads used to train the SVM.
+     
+     @return returns the number of training threads, 0 means one thread is used per CPU core
+     */
+    UINT getNumTrainingThreads() const{ return (UINT)param.nr_thread; }
+    
     /**
      Sets the SVM type.
      This should be one of the SVMTypes enumeration types.
@@ -343,6 +385,16 @@ public:
      return returns true if the useCrossValidation was set, false otherwise
      */
     bool enableCrossValidationTraining(bool useCrossValidation);
+    
+    /**
+     Sets the number of threads used to train the SVM. The one-vs-one sub-problems (or the cross validation folds) are trained
+     in parallel, with the kernel cache split evenly between the threads. If there is only one sub-problem then the threads
+     are used to compute the kernel columns instead.
+     
+     @param UINT numTrainingThreads: the number of training threads, 0 will use one thread per CPU core, 1 will train serially
+     return returns true if the number of training threads was set, false otherwise
+     */
+    bool setNumTrainingThreads(UINT numTrainingThreads);
 
 protected:
     void deleteProblemSet();
@@ -352,8 +404,9 @@ protected:
     bool convertLabelledClassificationDataToLIBSVMFormat(LabelledClassificationData &trainingData);
 	bool trainSVM();
     
-	bool predict_(vector<double> inputVector);
-	bool predict_(vector<double> inputVector,double &maxProbability, vector<double> &probabilites);
+	bool predict_(const double *inputVector);
+    bool setupPredictionBuffers();
+    void computeDenseKernelValues();
     
 	bool problemSet;
 	struct svm_model *model;
@@ -364,6 +417,17 @@ protected:
 	double crossValidationResult;
 	bool useAutoGamma;
     bool useCrossValidation;
+    bool useDenseKernel;                    //True if the kernel values are computed from the dense support vectors rather than the LIBSVM nodes
+    Matrix< double > denseSupportVectors;   //The support vectors stored as dense rows, any feature missing from a LIBSVM node is stored as 0
+    bool useLinearWeights;                  //True if the decision functions of a linear kernel have been collapsed into the linearWeights
+    Matrix< double > linearWeights;         //The weight vector of each one-vs-one decision function of a linear kernel, with one row per sub-problem
+    vector< double > predictionInput;       //The (scaled) input vector of the current prediction
+    vector< svm_node > predictionNodes;     //The input vector in the LIBSVM node format, used when the dense kernel can not be used
+    vector< double > kernelValues;          //The kernel value between the input vector and each support vector
+    vector< double > decisionValues;        //The decision value of each one-vs-one sub-problem
+    vector< int > votes;                    //The number of one-vs-one votes for each class
+    vector< double > probabilityEstimates;  //The probability estimate for each class
+    vector< double > probabilityWorkspace;  //The memory used by LIBSVM to compute the probability estimates
     
     static RegisterClassifierModule< SVM > registerModule;
     
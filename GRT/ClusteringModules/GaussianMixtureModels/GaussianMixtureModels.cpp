@@ -1,198 +1,314 @@
-
-#include "GaussianMixtureModels.h"
-
-namespace GRT {
-
-GaussianMixtureModels::GaussianMixtureModels(){
-    debugLog.setProceedingText("[DEBUG GaussianMixtureModel]");
-    errorLog.setProceedingText("[ERROR GaussianMixtureModel]");
-    warningLog.setProceedingText("[WARNING GaussianMixtureModel]");
-
-    maxIter = 10;
-    minChange = 1.0e-2;
-    modelTrained = false;
-    failed = false;
-}
-
-GaussianMixtureModels::~GaussianMixtureModels(){}
-
-bool GaussianMixtureModels::train(UnlabelledClassificationData &trainingData,unsigned int K){
-
-	modelTrained = false;
-    failed = false;
-
-	//Clear any previous training results
-	det.clear();
-	invSigma.clear();
-
-    if( trainingData.getNumSamples() == 0 ){
-        errorLog << "train(UnlabelledClassificationData &trainingData,unsigned int K) - Training Failed! Training data is empty!" << endl;
-        return false;
-    }
-
-	//Set the training data
-	data = trainingData.getData();
-
-	//Resize the variables
-	M = data.getNumRows();
-	N = data.getNumCols();
-	this->K = K;
-	//Resize mu and resp
-	mu.resize(K,N);
-	resp.resize(M,K);
-	//Resize sigma
-	sigma.resize(K);
-	for(unsigned int k=0; k<K; k++){
-		sigma[k].resize(N,N);
-	}
-	//Resize frace and lndets
-	frac.resize(K);
-	lndets.resize(K);
-
-	//Pick K random starting points for the inital guesses of Mu
-	Random random;
-	vector< unsigned int > randomIndexs(M);
-	for(unsigned int i=0; i<M; i++) randomIndexs[i] = i;
-	for(unsigned int i=0; i<M*100; i++){
-		unsigned int indexA = random.getRandomNumberInt(0,M);
-		unsigned int indexB = random.getRandomNumberInt(0,M);
-		if( indexA != indexB ) SWAP(randomIndexs[indexA],randomIndexs[indexB]);
-	}
-	for(unsigned int k=0; k<K; k++){
-		for(unsigned int n=0; n<N; n++){
-			mu[k][n] = data[ randomIndexs[k] ][n];
-		}
-	}
-
-	//Setup sigma and the uniform prior on P(k)
-	for(unsigned int k=0; k<K; k++){
-		frac[k] = 1.0/double(K);
-		for(unsigned int i=0; i<N; i++){
-			for(unsigned int j=0; j<N; j++) sigma[k][i][j] = 0;
-			sigma[k][i][i] = 1.0e-10;   //Set the diagonal to a small number
-		}
-	}
-
-	loglike = 0;
-	unsigned int counter = 0;
-	bool keepGoing = true;
-	double change = 99.9e99;
-
-	while( keepGoing ){
-		change = estep();
-		mstep();
-
-		//debugLog <<"Iteration: " << counter << " change: " << change << endl;
-
-		if( fabs( change ) < minChange ) keepGoing = false;
-		if( ++counter >= maxIter ) keepGoing = false;
-		if( failed ) keepGoing = false;
-	}
-
-	if( failed ){
-		errorLog << "train(UnlabelledClassificationData &trainingData,unsigned int K) - Training failed!" << endl;
-		return modelTrained;
-	}
-
-	//debugLog << "GMM Converaged after " << counter << " iterations with a final improvement of " << change << endl;
-
-	//Compute the inverse of sigma and the determinants for prediction
-	if( !computeInvAndDet() ){
-        det.clear();
-        invSigma.clear();
-        errorLog << "train(UnlabelledClassificationData &trainingData,unsigned int K) - Failed to compute inverse and determinat!" << endl;
-        return false;
-    }
-
-    //Flag that the model was trained
-	modelTrained = true;
-
-	return modelTrained;
-}
-
-double GaussianMixtureModels::estep(){
-
-	double tmp,sum,max,oldloglike;
-	vector<double> u(N);
-	vector<double> v(N);
-	for(unsigned int j=0; j<N; j++) u[j]= v[j] = 0;
-
-	oldloglike = loglike;
-
-	for(unsigned int k=0; k<K; k++){
-		Cholesky choltmp( sigma[k] );
-		if( !choltmp.getSuccess() ){ failed = true; return 0; }
-		lndets[k] = choltmp.logdet();
-
-		for(unsigned int i=0; i<M; i++){
-			for(unsigned int j=0; j<N; j++) u[j] = data[i][j] - mu[k][j];
-			if( !choltmp.elsolve(u,v) ){ failed = true; return 0; }
-			sum=0;
-			for(unsigned int j=0; j<N; j++) sum += SQR(v[j]);
-			resp[i][k] = -0.5*(sum + lndets[k]) + log(frac[k]);
-		}
-	}
-
-	//Compute the overall likelihood of the entire estimated paramter set
-	loglike = 0;
-	for(unsigned int i=0; i<M; i++){
-		sum=0;
-		max = -99.9e99;
-		for(unsigned int k=0; k<K; k++) if( resp[i][k] > max ) max = resp[i][k];
-		for(unsigned int k=0; k<K; k++) sum += exp( resp[i][k]-max );
-		tmp = max + log( sum );
-		for(unsigned int k=0; k<K; k++) resp[i][k] = exp( resp[i][k] - tmp );
-		loglike += tmp;
-	}
-
-	return (loglike - oldloglike);
-}
-
-void GaussianMixtureModels::mstep(){
-
-	double wgt, sum;
-	for(unsigned int k=0; k<K; k++){
-		wgt = 0.0;
-		for(unsigned int m=0; m<M; m++) wgt += resp[m][k];
-		frac[k] = wgt/double(M);
-		for(unsigned int n=0; n<N; n++){
-			sum = 0;
-			for(unsigned int m=0; m<M; m++) sum += resp[m][k] * data[m][n];
-			mu[k][n] = sum/wgt;
-			for(unsigned int j=0; j<N; j++){
-				sum = 0;
-				for(unsigned int m=0; m<M; m++){
-					sum += resp[m][k] * (data[m][n]-mu[k][n]) * (data[m][j]-mu[k][j]);
-				}
-				sigma[k][n][j] = sum/wgt;
-			}
-		}
-	}
-
-}
-
-inline void GaussianMixtureModels::SWAP(UINT &a,UINT &b){
-	UINT temp = b;
-	b = a;
-	a = temp;
-}
-
-bool GaussianMixtureModels::computeInvAndDet(){
-
-	det.resize(K);
-	invSigma.resize(K);
-
-	for(unsigned int k=0; k<K; k++){
-		LUdcmp lu(sigma[k]);
-		if( !lu.inverse(invSigma[k]) ){
-            errorLog << "computeInvAndDet() - Matrix Inversion Failed!" << endl;
-            return false;
-        }
-		det[k] = lu.det();
-	}
-
-    return true;
-
-}
-
-}//End of namespace GRT
+
+#include "GaussianMixtureModels.h"
+
+//The training data is split into at most GMM_MAX_NUM_CHUNKS chunks of at least GMM_MIN_CHUNK_SIZE rows. The chunks only depend on the
+//number of rows, and the statistics of the chunks are added together in order, so the model does not depend on the number of threads
+#define GMM_MIN_CHUNK_SIZE 256
+#define GMM_MAX_NUM_CHUNKS 64
+
+namespace GRT {
+
+//Runs the E-step over the chunks [startIndex endIndex) of the training data, summing the results of each chunk into its own statistics
+class GaussianMixtureModelsEStepJob : public ParallelJob{
+public:
+    GaussianMixtureModelsEStepJob(GaussianMixtureModels *gmm,const Matrix< double > &data):gmm(gmm),data(data){}
+
+    virtual void run(unsigned int /*threadIndex*/,unsigned int startIndex,unsigned int endIndex){
+        vector< double > logResp( gmm->K );
+        vector< double > u( gmm->N );
+        vector< double > v( gmm->N );
+        for(unsigned int c=startIndex; c<endIndex; c++){
+            GaussianMixtureModels::SufficientStatistics &statistics = gmm->statistics[c];
+            const unsigned int chunkEnd = gmm->getChunkStart(c+1);
+            for(unsigned int i=gmm->getChunkStart(c); i<chunkEnd; i++){
+                gmm->accumulate(data[i],statistics,&logResp[0],&u[0],&v[0]);
+            }
+        }
+    }
+
+    GaussianMixtureModels *gmm;
+    const Matrix< double > &data;
+};
+
+GaussianMixtureModels::GaussianMixtureModels(){
+    debugLog.setProceedingText("[DEBUG GaussianMixtureModel]");
+    errorLog.setProceedingText("[ERROR GaussianMixtureModel]");
+    warningLog.setProceedingText("[WARNING GaussianMixtureModel]");
+
+    N = 0;
+    M = 0;
+    K = 0;
+    maxIter = 10;
+    minChange = 1.0e-2;
+    numTrainingThreads = 0;
+    useDiagonalCovariance = false;
+    modelTrained = false;
+    failed = false;
+}
+
+GaussianMixtureModels::~GaussianMixtureModels(){}
+
+bool GaussianMixtureModels::train(UnlabelledClassificationData &trainingData,unsigned int K){
+    return train(trainingData.getData(),K);
+}
+
+bool GaussianMixtureModels::train(const Matrix< double > &data,unsigned int K){
+
+	modelTrained = false;
+    failed = false;
+
+    if( data.getNumRows() == 0 ){
+        errorLog << "train(const Matrix< double > &data,unsigned int K) - Training Failed! Training data is empty!" << endl;
+        return false;
+    }
+
+    if( K == 0 || K > data.getNumRows() ){
+        errorLog << "train(const Matrix< double > &data,unsigned int K) - Training Failed! K (" << K << ") must be between 1 and the number of training samples (" << data.getNumRows() << ")!" << endl;
+        return false;
+    }
+
+	//Resize the variables
+	M = data.getNumRows();
+	N = data.getNumCols();
+	this->K = K;
+	//Resize mu
+	mu.resize(K,N);
+	//Resize sigma
+	sigma.resize(K);
+	for(unsigned int k=0; k<K; k++){
+		sigma[k].resize(N,N);
+	}
+	//Resize frace and lndets
+	frac.resize(K);
+	lndets.resize(K);
+    logConstants.resize(K);
+    if( useDiagonalCovariance ){
+        choleskyFactors.clear();
+        invVariances.resize(K,N);
+    }else{
+        choleskyFactors.resize(K);
+        invVariances.clear();
+    }
+
+    //Setup the sufficient statistics for each chunk of the data
+    statistics.resize( std::max( std::min( (M + GMM_MIN_CHUNK_SIZE - 1) / GMM_MIN_CHUNK_SIZE, (UINT)GMM_MAX_NUM_CHUNKS ), (UINT)1 ) );
+    for(unsigned int c=0; c<statistics.size(); c++){
+        resizeStatistics( statistics[c] );
+    }
+
+	//Pick K random starting points for the inital guesses of Mu
+	Random random;
+	vector< unsigned int > randomIndexs(M);
+	for(unsigned int i=0; i<M; i++) randomIndexs[i] = i;
+	for(unsigned int k=0; k<K; k++){
+        std::swap( randomIndexs[k], randomIndexs[ random.getRandomNumberInt(k,M) ] );
+		for(unsigned int n=0; n<N; n++){
+			mu[k][n] = data[ randomIndexs[k] ][n];
+		}
+	}
+
+	//Setup sigma and the uniform prior on P(k)
+	for(unsigned int k=0; k<K; k++){
+		frac[k] = 1.0/double(K);
+		for(unsigned int i=0; i<N; i++){
+			for(unsigned int j=0; j<N; j++) sigma[k][i][j] = 0;
+			sigma[k][i][i] = GMM_MIN_VARIANCE;   //Set the diagonal to a small number
+		}
+	}
+
+	loglike = 0;
+	unsigned int counter = 0;
+	bool keepGoing = true;
+	double change = 99.9e99;
+
+	while( keepGoing ){
+		change = estep(data);
+		if( !failed ) mstep();
+
+		//debugLog <<"Iteration: " << counter << " change: " << change << endl;
+
+		if( fabs( change ) < minChange ) keepGoing = false;
+		if( ++counter >= maxIter ) keepGoing = false;
+		if( failed ) keepGoing = false;
+	}
+
+    statistics.clear();
+
+	if( failed ){
+		errorLog << "train(const Matrix< double > &data,unsigned int K) - Training failed!" << endl;
+		return modelTrained;
+	}
+
+	//debugLog << "GMM Converaged after " << counter << " iterations with a final improvement of " << change << endl;
+
+    //Flag that the model was trained
+	modelTrained = true;
+
+	return modelTrained;
+}
+
+double GaussianMixtureModels::estep(const Matrix< double > &data){
+
+	double oldloglike = loglike;
+
+    //Factorize each sigma once for the whole pass
+    if( !computeGaussianTerms() ){ failed = true; return 0; }
+
+    //Compute the responsibilities and sufficient statistics of each chunk of the data in parallel. Each sample costs about K*N
+    //operations (K*N*N with a full covariance), so a small dataset is run on fewer threads
+    for(unsigned int c=0; c<statistics.size(); c++){
+        clearStatistics( statistics[c] );
+    }
+    const unsigned long long sampleWork = (unsigned long long)K * (useDiagonalCovariance ? 3*N : N*N + 3*N);
+    GaussianMixtureModelsEStepJob job(this,data);
+    ParallelFor::run(job,(unsigned int)statistics.size(),numTrainingThreads,ParallelFor::getMinTasksPerThread(getChunkStart(1)*sampleWork));
+
+    //Add the statistics of each chunk together in order
+    SufficientStatistics &total = statistics[0];
+    for(unsigned int c=1; c<statistics.size(); c++){
+        total.loglike += statistics[c].loglike;
+        for(unsigned int k=0; k<K; k++){
+            total.weights[k] += statistics[c].weights[k];
+        }
+        for(unsigned int k=0; k<K; k++){
+            for(unsigned int j=0; j<total.sum.getNumCols(); j++) total.sum[k][j] += statistics[c].sum[k][j];
+            for(unsigned int j=0; j<total.sumSquares.getNumCols(); j++) total.sumSquares[k][j] += statistics[c].sumSquares[k][j];
+        }
+    }
+
+	//The overall likelihood of the entire estimated paramter set
+	loglike = total.loglike;
+
+	return (loglike - oldloglike);
+}
+
+void GaussianMixtureModels::mstep(){
+
+    const SufficientStatistics &total = statistics[0];
+
+	for(unsigned int k=0; k<K; k++){
+		const double wgt = total.weights[k];
+		frac[k] = wgt/double(M);
+
+        //If the Gaussian is not responsible for any of the data then keep its previous mu and sigma, it will be ignored from now on as P(k) is 0
+        if( wgt <= 0 ) continue;
+
+        //The statistics are relative to the previous mu, so the new mu is the previous mu plus the mean offset and the new sigma is
+        //the mean outer product of the offsets minus the outer product of the mean offset
+        const double *sum = total.sum[k];
+        const double *sumSquares = total.sumSquares[k];
+        if( useDiagonalCovariance ){
+            for(unsigned int n=0; n<N; n++){
+                const double offset = sum[n]/wgt;
+                sigma[k][n][n] = std::max( sumSquares[n]/wgt - offset*offset, GMM_MIN_VARIANCE );
+            }
+        }else{
+            for(unsigned int n=0; n<N; n++){
+                const double *row = sumSquares + n*(n+1)/2;
+                for(unsigned int j=0; j<=n; j++){
+                    sigma[k][n][j] = sigma[k][j][n] = row[j]/wgt - (sum[n]/wgt)*(sum[j]/wgt);
+                }
+                //Adding the minimum variance to the diagonal keeps sigma positive definite if the Gaussian models fewer samples than dimensions
+                sigma[k][n][n] = std::max( sigma[k][n][n], 0.0 ) + GMM_MIN_VARIANCE;
+            }
+        }
+        for(unsigned int n=0; n<N; n++){
+            mu[k][n] += sum[n]/wgt;
+        }
+	}
+
+}
+
+bool GaussianMixtureModels::computeGaussianTerms(){
+
+    for(unsigned int k=0; k<K; k++){
+        if( useDiagonalCovariance ){
+            lndets[k] = 0;
+            for(unsigned int n=0; n<N; n++){
+                if( sigma[k][n][n] <= 0 ) return false;
+                invVariances[k][n] = 1.0/sigma[k][n][n];
+                lndets[k] += log( sigma[k][n][n] );
+            }
+        }else{
+            Cholesky choltmp( sigma[k] );
+            if( !choltmp.getSuccess() ) return false;
+            choleskyFactors[k] = choltmp.el;
+            lndets[k] = choltmp.logdet();
+        }
+        logConstants[k] = frac[k] > 0 ? log(frac[k]) - 0.5*lndets[k] : -INFINITY;
+    }
+
+    return true;
+}
+
+void GaussianMixtureModels::resizeStatistics(SufficientStatistics &statistics) const{
+    statistics.weights.resize(K);
+    statistics.sum.resize(K,N);
+    statistics.sumSquares.resize(K, useDiagonalCovariance ? N : N*(N+1)/2 );
+}
+
+void GaussianMixtureModels::clearStatistics(SufficientStatistics &statistics) const{
+    statistics.loglike = 0;
+    std::fill(statistics.weights.begin(),statistics.weights.end(),0);
+    for(unsigned int k=0; k<K; k++){
+        std::fill(statistics.sum[k],statistics.sum[k]+statistics.sum.getNumCols(),0);
+        std::fill(statistics.sumSquares[k],statistics.sumSquares[k]+statistics.sumSquares.getNumCols(),0);
+    }
+}
+
+void GaussianMixtureModels::accumulate(const double *x,SufficientStatistics &statistics,double *logResp,double *u,double *v) const{
+
+    //Compute the log of P(k) * P(x|k) for each Gaussian, up to a constant
+    double max = -INFINITY;
+    for(unsigned int k=0; k<K; k++){
+        if( frac[k] <= 0 ){
+            logResp[k] = -INFINITY;
+            continue;
+        }
+        double sum = 0;
+        if( useDiagonalCovariance ){
+            sum = DistanceKernels::weightedSquaredEuclidean(x,mu[k],invVariances[k],N);
+        }else{
+            //Solve L v = x - mu with forward substitution, the squared length of v is the Mahalanobis distance
+            const Matrix< double > &L = choleskyFactors[k];
+            for(unsigned int j=0; j<N; j++){
+                v[j] = ( x[j] - mu[k][j] - DistanceKernels::dot(L[j],v,j) ) / L[j][j];
+                sum += v[j]*v[j];
+            }
+        }
+        logResp[k] = logConstants[k] - 0.5*sum;
+        if( logResp[k] > max ) max = logResp[k];
+    }
+
+    //Normalize the responsibilities with a log-sum-exp
+    double sum = 0;
+    for(unsigned int k=0; k<K; k++) sum += exp( logResp[k]-max );
+    const double tmp = max + log( sum );
+    statistics.loglike += tmp;
+
+    //Add the responsibility weighted offsets from each mu to the statistics
+    for(unsigned int k=0; k<K; k++){
+        const double r = exp( logResp[k] - tmp );
+        if( r == 0 ) continue;
+
+        double *sumK = statistics.sum[k];
+        double *sumSquaresK = statistics.sumSquares[k];
+        statistics.weights[k] += r;
+        for(unsigned int j=0; j<N; j++){
+            u[j] = x[j] - mu[k][j];
+            sumK[j] += r * u[j];
+        }
+        if( useDiagonalCovariance ){
+            for(unsigned int j=0; j<N; j++) sumSquaresK[j] += r * u[j] * u[j];
+        }else{
+            //Only the lower triangle is summed, the rows are packed one after another
+            for(unsigned int n=0; n<N; n++){
+                const double ru = r * u[n];
+                double *row = sumSquaresK + n*(n+1)/2;
+                for(unsigned int j=0; j<=n; j++) row[j] += ru * u[j];
+            }
+        }
+    }
+}
+
+}//End of namespace GRT
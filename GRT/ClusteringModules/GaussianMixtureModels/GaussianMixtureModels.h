@@ -29,6 +29,9 @@
 #include "../../DataStructures/UnlabelledClassificationData.h"
 
 namespace GRT {
+    
+//The minimum variance of each dimension of a Gaussian (this is added to the diagonal of a full sigma), it stops a Gaussian that models fewer samples than dimensions from collapsing
+#define GMM_MIN_VARIANCE 1.0e-10
 
 class GaussianMixtureModels
 {
@@ -37,9 +40,24 @@ public:
 	~GaussianMixtureModels(void);
 
 	bool train(UnlabelledClassificationData &trainingData,UINT K);
+    
+    /**
+     Fits K Gaussians to the rows of the data matrix with the EM algorithm. Each EM iteration makes one pass over the data, the rows
+     are split into chunks and the responsibilities and sufficient statistics of each chunk are summed in parallel, these are then
+     added together in chunk order. The chunks only depend on the number of rows, so the model does not depend on the number of
+     threads. The data is not copied.
+     
+     @param const Matrix< double > &data: the training data, with one sample per row
+     @param UINT K: the number of Gaussians
+     @return returns true if the model was trained, false otherwise
+     */
+    bool train(const Matrix< double > &data,UINT K);
+    
     bool getModelTrained(){ return modelTrained; }
     
     UINT getK(){ return K; }
+    UINT getNumTrainingThreads(){ return numTrainingThreads; }
+    bool getUseDiagonalCovariance(){ return useDiagonalCovariance; }
     Matrix< double > getMu(){ if( modelTrained ){ return mu; } return Matrix<double>(); }
     vector< Matrix< double > > getSigma(){ if( modelTrained ){ return sigma; } return vector< Matrix<double> >(); }
     Matrix< double > getSigma(UINT k){
@@ -63,34 +81,73 @@ public:
         }
         return false;
     }
+    
+    /**
+     Sets the number of threads used by the EM algorithm, if numTrainingThreads is 0 then one thread is used per CPU core.
+     The result only depends on the number of threads, so a fixed number of threads will always give the same model for the same random start.
+     
+     @return returns true if the number of training threads was set successfully, false otherwise
+     */
+    bool setNumTrainingThreads(UINT numTrainingThreads){
+        this->numTrainingThreads = numTrainingThreads;
+        return true;
+    }
+    
+    /**
+     Sets if each Gaussian should only model the variance of each dimension. A diagonal covariance costs O(N) per sample and Gaussian
+     instead of O(N^2), so it is much faster for a large number of Gaussians or dimensions. The off-diagonal values of sigma are then 0.
+     
+     @return returns true if the covariance mode was set successfully, false otherwise
+     */
+    bool setUseDiagonalCovariance(bool useDiagonalCovariance){
+        this->useDiagonalCovariance = useDiagonalCovariance;
+        return true;
+    }
 	
 private:
-    double estep();
+    double estep(const Matrix< double > &data);
 	void mstep();
-	bool computeInvAndDet();
-	inline void SWAP(UINT &a,UINT &b);
-	inline double SQR(double v){ return v*v; }
+    bool computeGaussianTerms();
+    
+    //The responsibility weighted sums of one block of the training data, these are computed relative to the current mu of each Gaussian
+    struct SufficientStatistics{
+        vector< double > weights;               //The sum of the responsibilities of each Gaussian
+        Matrix< double > sum;                   //The sum of r * (x - mu) for each Gaussian, one row per Gaussian
+        Matrix< double > sumSquares;            //The lower triangle of the sum of r * (x - mu)(x - mu)' for each Gaussian (or just the diagonal), one row per Gaussian
+        double loglike;                         //The log likelihood of the block
+    };
+    
+    void resizeStatistics(SufficientStatistics &statistics) const;
+    void clearStatistics(SufficientStatistics &statistics) const;
+    void accumulate(const double *x,SufficientStatistics &statistics,double *logResp,double *u,double *v) const;
+    
+    //Returns the first row of chunk c, chunk c holds the rows [getChunkStart(c) getChunkStart(c+1))
+    UINT getChunkStart(UINT c) const{ return (UINT)( (unsigned long long)M * c / statistics.size() ); }
     
 	UINT N;                                     //The number of dimensions in the training data
 	UINT M;                                     //The number of samples in the training data
 	UINT K;                                     //The number of Gaussian Models we want to fit to the data
 	UINT maxIter;                               //The maximum number of iterations allowed during the training routine
+    UINT numTrainingThreads;                    //The number of threads used by the EM algorithm (0 = one per CPU core)
+    bool useDiagonalCovariance;                 //Sets if each Gaussian only models the variance of each dimension
 	double loglike;                             //The current loglikelihood value of the models given the data
 	double minChange;                           //The minimum change value that signals if the training routine has converged
-	Matrix<double> data;                        //A matrix holding the training data
 	Matrix<double> mu;                          //A matrix holding the estimated mean values of each Gaussian
-	Matrix<double> resp;                        //The responsibility matrix
 	vector<double> frac;                        //A vector holding the P(k)'s 
 	vector<double> lndets;                      //A vector holding the log detminants of SIGMA'k
-	vector<double> det;                         
+	vector<double> logConstants;                //A vector holding log(P(k)) - 0.5 * log(det(SIGMA'k)) for each Gaussian
 	vector< Matrix<double > > sigma;
-	vector< Matrix<double> > invSigma;
+	vector< Matrix<double> > choleskyFactors;   //The lower triangular Cholesky factor of each SIGMA'k, used if the covariance is full
+	Matrix<double> invVariances;                //The inverse of the diagonal of each SIGMA'k, used if the covariance is diagonal
+	vector< SufficientStatistics > statistics;  //The sufficient statistics summed for each chunk of the training data
 	bool modelTrained;
     bool failed;
     
     DebugLog debugLog;
     ErrorLog errorLog;
     WarningLog warningLog;
+    
+    friend class GaussianMixtureModelsEStepJob;
 	
 };
     
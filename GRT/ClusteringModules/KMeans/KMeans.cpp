@@ -20,17 +20,168 @@
 
 #include "KMeans.h"
 
+//The training data is split into at most KMEANS_MAX_NUM_CHUNKS chunks of at least KMEANS_MIN_CHUNK_SIZE rows. The chunks only depend on
+//the number of rows, and the sums of the chunks are added together in order, so the results do not depend on the number of threads
+#define KMEANS_MIN_CHUNK_SIZE 256
+#define KMEANS_MAX_NUM_CHUNKS 64
+
 namespace GRT{
 
+//Assigns the rows of the chunks [startIndex endIndex) to their closest cluster using Hamerly's bounds, and sums the rows assigned to each cluster
+class KMeansAssignJob : public ParallelJob{
+public:
+    KMeansAssignJob(KMeans *kmeans,const Matrix< double > &data):kmeans(kmeans),data(data){}
+
+    virtual void run(unsigned int /*threadIndex*/,unsigned int startIndex,unsigned int endIndex){
+        for(UINT c=startIndex; c<endIndex; c++){
+            runChunk( c );
+        }
+    }
+
+    void runChunk(UINT c){
+        const UINT K = kmeans->K;
+        const UINT N = kmeans->N;
+        const Matrix< double > &clusters = kmeans->clusters;
+        Matrix< double > &sums = kmeans->chunkClusterSums[c];
+        vector< UINT > &counts = kmeans->chunkClusterCounts[c];
+        const UINT chunkEnd = kmeans->getChunkStart(c+1);
+        UINT numChanged = 0;
+
+        for(UINT k=0; k<K; k++){
+            std::fill(sums[k],sums[k]+N,0);
+            counts[k] = 0;
+        }
+
+        for(UINT m=kmeans->getChunkStart(c); m<chunkEnd; m++){
+            const double *x = data[m];
+            UINT kmin = kmeans->assign[m];
+            double &upperBound = kmeans->upperBounds[m];
+            double &lowerBound = kmeans->lowerBounds[m];
+            bool search = kmin >= K;
+
+            if( !search ){
+                //Update the bounds with the movement of the clusters
+                upperBound += kmeans->clusterMovements[kmin];
+                lowerBound -= kmin == kmeans->maxClusterMovementIndex ? kmeans->secondMaxClusterMovement : kmeans->maxClusterMovement;
+
+                //The assigned cluster can only change if the upper bound is above both the lower bound and half the distance to the closest cluster
+                const double bound = std::max( kmeans->halfClusterDistances[kmin], lowerBound );
+                if( upperBound > bound ){
+                    upperBound = sqrt( DistanceKernels::squaredEuclidean(x,clusters[kmin],N) );
+                    search = upperBound > bound;
+                }
+            }
+
+            if( search ){
+                //Look for the closest and second closest center
+                double dmin = INFINITY;
+                double dsecond = INFINITY;
+                UINT knew = 0;
+                for(UINT k=0; k<K; k++){
+                    const double d = DistanceKernels::squaredEuclidean(x,clusters[k],N);
+                    if( d < dmin ){ dsecond = dmin; dmin = d; knew = k; }
+                    else if( d < dsecond ) dsecond = d;
+                }
+                upperBound = sqrt( dmin );
+                lowerBound = sqrt( dsecond );
+                if( knew != kmin ){
+                    numChanged++;
+                    kmeans->assign[m] = kmin = knew;
+                }
+            }
+
+            for(UINT n=0; n<N; n++) sums[kmin][n] += x[n];
+            counts[kmin]++;
+        }
+
+        kmeans->chunkNumChanged[c] = numChanged;
+    }
+
+    KMeans *kmeans;
+    const Matrix< double > &data;
+};
+
+//Finds the closest cluster to the rows indexs[startIndex endIndex), the cluster and squared distance of indexs[i] are stored in assign[i] and upperBounds[i]
+class KMeansNearestClusterJob : public ParallelJob{
+public:
+    KMeansNearestClusterJob(KMeans *kmeans,const Matrix< double > &data,const UINT *indexs):kmeans(kmeans),data(data),indexs(indexs){}
+
+    virtual void run(unsigned int /*threadIndex*/,unsigned int startIndex,unsigned int endIndex){
+        for(UINT i=startIndex; i<endIndex; i++){
+            const double *x = data[ indexs[i] ];
+            double dmin = INFINITY;
+            UINT kmin = 0;
+            for(UINT k=0; k<kmeans->K; k++){
+                const double d = DistanceKernels::squaredEuclidean(x,kmeans->clusters[k],kmeans->N);
+                if( d < dmin ){ dmin = d; kmin = k; }
+            }
+            kmeans->assign[i] = kmin;
+            kmeans->upperBounds[i] = dmin;
+        }
+    }
+
+    KMeans *kmeans;
+    const Matrix< double > &data;
+    const UINT *indexs;
+};
+
+//Updates the squared distance from the rows of the chunks [startIndex endIndex) to their closest k-means++ cluster with the new cluster,
+//and sums the distances of each chunk
+class KMeansSeedJob : public ParallelJob{
+public:
+    KMeansSeedJob(KMeans *kmeans,const Matrix< double > &data,UINT newCluster):kmeans(kmeans),data(data),newCluster(newCluster){}
+
+    virtual void run(unsigned int /*threadIndex*/,unsigned int startIndex,unsigned int endIndex){
+        for(UINT c=startIndex; c<endIndex; c++){
+            const UINT chunkEnd = kmeans->getChunkStart(c+1);
+            double sum = 0;
+            for(UINT i=kmeans->getChunkStart(c); i<chunkEnd; i++){
+                const double d = DistanceKernels::squaredEuclidean(data[i],kmeans->clusters[newCluster],kmeans->N);
+                double &minDistance = kmeans->upperBounds[i];
+                if( newCluster == 0 || d < minDistance ) minDistance = d;
+                sum += minDistance;
+            }
+            kmeans->chunkSums[c] = sum;
+        }
+    }
+
+    KMeans *kmeans;
+    const Matrix< double > &data;
+    UINT newCluster;
+};
+
+//Sums the squared distance from the rows of each of the chunks [startIndex endIndex) to their assigned cluster
+class KMeansThetaJob : public ParallelJob{
+public:
+    KMeansThetaJob(KMeans *kmeans,const Matrix< double > &data):kmeans(kmeans),data(data){}
+
+    virtual void run(unsigned int /*threadIndex*/,unsigned int startIndex,unsigned int endIndex){
+        for(UINT c=startIndex; c<endIndex; c++){
+            const UINT chunkEnd = kmeans->getChunkStart(c+1);
+            double theta = 0;
+            for(UINT m=kmeans->getChunkStart(c); m<chunkEnd; m++){
+                theta += DistanceKernels::squaredEuclidean(data[m],kmeans->clusters[ kmeans->assign[m] ],kmeans->N);
+            }
+            kmeans->chunkSums[c] = theta;
+        }
+    }
+
+    KMeans *kmeans;
+    const Matrix< double > &data;
+};
+
 //Constructor,destructor
 KMeans::KMeans(){
-    M = N = K = nchg = 0;
+    M = N = K = nchg = numChunks = 0;
     minNumEpochs = 10;
     maxNumEpochs = 1000;
     minChange = 1.0e-5;
     finalTheta = 0;
     numTrainingIterations = 0;
+    numTrainingThreads = 0;
+    batchSize = 0;
     computeTheta = true;
+    useKMeansPlusPlus = true;
     trained = false;
 }
 
@@ -55,7 +206,14 @@ bool KMeans::train(UINT K, LabelledClassificationData &trainingData){
     return train(K, data);
 }
 
-bool KMeans::train(UINT K, Matrix<double> data){
+bool KMeans::train(UINT K, const Matrix<double> &data){
+
+    trained = false;
+
+    if( K == 0 || K > data.getNumRows() ){
+        return false;
+    }
+
     this->K = K;
 	M = data.getNumRows();
 	N = data.getNumCols();
@@ -64,22 +222,13 @@ bool KMeans::train(UINT K, Matrix<double> data){
 	assign.resize(M);
 	count.resize(K);
 
-	//Randomly pick k data points as the starting clusters
-	Random random;
-	vector< UINT > randPoints(K);
-	for(UINT k=0; k<K; k++){
-        randPoints[k] = random.getRandomNumberInt(0,M);
-	}
-
-	for(UINT k=0; k<K; k++){
-		for(UINT j=0; j<N; j++){
-            clusters[k][j] = data[ randPoints[k] ][j];
-		}
-	}
+	//Pick the starting clusters
+	initClusters( data );
 
-	return train( data );
+	return batchSize > 0 && batchSize < M ? trainMiniBatch( data ) : train( data );
 }
-bool KMeans::train(Matrix<double> data,Matrix<double> clusters){
+
+bool KMeans::train(const Matrix<double> &data,const Matrix<double> &clusters){
 	this->clusters = clusters;
 	M = data.getNumRows();
 	N = data.getNumCols();
@@ -87,10 +236,10 @@ bool KMeans::train(Matrix<double> data,Matrix<double> clusters){
 	assign.resize( M );
 	count.resize( K );
 
-	return train( data );
+	return batchSize > 0 && batchSize < M ? trainMiniBatch( data ) : train( data );
 }
 
-bool KMeans::train(Matrix< double > &data){
+bool KMeans::train(const Matrix< double > &data){
 
 	UINT currentIter = 0;
     UINT numChanged = 0;
@@ -107,6 +256,15 @@ bool KMeans::train(Matrix< double > &data){
     for(UINT m=0; m<M; m++) assign[m] = K+1;
 	for(UINT k=0; k<K; k++) count[k] = 0;
 
+    //Init the bounds, there is no cluster movement before the first E step
+    upperBounds.resize(M);
+    lowerBounds.resize(M);
+    halfClusterDistances.resize(K);
+    clusterMovements.assign(K,0);
+    maxClusterMovement = secondMaxClusterMovement = 0;
+    maxClusterMovementIndex = 0;
+    resizeChunkBuffers();
+
     //Run the training loop
 	while( keepTraining ){
 
@@ -114,7 +272,7 @@ bool KMeans::train(Matrix< double > &data){
 		numChanged = estep(data);
 
         //Compute the M step
-        mstep(data);
+        mstep();
 
         //Update the iteration counter
         currentIter++;
@@ -127,78 +285,208 @@ bool KMeans::train(Matrix< double > &data){
         if( computeTheta )  thetaTracker.push_back( theta );
 	}
 
+    //Free the training buffers
+    upperBounds.clear();
+    lowerBounds.clear();
+    chunkClusterSums.clear();
+    chunkClusterCounts.clear();
+
     finalTheta = theta;
     numTrainingIterations = currentIter;
     trained = true;
 	return converged;
 }
 
-UINT KMeans::estep(Matrix< double > &data) {
-		UINT k,m,n,kmin;
-		double dmin,d;
-		nchg = 0;
-		kmin = 0;
-
-		//Reset Count
-		for (k=0;k<K;k++) count[k] = 0;
-
-		//Look for the closest center and reasign if needed
-		for (m=0; m<M; m++) {
-			dmin = 9.99e+99;
-			for (k=0; k<K; k++) {
-				d = 0.0;
-				for (n=0; n<N; n++)
-					d += SQR( data[m][n]-clusters[k][n] );
-				if (d <= dmin){ dmin = d; kmin = k; }
-			}
-			if ( kmin != assign[m] ){
-                nchg++;
-                assign[m] = kmin;
+bool KMeans::trainMiniBatch(const Matrix< double > &data){
+
+    Random random;
+    vector< UINT > batchIndexs( batchSize );
+    vector< UINT > clusterCounts( K, 0 );
+    thetaTracker.clear();
+    finalTheta = 0;
+    numTrainingIterations = 0;
+    trained = false;
+
+    //The batch assignments are stored in the first batchSize values of assign and the distances in the upper bounds
+    upperBounds.resize(M);
+
+    for(UINT iter=0; iter<maxNumEpochs; iter++){
+
+        //Pick a random mini-batch and find the closest cluster to each row in it
+        for(UINT i=0; i<batchSize; i++){
+            batchIndexs[i] = random.getRandomNumberInt(0,M);
+        }
+        KMeansNearestClusterJob job(this,data,&batchIndexs[0]);
+        ParallelFor::run(job,batchSize,numTrainingThreads,ParallelFor::getMinTasksPerThread((unsigned long long)K*N));
+
+        //Move each cluster towards its rows, the learning rate of each cluster is the inverse of the number of rows it has been given
+        double theta = 0;
+        for(UINT i=0; i<batchSize; i++){
+            const UINT k = assign[i];
+            const double *x = data[ batchIndexs[i] ];
+            const double eta = 1.0 / double( ++clusterCounts[k] );
+            for(UINT n=0; n<N; n++){
+                clusters[k][n] = (1.0-eta) * clusters[k][n] + eta * x[n];
             }
-			count[kmin]++;
-		}
-		return nchg;
+            theta += upperBounds[i];
+        }
+
+        //Scale the theta of the batch up to an estimate for all the data
+        if( computeTheta ) thetaTracker.push_back( theta * double(M) / double(batchSize) );
+    }
+
+    //Assign all the data to the final clusters
+    vector< UINT > indexs( M );
+    for(UINT i=0; i<M; i++) indexs[i] = i;
+    KMeansNearestClusterJob job(this,data,&indexs[0]);
+    ParallelFor::run(job,M,numTrainingThreads,ParallelFor::getMinTasksPerThread((unsigned long long)K*N));
+    for(UINT k=0; k<K; k++) count[k] = 0;
+    for(UINT i=0; i<M; i++) count[ assign[i] ]++;
+
+    upperBounds.clear();
+
+    finalTheta = computeTheta ? calculateTheta(data) : 0;
+    numTrainingIterations = maxNumEpochs;
+    trained = true;
+    return true;
 }
 
-void KMeans::mstep(Matrix< double > &data) {
-    UINT n,k,m;
+void KMeans::initClusters(const Matrix< double > &data){
+
+    Random random;
+
+    if( !useKMeansPlusPlus ){
+        //Randomly pick k data points as the starting clusters
+        for(UINT k=0; k<K; k++){
+            const UINT index = random.getRandomNumberInt(0,M);
+            for(UINT j=0; j<N; j++){
+                clusters[k][j] = data[ index ][j];
+            }
+        }
+        return;
+    }
+
+    //Pick the first cluster at random, then pick each new cluster with a probability proportional to the squared distance of each row
+    //from its closest cluster. The squared distances are stored in the upper bounds
+    resizeChunkBuffers();
+    upperBounds.assign( M, 0 );
+    UINT index = random.getRandomNumberInt(0,M);
+    for(UINT k=0; k<K; k++){
+        for(UINT j=0; j<N; j++){
+            clusters[k][j] = data[ index ][j];
+        }
+        if( k+1 == K ) break;
+
+        //Update the squared distances with the new cluster and sum them
+        KMeansSeedJob job(this,data,k);
+        ParallelFor::run(job,numChunks,numTrainingThreads,ParallelFor::getMinTasksPerThread((unsigned long long)getChunkStart(1)*N));
+        double sum = 0;
+        for(UINT c=0; c<numChunks; c++) sum += chunkSums[c];
+
+        //If every row is on a cluster then pick the next cluster at random
+        if( sum <= 0 ){
+            index = random.getRandomNumberInt(0,M);
+            continue;
+        }
+
+        double target = random.getRandomNumberUniform(0,sum);
+        index = M-1;
+        for(UINT i=0; i<M; i++){
+            target -= upperBounds[i];
+            if( target < 0 && upperBounds[i] > 0 ){ index = i; break; }
+        }
+    }
+    upperBounds.clear();
+}
 
-    //Reset means to zero
-    for (k=0;k<K;k++)
-        for (n=0;n<N;n++)
-            clusters[k][n] = 0.;
+UINT KMeans::estep(const Matrix< double > &data) {
 
-    //Get new mean by adding assigned data points and dividing by the number of values in each cluster
-    for(m=0; m<M; m++)
-        for(n=0; n<N; n++)
-            clusters[ assign[m] ][n] += data[m][n];
+    //Find half the distance from each cluster to its closest other cluster, a row closer than this to its cluster can not be closer to another
+    for(UINT k=0; k<K; k++){
+        double minDistance = INFINITY;
+        for(UINT j=0; j<K; j++){
+            if( j == k ) continue;
+            minDistance = std::min( minDistance, DistanceKernels::squaredEuclidean(clusters[k],clusters[j],N) );
+        }
+        halfClusterDistances[k] = 0.5 * sqrt( minDistance );
+    }
 
-    for (k=0; k<K; k++) {
-        if (count[k] > 0){
-            for (n=0; n<N; n++){
-                clusters[k][n] /= double(count[k]);
+    //Look for the closest center and reasign if needed, this also sums the rows assigned to each cluster. The first E step has to
+    //search every cluster for every row, this is used as the amount of work in each chunk
+    KMeansAssignJob job(this,data);
+    ParallelFor::run(job,numChunks,numTrainingThreads,ParallelFor::getMinTasksPerThread((unsigned long long)getChunkStart(1)*K*N));
+
+    //Add the results of each chunk together in order
+    nchg = 0;
+    for(UINT k=0; k<K; k++) count[k] = 0;
+    for(UINT c=0; c<numChunks; c++){
+        nchg += chunkNumChanged[c];
+        for(UINT k=0; k<K; k++) count[k] += chunkClusterCounts[c][k];
+        if( c > 0 ){
+            for(UINT k=0; k<K; k++){
+                for(UINT n=0; n<N; n++) chunkClusterSums[0][k][n] += chunkClusterSums[c][k][n];
             }
         }
     }
+
+    return nchg;
 }
 
-double KMeans::calculateTheta(Matrix< double > &data){
+void KMeans::mstep() {
 
-	double theta = 0;
+    //Get new mean by dividing the sum of the assigned data points by the number of values in each cluster, a cluster with no values is not moved
+    maxClusterMovement = secondMaxClusterMovement = 0;
+    maxClusterMovementIndex = 0;
+    for(UINT k=0; k<K; k++){
+        clusterMovements[k] = 0;
+        if( count[k] == 0 ) continue;
 
-	for(UINT m=0; m<M; m++){
-		UINT k = assign[m];
-		double sum = 0;
-		for(UINT n=0;n<N;n++){
-				sum += SQR(clusters[k][n] - data[m][n]);
-		}
-		theta += sum;
-	}
+        double movement = 0;
+        for(UINT n=0; n<N; n++){
+            const double value = chunkClusterSums[0][k][n] / double(count[k]);
+            movement += SQR( value - clusters[k][n] );
+            clusters[k][n] = value;
+        }
+        clusterMovements[k] = sqrt( movement );
+
+        //Track the two largest movements, these are used to update the lower bounds
+        if( clusterMovements[k] > maxClusterMovement ){
+            secondMaxClusterMovement = maxClusterMovement;
+            maxClusterMovement = clusterMovements[k];
+            maxClusterMovementIndex = k;
+        }else if( clusterMovements[k] > secondMaxClusterMovement ){
+            secondMaxClusterMovement = clusterMovements[k];
+        }
+    }
+}
+
+double KMeans::calculateTheta(const Matrix< double > &data){
+
+    resizeChunkBuffers();
+    KMeansThetaJob job(this,data);
+    ParallelFor::run(job,numChunks,numTrainingThreads,ParallelFor::getMinTasksPerThread((unsigned long long)getChunkStart(1)*N));
+
+	double theta = 0;
+    for(UINT c=0; c<numChunks; c++){
+        theta += chunkSums[c];
+    }
 
 	return theta;
 
 }
 
+void KMeans::resizeChunkBuffers(){
+    numChunks = std::max( std::min( (M + KMEANS_MIN_CHUNK_SIZE - 1) / KMEANS_MIN_CHUNK_SIZE, (UINT)KMEANS_MAX_NUM_CHUNKS ), (UINT)1 );
+    chunkClusterSums.resize( numChunks );
+    chunkClusterCounts.resize( numChunks );
+    chunkNumChanged.resize( numChunks );
+    chunkSums.resize( numChunks );
+    for(UINT c=0; c<numChunks; c++){
+        chunkClusterSums[c].resize(K,N);
+        chunkClusterCounts[c].resize(K);
+    }
+}
+
 
 bool KMeans::saveKMeansModelToFile(string fileName){
 
@@ -318,4 +606,19 @@ bool KMeans::setMaxNumEpochs(UINT maxNumEpochs){
     return false;
 }
 
+bool KMeans::setNumTrainingThreads(UINT numTrainingThreads){
+    this->numTrainingThreads = numTrainingThreads;
+    return true;
+}
+
+bool KMeans::setBatchSize(UINT batchSize){
+    this->batchSize = batchSize;
+    return true;
+}
+
+bool KMeans::setUseKMeansPlusPlus(bool useKMeansPlusPlus){
+    this->useKMeansPlusPlus = useKMeansPlusPlus;
+    return true;
+}
+
 }//End of namespace GRT
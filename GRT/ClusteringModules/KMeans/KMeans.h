@@ -33,8 +33,22 @@ public:
     ~KMeans();
     
     bool train(UINT K, LabelledClassificationData &trainingData);
-	bool train(UINT K, Matrix<double> data);
-	bool train(Matrix<double> data,Matrix<double> clusters);
+    
+    /**
+     Clusters the rows of data into K clusters. The starting clusters are picked with k-means++ (or at random if k-means++ is disabled).
+     If the batch size is 0 then each iteration assigns every row to its closest cluster, using Hamerly's bounds to skip the rows whose
+     closest cluster can not have changed, otherwise each iteration updates the clusters from a random mini-batch of rows.
+     
+     @return returns true if the training converged, false otherwise
+     */
+	bool train(UINT K, const Matrix<double> &data);
+    
+    /**
+     Clusters the rows of data, starting from the clusters given (one cluster per row).
+     
+     @return returns true if the training converged, false otherwise
+     */
+	bool train(const Matrix<double> &data,const Matrix<double> &clusters);
 	bool saveKMeansModelToFile(string fileName);
 	bool loadKMeansModelFromFile(string fileName);
 
@@ -42,6 +56,9 @@ public:
 	UINT getNumClusters(){ return K; }
 	UINT getNumDimensions(){ return N; }
     UINT getNumTrainingIterations(){ return numTrainingIterations; }
+    UINT getNumTrainingThreads(){ return numTrainingThreads; }
+    UINT getBatchSize(){ return batchSize; }
+    bool getUseKMeansPlusPlus(){ return useKMeansPlusPlus; }
 	double getTheta(){ return finalTheta; }
     inline double SQR(const double a) {return a*a;};
     vector< double > getTrainingThetaLog(){ return thetaTracker; }
@@ -55,12 +72,29 @@ public:
     bool setMinChange(double minChange);
     bool setMinNumEpochs(UINT minNumEpochs);
     bool setMaxNumEpochs(UINT maxNumEpochs);
+    
+    //Sets the number of threads used to assign the data to the clusters, 0 will use one thread per CPU core
+    bool setNumTrainingThreads(UINT numTrainingThreads);
+    
+    //Sets the number of random rows used to update the clusters at each iteration, 0 will use all the data. With a mini-batch the
+    //training runs for maxNumEpochs iterations and the theta log holds an estimate of theta from each batch
+    bool setBatchSize(UINT batchSize);
+    
+    //Sets if the starting clusters are picked with k-means++, which picks each new cluster with a probability proportional to its
+    //squared distance from the closest cluster already picked, or uniformly at random
+    bool setUseKMeansPlusPlus(bool useKMeansPlusPlus);
 
 private:
-	bool train(Matrix< double > &data);
-    UINT estep(Matrix< double > &data);
-	void mstep(Matrix< double > &data);
-	double calculateTheta(Matrix< double > &data);
+	bool train(const Matrix< double > &data);
+    bool trainMiniBatch(const Matrix< double > &data);
+    void initClusters(const Matrix< double > &data);
+    UINT estep(const Matrix< double > &data);
+	void mstep();
+	double calculateTheta(const Matrix< double > &data);
+    void resizeChunkBuffers();
+
+    //Returns the first row of chunk c, chunk c holds the rows [getChunkStart(c) getChunkStart(c+1))
+    UINT getChunkStart(UINT c) const{ return (UINT)( (unsigned long long)M * c / numChunks ); }
 
 	UINT M;                             //Number of training examples
 	UINT N;                             //Number of dimensions
@@ -69,13 +103,37 @@ private:
     UINT minNumEpochs;      
     UINT maxNumEpochs;
     UINT numTrainingIterations;
+    UINT numTrainingThreads;            //The number of threads used to assign the data (0 = one per CPU core)
+    UINT batchSize;                     //The number of rows in each mini-batch (0 = use all the data)
 	double finalTheta;
     double minChange;
     Matrix<double> clusters;
 	vector< UINT > assign, count;
     vector< double > thetaTracker;
 	bool computeTheta;
+    bool useKMeansPlusPlus;
     bool trained;
+    
+    //Hamerly's bounds, these are only used while training
+    vector< double > upperBounds;       //An upper bound on the distance from each row to its assigned cluster
+    vector< double > lowerBounds;       //A lower bound on the distance from each row to its second closest cluster
+    vector< double > halfClusterDistances;  //Half the distance from each cluster to its closest other cluster
+    vector< double > clusterMovements;  //The distance each cluster moved in the last M step
+    double maxClusterMovement;          //The largest cluster movement
+    double secondMaxClusterMovement;    //The second largest cluster movement
+    UINT maxClusterMovementIndex;       //The cluster with the largest movement
+    
+    //The sums computed for each chunk of rows during training, these are added together in chunk order
+    UINT numChunks;                     //The number of chunks the training data is split into
+    vector< Matrix< double > > chunkClusterSums;
+    vector< vector< UINT > > chunkClusterCounts;
+    vector< UINT > chunkNumChanged;
+    vector< double > chunkSums;
+    
+    friend class KMeansAssignJob;
+    friend class KMeansNearestClusterJob;
+    friend class KMeansSeedJob;
+    friend class KMeansThetaJob;
 		
 };
     
@@ -35,7 +35,7 @@ Gate::~Gate(){
     
 }
 
-bool Gate::process(vector< double > inputVector){
+bool Gate::process(const vector< double > &inputVector){
     data = inputVector;
     okToContinue = gateOpen;
     return true;
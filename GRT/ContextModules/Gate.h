@@ -47,7 +47,7 @@ public:
         return false;
     }
     
-    virtual bool process(vector< double > inputVector);
+    virtual bool process(const vector< double > &inputVector);
     virtual bool reset();
     
     bool updateContext(bool value){ 
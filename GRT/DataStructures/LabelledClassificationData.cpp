@@ -19,6 +19,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
 #include "LabelledClassificationData.h"
+#include "MappedLabelledClassificationData.h"
 
 namespace GRT{
 
@@ -299,6 +300,12 @@ double inline LabelledClassificationData::scale(double x,double minSource,double
 
 bool LabelledClassificationData::saveDatasetToFile(string filename){
 
+    //Use the binary format if the file has the binary extension
+    const string binaryExtension = GRT_LCD_BINARY_FILE_EXTENSION;
+    if( filename.size() >= binaryExtension.size() && filename.compare(filename.size()-binaryExtension.size(),binaryExtension.size(),binaryExtension) == 0 ){
+        return saveDatasetToBinaryFile( filename );
+    }
+
 	std::fstream file;
 	file.open(filename.c_str(), std::ios::out);
 
@@ -342,6 +349,11 @@ bool LabelledClassificationData::saveDatasetToFile(string filename){
 
 bool LabelledClassificationData::loadDatasetFromFile(string filename){
 
+    //Check if the file uses the binary format
+    if( MappedLabelledClassificationData::isBinaryFile( filename ) ){
+        return loadDatasetFromBinaryFile( filename );
+    }
+
 	std::fstream file;
 	file.open(filename.c_str(), std::ios::in);
 	UINT numClasses = 0;
@@ -473,6 +485,116 @@ bool LabelledClassificationData::loadDatasetFromFile(string filename){
 }
 
 
+bool LabelledClassificationData::saveDatasetToBinaryFile(string filename,bool useFloat32){
+
+	std::fstream file;
+	file.open(filename.c_str(), std::ios::out | std::ios::binary);
+
+	if( !file.is_open() ){
+        errorLog << "saveDatasetToBinaryFile(string filename,bool useFloat32) - could not open file!" << endl;
+		return false;
+	}
+
+    //Write the dataset info and the class tracker into a buffer first, so the offsets of the labels and samples are known
+    std::ostringstream info( std::ios::out | std::ios::binary );
+    UINT length = (UINT)datasetName.size();
+    info.write((const char*)&length,sizeof(UINT));
+    info.write(datasetName.c_str(),length);
+    length = (UINT)infoText.size();
+    info.write((const char*)&length,sizeof(UINT));
+    info.write(infoText.c_str(),length);
+    for(UINT k=0; k<classTracker.size(); k++){
+        info.write((const char*)&classTracker[k].classLabel,sizeof(UINT));
+        info.write((const char*)&classTracker[k].counter,sizeof(UINT));
+        length = (UINT)classTracker[k].className.size();
+        info.write((const char*)&length,sizeof(UINT));
+        info.write(classTracker[k].className.c_str(),length);
+    }
+    if( useExternalRanges ){
+        for(UINT j=0; j<numDimensions; j++){
+            info.write((const char*)&externalRanges[j].minValue,sizeof(double));
+            info.write((const char*)&externalRanges[j].maxValue,sizeof(double));
+        }
+    }
+    const string infoBuffer = info.str();
+
+    //The labels follow the info, and the samples start at the next aligned offset after the labels
+    const UINT headerSize = GRT_LCD_BINARY_FILE_HEADER_SIZE + 8*sizeof(UINT) + 2*sizeof(unsigned long long);
+    const unsigned long long labelsOffset = ((headerSize + infoBuffer.size() + sizeof(UINT) - 1) / sizeof(UINT)) * sizeof(UINT);
+    const unsigned long long labelsEnd = labelsOffset + (unsigned long long)totalNumSamples * sizeof(UINT);
+    const unsigned long long samplesOffset = ((labelsEnd + GRT_LCD_BINARY_SAMPLES_ALIGNMENT - 1) / GRT_LCD_BINARY_SAMPLES_ALIGNMENT) * GRT_LCD_BINARY_SAMPLES_ALIGNMENT;
+
+    UINT fields[8];
+    fields[0] = GRT_LCD_BINARY_FILE_VERSION;
+    fields[1] = GRT_LCD_BINARY_BYTE_ORDER_MARK;
+    fields[2] = useFloat32 ? sizeof(float) : sizeof(double);
+    fields[3] = numDimensions;
+    fields[4] = totalNumSamples;
+    fields[5] = (UINT)classTracker.size();
+    fields[6] = useExternalRanges ? 1 : 0;
+    fields[7] = 0;
+
+    const char padding[ GRT_LCD_BINARY_SAMPLES_ALIGNMENT ] = {0};
+    file.write(GRT_LCD_BINARY_FILE_HEADER,GRT_LCD_BINARY_FILE_HEADER_SIZE);
+    file.write((const char*)fields,sizeof(fields));
+    file.write((const char*)&labelsOffset,sizeof(labelsOffset));
+    file.write((const char*)&samplesOffset,sizeof(samplesOffset));
+    file.write(infoBuffer.c_str(),infoBuffer.size());
+    file.write(padding,labelsOffset - headerSize - infoBuffer.size());
+
+    for(UINT i=0; i<totalNumSamples; i++){
+        UINT classLabel = data[i].getClassLabel();
+        file.write((const char*)&classLabel,sizeof(UINT));
+    }
+    file.write(padding,samplesOffset - labelsEnd);
+
+    vector< float > floatSample( useFloat32 ? numDimensions : 0 );
+    for(UINT i=0; i<totalNumSamples && numDimensions > 0; i++){
+        if( useFloat32 ){
+            for(UINT j=0; j<numDimensions; j++) floatSample[j] = (float)data[i][j];
+            file.write((const char*)&floatSample[0],numDimensions*sizeof(float));
+        }else file.write((const char*)&data[i][0],numDimensions*sizeof(double));
+    }
+
+    if( !file.good() ){
+        errorLog << "saveDatasetToBinaryFile(string filename,bool useFloat32) - failed to write file!" << endl;
+        file.close();
+        return false;
+    }
+
+	file.close();
+	return true;
+}
+
+bool LabelledClassificationData::loadDatasetFromBinaryFile(string filename){
+
+    clear();
+
+    MappedLabelledClassificationData mappedData;
+    if( !mappedData.load( filename ) ){
+        errorLog << "loadDatasetFromBinaryFile(string filename) - failed to load file!" << endl;
+        return false;
+    }
+
+    datasetName = mappedData.getDatasetName();
+    infoText = mappedData.getInfoText();
+    numDimensions = mappedData.getNumDimensions();
+    totalNumSamples = mappedData.getNumSamples();
+    classTracker = mappedData.getClassTracker();
+    useExternalRanges = mappedData.getUseExternalRanges();
+    if( useExternalRanges ) externalRanges = mappedData.getExternalRanges();
+
+    //Copy the samples straight from the mapped file
+    data.resize( totalNumSamples );
+    vector< double > sample( numDimensions );
+    for(UINT i=0; i<totalNumSamples; i++){
+        mappedData.getSample(i,sample);
+        data[i].set(mappedData.getClassLabel(i), sample);
+    }
+
+    return true;
+}
+
 bool LabelledClassificationData::saveDatasetToCSVFile(string filename){
 
     std::fstream file;
@@ -914,6 +1036,13 @@ LabelledClassificationData LabelledClassificationData::getTestFoldData(UINT fold
     return testData;
 }
 
+vector< UINT > LabelledClassificationData::getTestFoldIndexs(UINT foldIndex) const{
+
+    if( !crossValidationSetup || foldIndex >= kFoldValue ) return vector< UINT >();
+
+    return crossValidationIndexs[ foldIndex ];
+}
+
 LabelledClassificationData LabelledClassificationData::getClassData(UINT classLabel){
     LabelledClassificationData classData;
     classData.setNumDimensions( this->numDimensions );
@@ -96,6 +96,10 @@ public:
 		return data[i];
 	}
 
+	inline const LabelledClassificationSample& operator[] (const UINT &i) const{
+		return data[i];
+	}
+
 	/**
      Clears any previous training data and counters
     */
@@ -222,6 +226,7 @@ public:
 	
 	/**
      Saves the labelled classification data to a custom file format.
+     If the filename ends with GRT_LCD_BINARY_FILE_EXTENSION (.grtb) then the binary format is used, otherwise the text format is used.
 
 	 @param string filename: the name of the file the data will be saved to
 	 @return true if the data was saved successfully, false otherwise
@@ -230,12 +235,32 @@ public:
 	
 	/**
      Loads the labelled classification data from a custom file format.
+     The format is picked from the start of the file, so both text and binary files can be loaded.
 
 	 @param string filename: the name of the file the data will be loaded from
 	 @return true if the data was loaded successfully, false otherwise
     */
 	bool loadDatasetFromFile(string filename);
     
+    /**
+     Saves the labelled classification data to the binary file format, see MappedLabelledClassificationData for the layout of the file.
+     A binary file is much faster to load than a text file and can be used in place with a MappedLabelledClassificationData.
+     
+	 @param string filename: the name of the file the data will be saved to
+     @param bool useFloat32: if true the samples are stored as float32 values, which halves the size of the file but loses precision, default value is false
+	 @return true if the data was saved successfully, false otherwise
+     */
+    bool saveDatasetToBinaryFile(string filename,bool useFloat32 = false);
+    
+    /**
+     Loads the labelled classification data from the binary file format. The file is memory mapped and the samples are copied straight
+     from the mapping, without being parsed.
+     
+	 @param string filename: the name of the file the data will be loaded from
+	 @return true if the data was loaded successfully, false otherwise
+     */
+    bool loadDatasetFromBinaryFile(string filename);
+    
     /**
      Saves the labelled classification data to a CSV file.
      This will save the class label as the first column and the sample data as the following N columns, where N is the number of dimensions in the data.  Each row will represent a sample.
@@ -310,6 +335,15 @@ public:
     */
     LabelledClassificationData getTestFoldData(UINT foldIndex);
     
+    /**
+     Returns the indexs of the samples in the test dataset for the k-th fold for cross validation, this lets the fold be used without copying
+     the samples into a new dataset. The spiltDataIntoKFolds(UINT K) function should have been called once before using this function.
+     
+	 @param UINT foldIndex: the index of the fold you want the test indexs for, this should be in the range [0 K-1], where K is the number of folds the data was spilt into 
+	 @return returns the indexs of the test samples, this will be empty if the fold is not valid
+    */
+    vector< UINT > getTestFoldIndexs(UINT foldIndex) const;
+    
     /**
      Returns the all the data with the class label set by classLabel.
      The classLabel should be a valid classLabel, otherwise the dataset returned will be empty.
@@ -355,21 +389,21 @@ public:
      
 	 @return an unsigned int representing the number of dimensions in the classification data
     */
-	UINT inline getNumDimensions(){ return numDimensions; }
+	UINT inline getNumDimensions() const{ return numDimensions; }
 	
 	/**
      Gets the number of samples in the classification data across all the classes.
      
 	 @return an unsigned int representing the total number of samples in the classification data
     */
-	UINT inline getNumSamples(){ return totalNumSamples; }
+	UINT inline getNumSamples() const{ return totalNumSamples; }
 	
 	/**
      Gets the number of classes.
      
 	 @return an unsigned int representing the number of classes
     */
-	UINT inline getNumClasses(){ return (UINT)classTracker.size(); }
+	UINT inline getNumClasses() const{ return (UINT)classTracker.size(); }
     
     /**
      Gets the minimum class label in the dataset. If there are no values in the dataset then the value 99999 will be returned.
@@ -411,7 +445,7 @@ public:
      
 	 @return a vector of ClassTracker, one for each class in the dataset
     */
-    vector< ClassTracker > getClassTracker(){ return classTracker; }
+    vector< ClassTracker > getClassTracker() const{ return classTracker; }
     
 	/**
      Gets the classification data.
@@ -52,11 +52,15 @@ public:
 		return sample[n];
 	}
 
+	inline const double& operator[] (const UINT &n) const{
+		return sample[n];
+	}
+
 	void clear();
 
     //Getters
-    UINT getNumDimensions(){ return numDimensions; }
-    UINT getClassLabel(){ return classLabel; }
+    UINT getNumDimensions() const{ return numDimensions; }
+    UINT getClassLabel() const{ return classLabel; }
     vector< double > getSample(){ return sample; }
     
     //Setters
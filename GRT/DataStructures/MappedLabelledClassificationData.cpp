@@ -0,0 +1,150 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "MappedLabelledClassificationData.h"
+
+namespace GRT{
+
+MappedLabelledClassificationData::MappedLabelledClassificationData():errorLog("[ERROR MappedLCD]"){
+    clear();
+}
+
+MappedLabelledClassificationData::~MappedLabelledClassificationData(){}
+
+void MappedLabelledClassificationData::clear(){
+    file.close();
+    datasetName = "NOT_SET";
+    infoText = "";
+    numDimensions = 0;
+    totalNumSamples = 0;
+    bytesPerValue = 0;
+    useExternalRanges = false;
+    externalRanges.clear();
+    classTracker.clear();
+    classLabels = NULL;
+    samples = NULL;
+}
+
+bool MappedLabelledClassificationData::isBinaryFile(string filename){
+
+    std::fstream file;
+    file.open(filename.c_str(), std::ios::in | std::ios::binary);
+    if( !file.is_open() ) return false;
+
+    char header[ GRT_LCD_BINARY_FILE_HEADER_SIZE ];
+    file.read(header,GRT_LCD_BINARY_FILE_HEADER_SIZE);
+    const bool isBinary = file.gcount() == GRT_LCD_BINARY_FILE_HEADER_SIZE && memcmp(header,GRT_LCD_BINARY_FILE_HEADER,GRT_LCD_BINARY_FILE_HEADER_SIZE) == 0;
+    file.close();
+
+    return isBinary;
+}
+
+bool MappedLabelledClassificationData::load(string filename){
+
+    clear();
+
+    if( !file.open(filename) ){
+        errorLog << "load(string filename) - could not map file!" << endl;
+        return false;
+    }
+
+    BinaryReader reader(file.getData(),file.getSize());
+    char header[ GRT_LCD_BINARY_FILE_HEADER_SIZE ];
+    if( !reader.read(header,GRT_LCD_BINARY_FILE_HEADER_SIZE) || memcmp(header,GRT_LCD_BINARY_FILE_HEADER,GRT_LCD_BINARY_FILE_HEADER_SIZE) != 0 ){
+        errorLog << "load(string filename) - could not find file header!" << endl;
+        clear();
+        return false;
+    }
+
+    UINT version = 0;
+    UINT byteOrderMark = 0;
+    UINT numClasses = 0;
+    UINT externalRangesFlag = 0;
+    UINT reserved = 0;
+    unsigned long long labelsOffset = 0;
+    unsigned long long samplesOffset = 0;
+    if( !reader.read(version) || !reader.read(byteOrderMark) || !reader.read(bytesPerValue) || !reader.read(numDimensions) || !reader.read(totalNumSamples) ||
+        !reader.read(numClasses) || !reader.read(externalRangesFlag) || !reader.read(reserved) ||
+        !reader.read(&labelsOffset,sizeof(labelsOffset)) || !reader.read(&samplesOffset,sizeof(samplesOffset)) ){
+        errorLog << "load(string filename) - the file header is truncated!" << endl;
+        clear();
+        return false;
+    }
+
+    if( version != GRT_LCD_BINARY_FILE_VERSION ){
+        errorLog << "load(string filename) - unsupported file version: " << version << endl;
+        clear();
+        return false;
+    }
+
+    if( byteOrderMark != GRT_LCD_BINARY_BYTE_ORDER_MARK ){
+        errorLog << "load(string filename) - the file was written on a machine with a different byte order!" << endl;
+        clear();
+        return false;
+    }
+
+    if( bytesPerValue != sizeof(double) && bytesPerValue != sizeof(float) ){
+        errorLog << "load(string filename) - unsupported value size: " << bytesPerValue << endl;
+        clear();
+        return false;
+    }
+
+    //Load the dataset info and the class tracker
+    useExternalRanges = externalRangesFlag != 0;
+    classTracker.resize( numClasses );
+    bool headerValid = reader.read(datasetName) && reader.read(infoText);
+    for(UINT k=0; k<numClasses && headerValid; k++){
+        headerValid = reader.read(classTracker[k].classLabel) && reader.read(classTracker[k].counter) && reader.read(classTracker[k].className);
+    }
+    if( useExternalRanges && headerValid ){
+        externalRanges.resize( numDimensions );
+        for(UINT j=0; j<numDimensions && headerValid; j++){
+            headerValid = reader.read(externalRanges[j].minValue) && reader.read(externalRanges[j].maxValue);
+        }
+    }
+
+    //Check the labels and the samples are inside the file, and aligned so they can be used in place
+    const unsigned long long labelsSize = (unsigned long long)totalNumSamples * sizeof(UINT);
+    const unsigned long long samplesSize = (unsigned long long)totalNumSamples * numDimensions * bytesPerValue;
+    if( !headerValid || labelsOffset < reader.getPosition() || labelsOffset % sizeof(UINT) != 0 || labelsOffset + labelsSize > samplesOffset ||
+        samplesOffset % GRT_LCD_BINARY_SAMPLES_ALIGNMENT != 0 || samplesOffset > file.getSize() || samplesSize > file.getSize() - samplesOffset ){
+        errorLog << "load(string filename) - the file is truncated or corrupt!" << endl;
+        clear();
+        return false;
+    }
+
+    classLabels = (const UINT*)(file.getData() + labelsOffset);
+    samples = file.getData() + samplesOffset;
+
+    return true;
+}
+
+void MappedLabelledClassificationData::getSample(UINT i,vector< double > &sample) const{
+    sample.resize( numDimensions );
+    if( bytesPerValue == sizeof(double) ){
+        const double *x = getSample(i);
+        std::copy(x,x+numDimensions,sample.begin());
+    }else{
+        const float *x = getFloatSample(i);
+        std::copy(x,x+numDimensions,sample.begin());
+    }
+}
+
+} //End of namespace GRT
@@ -0,0 +1,136 @@
+/**
+ @file
+ @author  Nicholas Gillian <ngillian@media.mit.edu>
+ @version 1.0
+
+ @section LICENSE
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ @section DESCRIPTION
+ The MappedLabelledClassificationData gives read only access to a LabelledClassificationData binary file without loading it. The file is
+ memory mapped and each sample is returned as a pointer into the mapping, so a dataset larger than the available memory can be used and
+ opening a file takes the same time whatever its size.
+
+ A binary file is written by LabelledClassificationData::saveDatasetToBinaryFile. All the values are stored in the byte order of the machine
+ that wrote the file (little-endian on every platform the GRT builds for), and a file with a different byte order is rejected. The layout is:
+
+ - the 16 byte file header GRT_LCD_BINARY_FILE_HEADER
+ - the file version, the byte order mark GRT_LCD_BINARY_BYTE_ORDER_MARK, the number of bytes per value (8 for float64, 4 for float32), the number
+   of dimensions, the number of samples, the number of classes, the use external ranges flag and a reserved 0, each as a 32 bit unsigned int
+ - the offsets of the class labels and the samples from the start of the file, each as a 64 bit unsigned int
+ - the dataset name and the info text, each as a 32 bit length followed by the characters
+ - the class label, counter and class name (as a string) of each class
+ - the min and max value of each dimension as float64 values, if the external ranges are used
+ - the class label of each sample as a 32 bit unsigned int, starting at the class labels offset
+ - the samples, one after another with the values of each sample next to each other, starting at the samples offset (which is a multiple of 64)
+ */
+
+#pragma once
+
+#include "../Util/GRTCommon.h"
+
+#define GRT_LCD_BINARY_FILE_HEADER "GRT_LCD_BINARY\n"                   //The first 16 bytes of a binary file, including the terminating 0
+#define GRT_LCD_BINARY_FILE_HEADER_SIZE 16
+#define GRT_LCD_BINARY_FILE_VERSION 1
+#define GRT_LCD_BINARY_BYTE_ORDER_MARK 0x01020304
+#define GRT_LCD_BINARY_SAMPLES_ALIGNMENT 64
+#define GRT_LCD_BINARY_FILE_EXTENSION ".grtb"                           //LabelledClassificationData::saveDatasetToFile uses the binary format for this extension
+
+namespace GRT{
+
+class MappedLabelledClassificationData{
+public:
+    MappedLabelledClassificationData();
+    ~MappedLabelledClassificationData();
+
+    /**
+     Maps a LabelledClassificationData binary file into memory. Only the header of the file is read, the samples are read by the operating
+     system as they are used.
+
+	 @param string filename: the name of the binary file
+	 @return true if the file was mapped and its header is valid, false otherwise
+    */
+    bool load(string filename);
+
+    /**
+     Removes the mapping of the file, any pointer returned by getSample or getFloatSample is invalid after this.
+    */
+    void clear();
+
+    /**
+     Checks if the file starts with the binary file header, this is used to pick the format when a dataset is loaded.
+
+	 @param string filename: the name of the file to check
+	 @return true if the file is a LabelledClassificationData binary file, false otherwise
+    */
+    static bool isBinaryFile(string filename);
+
+    /**
+     Gets the sample at index i, without copying it. The pointer is only valid while the file is mapped.
+
+	 @param UINT i: the index of the sample, must be in the range [0 getNumSamples()-1]
+	 @return a pointer to the numDimensions values of the sample, or NULL if the file stores float32 values
+    */
+    const double* getSample(UINT i) const{ return bytesPerValue == sizeof(double) ? (const double*)(samples + (unsigned long long)i*numDimensions*sizeof(double)) : NULL; }
+
+    /**
+     Gets the sample at index i of a float32 file, without copying it. The pointer is only valid while the file is mapped.
+
+	 @param UINT i: the index of the sample, must be in the range [0 getNumSamples()-1]
+	 @return a pointer to the numDimensions values of the sample, or NULL if the file stores float64 values
+    */
+    const float* getFloatSample(UINT i) const{ return bytesPerValue == sizeof(float) ? (const float*)(samples + (unsigned long long)i*numDimensions*sizeof(float)) : NULL; }
+
+    /**
+     Copies the sample at index i into the sample vector, converting float32 values to double.
+
+	 @param UINT i: the index of the sample, must be in the range [0 getNumSamples()-1]
+     @param vector< double > &sample: the vector the sample will be copied to, this is resized to the number of dimensions
+    */
+    void getSample(UINT i,vector< double > &sample) const;
+
+    UINT getClassLabel(UINT i) const{ return classLabels[i]; }
+    bool isLoaded() const{ return file.isOpen(); }
+    bool isFloat32() const{ return bytesPerValue == sizeof(float); }
+    string getDatasetName() const{ return datasetName; }
+    string getInfoText() const{ return infoText; }
+    UINT getNumDimensions() const{ return numDimensions; }
+    UINT getNumSamples() const{ return totalNumSamples; }
+    UINT getNumClasses() const{ return (UINT)classTracker.size(); }
+    bool getUseExternalRanges() const{ return useExternalRanges; }
+    vector< MinMax > getExternalRanges() const{ return externalRanges; }
+    vector< ClassTracker > getClassTracker() const{ return classTracker; }
+
+private:
+    MemoryMappedFile file;                                  ///< The mapping of the binary file
+    string datasetName;                                     ///< The name of the dataset
+    string infoText;                                        ///< Some infoText about the dataset
+    UINT numDimensions;                                     ///< The number of dimensions in the dataset
+    UINT totalNumSamples;                                   ///< The total number of samples in the dataset
+    UINT bytesPerValue;                                     ///< The size of each value in the samples block, 8 for float64 or 4 for float32
+    bool useExternalRanges;                                 ///< A flag to show if the dataset should be scaled using the externalRanges values
+    vector< MinMax > externalRanges;                        ///< The external ranges stored in the file
+    vector< ClassTracker > classTracker;                    ///< The number of samples of each class
+    const UINT *classLabels;                                ///< The class label of each sample, this points into the mapped file
+    const char *samples;                                    ///< The start of the samples block, this points into the mapped file
+
+    ErrorLog errorLog;                                      ///< Default error log
+};
+
+} //End of namespace GRT
@@ -24,14 +24,25 @@
  
  @section DESCRIPTION
  The Matrix class is a basic class for storing any type of data.  This class is a template and can therefore be used with any generic data type.
+ 
+ The data is stored in one contiguous, row-major block that starts on a cache line boundary, so row r starts at getData() + r*getNumCols().
+ push_back grows the capacity of the block geometrically, so adding N rows one at a time only copies the data O(log N) times.
  */
 
 #pragma once
 
 #include "../Util/GRTCommon.h"
+#include <new>
+
+//Move construction and move assignment are only available if the compiler supports rvalue references
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1600)
+    #define __GRT_RVALUE_REFERENCES__
+#endif
 
 namespace GRT{
 
+#define GRT_MATRIX_ALIGNMENT 64
+
 template <class T>
 class Matrix{
 public:
@@ -39,9 +50,11 @@ public:
      Default Constructor
     */
 	Matrix(){
-	 rows = 0;
-	 cols = 0;
-     dataPtr = NULL;
+        rows = 0;
+        cols = 0;
+        capacity = 0;
+        data = NULL;
+        memoryBlock = NULL;
 	}
     
     /**
@@ -51,8 +64,12 @@ public:
      @param UINT cols: sets the number of columns in the matrix, must be a value greater than zero
     */
 	Matrix(UINT rows,UINT cols){
-      dataPtr = NULL;
-      resize(rows,cols);
+        this->rows = 0;
+        this->cols = 0;
+        capacity = 0;
+        data = NULL;
+        memoryBlock = NULL;
+        resize(rows,cols);
 	}
     
     /**
@@ -61,18 +78,34 @@ public:
      @param const Matrix &rhs: the Matrix from which the values will be copied
     */
 	Matrix(const Matrix &rhs){
-		if(this!=&rhs){
-			 this->dataPtr = NULL;
-			 this->rows = rhs.rows;
-			 this->cols = rhs.cols;
-			 dataPtr = new T*[rows];
-			 for(UINT i=0; i<rows; i++){
-				 dataPtr[i] = new T[cols];
-				 for(UINT j=0; j<cols; j++) 
-					 this->dataPtr[i][j] = rhs.dataPtr[i][j];
-			 }
-		}
+        rows = 0;
+        cols = 0;
+        capacity = 0;
+        data = NULL;
+        memoryBlock = NULL;
+        if( rhs.rows > 0 && rhs.cols > 0 ){
+            allocate( rhs.getSize() );
+            rows = rhs.rows;
+            cols = rhs.cols;
+            std::copy(rhs.data,rhs.data+getSize(),data);
+        }
+	}
+    
+#ifdef __GRT_RVALUE_REFERENCES__
+    /**
+     Move Constructor, takes the data from the rhs Matrix without copying it.  The rhs Matrix is left empty.
+     
+     @param Matrix &&rhs: the Matrix from which the data will be taken
+    */
+	Matrix(Matrix &&rhs){
+        rows = 0;
+        cols = 0;
+        capacity = 0;
+        data = NULL;
+        memoryBlock = NULL;
+        swap( rhs );
 	}
+#endif
     
     /**
      Destructor, cleans up any memory
@@ -89,18 +122,46 @@ public:
     */
 	Matrix& operator=(const Matrix &rhs){
 		if(this!=&rhs){
-			 this->clear();
-			 this->rows = rhs.rows;
-			 this->cols = rhs.cols;
-			 dataPtr = new T*[rows];
-			 for(UINT i=0; i<rows; i++){
-				 dataPtr[i] = new T[cols];
-				 for(UINT j=0; j<cols; j++) 
-					 this->dataPtr[i][j] = rhs.dataPtr[i][j];
-			 }
+            //The existing memory is reused if it is large enough
+            if( rhs.getSize() > capacity ){
+                clear();
+                if( rhs.rows > 0 && rhs.cols > 0 ) allocate( rhs.getSize() );
+            }
+            rows = rhs.rows;
+            cols = rhs.cols;
+            if( rows > 0 && cols > 0 ) std::copy(rhs.data,rhs.data+getSize(),data);
+		}
+		return *this;
+	}
+    
+#ifdef __GRT_RVALUE_REFERENCES__
+    /**
+     Move assignment, takes the data from the rhs Matrix without copying it.  The rhs Matrix is left empty.
+     
+     @param Matrix &&rhs: the Matrix from which the data will be taken
+     @return returns a pointer to this instance of the Matrix
+    */
+	Matrix& operator=(Matrix &&rhs){
+		if(this!=&rhs){
+            clear();
+            swap( rhs );
 		}
 		return *this;
 	}
+#endif
+    
+    /**
+     Swaps the data of this Matrix with the data of the rhs Matrix, without copying any of the data
+     
+     @param Matrix &rhs: the Matrix to swap the data with
+    */
+    void swap(Matrix &rhs){
+        std::swap(rows,rhs.rows);
+        std::swap(cols,rhs.cols);
+        std::swap(capacity,rhs.capacity);
+        std::swap(data,rhs.data);
+        std::swap(memoryBlock,rhs.memoryBlock);
+    }
     
     /**
      Returns a pointer to the data at row r
@@ -109,7 +170,30 @@ public:
      @return a pointer to the data at row r
     */
 	inline T* operator[](const UINT r){
-     return dataPtr[r];
+        return data + ((size_t)r*cols);
+	}
+    
+    /**
+     Returns a const pointer to the data at row r
+     
+     @param const UINT r: the index of the row you want, should be in the range [0 rows-1]
+     @return a const pointer to the data at row r
+    */
+	inline const T* operator[](const UINT r) const{
+        return data + ((size_t)r*cols);
+	}
+    
+    /**
+     Returns a pointer to the first value in the Matrix, the rows are stored one after another so the value at [r c] is at getData()[ r*cols + c ]
+     
+     @return a pointer to the data, or NULL if the Matrix is empty
+    */
+	inline T* getData(){
+        return data;
+	}
+    
+	inline const T* getData() const{
+        return data;
 	}
 
     /**
@@ -118,11 +202,9 @@ public:
      @param const UINT r: the index of the row, this should be in the range [0 rows-1]
      @return returns a row vector from the Matrix at the row index r
     */
-	vector<T> getRowVector(const UINT r){
-		vector<T> rowVector(cols);
-		for(UINT c=0; c<cols; c++)
-			rowVector[c] = dataPtr[r][c];
-		return rowVector;
+	vector<T> getRowVector(const UINT r) const{
+		const T *row = data + ((size_t)r*cols);
+		return vector<T>(row,row+cols);
 	}
 
     /**
@@ -131,10 +213,10 @@ public:
      @param const UINT c: the index of the column, this should be in the range [0 cols-1]
      @return returns a column vector from the Matrix at the column index c
     */
-	vector<T> getColVector(const UINT c){
+	vector<T> getColVector(const UINT c) const{
 		vector<T> columnVector(rows);
 		for(UINT r=0; r<rows; r++)
-			columnVector[r] = dataPtr[r][c];
+			columnVector[r] = data[ ((size_t)r*cols)+c ];
 		return columnVector;
 	}
     
@@ -147,23 +229,19 @@ public:
      @param bool concatByRow: sets if the matrix data will be added to the vector row-vector by row-vector
      @return returns a vector containing the entire matrix data
      */
-    vector<T> getConcatenatedVector(bool concatByRow = true){
+    vector<T> getConcatenatedVector(bool concatByRow = true) const{
         
         if( rows == 0 || cols == 0 ) return vector<T>();
         
-        vector<T> vectorData(rows*cols);
-        
         if( concatByRow ){
+            //The data is already stored row by row
+            return vector<T>(data,data+getSize());
+        }
+        
+        vector<T> vectorData(getSize());
+        for(UINT j=0; j<cols; j++){
             for(UINT i=0; i<rows; i++){
-                for(UINT j=0; j<cols; j++){
-                    vectorData[ (i*cols)+j ] = dataPtr[i][j];
-                }
-            }
-        }else{
-            for(UINT j=0; j<cols; j++){
-                for(UINT i=0; i<rows; i++){
-                    vectorData[ (i*cols)+j ] = dataPtr[i][j];
-                }
+                vectorData[ ((size_t)j*rows)+i ] = data[ ((size_t)i*cols)+j ];
             }
         }
         
@@ -171,33 +249,45 @@ public:
     }
 
     /**
-     Resizes the Matrix to the new size of [r c]
+     Resizes the Matrix to the new size of [r c].  The values in the Matrix are not kept, every value is reset to T() (so a Matrix
+     of numbers is filled with zeros).  If the existing memory is large enough then it is reused.  The resize fails if the size of
+     the memory block for r*c values would overflow.
      
      @param UINT r: the number of rows, must be greater than zero
      @param UINT c: the number of columns, must be greater than zero
      @return returns true or false, indicating if the resize was successful 
     */
 	bool resize(UINT r,UINT c){
-        //Clear any previous memory
-        clear();
-        if( r > 0 && c > 0 ){
+        if( r > 0 && c > 0 && r <= getMaxNumValues() / c ){
+            const size_t numValues = (size_t)r*c;
+            if( numValues > capacity ){
+                clear();
+                allocate( numValues );
+            }else{
+                //The reused memory still holds the old values, so reset them as a new block would be
+                std::fill(data,data+numValues,T());
+            }
             rows = r;
             cols = c;
-            dataPtr = new T*[rows];
-            
-            //Check to see if the memory was created correctly
-            if( dataPtr == NULL ){
-                rows = 0;
-                cols = 0;
-                return false;
-            }
-            for(UINT i=0; i<rows; i++){
-                dataPtr[i] = new T[cols];
-            }
             return true;
         }
+        //Clear any previous memory
+        clear();
         return false;
 	}
+    
+    /**
+     Reserves enough memory for the Matrix to hold numRows rows without having to reallocate its memory.  The number of columns
+     must already be set (by resize or push_back).
+     
+     @param UINT numRows: the number of rows to reserve memory for
+     @return returns true or false, indicating if the memory was reserved
+    */
+	bool reserve(UINT numRows){
+        if( cols == 0 || numRows > getMaxNumValues() / cols ) return false;
+        if( (size_t)numRows*cols > capacity ) reallocate( (size_t)numRows*cols );
+        return true;
+	}
 
     /**
      Sets all the values in the Matrix to the input value
@@ -206,10 +296,8 @@ public:
      @return returns true or false, indicating if the set was successful 
     */
 	bool setAllValues(T value){
-		if(dataPtr!=NULL){
-			for(UINT i=0; i<rows; i++)
-				for(UINT j=0; j<cols; j++)
-					dataPtr[i][j] = value;
+		if(data!=NULL){
+            std::fill(data,data+getSize(),value);
             return true;
 		}
         return false;
@@ -220,19 +308,17 @@ public:
      the number of columns in the Matrix, unless the Matrix size has not been set, in which case the new sample size will define the
      number of columns in the Matrix.
      
-     @param vector< T > sample: the new column vector you want to add to the end of the Matrix.  Its size should match the number of columns in the Matrix
+     @param const vector< T > &sample: the new column vector you want to add to the end of the Matrix.  Its size should match the number of columns in the Matrix
      @return returns true or false, indicating if the push was successful 
     */
-	bool push_back(vector<T> sample){
+	bool push_back(const vector<T> &sample){
 		//If there is no data, but we know how many cols are in a sample then we simply create a new buffer of size 1 and add the sample
-		if(dataPtr==NULL){
-			cols = (UINT)sample.size();
-			if( !resize(1,cols) ){
+		if(rows==0){
+			if( !resize(1,(UINT)sample.size()) ){
                 clear();
                 return false;
             }
-			for(UINT j=0; j<cols; j++)
-				dataPtr[0][j] = sample[j];
+            std::copy(sample.begin(),sample.end(),data);
 			return true;
 		}
 
@@ -241,32 +327,16 @@ public:
 			return false;
 		}
 
-		//Otherwise we copy the existing data from the data ptr into a new buffer of size (rows+1) and add the sample at the end
-		T** tempDataPtr = NULL;
-		tempDataPtr = new T*[ rows+1 ];
-		if( tempDataPtr == NULL ){//If NULL then we have run out of memory
-			return false;
-		}
-		for(UINT i=0; i<rows+1; i++){
-			tempDataPtr[i] = new T[cols];
+		//If the memory is full then double the number of rows it can hold, so the data is only copied O(log N) times for N push_backs
+		if( getSize()+cols > capacity ){
+            //The number of rows is limited by the size of the memory block and by the range of a UINT
+            const size_t maxNumRows = std::min( getMaxNumValues() / cols, (size_t)(UINT)-1 );
+            if( rows >= maxNumRows ) return false;
+            reallocate( std::min( rows < 4 ? (size_t)8 : (size_t)rows*2, maxNumRows )*cols );
 		}
 
-		//Copy the original data
-		for(UINT i=0; i<rows; i++)
-			for(UINT j=0; j<cols; j++)
-				tempDataPtr[i][j] = dataPtr[i][j];
-
 		//Add the new sample at the end
-		for(UINT j=0; j<cols; j++)
-			tempDataPtr[rows][j] = sample[j];
-
-		//Delete the original data and copy the pointer
-		for(UINT i=0; i<rows; i++){
-			delete[] dataPtr[i];
-			dataPtr[i] = NULL;
-		}
-		delete[] dataPtr;
-		dataPtr = tempDataPtr;
+        std::copy(sample.begin(),sample.end(),data+getSize());
         
         //Increment the number of rows
 		rows++;
@@ -279,14 +349,15 @@ public:
      Cleans up any dynamic memory and sets the number of rows and columns in the matrix to zero
     */
 	void clear(){
-		if(dataPtr!=NULL){
-			for(UINT i=0; i<rows; i++){
-                delete[] dataPtr[i];
-                dataPtr[i] = NULL;
+		if(memoryBlock!=NULL){
+			for(size_t i=0; i<capacity; i++){
+                data[i].~T();
 			}
-			delete[] dataPtr;
-			dataPtr = NULL;
+			::operator delete(memoryBlock);
 		}
+        memoryBlock = NULL;
+        data = NULL;
+        capacity = 0;
 		rows = 0;
 		cols = 0;
 	}
@@ -296,14 +367,28 @@ public:
      
      @return returns the number of rows in the Matrix
     */
-	inline UINT getNumRows(){return rows;}
+	inline UINT getNumRows() const{return rows;}
     
     /**
      Gets the number of columns in the Matrix
      
      @return returns the number of columns in the Matrix
     */
-	inline UINT getNumCols(){return cols;}
+	inline UINT getNumCols() const{return cols;}
+    
+    /**
+     Gets the number of values in the Matrix (rows*cols)
+     
+     @return returns the number of values in the Matrix
+    */
+	inline size_t getSize() const{return (size_t)rows*cols;}
+    
+    /**
+     Gets the number of values the Matrix can hold without reallocating its memory
+     
+     @return returns the capacity of the Matrix
+    */
+	inline size_t getCapacity() const{return capacity;}
 
     /**
      Saves the Matrix data to a file. This function assumes that the template T can be easily saved and loaded 
@@ -331,7 +416,7 @@ public:
 		
 		for(UINT i=0; i<rows; i++){
 			for(UINT j=0; j<cols; j++){
-				file << dataPtr[i][j] << "\t";
+				file << data[ ((size_t)i*cols)+j ] << "\t";
 			}file << endl;
 		}
 
@@ -361,6 +446,8 @@ public:
 		}
 		
 		std::string word;
+		UINT numRows = 0;
+		UINT numCols = 0;
 		
 		//Check to make sure this is a file with the correct format
 		file >> word;
@@ -375,7 +462,7 @@ public:
 			cout<<"MATRIX_LOAD_ERROR: Incorrect file format, can't find Number of Rows\n";
 			return false;
 		}
-		file >> rows;
+		file >> numRows;
 		
 		//Check and load the number of columns
 		file >> word;
@@ -383,10 +470,10 @@ public:
 			cout<<"MATRIX_LOAD_ERROR: Incorrect file format, can't find Number of Columns\n";
 			return false;
 		}
-		file >> cols;
+		file >> numCols;
 		
 		//Resize the data buffer
-		resize(rows,cols);
+		resize(numRows,numCols);
 
 		//Now we should have the data with each row containing a sample of the training data followed 
 		//by a sample of the target data, tab seperated.
@@ -394,7 +481,7 @@ public:
 			for(UINT j=0; j<cols; j++){
 				T value;
 				file >> value;
-				dataPtr[i][j] = value;
+				data[ ((size_t)i*cols)+j ] = value;
 			}
 		}
 
@@ -405,11 +492,45 @@ public:
 
 private:
     
-	UINT rows;      ///< The number of rows in the Matrix
-	UINT cols;      ///< The number of columns in the Matrix
-	T **dataPtr;    ///< A pointer to the data
+    /**
+     Returns the largest number of values a block can hold without its size in bytes overflowing
+    */
+    static size_t getMaxNumValues(){
+        return ((size_t)-1 - GRT_MATRIX_ALIGNMENT) / sizeof(T);
+    }
+    
+    /**
+     Allocates a new cache line aligned block for numValues values, this should only be called when the Matrix has no memory
+    */
+    void allocate(size_t numValues){
+        memoryBlock = ::operator new( numValues*sizeof(T) + GRT_MATRIX_ALIGNMENT );
+        size_t address = (size_t)memoryBlock;
+        address = (address + GRT_MATRIX_ALIGNMENT - 1) & ~((size_t)GRT_MATRIX_ALIGNMENT - 1);
+        data = (T*)address;
+        for(size_t i=0; i<numValues; i++){
+            new (data+i) T();
+        }
+        capacity = numValues;
+    }
+    
+    /**
+     Moves the data into a new block that can hold numValues values
+    */
+    void reallocate(size_t numValues){
+        Matrix<T> temp;
+        temp.allocate( numValues );
+        temp.rows = rows;
+        temp.cols = cols;
+        std::copy(data,data+getSize(),temp.data);
+        swap( temp );
+    }
+    
+	UINT rows;              ///< The number of rows in the Matrix
+	UINT cols;              ///< The number of columns in the Matrix
+	size_t capacity;        ///< The number of values the memory can hold
+	T *data;                ///< A pointer to the (aligned) data, the rows are stored one after another
+	void *memoryBlock;      ///< A pointer to the memory block that holds the data
 
 };
 
 }//End of namespace GRT
-
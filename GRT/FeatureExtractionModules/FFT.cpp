@@ -415,7 +415,7 @@ bool FFT::init(UINT fftWindowSize,UINT hopSize,UINT numDimensions,UINT fftWindow
     return true;
 }
     
-bool FFT::computeFeatures(vector< double > inputVector){ 
+bool FFT::computeFeatures(const vector< double > &inputVector){ 
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
         errorLog << "computeFeatures(vector< double > inputVector) - Not initialized!" << endl;
@@ -447,7 +447,7 @@ bool FFT::update(double x){
     return update(vector<double>(1,x));
 }
 
-bool FFT::update(vector< double > x){
+bool FFT::update(const vector< double > &x){
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
         errorLog << "update(vector<double> x) - Not initialized!" << endl;
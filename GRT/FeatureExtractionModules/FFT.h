@@ -88,7 +88,7 @@ public:
 	 @param vector< double > inputVector: the inputVector that should be processed.  Must have the same dimensionality as the FeatureExtraction module
 	 @return true if the data was processed, false otherwise
      */
-    virtual bool computeFeatures(vector< double > inputVector);
+    virtual bool computeFeatures(const vector< double > &inputVector);
     
     /**
      Sets the FeatureExtraction reset function, overwriting the base FeatureExtraction function.
@@ -170,7 +170,7 @@ public:
      @param vector< double > x: the new N-dimensional sample, this will be added to a buffer and the FFT will be computed for the data in the buffer
 	 @return true if the FTT was updated successfully, false otherwise
      */   
-    bool update(vector< double > x);
+    bool update(const vector< double > &x);
     
     /**
      Returns the current hopSize.
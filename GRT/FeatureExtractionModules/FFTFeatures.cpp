@@ -292,7 +292,7 @@ bool FFTFeatures::init(UINT fftWindowSize,UINT numChannelsInFFTSignal,bool compu
     return true;
 }
     
-bool FFTFeatures::computeFeatures(vector< double > inputVector){ 
+bool FFTFeatures::computeFeatures(const vector< double > &inputVector){ 
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
         errorLog << "computeFeatures(vector< double > inputVector) - Not initialized!" << endl;
@@ -310,7 +310,7 @@ bool FFTFeatures::computeFeatures(vector< double > inputVector){
     
     UINT featureIndex = 0;
     IndexedDouble maxFreq(0,0);
-    vector< IndexedDouble > fftMagData(fftWindowSize);
+    if( fftMagData.size() != fftWindowSize ) fftMagData.resize( fftWindowSize );
     
     for(UINT i=0; i<numChannelsInFFTSignal; i++){
         double spectrumSum = 0;
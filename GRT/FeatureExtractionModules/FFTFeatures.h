@@ -75,7 +75,7 @@ public:
 	 @param vector< double > inputVector: the inputVector that should be processed.  Must have the same dimensionality as the FeatureExtraction module
 	 @return true if the data was processed, false otherwise
      */
-    virtual bool computeFeatures(vector< double > inputVector);
+    virtual bool computeFeatures(const vector< double > &inputVector);
     
     /**
      Sets the FeatureExtraction reset function, overwriting the base FeatureExtraction function.
@@ -144,6 +144,7 @@ protected:
     double maxFreqSpectrumRatio;
     double centroidFeature;
     vector< double > topNFreqFeatures;
+    vector< IndexedDouble > fftMagData;
     
     static RegisterFeatureExtractionModule< FFTFeatures > registerModule;
     
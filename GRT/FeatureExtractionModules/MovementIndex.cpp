@@ -36,6 +36,7 @@ MovementIndex::MovementIndex(UINT bufferLength,UINT numDimensions){
 MovementIndex::MovementIndex(const MovementIndex &rhs){
 
     this->bufferLength = rhs.bufferLength;
+    this->windowStatistics = rhs.windowStatistics;
     
     //Copy the base variables
     copyBaseVariables((FeatureExtraction*)this, (FeatureExtraction*)&rhs);
@@ -48,6 +49,7 @@ MovementIndex::~MovementIndex(){
 MovementIndex& MovementIndex::operator=(const MovementIndex &rhs){
     if(this!=&rhs){
         this->bufferLength = rhs.bufferLength;
+        this->windowStatistics = rhs.windowStatistics;
         
         //Copy the base variables
         copyBaseVariables((FeatureExtraction*)this, (FeatureExtraction*)&rhs);
@@ -63,6 +65,7 @@ bool MovementIndex::clone(const FeatureExtraction *featureExtraction){
         
         MovementIndex *ptr = (MovementIndex*)featureExtraction;
         this->bufferLength = ptr->bufferLength;
+        this->windowStatistics = ptr->windowStatistics;
         
         //Clone the base class variables
         return copyBaseVariables((FeatureExtraction*)this,featureExtraction);
@@ -73,7 +76,7 @@ bool MovementIndex::clone(const FeatureExtraction *featureExtraction){
     return false;
 }
     
-bool MovementIndex::computeFeatures(vector< double > inputVector){
+bool MovementIndex::computeFeatures(const vector< double > &inputVector){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
@@ -87,7 +90,22 @@ bool MovementIndex::computeFeatures(vector< double > inputVector){
     }
 #endif
     
-    featureVector = update( inputVector );
+    //Add the new data to the window, this updates the mean and variance of each dimension without summing the whole window
+    windowStatistics.push_back( inputVector );
+    
+    //Only flag that the feature data is ready if the trajectory data is full
+    if( !windowStatistics.getBufferFilled() ){
+        featureDataReady = false;
+        for(UINT i=0; i<featureVector.size(); i++){
+            featureVector[i] = 0;
+        }
+        return true;
+    }else featureDataReady = true;
+    
+    //The movement index is the RMS error of each dimension over the window, which is its standard deviation
+    for(UINT j=0; j<numInputDimensions; j++){
+        featureVector[j] = windowStatistics.getStdDev(j);
+    }
     
     return true;
 }
@@ -217,7 +235,7 @@ bool MovementIndex::init(UINT bufferLength,UINT numDimensions){
     featureVector.resize(numInputDimensions);
     
     //Resize the raw trajectory data buffer
-    dataBuffer.resize( bufferLength, vector< double >(numInputDimensions,0) );
+    windowStatistics.init( bufferLength, numInputDimensions );
 
     //Flag that the zero crossing counter has been initialized
     initialized = true;
@@ -230,7 +248,7 @@ vector< double > MovementIndex::update(double x){
 	return update(vector<double>(1,x));
 }
     
-vector< double > MovementIndex::update(vector< double > x){
+vector< double > MovementIndex::update(const vector< double > &x){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
@@ -244,43 +262,13 @@ vector< double > MovementIndex::update(vector< double > x){
     }
 #endif
     
-    //Add the new data to the trajectory data buffer
-    dataBuffer.push_back( x );
-    
-    //Only flag that the feature data is ready if the trajectory data is full
-    if( !dataBuffer.getBufferFilled() ){
-        featureDataReady = false;
-        for(UINT i=0; i<featureVector.size(); i++){
-            featureVector[i] = 0;
-        }
-        return featureVector;
-    }else featureDataReady = true;
-    
-    //Compute the movement index (which is the RMS error)
-    vector< double > mu(numInputDimensions,0);
-    
-    //Compute mu
-    for(UINT j=0; j<numInputDimensions; j++){
-        for(UINT i=0; i<dataBuffer.getSize(); i++){
-            mu[j] += dataBuffer[i][j];
-        }
-        mu[j] /= double(dataBuffer.getSize());
-    }
-    
-    for(UINT j=0; j<numInputDimensions; j++){
-        featureVector[j] = 0;
-        for(UINT i=0; i<dataBuffer.getSize(); i++){
-            featureVector[j] += SQR( dataBuffer[i][j] - mu[j] );
-        }
-        featureVector[j] = sqrt( featureVector[j]/double(dataBuffer.getSize()) );
-    }
-    
+    if( !computeFeatures( x ) ) return vector< double >();
     return featureVector;
 }
     
 CircularBuffer< vector< double > > MovementIndex::getData(){
     if( initialized ){
-        return dataBuffer;
+        return windowStatistics.getData();
     }
     return CircularBuffer< vector<double > >();
 }
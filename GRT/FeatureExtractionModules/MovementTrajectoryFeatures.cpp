@@ -95,7 +95,7 @@ bool MovementTrajectoryFeatures::clone(const FeatureExtraction *featureExtractio
     return false;
 }
     
-bool MovementTrajectoryFeatures::computeFeatures(vector< double > inputVector){
+bool MovementTrajectoryFeatures::computeFeatures(const vector< double > &inputVector){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
@@ -109,7 +109,145 @@ bool MovementTrajectoryFeatures::computeFeatures(vector< double > inputVector){
     }
 #endif
     
-    featureVector = update( inputVector );
+    //Add the new data to the trajectory data buffer
+    trajectoryDataBuffer.push_back( inputVector );
+    
+    //Only flag that the feature data is ready if the trajectory data is full
+    if( trajectoryDataBuffer.getBufferFilled() ){
+        featureDataReady = true;
+    }else featureDataReady = false;
+    
+    //Compute the centroids
+    centroids.setAllValues(0);
+    
+    UINT dataBufferIndex = 0;
+    UINT numValuesPerCentroid = (UINT)floor(double(trajectoryLength/numCentroids));
+    for(UINT n=0; n<numInputDimensions; n++){
+        dataBufferIndex = 0;
+        for(UINT i=0; i<numCentroids; i++){
+            for(UINT j=0; j<numValuesPerCentroid; j++){
+                centroids[i][n] += trajectoryDataBuffer[dataBufferIndex++][n];
+            }
+            centroids[i][n] /= double(numValuesPerCentroid);
+        }
+    }
+    
+    //Copmute the features
+    UINT featureIndex = 0;
+    vector< MinMax > centroidNormValues(numInputDimensions);
+    vector< double > histSumValues;
+    vector< vector< AngleMagnitude > >  angleMagnitudeValues;
+    switch( featureMode ){
+        case CENTROID_VALUE:
+            //Simply set the feature vector as the list of centroids
+            for(UINT n=0; n<numInputDimensions; n++){
+                for(UINT i=0; i<numCentroids; i++){
+                    featureVector[ featureIndex++ ] = centroids[i][n];
+                }
+            }
+            break;
+        case NORMALIZED_CENTROID_VALUE:
+            for(UINT n=0; n<numInputDimensions; n++){
+                
+                //Find the min and max values
+                for(UINT i=0; i<numCentroids; i++){
+                    centroidNormValues[n].updateMinMax( centroids[i][n] );
+                }
+                
+                //Use the normalized centroids as the features
+                for(UINT i=0; i<numCentroids; i++){
+                    if( centroidNormValues[n].maxValue - centroidNormValues[n].minValue != 0 ){
+                        featureVector[ featureIndex++ ] = Util::scale(centroids[i][n],centroidNormValues[n].minValue,centroidNormValues[n].maxValue,0,1);
+                    }else featureVector[ featureIndex++ ] = 0;
+                }
+                
+                //Add the start and end centroid values if needed
+                if( useTrajStartAndEndValues ){
+                    featureVector[ featureIndex++ ] = centroids[0][n];
+                    featureVector[ featureIndex++ ] = centroids[numCentroids-1][n];
+                }
+            }
+            break;
+        case CENTROID_DERIVATIVE:
+            for(UINT n=0; n<numInputDimensions; n++){
+                
+                //Compute the derivative between centroid i and centroid i+1
+                for(UINT i=0; i<numCentroids-1; i++){
+                    featureVector[ featureIndex++ ] = centroids[i+1][n]-centroids[i][n];
+                }
+                
+                //Add the start and end centroid values if needed
+                if( useTrajStartAndEndValues ){
+                    featureVector[ featureIndex++ ] = centroids[0][n];
+                    featureVector[ featureIndex++ ] = centroids[numCentroids-1][n];
+                }
+            }
+            break;
+        case CENTROID_ANGLE_2D:
+            histSumValues.resize( numInputDimensions/2, 0);
+            angleMagnitudeValues.resize( numInputDimensions/2 );
+            
+            //Zero the feature vector
+            for(UINT i=0; i<featureVector.size(); i++){
+                featureVector[ i ] = 0;
+            }
+            
+            //Compute the angle and magnitude betweem each of the centroids, do this for each pair of points
+            for(UINT n=0; n<numInputDimensions/2; n++){
+                //Resize the nth buffer to hold the values for each centroid
+                angleMagnitudeValues[n].resize(numCentroids-1);
+                for(UINT i=0; i<numCentroids-1; i++){
+                    cartToPolar(centroids[i+1][n*2]-centroids[i][n*2], centroids[i+1][n*2+1]-centroids[i][n*2+1], angleMagnitudeValues[n][i].magnitude, angleMagnitudeValues[n][i].angle);
+                }
+                
+                //Add the angles to the histogram
+                for(UINT i=0; i<numCentroids-1; i++){
+                    UINT histBin = 0;
+                    double degreesPerBin = 360.0/numHistogramBins;
+                    double binStartValue = 0;
+                    double binEndValue = degreesPerBin;
+                    bool keepSearching = true;
+                    
+                    if( angleMagnitudeValues[n][i].angle < 0 || angleMagnitudeValues[n][i].angle  > 360.0 ){
+                        warningLog << "The angle of a point is not between [0 360]. Angle: " << angleMagnitudeValues[n][i].angle << endl;
+                        return false;
+                    }
+                    
+                    //Find which hist bin the current angle is in
+                    while( true ){
+                        if( angleMagnitudeValues[n][i].angle >= binStartValue && angleMagnitudeValues[n][i].angle  < binEndValue ){
+                            break;
+                        }
+                        histBin++;
+                        binStartValue += degreesPerBin;
+                        binEndValue += degreesPerBin;
+                    }
+                    
+                    histSumValues[ n ] += angleMagnitudeValues[n][i].magnitude;
+                    if( useWeightedMagnitudeValues ) featureVector[ n*numHistogramBins + histBin ] +=  angleMagnitudeValues[n][i].magnitude;
+                    else featureVector[ n*numHistogramBins + histBin ] += 1;
+                    
+                }
+                
+                //Normalize the hist bins
+                for(UINT n=0; n<numInputDimensions/2; n++){
+                    if( histSumValues[ n ] > 0 ){
+                        for(UINT i=0; i<numHistogramBins; i++){
+                            if( useWeightedMagnitudeValues ) featureVector[ n*numHistogramBins + i  ] /=  histSumValues[ n ];
+                            else featureVector[ n*numHistogramBins + i  ] /=  numHistogramBins;
+                        }
+                    }
+                }
+                
+            }
+            break;
+        case CENTROID_ANGLE_3D:
+            break;
+        default:
+            errorLog << "computeFeatures(vector< double > inputVector) - Unknown featureMode!" << endl;
+            return true;
+            break;
+    }
     
     return true;
 }
@@ -357,7 +495,7 @@ vector< double > MovementTrajectoryFeatures::update(double x){
 	return update(vector<double>(1,x));
 }
     
-vector< double > MovementTrajectoryFeatures::update(vector< double > x){
+vector< double > MovementTrajectoryFeatures::update(const vector< double > &x){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
@@ -371,146 +509,7 @@ vector< double > MovementTrajectoryFeatures::update(vector< double > x){
     }
 #endif
     
-    //Add the new data to the trajectory data buffer
-    trajectoryDataBuffer.push_back( x );
-    
-    //Only flag that the feature data is ready if the trajectory data is full
-    if( trajectoryDataBuffer.getBufferFilled() ){
-        featureDataReady = true;
-    }else featureDataReady = false;
-    
-    //Compute the centroids
-    centroids.setAllValues(0);
-    
-    UINT dataBufferIndex = 0;
-    UINT numValuesPerCentroid = (UINT)floor(double(trajectoryLength/numCentroids));
-    for(UINT n=0; n<numInputDimensions; n++){
-        dataBufferIndex = 0;
-        for(UINT i=0; i<numCentroids; i++){
-            for(UINT j=0; j<numValuesPerCentroid; j++){
-                centroids[i][n] += trajectoryDataBuffer[dataBufferIndex++][n];
-            }
-            centroids[i][n] /= double(numValuesPerCentroid);
-        }
-    }
-    
-    //Copmute the features
-    UINT featureIndex = 0;
-    vector< MinMax > centroidNormValues(numInputDimensions);
-    vector< double > histSumValues;
-    vector< vector< AngleMagnitude > >  angleMagnitudeValues;
-    switch( featureMode ){
-        case CENTROID_VALUE:
-            //Simply set the feature vector as the list of centroids
-            for(UINT n=0; n<numInputDimensions; n++){
-                for(UINT i=0; i<numCentroids; i++){
-                    featureVector[ featureIndex++ ] = centroids[i][n];
-                }
-            }
-            break;
-        case NORMALIZED_CENTROID_VALUE:
-            for(UINT n=0; n<numInputDimensions; n++){
-                
-                //Find the min and max values
-                for(UINT i=0; i<numCentroids; i++){
-                    centroidNormValues[n].updateMinMax( centroids[i][n] );
-                }
-                
-                //Use the normalized centroids as the features
-                for(UINT i=0; i<numCentroids; i++){
-                    if( centroidNormValues[n].maxValue - centroidNormValues[n].minValue != 0 ){
-                        featureVector[ featureIndex++ ] = Util::scale(centroids[i][n],centroidNormValues[n].minValue,centroidNormValues[n].maxValue,0,1);
-                    }else featureVector[ featureIndex++ ] = 0;
-                }
-                
-                //Add the start and end centroid values if needed
-                if( useTrajStartAndEndValues ){
-                    featureVector[ featureIndex++ ] = centroids[0][n];
-                    featureVector[ featureIndex++ ] = centroids[numCentroids-1][n];
-                }
-            }
-            break;
-        case CENTROID_DERIVATIVE:
-            for(UINT n=0; n<numInputDimensions; n++){
-                
-                //Compute the derivative between centroid i and centroid i+1
-                for(UINT i=0; i<numCentroids-1; i++){
-                    featureVector[ featureIndex++ ] = centroids[i+1][n]-centroids[i][n];
-                }
-                
-                //Add the start and end centroid values if needed
-                if( useTrajStartAndEndValues ){
-                    featureVector[ featureIndex++ ] = centroids[0][n];
-                    featureVector[ featureIndex++ ] = centroids[numCentroids-1][n];
-                }
-            }
-            break;
-        case CENTROID_ANGLE_2D:
-            histSumValues.resize( numInputDimensions/2, 0);
-            angleMagnitudeValues.resize( numInputDimensions/2 );
-            
-            //Zero the feature vector
-            for(UINT i=0; i<featureVector.size(); i++){
-                featureVector[ i ] = 0;
-            }
-            
-            //Compute the angle and magnitude betweem each of the centroids, do this for each pair of points
-            for(UINT n=0; n<numInputDimensions/2; n++){
-                //Resize the nth buffer to hold the values for each centroid
-                angleMagnitudeValues[n].resize(numCentroids-1);
-                for(UINT i=0; i<numCentroids-1; i++){
-                    cartToPolar(centroids[i+1][n*2]-centroids[i][n*2], centroids[i+1][n*2+1]-centroids[i][n*2+1], angleMagnitudeValues[n][i].magnitude, angleMagnitudeValues[n][i].angle);
-                }
-                
-                //Add the angles to the histogram
-                for(UINT i=0; i<numCentroids-1; i++){
-                    UINT histBin = 0;
-                    double degreesPerBin = 360.0/numHistogramBins;
-                    double binStartValue = 0;
-                    double binEndValue = degreesPerBin;
-                    bool keepSearching = true;
-                    
-                    if( angleMagnitudeValues[n][i].angle < 0 || angleMagnitudeValues[n][i].angle  > 360.0 ){
-                        warningLog << "The angle of a point is not between [0 360]. Angle: " << angleMagnitudeValues[n][i].angle << endl;
-                        return vector<double>();
-                    }
-                    
-                    //Find which hist bin the current angle is in
-                    while( true ){
-                        if( angleMagnitudeValues[n][i].angle >= binStartValue && angleMagnitudeValues[n][i].angle  < binEndValue ){
-                            break;
-                        }
-                        histBin++;
-                        binStartValue += degreesPerBin;
-                        binEndValue += degreesPerBin;
-                    }
-                    
-                    histSumValues[ n ] += angleMagnitudeValues[n][i].magnitude;
-                    if( useWeightedMagnitudeValues ) featureVector[ n*numHistogramBins + histBin ] +=  angleMagnitudeValues[n][i].magnitude;
-                    else featureVector[ n*numHistogramBins + histBin ] += 1;
-                    
-                }
-                
-                //Normalize the hist bins
-                for(UINT n=0; n<numInputDimensions/2; n++){
-                    if( histSumValues[ n ] > 0 ){
-                        for(UINT i=0; i<numHistogramBins; i++){
-                            if( useWeightedMagnitudeValues ) featureVector[ n*numHistogramBins + i  ] /=  histSumValues[ n ];
-                            else featureVector[ n*numHistogramBins + i  ] /=  numHistogramBins;
-                        }
-                    }
-                }
-                
-            }
-            break;
-        case CENTROID_ANGLE_3D:
-            break;
-        default:
-            errorLog << "update(vector< double > x)- Unknown featureMode!" << endl;
-            return featureVector;
-            break;
-    }
-    
+    if( !computeFeatures( x ) ) return vector< double >();
     return featureVector;
 }
     
@@ -86,7 +86,7 @@ public:
      @param vector< double > inputVector: the inputVector that should be processed.  Must have the same dimensionality as the FeatureExtraction module
      @return returns true if the data was processed, false otherwise
      */
-    virtual bool computeFeatures(vector< double > inputVector);
+    virtual bool computeFeatures(const vector< double > &inputVector);
     
     /**
      Sets the FeatureExtraction reset function, overwriting the base FeatureExtraction function.
@@ -152,7 +152,7 @@ public:
      @param double x: the value to compute features from, this should only be called if the dimensionality of the filter was set to 1
 	 @return a vector containing the features, an empty vector will be returned if the features were not computed
      */
-    vector< double > update(vector< double > x);
+    vector< double > update(const vector< double > &x);
     
     /**
      */
@@ -42,6 +42,8 @@ ZeroCrossingCounter::ZeroCrossingCounter(const ZeroCrossingCounter &rhs){
     this->derivative = rhs.derivative;
     this->deadZone = rhs.deadZone;
     this->dataBuffer = rhs.dataBuffer;
+    this->numZeroCrossings = rhs.numZeroCrossings;
+    this->settledZeroCrossingMagnitudes = rhs.settledZeroCrossingMagnitudes;
     
     copyBaseVariables((FeatureExtraction*)this, (FeatureExtraction*)&rhs);
 }
@@ -58,6 +60,8 @@ ZeroCrossingCounter& ZeroCrossingCounter::operator=(const ZeroCrossingCounter &r
         this->derivative = rhs.derivative;
         this->deadZone = rhs.deadZone;
         this->dataBuffer = rhs.dataBuffer;
+        this->numZeroCrossings = rhs.numZeroCrossings;
+        this->settledZeroCrossingMagnitudes = rhs.settledZeroCrossingMagnitudes;
         
         copyBaseVariables((FeatureExtraction*)this, (FeatureExtraction*)&rhs);
     }
@@ -78,6 +82,8 @@ bool ZeroCrossingCounter::clone(const FeatureExtraction *featureExtraction){
         this->derivative = ptr->derivative;
         this->deadZone = ptr->deadZone;
         this->dataBuffer = ptr->dataBuffer;
+        this->numZeroCrossings = ptr->numZeroCrossings;
+        this->settledZeroCrossingMagnitudes = ptr->settledZeroCrossingMagnitudes;
         
         //Clone the base class variables
         return copyBaseVariables((FeatureExtraction*)this,featureExtraction);
@@ -88,7 +94,7 @@ bool ZeroCrossingCounter::clone(const FeatureExtraction *featureExtraction){
     return false;
 }
     
-bool ZeroCrossingCounter::computeFeatures(vector< double > inputVector){
+bool ZeroCrossingCounter::computeFeatures(const vector< double > &inputVector){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
@@ -102,7 +108,68 @@ bool ZeroCrossingCounter::computeFeatures(vector< double > inputVector){
     }
 #endif
     
-    featureVector = update( inputVector );
+    //Clear the feature vector
+    for(UINT j=0; j<featureVector.size(); j++){
+        featureVector[j] = 0;
+    }
+    
+    //Update the derivative data and 
+    if( !derivative.process( inputVector ) ) return false;
+    
+    //The DeadZone can not be setup with a threshold of 0, the features are then always 0
+    if( deadZoneThreshold == 0 ){
+        featureDataReady = true;
+        return true;
+    }
+    
+    //Dead zone the derivative data
+    if( !deadZone.process( derivative.getProcessedData() ) ) return false;
+    
+    const UINT filterSize = derivative.getFilterSize();
+    const vector< double > &x = deadZone.getProcessedData();
+    
+    //The crossing between the two oldest values in the buffer is about to leave the buffer, and the crossing filterSize values from the
+    //start of the buffer is about to move to where its magnitude search is cut short by the start of the buffer
+    for(UINT j=0; j<numInputDimensions; j++){
+        if( searchWindowSize > 1 && isZeroCrossing(dataBuffer[0][j],dataBuffer[1][j]) ) numZeroCrossings[j]--;
+        if( filterSize < searchWindowSize && isZeroCrossing(dataBuffer[filterSize-1][j],dataBuffer[filterSize][j]) ){
+            settledZeroCrossingMagnitudes[j].pop_front();
+        }
+    }
+    
+    //Add the deadzone data to the buffer
+    dataBuffer.push_back( x );
+    
+    //Add the crossing between the new value and the previous value, then compute the features.  The magnitudes are added in the order
+    //of the buffer, the crossings near the start of the buffer (whose magnitude search is cut short by the start of the buffer) first,
+    //so the features are exactly the same as if the whole buffer was searched
+    const UINT lastIndex = searchWindowSize-1;
+    const UINT settledIndex = filterSize < searchWindowSize ? filterSize : searchWindowSize;
+    for(UINT j=0; j<numInputDimensions; j++){
+        UINT colIndex = featureMode == INDEPENDANT_FEATURE_MODE ? (TOTAL_NUM_ZERO_CROSSING_FEATURES*j) : 0;
+        if( searchWindowSize > 1 && isZeroCrossing(dataBuffer[lastIndex-1][j],dataBuffer[lastIndex][j]) ){
+            numZeroCrossings[j]++;
+            if( lastIndex >= filterSize ){
+                settledZeroCrossingMagnitudes[j].push_back( getZeroCrossingMagnitude(lastIndex,j,filterSize) );
+            }
+        }
+        
+        featureVector[ NUM_ZERO_CROSSINGS_COUNTED + colIndex ] += numZeroCrossings[j];
+        
+        double maxValue = 0;
+        for(UINT i=1; i<settledIndex; i++){
+            double value = fabs( dataBuffer[i][j] );
+            if( value > maxValue ) maxValue = value;
+            if( isZeroCrossing(dataBuffer[i-1][j],dataBuffer[i][j]) ) featureVector[ ZERO_CROSSING_MAGNITUDE + colIndex ] += maxValue;
+        }
+        const std::deque< double > &magnitudes = settledZeroCrossingMagnitudes[j];
+        for(std::deque< double >::const_iterator iter = magnitudes.begin(); iter != magnitudes.end(); ++iter){
+            featureVector[ ZERO_CROSSING_MAGNITUDE + colIndex ] += *iter;
+        }
+    }
+    
+    //Flag that the feature data has been computed
+    featureDataReady = true;
     
     return true;
 }
@@ -236,7 +303,7 @@ bool ZeroCrossingCounter::init(UINT searchWindowSize,double deadZoneThreshold,UI
     }
     
     if( deadZoneThreshold < 0 ){
-        errorLog << "init(UINT searchWindowSize,double deadZoneThreshold,UINT numDimensions,UINT featureMode) - The deadZoneThreshold must be greater than zero!" << endl;
+        errorLog << "init(UINT searchWindowSize,double deadZoneThreshold,UINT numDimensions,UINT featureMode) - The deadZoneThreshold must not be negative!" << endl;
         return false;
     }
     
@@ -257,8 +324,10 @@ bool ZeroCrossingCounter::init(UINT searchWindowSize,double deadZoneThreshold,UI
     numInputDimensions = numDimensions;
     numOutputDimensions = featureMode == INDEPENDANT_FEATURE_MODE ? TOTAL_NUM_ZERO_CROSSING_FEATURES * numDimensions : TOTAL_NUM_ZERO_CROSSING_FEATURES;
     derivative.init(Derivative::FIRST_DERIVATIVE, 1.0, numDimensions, true, 5);
-    deadZone.init(-deadZoneThreshold,deadZoneThreshold,numDimensions);
+    if( deadZoneThreshold > 0 ) deadZone.init(-deadZoneThreshold,deadZoneThreshold,numDimensions);
     dataBuffer.resize( searchWindowSize, vector< double >(numDimensions,0) );
+    numZeroCrossings.assign(numDimensions,0);
+    settledZeroCrossingMagnitudes.assign(numDimensions,std::deque< double >());
     featureVector.resize(numOutputDimensions,0);
     
     //Flag that the zero crossing counter has been initialized
@@ -268,11 +337,20 @@ bool ZeroCrossingCounter::init(UINT searchWindowSize,double deadZoneThreshold,UI
 }
 
 
+double ZeroCrossingCounter::getZeroCrossingMagnitude(UINT i,UINT j,UINT searchSize){
+    double maxValue = 0;
+    for(UINT n=0; n<searchSize; n++){
+        double value = fabs( dataBuffer[ i-n ][j] );
+        if( value > maxValue ) maxValue = value;
+    }
+    return maxValue;
+}
+
 vector< double > ZeroCrossingCounter::update(double x){
 	return update(vector<double>(1,x));
 }
     
-vector< double > ZeroCrossingCounter::update(vector< double > x){
+vector< double > ZeroCrossingCounter::update(const vector< double > &x){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
@@ -286,44 +364,7 @@ vector< double > ZeroCrossingCounter::update(vector< double > x){
     }
 #endif
     
-    //Clear the feature vector
-    for(UINT j=0; j<featureVector.size(); j++){
-        featureVector[j] = 0;
-    }
-    
-    //Update the derivative data and 
-    derivative.computeDerivative( x );
-    
-    //Dead zone the derivative data
-    deadZone.filter( derivative.getProcessedData() );
-    
-    //Add the deadzone data to the buffer
-    dataBuffer.push_back( deadZone.getProcessedData() );
-    
-    //Search the buffer for the zero crossing features
-    for(UINT j=0; j<numInputDimensions; j++){
-        UINT colIndex = featureMode == INDEPENDANT_FEATURE_MODE ? (TOTAL_NUM_ZERO_CROSSING_FEATURES*j) : 0;
-        for(UINT i=1; i<dataBuffer.getSize(); i++){
-            //Search for a zero crossing
-            if( (dataBuffer[i][j] > 0 && dataBuffer[i-1][j] <= 0) || (dataBuffer[i][j] < 0 && dataBuffer[i-1][j] >= 0) ){
-                //Update the zero crossing count
-                featureVector[ NUM_ZERO_CROSSINGS_COUNTED + colIndex ]++;
-                
-                //Update the magnitude, pick the maximum value around the zero crossing to make sure we get the peak
-                double maxValue = 0;
-                UINT searchSize = i > derivative.getFilterSize() ? derivative.getFilterSize() : i;
-                for(UINT n=0; n<searchSize; n++){
-                    double value = fabs( dataBuffer[ i-n ][j] );
-                    if( value > maxValue ) maxValue = value;
-                }
-                featureVector[ ZERO_CROSSING_MAGNITUDE + colIndex ] += maxValue;
-            }
-        }
-    }
-    
-    //Flag that the feature data has been computed
-    featureDataReady = true;
-    
+    if( !computeFeatures( x ) ) return vector< double >();
     return featureVector;
 }
     
@@ -35,6 +35,10 @@
  In COMBINED_FEATURE_MODE the zero-crossing count and zero-crossing magnitude features will be integrated across all of the N dimensions in the input signal.
  This means that if the ZeroCrossingCounter is set to INDEPENDANT_FEATURE_MODE, the size of the output feature vector will be 2 * N, where 2 is the two features (zero-crossing count and zero-crossing magnitude) and N is the number of dimensions in the input signal. Alternatively in COMBINED_FEATURE_MODE the size of the output vector will simply be 2, where 2 is the two features (zero-crossing count and zero-crossing magnitude). The feature modes can be set either in the ZeroCrossingCounter constructor or by using the setFeatureMode(UINT featureMode) function.
  
+ The zero crossings are counted as they enter and leave the buffer, and the magnitude of each zero crossing is only searched for once, so
+ the buffer does not have to be searched on each update.  The zero-crossing magnitude is still summed over every zero crossing in the
+ buffer, in the order of the buffer, so the features are exactly the same as if the whole buffer was searched.
+ 
  The ZeroCrossingCounter class is part of the Feature Extraction Modules.
  */
 
@@ -43,6 +47,7 @@
 #include "../GestureRecognitionPipeline/FeatureExtraction.h"
 #include "../PreProcessingModules/Derivative.h"
 #include "../PreProcessingModules/DeadZone.h"
+#include <deque>
 
 namespace GRT{
     
@@ -97,7 +102,7 @@ public:
      @param vector< double > inputVector: the inputVector that should be processed.  Must have the same dimensionality as the FeatureExtraction module
      @return returns true if the data was processed, false otherwise
      */
-    virtual bool computeFeatures(vector< double > inputVector);
+    virtual bool computeFeatures(const vector< double > &inputVector);
     
     /**
      Sets the FeatureExtraction reset function, overwriting the base FeatureExtraction function.
@@ -146,7 +151,8 @@ public:
 
     /**
      Initializes the ZeroCrossingCounter, setting the searchWindowSize, deadZoneThreshold, and dimensionality of the data it will filter.
-     The search window size, deadZoneThreshold, and numDimensions values must be larger than 0.
+     The search window size and numDimensions values must be larger than 0, the deadZoneThreshold must not be negative (all of the
+     features are 0 if the deadZoneThreshold is 0).
      Sets all the data buffer values to zero.
      
      @param UINT searchWindowSize: sets how much data should be held in memory and searched each time the update function is called
@@ -171,7 +177,7 @@ public:
      @param double x: the value to compute features from, this should only be called if the dimensionality of the filter was set to 1
 	 @return a vector containing the ZeroCrossingCounter features, an empty vector will be returned if the features were not computed
      */
-    vector< double > update(vector< double > x);
+    vector< double > update(const vector< double > &x);
     
     /**
      Sets the search window size.  The search window size must be larger than zero.
@@ -238,12 +244,23 @@ public:
     CircularBuffer< vector< double > > getDataBuffer(){ if( initialized ){ return dataBuffer; } return CircularBuffer< vector< double > >(); }
     
 protected:
+    /**
+     Gets the magnitude of a zero crossing, which is the largest absolute value of the searchSize values up to and including index i of the buffer.
+     */
+    double getZeroCrossingMagnitude(UINT i,UINT j,UINT searchSize);
+    
+    static inline bool isZeroCrossing(double previous,double current){
+        return (current > 0 && previous <= 0) || (current < 0 && previous >= 0);
+    }
+    
     UINT searchWindowSize;                                  ///< The size of the search window, i.e. the amount of previous data stored and searched
     UINT featureMode;                                       ///< The featureMode controls how the features are added to the feature vector
     double deadZoneThreshold;                               ///< The threshold value used for the dead zone filter
     Derivative derivative;                                  ///< Used to compute the derivative of the input signal
     DeadZone deadZone;                                      ///< Used to remove small amounts of noise from the data
     CircularBuffer< vector< double > > dataBuffer;          ///< A buffer used to store the previous derivative data
+    vector< UINT > numZeroCrossings;                        ///< The number of zero crossings in the buffer for each dimension
+    vector< std::deque< double > > settledZeroCrossingMagnitudes; ///< For each dimension, the magnitude of each zero crossing at least filterSize values from the start of the buffer (this no longer changes), in buffer order
     
     static RegisterFeatureExtractionModule< ZeroCrossingCounter > registerModule;
     
@@ -24,11 +24,13 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Util/GRTVersionInfo.h"
 #include "Util/GRTCommon.h"
 #include "Util/RangeTracker.h"
+#include "Util/SlidingWindowStatistics.h"
 #include "Util/TrainingDataRecordingTimer.h"
 
 //Include the data structures
 #include "DataStructures/Matrix.h"
 #include "DataStructures/LabelledClassificationData.h"
+#include "DataStructures/MappedLabelledClassificationData.h"
 #include "DataStructures/LabelledTimeSeriesClassificationData.h"
 #include "DataStructures/LabelledContinuousTimeSeriesClassificationData.h"
 #include "DataStructures/LabelledRegressionData.h"
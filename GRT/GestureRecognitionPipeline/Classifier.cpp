@@ -137,6 +137,42 @@ vector< UINT > Classifier::getClassLabels() const{
     return classLabels;
 }
 
+bool Classifier::predictBatch(const Matrix<double> &inputData,vector< UINT > &predictedClassLabels,Matrix<double> &likelihoods,Matrix<double> &distances){
+    
+    if( !trained ){
+        errorLog << "predictBatch(const Matrix<double> &inputData,...) - The classifier has not been trained!" << endl;
+        return false;
+    }
+    
+    const UINT M = inputData.getNumRows();
+    const UINT N = inputData.getNumCols();
+    predictedClassLabels.resize( M );
+    likelihoods.resize( M, getNumClasses() );
+    distances.resize( M, getNumClasses() );
+    likelihoods.setAllValues( 0 );
+    distances.setAllValues( 0 );
+    
+    vector< double > inputVector( N );
+    for(UINT i=0; i<M; i++){
+        std::copy(inputData[i],inputData[i]+N,inputVector.begin());
+        if( !predict( inputVector ) ){
+            errorLog << "predictBatch(const Matrix<double> &inputData,...) - Failed to predict the row at index: " << i << endl;
+            return false;
+        }
+        storeBatchPrediction(i,predictedClassLabels,likelihoods,distances);
+    }
+    
+    return true;
+}
+    
+void Classifier::storeBatchPrediction(UINT rowIndex,vector< UINT > &predictedClassLabels,Matrix<double> &likelihoods,Matrix<double> &distances) const{
+    predictedClassLabels[ rowIndex ] = predictedClassLabel;
+    const UINT numLikelihoods = (UINT)classLikelihoods.size() < likelihoods.getNumCols() ? (UINT)classLikelihoods.size() : likelihoods.getNumCols();
+    const UINT numDistances = (UINT)classDistances.size() < distances.getNumCols() ? (UINT)classDistances.size() : distances.getNumCols();
+    for(UINT k=0; k<numLikelihoods; k++) likelihoods[ rowIndex ][k] = classLikelihoods[k];
+    for(UINT k=0; k<numDistances; k++) distances[ rowIndex ][k] = classDistances[k];
+}
+
 bool Classifier::enableNullRejection(bool useNullRejection){ 
     this->useNullRejection = useNullRejection; 
     return true;
@@ -94,6 +94,19 @@ public:
      */
     virtual bool train(UnlabelledClassificationData &trainingData){ return false; }
 
+    /**
+     This predicts the class of each row of the inputData, the rows are predicted in order so after the call the classifier holds the
+     prediction of the last row.  The base function simply calls predict(...) for each row, classifiers that can share work between
+     the rows (such as scaling the data or keeping the model parameters in the cache) should overwrite this function.
+
+     @param const Matrix<double> &inputData: the input vectors to classify, with one vector per row
+     @param vector< UINT > &predictedClassLabels: returns the predicted class label of each row
+     @param Matrix<double> &likelihoods: returns the class likelihoods of each row, with one column per class
+     @param Matrix<double> &distances: returns the class distances of each row, with one column per class
+     @return returns true if every row was predicted, false otherwise
+     */
+    virtual bool predictBatch(const Matrix<double> &inputData,vector< UINT > &predictedClassLabels,Matrix<double> &likelihoods,Matrix<double> &distances);
+
     /**
      Returns the classifeir type as a string.
      
@@ -246,6 +259,12 @@ protected:
     vector< double > nullRejectionThresholds;
     vector< UINT > classLabels;
     
+    /**
+     Copies the prediction of the classifier (the predicted class label, class likelihoods and class distances) into the rowIndex row
+     of the batch results, this is used by predictBatch(...) once each row has been predicted.
+     */
+    void storeBatchPrediction(UINT rowIndex,vector< UINT > &predictedClassLabels,Matrix<double> &likelihoods,Matrix<double> &distances) const;
+    
     static StringClassifierMap *getMap() {
         if( !stringClassifierMap ){ stringClassifierMap = new StringClassifierMap; } 
         return stringClassifierMap; 
@@ -55,7 +55,7 @@ public:
         return true;
     }
 
-    virtual bool process(vector< double > inputVector){ return false; }
+    virtual bool process(const vector< double > &inputVector){ return false; }
     virtual bool reset(){ return false; }
     
     virtual bool updateContext(bool value){ return false; }
@@ -66,7 +66,7 @@ public:
     UINT getNumOutputDimensions(){ return numOutputDimensions; }
     bool getInitialized(){ return initialized; }
     bool getOK(){ return okToContinue; }
-    vector< double > getProcessedData(){ return data; }
+    const vector< double >& getProcessedData() const { return data; }
     
     //Setters
     
@@ -90,7 +90,7 @@ bool FeatureExtraction::getFeatureDataReady() const{
     return featureDataReady;
 }
 
-vector< double > FeatureExtraction::getFeatureVector() const{ 
+const vector< double >& FeatureExtraction::getFeatureVector() const{ 
     return featureVector; 
 }
     
@@ -72,7 +72,7 @@ public:
      @param vector< double > inputVector: the inputVector that should be processed
      @return returns true if the data was processed, false otherwise (the base class always returns false)
      */
-    virtual bool computeFeatures(vector< double > inputVector){ return false; }
+    virtual bool computeFeatures(const vector< double > &inputVector){ return false; }
     
     /**
      This function is called by the GestureRecognitionPipeline's reset function.
@@ -159,7 +159,7 @@ public:
      
      @return returns the current feature vector, this vector will be empty if the module has not been initialized
      */
-    vector< double > getFeatureVector() const;
+    const vector< double >& getFeatureVector() const;
     
     /**
      Creates a new feature extraction instance based on the current featureExtractionType string value.
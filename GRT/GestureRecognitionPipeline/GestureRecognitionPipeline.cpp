@@ -31,6 +31,7 @@ GestureRecognitionPipeline::GestureRecognitionPipeline(void)
     outputVectorDimensions = 0;
     predictedClassLabel = 0;
     predictionModuleIndex = 0;
+    numTrainingThreads = 0;
     testAccuracy = 0;
     testRMSError = 0;
     testRejectionPrecision = 0;
@@ -38,12 +39,85 @@ GestureRecognitionPipeline::GestureRecognitionPipeline(void)
     classifier = NULL;
     regressifier = NULL;
     contextModules.resize( NUM_CONTEXT_LEVELS );
+    classLabelBuffer.resize( 1, 0 );
     
     debugLog.setProceedingText("[DEBUG GRP]");
     errorLog.setProceedingText("[ERROR GRP]");
     warningLog.setProceedingText("[WARNING GRP]");
 }
 
+GestureRecognitionPipeline::GestureRecognitionPipeline(const GestureRecognitionPipeline &rhs)
+{
+    classifier = NULL;
+    regressifier = NULL;
+    contextModules.resize( NUM_CONTEXT_LEVELS );
+    
+    debugLog.setProceedingText("[DEBUG GRP]");
+    errorLog.setProceedingText("[ERROR GRP]");
+    warningLog.setProceedingText("[WARNING GRP]");
+    
+    *this = rhs;
+}
+
+GestureRecognitionPipeline& GestureRecognitionPipeline::operator=(const GestureRecognitionPipeline &rhs){
+    
+    if( this != &rhs ){
+        //Clean up any existing modules
+        deleteAllPreProcessingModules();
+        deleteAllFeatureExtractionModules();
+        deleteClassifier();
+        deleteRegressifier();
+        deleteAllPostProcessingModules();
+        deleteAllContextModules();
+        
+        //Clone the modules from the rhs pipeline, each module is created from its type so this pipeline owns its own copy
+        for(UINT i=0; i<rhs.preProcessingModules.size(); i++){
+            addPreProcessingModule( *rhs.preProcessingModules[i] );
+        }
+        for(UINT i=0; i<rhs.featureExtractionModules.size(); i++){
+            addFeatureExtractionModule( *rhs.featureExtractionModules[i] );
+        }
+        if( rhs.classifier != NULL ){
+            setClassifier( *rhs.classifier );
+        }
+        if( rhs.regressifier != NULL ){
+            setRegressifier( *rhs.regressifier );
+        }
+        for(UINT i=0; i<rhs.postProcessingModules.size(); i++){
+            addPostProcessingModule( *rhs.postProcessingModules[i] );
+        }
+        for(UINT i=0; i<rhs.contextModules.size(); i++){
+            if( rhs.contextModules[i].size() > 0 ){
+                warningLog << "operator=(const GestureRecognitionPipeline &rhs) - The context modules can not be copied, they will need to be added to the new pipeline!" << endl;
+                break;
+            }
+        }
+        
+        //Copy the pipeline variables
+        this->initialized = rhs.initialized;
+        this->trained = rhs.trained;
+        this->inputVectorDimensions = rhs.inputVectorDimensions;
+        this->outputVectorDimensions = rhs.outputVectorDimensions;
+        this->predictedClassLabel = rhs.predictedClassLabel;
+        this->pipelineMode = rhs.pipelineMode;
+        this->predictionModuleIndex = rhs.predictionModuleIndex;
+        this->numTrainingThreads = rhs.numTrainingThreads;
+        this->testAccuracy = rhs.testAccuracy;
+        this->testRMSError = rhs.testRMSError;
+        this->testFMeasure = rhs.testFMeasure;
+        this->testPrecision = rhs.testPrecision;
+        this->testRecall = rhs.testRecall;
+        this->regressionData = rhs.regressionData;
+        this->inputBuffer = rhs.inputBuffer;
+        this->classLabelBuffer = rhs.classLabelBuffer;
+        this->testRejectionPrecision = rhs.testRejectionPrecision;
+        this->testRejectionRecall = rhs.testRejectionRecall;
+        this->testConfusionMatrix = rhs.testConfusionMatrix;
+    }
+    
+    return *this;
+}
+
 GestureRecognitionPipeline::~GestureRecognitionPipeline(void)
 {
     //Clean up the memory
@@ -135,6 +209,63 @@ bool GestureRecognitionPipeline::train(LabelledClassificationData &trainingData)
     return true;
 }
     
+//Trains and tests the folds of a k-fold cross validation, each fold is run on its own pipeline. The training samples of a fold are copied into a
+//new dataset (as this is what the classifiers train on) but the test samples are read straight from the parent dataset through the fold indexs.
+//The raw test counters of each fold are kept so they can be merged in fold order once all the folds have finished
+class PipelineKFoldJob : public ParallelJob{
+public:
+    struct FoldResult{
+        FoldResult():trained(false),tested(false),numTestSamples(0),numCorrect(0),rejectionPrecision(0),rejectionRecall(0),rejectionPrecisionCounter(0),rejectionRecallCounter(0){}
+        bool trained;
+        bool tested;
+        UINT numTestSamples;
+        double numCorrect;
+        double rejectionPrecision;
+        double rejectionRecall;
+        double rejectionPrecisionCounter;
+        double rejectionRecallCounter;
+        vector< UINT > classLabels;
+        vector< double > precision;
+        vector< double > recall;
+        vector< double > precisionCounter;
+        vector< double > recallCounter;
+        vector< double > confusionMatrixCounter;
+        Matrix< double > confusionMatrix;
+    };
+    
+    PipelineKFoldJob(LabelledClassificationData &data,vector< GestureRecognitionPipeline* > &foldPipelines):
+        data(data),foldPipelines(foldPipelines),foldResults(foldPipelines.size()){}
+    
+    virtual void run(unsigned int /*threadIndex*/,unsigned int startIndex,unsigned int endIndex){
+        for(UINT k=startIndex; k<endIndex; k++){
+            GestureRecognitionPipeline *pipeline = foldPipelines[k];
+            FoldResult &fold = foldResults[k];
+            
+            LabelledClassificationData foldTrainingData = data.getTrainingFoldData(k);
+            fold.trained = pipeline->train( foldTrainingData );
+            if( !fold.trained ) continue;
+            
+            const vector< UINT > testIndexs = data.getTestFoldIndexs(k);
+            fold.tested = pipeline->testSamples(data,testIndexs,fold.precisionCounter,fold.recallCounter,fold.rejectionPrecisionCounter,fold.rejectionRecallCounter,fold.confusionMatrixCounter);
+            if( !fold.tested ) continue;
+            
+            //Keep the raw counts, the pipeline may be used by the next fold
+            fold.numTestSamples = (UINT)testIndexs.size();
+            fold.numCorrect = pipeline->testAccuracy;
+            fold.rejectionPrecision = pipeline->testRejectionPrecision;
+            fold.rejectionRecall = pipeline->testRejectionRecall;
+            fold.classLabels = pipeline->classifier->getClassLabels();
+            fold.precision = pipeline->testPrecision;
+            fold.recall = pipeline->testRecall;
+            fold.confusionMatrix = pipeline->testConfusionMatrix;
+        }
+    }
+    
+    LabelledClassificationData &data;
+    vector< GestureRecognitionPipeline* > &foldPipelines;
+    vector< FoldResult > foldResults;
+};
+    
 bool GestureRecognitionPipeline::train(LabelledClassificationData &trainingData, UINT kFoldValue, bool useStratifiedSampling){
     
     trained = false;
@@ -163,30 +294,125 @@ bool GestureRecognitionPipeline::train(LabelledClassificationData &trainingData,
         return false;
     }
     
-    //Run the k-fold training and testing
+    //Each fold is trained and tested on its own copy of this pipeline so the folds can run at the same time. The copies are created and
+    //deleted on this thread as the module factories are not thread safe. Context modules can not be copied, so if any are set then the
+    //folds are run one after the other on this pipeline instead
+    const bool useFoldPipelines = !getIsContextSet();
+    vector< GestureRecognitionPipeline* > foldPipelines(kFoldValue,this);
+    if( useFoldPipelines ){
+        for(UINT k=0; k<kFoldValue; k++){
+            foldPipelines[k] = new GestureRecognitionPipeline( *this );
+        }
+    }
+    
+    //If the folds run in parallel then the modules of each fold are trained on that fold's thread, as any parallel loops they run are
+    //nested in this one
+    PipelineKFoldJob job(trainingData,foldPipelines);
+    ParallelFor::run(job,kFoldValue,useFoldPipelines ? numTrainingThreads : 1);
+    
+    //Keep the modules trained on the last fold, so the pipeline is left in the same state as if the folds had been run in order
+    if( useFoldPipelines ){
+        GestureRecognitionPipeline *lastFoldPipeline = foldPipelines[kFoldValue-1];
+        std::swap(preProcessingModules,lastFoldPipeline->preProcessingModules);
+        std::swap(featureExtractionModules,lastFoldPipeline->featureExtractionModules);
+        std::swap(classifier,lastFoldPipeline->classifier);
+        std::swap(regressifier,lastFoldPipeline->regressifier);
+        std::swap(postProcessingModules,lastFoldPipeline->postProcessingModules);
+        inputVectorDimensions = lastFoldPipeline->inputVectorDimensions;
+        trained = lastFoldPipeline->trained;
+        
+        for(UINT k=0; k<kFoldValue; k++){
+            delete foldPipelines[k];
+            foldPipelines[k] = NULL;
+        }
+    }
+    
+    for(UINT k=0; k<kFoldValue; k++){
+        if( !job.foldResults[k].trained ){
+            errorLog << "train(LabelledClassificationData &trainingData,UINT kFoldValue, bool useStratifiedSampling) - Failed to train fold " << k << endl;
+            trained = false;
+            return false;
+        }
+        if( !job.foldResults[k].tested ){
+            errorLog << "train(LabelledClassificationData &trainingData,UINT kFoldValue, bool useStratifiedSampling) - Failed to test fold " << k << endl;
+            return false;
+        }
+    }
+    
+    //Merge the test results of the folds in fold order. The folds can order their class labels differently (the order depends on which
+    //sample of each class is seen first) so the per class counters are mapped to the class labels of the final model by label
+    const UINT numClasses = classifier->getNumClasses();
+    const vector< UINT > classLabels = classifier->getClassLabels();
+    const UINT nullOffset = classifier->getNullRejectionEnabled() ? 1 : 0;
+    const UINT confusionMatrixSize = numClasses + nullOffset;
+    vector< double > precisionCounter(numClasses, 0);
+    vector< double > recallCounter(numClasses, 0);
+    vector< double > confusionMatrixCounter(confusionMatrixSize, 0);
+    double rejectionPrecisionCounter = 0;
+    double rejectionRecallCounter = 0;
+    UINT numTestSamples = 0;
     double crossValidationAccuracy = 0;
-    bool trainingResult = false;
-    bool testingResult = false;
-    LabelledClassificationData foldTrainingData;
-    LabelledClassificationData foldTestData;
+    
+    testAccuracy = 0;
+    testPrecision.clear();
+    testRecall.clear();
+    testFMeasure.clear();
+    testPrecision.resize(numClasses, 0);
+    testRecall.resize(numClasses, 0);
+    testFMeasure.resize(numClasses, 0);
+    testRejectionPrecision = 0;
+    testRejectionRecall = 0;
+    testConfusionMatrix.resize(confusionMatrixSize, confusionMatrixSize);
+    testConfusionMatrix.setAllValues(0);
+    
     for(UINT k=0; k<kFoldValue; k++){
-        ///Train the classification system
-        foldTrainingData = trainingData.getTrainingFoldData(k);
-        trainingResult = train( foldTrainingData );
+        const PipelineKFoldJob::FoldResult &fold = job.foldResults[k];
         
-        if( !trainingResult ){
-            return false;
+        //Map the class index of the fold to the class index of the final model, with the null class (if used) kept at index 0
+        vector< UINT > classIndexMap( fold.confusionMatrix.getNumRows(), 0 );
+        for(UINT i=0; i<fold.classLabels.size(); i++){
+            bool labelFound = false;
+            for(UINT j=0; j<numClasses; j++){
+                if( fold.classLabels[i] == classLabels[j] ){
+                    classIndexMap[i+nullOffset] = j+nullOffset;
+                    labelFound = true;
+                    break;
+                }
+            }
+            if( !labelFound ){
+                errorLog << "train(LabelledClassificationData &trainingData,UINT kFoldValue, bool useStratifiedSampling) - Fold " << k << " contains a class label (" << fold.classLabels[i] << ") that is not in the model of the last fold!" << endl;
+                return false;
+            }
         }
         
-        //Test the classification system
-        foldTestData = trainingData.getTestFoldData(k);
-        testingResult = test( foldTestData );
+        for(UINT i=0; i<fold.classLabels.size(); i++){
+            const UINT j = classIndexMap[i+nullOffset]-nullOffset;
+            testPrecision[j] += fold.precision[i];
+            testRecall[j] += fold.recall[i];
+            precisionCounter[j] += fold.precisionCounter[i];
+            recallCounter[j] += fold.recallCounter[i];
+        }
+        for(UINT r=0; r<fold.confusionMatrix.getNumRows(); r++){
+            for(UINT c=0; c<fold.confusionMatrix.getNumCols(); c++){
+                testConfusionMatrix[ classIndexMap[r] ][ classIndexMap[c] ] += fold.confusionMatrix[r][c];
+            }
+            confusionMatrixCounter[ classIndexMap[r] ] += fold.confusionMatrixCounter[r];
+        }
+        testAccuracy += fold.numCorrect;
+        testRejectionPrecision += fold.rejectionPrecision;
+        testRejectionRecall += fold.rejectionRecall;
+        rejectionPrecisionCounter += fold.rejectionPrecisionCounter;
+        rejectionRecallCounter += fold.rejectionRecallCounter;
+        numTestSamples += fold.numTestSamples;
         
-        if( !testingResult ){
-            return false;
+        if( fold.numTestSamples > 0 ){
+            crossValidationAccuracy += fold.numCorrect / double(fold.numTestSamples) * 100.0;
         }
-        
-        crossValidationAccuracy += getTestAccuracy();
+    }
+    
+    if( !computeTestMetrics(precisionCounter,recallCounter,rejectionPrecisionCounter,rejectionRecallCounter,confusionMatrixCounter,numTestSamples) ){
+        errorLog << "train(LabelledClassificationData &trainingData,UINT kFoldValue, bool useStratifiedSampling) - Failed to compute test metrics !" << endl;
+        return false;
     }
     
     //Set the accuracy of the classification system averaged over the kfolds
@@ -446,98 +672,22 @@ bool GestureRecognitionPipeline::train(LabelledRegressionData &trainingData){
     
 bool GestureRecognitionPipeline::test(LabelledClassificationData &testData){
     
-    testAccuracy = 0;
-    testRMSError = 0;
-    testFMeasure.clear();
-    testPrecision.clear();
-    testRecall.clear();
-    testRejectionPrecision = 0;
-    testRejectionRecall = 0;
-    testConfusionMatrix.clear();
-    
-    //Make sure the classification model has been trained
-    if( !trained ){
-        errorLog << "test(LabelledClassificationData &testData) - Classifier is not trained" << endl;
-        return false;
-    }
-    
-    //Make sure the dimensionality of the test data matches the input vector's dimensions
-    if( testData.getNumDimensions() != inputVectorDimensions ){
-        errorLog << "test(LabelledClassificationData &testData) - The dimensionality of the test data (" << testData.getNumDimensions() << ") does not match that of the input vector dimensions of the pipeline (" << inputVectorDimensions << ")" << endl;
-        return false;
-    }
+    //Test all the samples in the test data
+    const UINT M = testData.getNumSamples();
+    vector< UINT > testIndexs( M );
+    for(UINT i=0; i<M; i++) testIndexs[i] = i;
     
-    if( !getIsClassifierSet() ){
-        errorLog << "test(LabelledClassificationData &testData) - The classifier has not been set" << endl;
-        return false;
-    }
-
-	//Validate that the class labels in the test data match the class labels in the model
-	bool classLabelValidationPassed = true;
-	for(UINT i=0; i<testData.getNumClasses(); i++){
-		bool labelFound = false;
-		for(UINT k=0; k<classifier->getNumClasses(); k++){
-			if( testData.getClassTracker()[i].classLabel == classifier->getClassLabels()[k] ){
-				labelFound = true;
-				break;
-			}
-		}
-
-		if( !labelFound ){
-			classLabelValidationPassed = false;
-			errorLog << "test(LabelledClassificationData &testData) - The test dataset contains a class label (" << testData.getClassTracker()[i].classLabel << ") that is not in the model!" << endl;
-		}
-	}
-
-	if( !classLabelValidationPassed ){
-        errorLog << "test(LabelledClassificationData &testData) -  Model Class Labels: ";
-        for(UINT k=0; k<classifier->getNumClasses(); k++){
-			errorLog << classifier->getClassLabels()[k] << "\t";
-		}
-        errorLog << endl;
-        return false;
-    }
-
     double rejectionPrecisionCounter = 0;
     double rejectionRecallCounter = 0;
-    unsigned int confusionMatrixSize = classifier->getNullRejectionEnabled() ? classifier->getNumClasses()+1 : classifier->getNumClasses();
-    vector< double > precisionCounter(classifier->getNumClasses(), 0);
-    vector< double > recallCounter(classifier->getNumClasses(), 0);
-    vector< double > confusionMatrixCounter(confusionMatrixSize,0);
-    
-    //Resize the test matrix
-    testConfusionMatrix.resize(confusionMatrixSize, confusionMatrixSize);
-    testConfusionMatrix.setAllValues(0);
+    vector< double > precisionCounter;
+    vector< double > recallCounter;
+    vector< double > confusionMatrixCounter;
     
-    //Resize the precision and recall vectors
-    testPrecision.clear();
-    testRecall.clear();
-    testFMeasure.clear();
-    testPrecision.resize(getNumClassesInModel(), 0);
-    testRecall.resize(getNumClassesInModel(), 0);
-    testFMeasure.resize(getNumClassesInModel(), 0);
-
-    //Run the test
-    for(UINT i=0; i<testData.getNumSamples(); i++){
-        UINT classLabel = testData[i].getClassLabel();
-        vector< double > testSample = testData[i].getSample();
-        
-        //Pass the test sample through the pipeline
-        if( !predict( testSample ) ){
-            errorLog << "test(LabelledClassificationData &testData) - Prediction failed for test sample at index: " << i << endl;
-            return false;
-        }
-        
-        //Update the test metrics
-        UINT predictedClassLabel = getPredictedClassLabel();
-        
-        if( !updateTestMetrics(classLabel,predictedClassLabel,precisionCounter,recallCounter,rejectionPrecisionCounter,rejectionRecallCounter, confusionMatrixCounter) ){
-            errorLog << "test(LabelledClassificationData &testData) - Failed to update test metrics at test sample index: " << i << endl;
-            return false;
-        }
+    if( !testSamples(testData,testIndexs,precisionCounter,recallCounter,rejectionPrecisionCounter,rejectionRecallCounter,confusionMatrixCounter) ){
+        return false;
     }
     
-    if( !computeTestMetrics(precisionCounter,recallCounter,rejectionPrecisionCounter,rejectionRecallCounter, confusionMatrixCounter, testData.getNumSamples()) ){
+    if( !computeTestMetrics(precisionCounter,recallCounter,rejectionPrecisionCounter,rejectionRecallCounter, confusionMatrixCounter, M) ){
         errorLog << "test(LabelledClassificationData &testData) - Failed to compute test metrics !" << endl;
         return false;
     }
@@ -754,7 +904,20 @@ bool GestureRecognitionPipeline::test(LabelledRegressionData &testData){
     return true;
 }
 
-bool GestureRecognitionPipeline::predict(vector< double > inputVector){
+bool GestureRecognitionPipeline::predict(const double *inputVector,const UINT inputVectorSize){
+    
+    if( inputVector == NULL ){
+        errorLog << "predict(const double *inputVector,const UINT inputVectorSize) - The input vector is NULL!" << endl;
+        return false;
+    }
+    
+    //Copy the input into the input buffer, assign reuses the memory of the buffer so this only allocates the first time it is called
+    inputBuffer.assign(inputVector,inputVector+inputVectorSize);
+    
+    return predict( inputBuffer );
+}
+    
+bool GestureRecognitionPipeline::predict(const vector< double > &inputVector){
     
     predictedClassLabel = 0;
     
@@ -775,29 +938,32 @@ bool GestureRecognitionPipeline::predict(vector< double > inputVector){
         return false;
     }
     
+    //Each stage reads the output buffer of the stage before it, so the data is not copied between the stages
+    const vector< double > *data = &inputVector;
+    
     //Update the context module
     predictionModuleIndex = START_OF_PIPELINE;
     if( contextModules[ START_OF_PIPELINE ].size() ){
         for(UINT moduleIndex=0; moduleIndex<contextModules[ START_OF_PIPELINE ].size(); moduleIndex++){
-            if( !contextModules[ START_OF_PIPELINE ][moduleIndex]->process( inputVector ) ){
+            if( !contextModules[ START_OF_PIPELINE ][moduleIndex]->process( *data ) ){
                 errorLog << "predict(vector< double > inputVector) - Context Module Failed at START_OF_PIPELINE. ModuleIndex: " << moduleIndex << endl;
                 return false;
             }
             if( !contextModules[ START_OF_PIPELINE ][moduleIndex]->getOK() ){
                 return true;
             }
-            inputVector = contextModules[ START_OF_PIPELINE ][moduleIndex]->getProcessedData();
+            data = &contextModules[ START_OF_PIPELINE ][moduleIndex]->getProcessedData();
         }
     }
     
     //Perform any pre-processing
     if( getIsPreProcessingSet() ){
         for(UINT moduleIndex=0; moduleIndex<preProcessingModules.size(); moduleIndex++){
-            if( !preProcessingModules[moduleIndex]->process( inputVector ) ){
+            if( !preProcessingModules[moduleIndex]->process( *data ) ){
                 errorLog << "predict(vector< double > inputVector) - Failed to PreProcess Input Vector. PreProcessingModuleIndex: " << moduleIndex << endl;
                 return false;
             }
-            inputVector = preProcessingModules[moduleIndex]->getProcessedData();
+            data = &preProcessingModules[moduleIndex]->getProcessedData();
         }
     }
     
@@ -805,7 +971,7 @@ bool GestureRecognitionPipeline::predict(vector< double > inputVector){
     predictionModuleIndex = AFTER_PREPROCESSING;
     if( contextModules[ AFTER_PREPROCESSING ].size() ){
         for(UINT moduleIndex=0; moduleIndex<contextModules[ AFTER_PREPROCESSING ].size(); moduleIndex++){
-            if( !contextModules[ AFTER_PREPROCESSING ][moduleIndex]->process( inputVector ) ){
+            if( !contextModules[ AFTER_PREPROCESSING ][moduleIndex]->process( *data ) ){
                 errorLog << "predict(vector< double > inputVector) - Context Module Failed at AFTER_PREPROCESSING. ModuleIndex: " << moduleIndex << endl;
                 return false;
             }
@@ -813,18 +979,18 @@ bool GestureRecognitionPipeline::predict(vector< double > inputVector){
                 predictionModuleIndex = AFTER_PREPROCESSING;
                 return false;
             }
-            inputVector = contextModules[ AFTER_PREPROCESSING ][moduleIndex]->getProcessedData();
+            data = &contextModules[ AFTER_PREPROCESSING ][moduleIndex]->getProcessedData();
         }
     }
     
     //Perform any feature extraction
     if( getIsFeatureExtractionSet() ){
         for(UINT moduleIndex=0; moduleIndex<featureExtractionModules.size(); moduleIndex++){
-            if( !featureExtractionModules[moduleIndex]->computeFeatures( inputVector ) ){
+            if( !featureExtractionModules[moduleIndex]->computeFeatures( *data ) ){
                 errorLog << "predict(vector< double > inputVector) - Failed to compute features from data. FeatureExtractionModuleIndex: " << moduleIndex << endl;
                 return false;
             }
-            inputVector = featureExtractionModules[moduleIndex]->getFeatureVector();
+            data = &featureExtractionModules[moduleIndex]->getFeatureVector();
         }
     }
     
@@ -832,7 +998,7 @@ bool GestureRecognitionPipeline::predict(vector< double > inputVector){
     predictionModuleIndex = AFTER_FEATURE_EXTRACTION;
     if( contextModules[ AFTER_FEATURE_EXTRACTION ].size() ){
         for(UINT moduleIndex=0; moduleIndex<contextModules[ AFTER_FEATURE_EXTRACTION ].size(); moduleIndex++){
-            if( !contextModules[ AFTER_FEATURE_EXTRACTION ][moduleIndex]->process( inputVector ) ){
+            if( !contextModules[ AFTER_FEATURE_EXTRACTION ][moduleIndex]->process( *data ) ){
                 errorLog << "predict(vector< double > inputVector) - Context Module Failed at AFTER_FEATURE_EXTRACTION. ModuleIndex: " << moduleIndex << endl;
                 return false;
             }
@@ -840,12 +1006,12 @@ bool GestureRecognitionPipeline::predict(vector< double > inputVector){
                 predictionModuleIndex = AFTER_FEATURE_EXTRACTION;
                 return false;
             }
-            inputVector = contextModules[ AFTER_FEATURE_EXTRACTION ][moduleIndex]->getProcessedData();
+            data = &contextModules[ AFTER_FEATURE_EXTRACTION ][moduleIndex]->getProcessedData();
         }
     }
     
     //Perform the classification
-    if( !classifier->predict(inputVector) ){
+    if( !classifier->predict(*data) ){
         errorLog << "predict(vector< double > inputVector) - Prediction Failed" << endl;
         return false;
     }
@@ -854,7 +1020,8 @@ bool GestureRecognitionPipeline::predict(vector< double > inputVector){
     //Update the context module
     if( contextModules[ AFTER_CLASSIFIER ].size() ){
         for(UINT moduleIndex=0; moduleIndex<contextModules[ AFTER_CLASSIFIER ].size(); moduleIndex++){
-            if( !contextModules[ AFTER_CLASSIFIER ][moduleIndex]->process( vector<double>(1,predictedClassLabel) ) ){
+            classLabelBuffer[0] = predictedClassLabel;
+            if( !contextModules[ AFTER_CLASSIFIER ][moduleIndex]->process( classLabelBuffer ) ){
                 errorLog << "predict(vector< double > inputVector) - Context Module Failed at AFTER_CLASSIFIER. ModuleIndex: " << moduleIndex << endl;
                 return false;
             }
@@ -868,76 +1035,199 @@ bool GestureRecognitionPipeline::predict(vector< double > inputVector){
     
     //Perform any post processing
     predictionModuleIndex = AFTER_CLASSIFIER;
+    if( !postProcessPredictedClassLabel() ){
+        return false;
+    }
+    
+    //Update the context module
+    predictionModuleIndex = END_OF_PIPELINE;
+    if( contextModules[ END_OF_PIPELINE ].size() ){
+        for(UINT moduleIndex=0; moduleIndex<contextModules[ END_OF_PIPELINE ].size(); moduleIndex++){
+            classLabelBuffer[0] = predictedClassLabel;
+            if( !contextModules[ END_OF_PIPELINE ][moduleIndex]->process( classLabelBuffer ) ){
+                errorLog << "predict(vector< double > inputVector) - Context Module Failed at END_OF_PIPELINE. ModuleIndex: " << moduleIndex << endl;
+                return false;
+            }
+            if( !contextModules[ END_OF_PIPELINE ][moduleIndex]->getOK() ){
+                predictionModuleIndex = END_OF_PIPELINE;
+                return false;
+            }
+            predictedClassLabel = (UINT)contextModules[ END_OF_PIPELINE ][moduleIndex]->getProcessedData()[0];
+        }
+    }
+    
+    return true;
+}
+    
+bool GestureRecognitionPipeline::predictBatch(const Matrix<double> &inputData,vector< UINT > &predictedClassLabels,Matrix<double> &likelihoods,Matrix<double> &distances){
+    
+    predictedClassLabel = 0;
+    
+    //Make sure the classification model has been trained
+    if( !trained ){
+        errorLog << "predictBatch(const Matrix<double> &inputData,...) - The classifier has not been trained" << endl;
+        return false;
+    }
+    
+    //Make sure the dimensionality of the input data matches the inputVectorDimensions
+    if( inputData.getNumCols() != inputVectorDimensions ){
+        errorLog << "predictBatch(const Matrix<double> &inputData,...) - The number of columns in the input data (" << inputData.getNumCols() << ") does not match that of the input vector dimensions of the pipeline (" << inputVectorDimensions << ")" << endl;
+        return false;
+    }
+    
+    if( !getIsClassifierSet() ){
+        errorLog << "predictBatch(const Matrix<double> &inputData,...) - Classifier is not set" << endl;
+        return false;
+    }
+    
+    const UINT M = inputData.getNumRows();
+    const UINT N = inputData.getNumCols();
+    
+    //A context module can stop a prediction part way through the pipeline, so in this case each row is run through the full predict function
+    if( getIsContextSet() ){
+        const UINT K = getNumClassesInModel();
+        predictedClassLabels.resize( M );
+        likelihoods.resize( M, K );
+        distances.resize( M, K );
+        likelihoods.setAllValues( 0 );
+        distances.setAllValues( 0 );
+        for(UINT i=0; i<M; i++){
+            inputBuffer.assign(inputData[i],inputData[i]+N);
+            if( !predict( inputBuffer ) ){
+                errorLog << "predictBatch(const Matrix<double> &inputData,...) - Prediction failed for the row at index: " << i << endl;
+                return false;
+            }
+            predictedClassLabels[i] = predictedClassLabel;
+            vector< double > classLikelihoods = classifier->getClassLikelihoods();
+            vector< double > classDistances = classifier->getClassDistances();
+            for(UINT k=0; k<K && k<classLikelihoods.size(); k++) likelihoods[i][k] = classLikelihoods[k];
+            for(UINT k=0; k<K && k<classDistances.size(); k++) distances[i][k] = classDistances[k];
+        }
+        return true;
+    }
+    
+    //The pre-processing and feature extraction modules are stateful, so each row is run through them in order and the output of the last
+    //module is stored in one block that is given to the classifier
+    const Matrix<double> *features = &inputData;
+    Matrix<double> featureData;
+    if( getIsPreProcessingSet() || getIsFeatureExtractionSet() ){
+        for(UINT i=0; i<M; i++){
+            inputBuffer.assign(inputData[i],inputData[i]+N);
+            const vector< double > *data = &inputBuffer;
+            
+            for(UINT moduleIndex=0; moduleIndex<preProcessingModules.size(); moduleIndex++){
+                if( !preProcessingModules[moduleIndex]->process( *data ) ){
+                    errorLog << "predictBatch(const Matrix<double> &inputData,...) - Failed to PreProcess the row at index: " << i << ". PreProcessingModuleIndex: " << moduleIndex << endl;
+                    return false;
+                }
+                data = &preProcessingModules[moduleIndex]->getProcessedData();
+            }
+            
+            for(UINT moduleIndex=0; moduleIndex<featureExtractionModules.size(); moduleIndex++){
+                if( !featureExtractionModules[moduleIndex]->computeFeatures( *data ) ){
+                    errorLog << "predictBatch(const Matrix<double> &inputData,...) - Failed to compute features from the row at index: " << i << ". FeatureExtractionModuleIndex: " << moduleIndex << endl;
+                    return false;
+                }
+                data = &featureExtractionModules[moduleIndex]->getFeatureVector();
+            }
+            
+            if( i == 0 ) featureData.resize( M, (UINT)data->size() );
+            std::copy(data->begin(),data->end(),featureData[i]);
+        }
+        features = &featureData;
+    }
+    
+    //Perform the classification
+    if( M > 0 ){
+        if( !classifier->predictBatch(*features,predictedClassLabels,likelihoods,distances) ){
+            errorLog << "predictBatch(const Matrix<double> &inputData,...) - Prediction Failed" << endl;
+            return false;
+        }
+    }else{
+        predictedClassLabels.clear();
+        likelihoods.clear();
+        distances.clear();
+        return true;
+    }
+    
+    //The post processing modules are also stateful, so the predicted class labels are filtered in order
+    predictionModuleIndex = AFTER_CLASSIFIER;
+    for(UINT i=0; i<M; i++){
+        predictedClassLabel = predictedClassLabels[i];
+        if( !postProcessPredictedClassLabel() ){
+            return false;
+        }
+        predictedClassLabels[i] = predictedClassLabel;
+    }
+    predictionModuleIndex = END_OF_PIPELINE;
+    
+    return true;
+}
+    
+bool GestureRecognitionPipeline::postProcessPredictedClassLabel(){
+    
     if( getIsPostProcessingSet() ){
         
         if( pipelineMode != CLASSIFICATION_MODE){
-            errorLog << "predict(vector< double > inputVector) - Pipeline Mode Is Not in CLASSIFICATION_MODE!" << endl;
+            errorLog << "postProcessPredictedClassLabel() - Pipeline Mode Is Not in CLASSIFICATION_MODE!" << endl;
             return false;
         }
         
-        vector< double > data;
         for(UINT moduleIndex=0; moduleIndex<postProcessingModules.size(); moduleIndex++){
             
             //Select which input we should give the postprocessing module
             if( postProcessingModules[moduleIndex]->getIsPostProcessingInputModePredictedClassLabel() ){
                 //Set the input
-                data.resize(1);
-                data[0] = predictedClassLabel;
+                classLabelBuffer[0] = predictedClassLabel;
                 
                 //Verify that the input size is OK
-                if( data.size() != postProcessingModules[moduleIndex]->getNumInputDimensions() ){
-                    errorLog << "predict(vector< double > inputVector) - The size of the data vector (" << data.size() << ") does not match that of the postProcessingModule (" << postProcessingModules[moduleIndex]->getNumInputDimensions() << ") at the moduleIndex: " << moduleIndex <<endl;
+                if( classLabelBuffer.size() != postProcessingModules[moduleIndex]->getNumInputDimensions() ){
+                    errorLog << "postProcessPredictedClassLabel() - The size of the data vector (" << classLabelBuffer.size() << ") does not match that of the postProcessingModule (" << postProcessingModules[moduleIndex]->getNumInputDimensions() << ") at the moduleIndex: " << moduleIndex <<endl;
                     return false;
                 }
                 
                 //Postprocess the data
-                if( !postProcessingModules[moduleIndex]->process( data ) ){
-                    errorLog << "predict(vector< double > inputVector) - Failed to post process data. PostProcessing moduleIndex: " << moduleIndex <<endl;
+                if( !postProcessingModules[moduleIndex]->process( classLabelBuffer ) ){
+                    errorLog << "postProcessPredictedClassLabel() - Failed to post process data. PostProcessing moduleIndex: " << moduleIndex <<endl;
                     return false;
                 }
-                
-                //Select which output we should update
-                data = postProcessingModules[moduleIndex]->getProcessedData();  
             }
             
             //Select which output we should update
             if( postProcessingModules[moduleIndex]->getIsPostProcessingOutputModePredictedClassLabel() ){
                 //Get the processed predicted class label
-                data = postProcessingModules[moduleIndex]->getProcessedData(); 
+                const vector< double > &processedData = postProcessingModules[moduleIndex]->getProcessedData(); 
                 
                 //Verify that the output size is OK
-                if( data.size() != 1 ){
-                    errorLog << "predict(vector< double > inputVector) - The size of the processed data vector (" << data.size() << ") from postProcessingModule at the moduleIndex: " << moduleIndex << " is not equal to 1 even though it is in OutputModePredictedClassLabel!" << endl;
+                if( processedData.size() != 1 ){
+                    errorLog << "postProcessPredictedClassLabel() - The size of the processed data vector (" << processedData.size() << ") from postProcessingModule at the moduleIndex: " << moduleIndex << " is not equal to 1 even though it is in OutputModePredictedClassLabel!" << endl;
                     return false;
                 }
                 
                 //Update the predicted class label
-                predictedClassLabel = (UINT)data[0];
+                predictedClassLabel = (UINT)processedData[0];
             }
                   
         }
-    } 
-    
-    //Update the context module
-    predictionModuleIndex = END_OF_PIPELINE;
-    if( contextModules[ END_OF_PIPELINE ].size() ){
-        for(UINT moduleIndex=0; moduleIndex<contextModules[ END_OF_PIPELINE ].size(); moduleIndex++){
-            if( !contextModules[ END_OF_PIPELINE ][moduleIndex]->process( vector<double>(1,predictedClassLabel) ) ){
-                errorLog << "predict(vector< double > inputVector) - Context Module Failed at END_OF_PIPELINE. ModuleIndex: " << moduleIndex << endl;
-                return false;
-            }
-            if( !contextModules[ END_OF_PIPELINE ][moduleIndex]->getOK() ){
-                predictionModuleIndex = END_OF_PIPELINE;
-                return false;
-            }
-            predictedClassLabel = (UINT)contextModules[ END_OF_PIPELINE ][moduleIndex]->getProcessedData()[0];
-        }
     }
     
     return true;
 }
     
-bool GestureRecognitionPipeline::map(vector< double > inputVector){
+bool GestureRecognitionPipeline::map(const double *inputVector,const UINT inputVectorSize){
+    
+    if( inputVector == NULL ){
+        errorLog << "map(const double *inputVector,const UINT inputVectorSize) - The input vector is NULL!" << endl;
+        return false;
+    }
+    
+    //Copy the input into the input buffer, assign reuses the memory of the buffer so this only allocates the first time it is called
+    inputBuffer.assign(inputVector,inputVector+inputVectorSize);
+    
+    return map( inputBuffer );
+}
+    
+bool GestureRecognitionPipeline::map(const vector< double > &inputVector){
     
     predictedClassLabel = 0;
     
@@ -958,29 +1248,32 @@ bool GestureRecognitionPipeline::map(vector< double > inputVector){
         return false;
     }
     
+    //Each stage reads the output buffer of the stage before it, so the data is not copied between the stages
+    const vector< double > *data = &inputVector;
+    
     //Update the context module
     predictionModuleIndex = START_OF_PIPELINE;
     if( contextModules[ START_OF_PIPELINE ].size() ){
         for(UINT moduleIndex=0; moduleIndex<contextModules[ START_OF_PIPELINE ].size(); moduleIndex++){
-            if( !contextModules[ START_OF_PIPELINE ][moduleIndex]->process( inputVector ) ){
+            if( !contextModules[ START_OF_PIPELINE ][moduleIndex]->process( *data ) ){
                 errorLog << "map(vector< double > inputVector) - Context Module Failed at START_OF_PIPELINE. ModuleIndex: " << moduleIndex << endl;
                 return false;
             }
             if( !contextModules[ START_OF_PIPELINE ][moduleIndex]->getOK() ){
                 return true;
             }
-            inputVector = contextModules[ START_OF_PIPELINE ][moduleIndex]->getProcessedData();
+            data = &contextModules[ START_OF_PIPELINE ][moduleIndex]->getProcessedData();
         }
     }
     
     //Perform any pre-processing
     if( getIsPreProcessingSet() ){
         for(UINT moduleIndex=0; moduleIndex<preProcessingModules.size(); moduleIndex++){
-            if( !preProcessingModules[moduleIndex]->process( inputVector ) ){
+            if( !preProcessingModules[moduleIndex]->process( *data ) ){
                 errorLog << "map(vector< double > inputVector) - Failed to PreProcess Input Vector. PreProcessingModuleIndex: " << moduleIndex << endl;
                 return false;
             }
-            inputVector = preProcessingModules[moduleIndex]->getProcessedData();
+            data = &preProcessingModules[moduleIndex]->getProcessedData();
         }
     }
     
@@ -988,7 +1281,7 @@ bool GestureRecognitionPipeline::map(vector< double > inputVector){
     predictionModuleIndex = AFTER_PREPROCESSING;
     if( contextModules[ AFTER_PREPROCESSING ].size() ){
         for(UINT moduleIndex=0; moduleIndex<contextModules[ AFTER_PREPROCESSING ].size(); moduleIndex++){
-            if( !contextModules[ AFTER_PREPROCESSING ][moduleIndex]->process( inputVector ) ){
+            if( !contextModules[ AFTER_PREPROCESSING ][moduleIndex]->process( *data ) ){
                 errorLog << "map(vector< double > inputVector) - Context Module Failed at AFTER_PREPROCESSING. ModuleIndex: " << moduleIndex << endl;
                 return false;
             }
@@ -996,18 +1289,18 @@ bool GestureRecognitionPipeline::map(vector< double > inputVector){
                 predictionModuleIndex = AFTER_PREPROCESSING;
                 return false;
             }
-            inputVector = contextModules[ AFTER_PREPROCESSING ][moduleIndex]->getProcessedData();
+            data = &contextModules[ AFTER_PREPROCESSING ][moduleIndex]->getProcessedData();
         }
     }
     
     //Perform any feature extraction
     if( getIsFeatureExtractionSet() ){
         for(UINT moduleIndex=0; moduleIndex<featureExtractionModules.size(); moduleIndex++){
-            if( !featureExtractionModules[moduleIndex]->computeFeatures( inputVector ) ){
+            if( !featureExtractionModules[moduleIndex]->computeFeatures( *data ) ){
                 errorLog << "map(vector< double > inputVector) - Failed to compute features from data. FeatureExtractionModuleIndex: " << moduleIndex << endl;
                 return false;
             }
-            inputVector = featureExtractionModules[moduleIndex]->getFeatureVector();
+            data = &featureExtractionModules[moduleIndex]->getFeatureVector();
         }
     }
     
@@ -1015,7 +1308,7 @@ bool GestureRecognitionPipeline::map(vector< double > inputVector){
     predictionModuleIndex = AFTER_FEATURE_EXTRACTION;
     if( contextModules[ AFTER_FEATURE_EXTRACTION ].size() ){
         for(UINT moduleIndex=0; moduleIndex<contextModules[ AFTER_FEATURE_EXTRACTION ].size(); moduleIndex++){
-            if( !contextModules[ AFTER_FEATURE_EXTRACTION ][moduleIndex]->process( inputVector ) ){
+            if( !contextModules[ AFTER_FEATURE_EXTRACTION ][moduleIndex]->process( *data ) ){
                 errorLog << "map(vector< double > inputVector) - Context Module Failed at AFTER_FEATURE_EXTRACTION. ModuleIndex: " << moduleIndex << endl;
                 return false;
             }
@@ -1023,12 +1316,12 @@ bool GestureRecognitionPipeline::map(vector< double > inputVector){
                 predictionModuleIndex = AFTER_FEATURE_EXTRACTION;
                 return false;
             }
-            inputVector = contextModules[ AFTER_FEATURE_EXTRACTION ][moduleIndex]->getProcessedData();
+            data = &contextModules[ AFTER_FEATURE_EXTRACTION ][moduleIndex]->getProcessedData();
         }
     }
     
     //Perform the regression
-    if( !regressifier->predict(inputVector) ){
+    if( !regressifier->predict(*data) ){
             errorLog << "map(vector< double > inputVector) - Prediction Failed" << endl;
             return false;
     }
@@ -1077,7 +1370,7 @@ bool GestureRecognitionPipeline::map(vector< double > inputVector){
     predictionModuleIndex = END_OF_PIPELINE;
     if( contextModules[ END_OF_PIPELINE ].size() ){
         for(UINT moduleIndex=0; moduleIndex<contextModules[ END_OF_PIPELINE ].size(); moduleIndex++){
-            if( !contextModules[ END_OF_PIPELINE ][moduleIndex]->process( inputVector ) ){
+            if( !contextModules[ END_OF_PIPELINE ][moduleIndex]->process( *data ) ){
                 errorLog << "map(vector< double > inputVector) - Context Module Failed at END_OF_PIPELINE. ModuleIndex: " << moduleIndex << endl;
                 return false;
             }
@@ -1136,6 +1429,12 @@ bool GestureRecognitionPipeline::reset(){
     
 bool GestureRecognitionPipeline::savePipelineToFile(string filename){
     
+    //Use the binary format if the file has the binary extension
+    const string binaryExtension = GRT_PIPELINE_BINARY_FILE_EXTENSION;
+    if( filename.size() >= binaryExtension.size() && filename.compare(filename.size()-binaryExtension.size(),binaryExtension.size(),binaryExtension) == 0 ){
+        return savePipelineToBinaryFile( filename );
+    }
+    
     if( !initialized ){
         errorLog << "Failed to write pipeline to file as the pipeline has not been initialized yet!" << endl;
         return false;
@@ -1255,14 +1554,490 @@ bool GestureRecognitionPipeline::savePipelineToFile(string filename){
 
 bool GestureRecognitionPipeline::loadPipelineFromFile(string filename){
     
-    //TODO
+    //Binary pipeline files are loaded from a mapping of the file
+    if( getIsBinaryPipelineFile( filename ) ){
+        return loadPipelineFromBinaryFile( filename );
+    }
     
-    return false;
-}
+    fstream file;
     
-bool GestureRecognitionPipeline::preProcessData(vector< double > inputVector,bool computeFeatures){
+    file.open(filename.c_str(), iostream::in );
     
-    if( getIsPreProcessingSet() ){
+    if( !file.is_open() ){
+        errorLog << "loadPipelineFromFile(string filename) - Failed to open file with filename: " << filename << endl;
+        return false;
+    }
+    
+    //Clear any previous modules, the context modules are not saved in the file so they are kept
+    deleteAllModules();
+    pipelineMode = PIPELINE_MODE_NOT_SET;
+    
+    string word;
+    string pipelineModeName;
+    UINT numPreProcessingModules = 0;
+    UINT numFeatureExtractionModules = 0;
+    UINT numPostProcessingModules = 0;
+    bool pipelineTrained = false;
+    
+    //Read the pipeline header info
+    file >> word;
+    if( word != "GRT_PIPELINE_FILE_V1.0" ){
+        errorLog << "loadPipelineFromFile(string filename) - Failed to find the file header!" << endl;
+        return false;
+    }
+    
+    file >> word;
+    if( word != "PipelineMode:" ){
+        errorLog << "loadPipelineFromFile(string filename) - Failed to find PipelineMode!" << endl;
+        return false;
+    }
+    file >> pipelineModeName;
+    
+    file >> word;
+    if( word != "NumPreprocessingModules:" ){
+        errorLog << "loadPipelineFromFile(string filename) - Failed to find NumPreprocessingModules!" << endl;
+        return false;
+    }
+    file >> numPreProcessingModules;
+    
+    file >> word;
+    if( word != "NumFeatureExtractionModules:" ){
+        errorLog << "loadPipelineFromFile(string filename) - Failed to find NumFeatureExtractionModules!" << endl;
+        return false;
+    }
+    file >> numFeatureExtractionModules;
+    
+    file >> word;
+    if( word != "NumPostprocessingModules:" ){
+        errorLog << "loadPipelineFromFile(string filename) - Failed to find NumPostprocessingModules!" << endl;
+        return false;
+    }
+    file >> numPostProcessingModules;
+    
+    file >> word;
+    if( word != "Trained:" ){
+        errorLog << "loadPipelineFromFile(string filename) - Failed to find Trained!" << endl;
+        return false;
+    }
+    file >> pipelineTrained;
+    
+    //Create each of the modules from its datatype
+    file >> word;
+    if( word != "PreProcessingModuleDatatypes:" ){
+        errorLog << "loadPipelineFromFile(string filename) - Failed to find PreProcessingModuleDatatypes!" << endl;
+        return false;
+    }
+    for(UINT i=0; i<numPreProcessingModules; i++){
+        file >> word;
+        PreProcessing *newInstance = PreProcessing::createInstanceFromString( word );
+        if( newInstance == NULL ){
+            errorLog << "loadPipelineFromFile(string filename) - Failed to create preprocessing module of type: " << word << endl;
+            deleteAllModules();
+            return false;
+        }
+        preProcessingModules.push_back( newInstance );
+    }
+    
+    file >> word;
+    if( word != "FeatureExtractionModuleDatatypes:" ){
+        errorLog << "loadPipelineFromFile(string filename) - Failed to find FeatureExtractionModuleDatatypes!" << endl;
+        deleteAllModules();
+        return false;
+    }
+    for(UINT i=0; i<numFeatureExtractionModules; i++){
+        file >> word;
+        FeatureExtraction *newInstance = FeatureExtraction::createInstanceFromString( word );
+        if( newInstance == NULL ){
+            errorLog << "loadPipelineFromFile(string filename) - Failed to create feature extraction module of type: " << word << endl;
+            deleteAllModules();
+            return false;
+        }
+        featureExtractionModules.push_back( newInstance );
+    }
+    
+    if( pipelineModeName == "CLASSIFICATION_MODE" ){
+        file >> word;
+        if( word != "ClassificationModuleDatatype:" ){
+            errorLog << "loadPipelineFromFile(string filename) - Failed to find ClassificationModuleDatatype!" << endl;
+            deleteAllModules();
+            return false;
+        }
+        file >> word;
+        if( word != "CLASSIFIER_NOT_SET" ){
+            classifier = Classifier::createInstanceFromString( word );
+            if( classifier == NULL ){
+                errorLog << "loadPipelineFromFile(string filename) - Failed to create classifier of type: " << word << endl;
+                deleteAllModules();
+                return false;
+            }
+        }
+        pipelineMode = CLASSIFICATION_MODE;
+    }else if( pipelineModeName == "REGRESSION_MODE" ){
+        file >> word;
+        if( word != "RegressionnModuleDatatype:" ){
+            errorLog << "loadPipelineFromFile(string filename) - Failed to find RegressionnModuleDatatype!" << endl;
+            deleteAllModules();
+            return false;
+        }
+        file >> word;
+        if( word != "REGRESSIFIER_NOT_SET" ){
+            regressifier = Regressifier::createInstanceFromString( word );
+            if( regressifier == NULL ){
+                errorLog << "loadPipelineFromFile(string filename) - Failed to create regressifier of type: " << word << endl;
+                deleteAllModules();
+                return false;
+            }
+        }
+        pipelineMode = REGRESSION_MODE;
+    }
+    
+    file >> word;
+    if( word != "PostProcessingModuleDatatypes:" ){
+        errorLog << "loadPipelineFromFile(string filename) - Failed to find PostProcessingModuleDatatypes!" << endl;
+        deleteAllModules();
+        return false;
+    }
+    for(UINT i=0; i<numPostProcessingModules; i++){
+        file >> word;
+        PostProcessing *newInstance = PostProcessing::createInstanceFromString( word );
+        if( newInstance == NULL ){
+            errorLog << "loadPipelineFromFile(string filename) - Failed to create post processing module of type: " << word << endl;
+            deleteAllModules();
+            return false;
+        }
+        postProcessingModules.push_back( newInstance );
+    }
+    
+    //Load the settings of each module, in the order they were saved
+    for(UINT i=0; i<numPreProcessingModules; i++){
+        file >> word;
+        if( word != "PreProcessingModule_" + Util::intToString(i+1) || !preProcessingModules[i]->loadSettingsFromFile( file ) ){
+            errorLog << "loadPipelineFromFile(string filename) - Failed to load preprocessing module " << i << " settings from file!" << endl;
+            deleteAllModules();
+            return false;
+        }
+    }
+    
+    for(UINT i=0; i<numFeatureExtractionModules; i++){
+        file >> word;
+        if( word != "FeatureExtractionModule_" + Util::intToString(i+1) || !featureExtractionModules[i]->loadSettingsFromFile( file ) ){
+            errorLog << "loadPipelineFromFile(string filename) - Failed to load feature extraction module " << i << " settings from file!" << endl;
+            deleteAllModules();
+            return false;
+        }
+    }
+    
+    if( classifier != NULL && !classifier->loadModelFromFile( file ) ){
+        errorLog << "loadPipelineFromFile(string filename) - Failed to load the classifier model from file!" << endl;
+        deleteAllModules();
+        return false;
+    }
+    
+    if( regressifier != NULL && !regressifier->loadModelFromFile( file ) ){
+        errorLog << "loadPipelineFromFile(string filename) - Failed to load the regressifier model from file!" << endl;
+        deleteAllModules();
+        return false;
+    }
+    
+    for(UINT i=0; i<numPostProcessingModules; i++){
+        file >> word;
+        if( word != "PostProcessingModule_" + Util::intToString(i+1) || !postProcessingModules[i]->loadSettingsFromFile( file ) ){
+            errorLog << "loadPipelineFromFile(string filename) - Failed to load post processing module " << i << " settings from file!" << endl;
+            deleteAllModules();
+            return false;
+        }
+    }
+    
+    file.close();
+    
+    //The text file does not store the input dimensions of the pipeline, so they are taken from the first module
+    inputVectorDimensions = 0;
+    if( preProcessingModules.size() > 0 ) inputVectorDimensions = preProcessingModules[0]->getNumInputDimensions();
+    else if( featureExtractionModules.size() > 0 ) inputVectorDimensions = featureExtractionModules[0]->getNumInputDimensions();
+    else if( classifier != NULL ) inputVectorDimensions = classifier->getNumInputFeatures();
+    else if( regressifier != NULL ) inputVectorDimensions = regressifier->getNumInputFeatures();
+    
+    initialized = classifier != NULL || regressifier != NULL;
+    trained = initialized && pipelineTrained;
+    
+    return true;
+}
+    
+bool GestureRecognitionPipeline::savePipelineToBinaryFile(string filename){
+    
+    if( !initialized ){
+        errorLog << "savePipelineToBinaryFile(string filename) - Failed to write pipeline to file as the pipeline has not been initialized yet!" << endl;
+        return false;
+    }
+    
+    //The file is opened for reading as well, so the checksum of each section can be computed from the bytes written to the file
+    fstream file;
+    file.open(filename.c_str(), iostream::in | iostream::out | iostream::binary | iostream::trunc );
+    
+    if( !file.is_open() ){
+        errorLog << "savePipelineToBinaryFile(string filename) - Failed to open file with filename: " << filename << endl;
+        return false;
+    }
+    
+    //Write the header, the offset and checksum of the section table are filled in once all the sections have been written
+    BinaryWriter writer( file );
+    const UINT numSections = getNumPreProcessingModules() + getNumFeatureExtractionModules() + (classifier != NULL || regressifier != NULL ? 1 : 0) + getNumPostProcessingModules();
+    unsigned long long sectionTableOffset = 0;
+    unsigned long long sectionTableChecksum = 0;
+    writer.write( GRT_PIPELINE_BINARY_FILE_HEADER, GRT_PIPELINE_BINARY_FILE_HEADER_SIZE );
+    writer.write( (UINT)GRT_PIPELINE_BINARY_FILE_VERSION );
+    writer.write( (UINT)GRT_PIPELINE_BINARY_BYTE_ORDER_MARK );
+    writer.write( pipelineMode );
+    writer.write( trained );
+    writer.write( inputVectorDimensions );
+    writer.write( numSections );
+    const streampos sectionTableInfoPosition = file.tellp();
+    writer.write( &sectionTableOffset, sizeof(sectionTableOffset) );
+    writer.write( &sectionTableChecksum, sizeof(sectionTableChecksum) );
+    
+    vector< PipelineFileSection > sections;
+    bool sectionsSaved = true;
+    
+    for(UINT i=0; i<getNumPreProcessingModules() && sectionsSaved; i++){
+        beginBinaryFileSection( file, writer, sections, PRE_PROCESSING_SECTION, TEXT_SECTION, preProcessingModules[i]->getPreProcessingType() );
+        sectionsSaved = preProcessingModules[i]->saveSettingsToFile( file ) && endBinaryFileSection( file, sections.back() );
+    }
+    
+    for(UINT i=0; i<getNumFeatureExtractionModules() && sectionsSaved; i++){
+        beginBinaryFileSection( file, writer, sections, FEATURE_EXTRACTION_SECTION, TEXT_SECTION, featureExtractionModules[i]->getFeatureExtractionType() );
+        sectionsSaved = featureExtractionModules[i]->saveSettingsToFile( file ) && endBinaryFileSection( file, sections.back() );
+    }
+    
+    //Models that do not support the binary format are saved in their text format inside the section
+    if( classifier != NULL && sectionsSaved ){
+        const bool binaryModel = classifier->getSupportsBinaryModel();
+        beginBinaryFileSection( file, writer, sections, CLASSIFIER_SECTION, binaryModel ? BINARY_SECTION : TEXT_SECTION, classifier->getClassifierType() );
+        sectionsSaved = (binaryModel ? classifier->saveModelToBinaryFile( file ) : classifier->saveModelToFile( file )) && endBinaryFileSection( file, sections.back() );
+    }
+    
+    if( regressifier != NULL && sectionsSaved ){
+        const bool binaryModel = regressifier->getSupportsBinaryModel();
+        beginBinaryFileSection( file, writer, sections, REGRESSIFIER_SECTION, binaryModel ? BINARY_SECTION : TEXT_SECTION, regressifier->getRegressifierType() );
+        sectionsSaved = (binaryModel ? regressifier->saveModelToBinaryFile( file ) : regressifier->saveModelToFile( file )) && endBinaryFileSection( file, sections.back() );
+    }
+    
+    for(UINT i=0; i<getNumPostProcessingModules() && sectionsSaved; i++){
+        beginBinaryFileSection( file, writer, sections, POST_PROCESSING_SECTION, TEXT_SECTION, postProcessingModules[i]->getPostProcessingType() );
+        sectionsSaved = postProcessingModules[i]->saveSettingsToFile( file ) && endBinaryFileSection( file, sections.back() );
+    }
+    
+    if( !sectionsSaved ){
+        errorLog << "savePipelineToBinaryFile(string filename) - Failed to write the " << sections.back().moduleType << " module to file!" << endl;
+        file.close();
+        return false;
+    }
+    
+    //Write the section table at the end of the file
+    writer.align( sizeof(unsigned long long) );
+    sectionTableOffset = (unsigned long long)file.tellp();
+    for(UINT i=0; i<sections.size(); i++){
+        writer.write( sections[i].sectionType );
+        writer.write( sections[i].sectionFormat );
+        writer.write( sections[i].moduleType );
+        writer.write( &sections[i].offset, sizeof(sections[i].offset) );
+        writer.write( &sections[i].size, sizeof(sections[i].size) );
+        writer.write( &sections[i].checksum, sizeof(sections[i].checksum) );
+    }
+    const unsigned long long fileSize = (unsigned long long)file.tellp();
+    if( !writer.good() || !computeFileChecksum( file, sectionTableOffset, fileSize - sectionTableOffset, sectionTableChecksum ) ){
+        errorLog << "savePipelineToBinaryFile(string filename) - Failed to write the section table to file!" << endl;
+        file.close();
+        return false;
+    }
+    
+    file.seekp( sectionTableInfoPosition );
+    writer.write( &sectionTableOffset, sizeof(sectionTableOffset) );
+    writer.write( &sectionTableChecksum, sizeof(sectionTableChecksum) );
+    
+    if( !writer.good() ){
+        errorLog << "savePipelineToBinaryFile(string filename) - Failed to write the file header!" << endl;
+        file.close();
+        return false;
+    }
+    
+    file.close();
+    
+    return true;
+}
+    
+bool GestureRecognitionPipeline::loadPipelineFromBinaryFile(string filename){
+    
+    MemoryMappedFile mappedFile;
+    if( !mappedFile.open( filename ) ){
+        errorLog << "loadPipelineFromBinaryFile(string filename) - Failed to map file with filename: " << filename << endl;
+        return false;
+    }
+    const char *data = mappedFile.getData();
+    const unsigned long long fileSize = mappedFile.getSize();
+    
+    //Read the header
+    BinaryReader reader( data, fileSize );
+    char header[ GRT_PIPELINE_BINARY_FILE_HEADER_SIZE ];
+    UINT version = 0;
+    UINT byteOrderMark = 0;
+    UINT savedPipelineMode = PIPELINE_MODE_NOT_SET;
+    bool pipelineTrained = false;
+    UINT savedInputVectorDimensions = 0;
+    UINT numSections = 0;
+    unsigned long long sectionTableOffset = 0;
+    unsigned long long sectionTableChecksum = 0;
+    
+    if( !reader.read( header, GRT_PIPELINE_BINARY_FILE_HEADER_SIZE ) || memcmp(header,GRT_PIPELINE_BINARY_FILE_HEADER,GRT_PIPELINE_BINARY_FILE_HEADER_SIZE) != 0 ){
+        errorLog << "loadPipelineFromBinaryFile(string filename) - Failed to find the file header!" << endl;
+        return false;
+    }
+    reader.read( version );
+    reader.read( byteOrderMark );
+    reader.read( savedPipelineMode );
+    reader.read( pipelineTrained );
+    reader.read( savedInputVectorDimensions );
+    reader.read( numSections );
+    reader.read( &sectionTableOffset, sizeof(sectionTableOffset) );
+    reader.read( &sectionTableChecksum, sizeof(sectionTableChecksum) );
+    
+    if( !reader.good() || sectionTableOffset < reader.getPosition() || sectionTableOffset > fileSize ){
+        errorLog << "loadPipelineFromBinaryFile(string filename) - The file header is truncated or corrupt!" << endl;
+        return false;
+    }
+    
+    if( version != GRT_PIPELINE_BINARY_FILE_VERSION ){
+        errorLog << "loadPipelineFromBinaryFile(string filename) - Unsupported file version: " << version << endl;
+        return false;
+    }
+    
+    if( byteOrderMark != GRT_PIPELINE_BINARY_BYTE_ORDER_MARK ){
+        errorLog << "loadPipelineFromBinaryFile(string filename) - The file was written on a machine with a different byte order!" << endl;
+        return false;
+    }
+    
+    if( BinaryReader::computeChecksum( data + sectionTableOffset, fileSize - sectionTableOffset ) != sectionTableChecksum ){
+        errorLog << "loadPipelineFromBinaryFile(string filename) - The checksum of the section table does not match, the file is corrupt!" << endl;
+        return false;
+    }
+    
+    //Read the section table and check each section before any module is created
+    BinaryReader tableReader( data + sectionTableOffset, fileSize - sectionTableOffset );
+    vector< PipelineFileSection > sections( numSections <= fileSize / 36 ? numSections : 0 );
+    for(UINT i=0; i<sections.size(); i++){
+        tableReader.read( sections[i].sectionType );
+        tableReader.read( sections[i].sectionFormat );
+        tableReader.read( sections[i].moduleType );
+        tableReader.read( &sections[i].offset, sizeof(sections[i].offset) );
+        tableReader.read( &sections[i].size, sizeof(sections[i].size) );
+        tableReader.read( &sections[i].checksum, sizeof(sections[i].checksum) );
+        if( !tableReader.good() || sections[i].offset > sectionTableOffset || sections[i].size > sectionTableOffset - sections[i].offset ){
+            errorLog << "loadPipelineFromBinaryFile(string filename) - The section table is truncated or corrupt!" << endl;
+            return false;
+        }
+        if( BinaryReader::computeChecksum( data + sections[i].offset, sections[i].size ) != sections[i].checksum ){
+            errorLog << "loadPipelineFromBinaryFile(string filename) - The checksum of the " << sections[i].moduleType << " module does not match, the file is corrupt!" << endl;
+            return false;
+        }
+    }
+    if( sections.size() != numSections ){
+        errorLog << "loadPipelineFromBinaryFile(string filename) - The section table is truncated or corrupt!" << endl;
+        return false;
+    }
+    
+    //Clear any previous modules, the context modules are not saved in the file so they are kept
+    deleteAllModules();
+    pipelineMode = PIPELINE_MODE_NOT_SET;
+    
+    //The text sections are loaded by the text loader of each module, from a stream positioned at the start of the section
+    fstream textFile;
+    
+    for(UINT i=0; i<numSections; i++){
+        const PipelineFileSection &section = sections[i];
+        MLBase *model = NULL;
+        bool sectionLoaded = false;
+        
+        if( section.sectionFormat == TEXT_SECTION ){
+            if( !textFile.is_open() ) textFile.open( filename.c_str(), iostream::in | iostream::binary );
+            textFile.clear();
+            textFile.seekg( (streamoff)section.offset );
+        }
+        
+        switch( section.sectionType ){
+            case PRE_PROCESSING_SECTION:
+                preProcessingModules.push_back( PreProcessing::createInstanceFromString( section.moduleType ) );
+                sectionLoaded = preProcessingModules.back() != NULL && section.sectionFormat == TEXT_SECTION && preProcessingModules.back()->loadSettingsFromFile( textFile );
+                break;
+            case FEATURE_EXTRACTION_SECTION:
+                featureExtractionModules.push_back( FeatureExtraction::createInstanceFromString( section.moduleType ) );
+                sectionLoaded = featureExtractionModules.back() != NULL && section.sectionFormat == TEXT_SECTION && featureExtractionModules.back()->loadSettingsFromFile( textFile );
+                break;
+            case CLASSIFIER_SECTION:
+                if( classifier == NULL && regressifier == NULL ){
+                    classifier = Classifier::createInstanceFromString( section.moduleType );
+                    model = classifier;
+                }
+                break;
+            case REGRESSIFIER_SECTION:
+                if( classifier == NULL && regressifier == NULL ){
+                    regressifier = Regressifier::createInstanceFromString( section.moduleType );
+                    model = regressifier;
+                }
+                break;
+            case POST_PROCESSING_SECTION:
+                postProcessingModules.push_back( PostProcessing::createInstanceFromString( section.moduleType ) );
+                sectionLoaded = postProcessingModules.back() != NULL && section.sectionFormat == TEXT_SECTION && postProcessingModules.back()->loadSettingsFromFile( textFile );
+                break;
+            default:
+                break;
+        }
+        
+        //The large blocks in a binary model are copied straight from the mapping, without being parsed
+        if( model != NULL ){
+            if( section.sectionFormat == BINARY_SECTION ) sectionLoaded = model->loadModelFromBinaryData( data + section.offset, section.size );
+            else sectionLoaded = model->loadModelFromFile( textFile );
+        }
+        
+        if( !sectionLoaded ){
+            errorLog << "loadPipelineFromBinaryFile(string filename) - Failed to load the " << section.moduleType << " module in section " << i << "!" << endl;
+            deleteAllModules();
+            return false;
+        }
+    }
+    
+    textFile.close();
+    
+    pipelineMode = classifier != NULL ? CLASSIFICATION_MODE : (regressifier != NULL ? REGRESSION_MODE : PIPELINE_MODE_NOT_SET);
+    if( pipelineMode != savedPipelineMode ){
+        errorLog << "loadPipelineFromBinaryFile(string filename) - The modules in the file do not match the pipeline mode!" << endl;
+        deleteAllModules();
+        pipelineMode = PIPELINE_MODE_NOT_SET;
+        return false;
+    }
+    
+    inputVectorDimensions = savedInputVectorDimensions;
+    initialized = pipelineMode != PIPELINE_MODE_NOT_SET;
+    trained = initialized && pipelineTrained;
+    
+    return true;
+}
+    
+bool GestureRecognitionPipeline::getIsBinaryPipelineFile(string filename){
+    
+    fstream file;
+    file.open(filename.c_str(), iostream::in | iostream::binary );
+    if( !file.is_open() ) return false;
+    
+    char header[ GRT_PIPELINE_BINARY_FILE_HEADER_SIZE ];
+    file.read( header, GRT_PIPELINE_BINARY_FILE_HEADER_SIZE );
+    const bool isBinary = file.gcount() == GRT_PIPELINE_BINARY_FILE_HEADER_SIZE && memcmp(header,GRT_PIPELINE_BINARY_FILE_HEADER,GRT_PIPELINE_BINARY_FILE_HEADER_SIZE) == 0;
+    file.close();
+    
+    return isBinary;
+}
+    
+bool GestureRecognitionPipeline::preProcessData(vector< double > inputVector,bool computeFeatures){
+    
+    if( getIsPreProcessingSet() ){
         for(UINT moduleIndex=0; moduleIndex<preProcessingModules.size(); moduleIndex++){
             
             if( inputVector.size() != preProcessingModules[ moduleIndex ]->getNumInputDimensions() ){
@@ -1537,6 +2312,10 @@ vector< UINT > GestureRecognitionPipeline::getClassLabels(){
     return vector< UINT>(); 
 }
     
+UINT GestureRecognitionPipeline::getNumTrainingThreads(){
+    return numTrainingThreads;
+}
+    
 PreProcessing* GestureRecognitionPipeline::getPreProcessingModule(UINT moduleIndex){ 
     if( moduleIndex < preProcessingModules.size() ){
         return preProcessingModules[ moduleIndex ];
@@ -1719,6 +2498,11 @@ bool GestureRecognitionPipeline::addPostProcessingModule(const PostProcessing &p
     return true;
 }
     
+bool GestureRecognitionPipeline::setNumTrainingThreads(UINT numTrainingThreads){
+    this->numTrainingThreads = numTrainingThreads;
+    return true;
+}
+    
 bool GestureRecognitionPipeline::removeAllPreProcessingModules(){
     deleteAllPreProcessingModules();
     return true;
@@ -1803,6 +2587,53 @@ bool GestureRecognitionPipeline::removeAllContextModules(){
 ///////////////////////////////////////////          PROTECTED FUNCTIONS              ///////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////// 
     
+void GestureRecognitionPipeline::deleteAllModules(){
+    deleteAllPreProcessingModules();
+    deleteAllFeatureExtractionModules();
+    deleteClassifier();
+    deleteRegressifier();
+    deleteAllPostProcessingModules();
+}
+    
+void GestureRecognitionPipeline::beginBinaryFileSection(fstream &file,BinaryWriter &writer,vector< PipelineFileSection > &sections,UINT sectionType,UINT sectionFormat,string moduleType){
+    
+    //Each section starts on a cache line boundary, so the arrays in a binary model are aligned when the file is mapped
+    writer.align( GRT_PIPELINE_BINARY_SECTION_ALIGNMENT );
+    
+    PipelineFileSection section;
+    section.sectionType = sectionType;
+    section.sectionFormat = sectionFormat;
+    section.moduleType = moduleType;
+    section.offset = (unsigned long long)file.tellp();
+    section.size = 0;
+    section.checksum = 0;
+    sections.push_back( section );
+}
+    
+bool GestureRecognitionPipeline::endBinaryFileSection(fstream &file,PipelineFileSection &section){
+    section.size = (unsigned long long)file.tellp() - section.offset;
+    return computeFileChecksum( file, section.offset, section.size, section.checksum );
+}
+    
+bool GestureRecognitionPipeline::computeFileChecksum(fstream &file,unsigned long long offset,unsigned long long size,unsigned long long &checksum){
+    
+    //Read the bytes back from the file, then move the write position back to the end of them
+    const unsigned long long endPosition = offset + size;
+    char buffer[ 4096 ];
+    checksum = GRT_BINARY_CHECKSUM_SEED;
+    file.flush();
+    file.seekg( (streamoff)offset );
+    while( size > 0 && file.good() ){
+        const unsigned long long n = size < sizeof(buffer) ? size : sizeof(buffer);
+        file.read( buffer, (streamsize)n );
+        checksum = BinaryReader::updateChecksum( checksum, buffer, n );
+        size -= n;
+    }
+    file.seekp( (streamoff)endPosition );
+    
+    return file.good();
+}
+    
 void GestureRecognitionPipeline::deleteAllPreProcessingModules(){
     if( preProcessingModules.size() != 0 ){
         for(UINT i=0; i<preProcessingModules.size(); i++){
@@ -1945,6 +2776,122 @@ bool GestureRecognitionPipeline::updateTestMetrics(const UINT classLabel,const U
     return true;
 }
 
+bool GestureRecognitionPipeline::testSamples(LabelledClassificationData &testData,const vector< UINT > &testIndexs,vector< double > &precisionCounter,vector< double > &recallCounter,double &rejectionPrecisionCounter,double &rejectionRecallCounter,vector< double > &confusionMatrixCounter){
+    
+    testAccuracy = 0;
+    testRMSError = 0;
+    testFMeasure.clear();
+    testPrecision.clear();
+    testRecall.clear();
+    testRejectionPrecision = 0;
+    testRejectionRecall = 0;
+    testConfusionMatrix.clear();
+    
+    //Make sure the classification model has been trained
+    if( !trained ){
+        errorLog << "test(LabelledClassificationData &testData) - Classifier is not trained" << endl;
+        return false;
+    }
+    
+    //Make sure the dimensionality of the test data matches the input vector's dimensions
+    if( testData.getNumDimensions() != inputVectorDimensions ){
+        errorLog << "test(LabelledClassificationData &testData) - The dimensionality of the test data (" << testData.getNumDimensions() << ") does not match that of the input vector dimensions of the pipeline (" << inputVectorDimensions << ")" << endl;
+        return false;
+    }
+    
+    if( !getIsClassifierSet() ){
+        errorLog << "test(LabelledClassificationData &testData) - The classifier has not been set" << endl;
+        return false;
+    }
+
+	//Validate that the class labels of the test samples match the class labels in the model
+	vector< UINT > testClassLabels;
+	for(UINT i=0; i<testIndexs.size(); i++){
+		const UINT classLabel = testData[ testIndexs[i] ].getClassLabel();
+		if( std::find(testClassLabels.begin(),testClassLabels.end(),classLabel) == testClassLabels.end() ){
+			testClassLabels.push_back( classLabel );
+		}
+	}
+
+	bool classLabelValidationPassed = true;
+	for(UINT i=0; i<testClassLabels.size(); i++){
+		bool labelFound = false;
+		for(UINT k=0; k<classifier->getNumClasses(); k++){
+			if( testClassLabels[i] == classifier->getClassLabels()[k] ){
+				labelFound = true;
+				break;
+			}
+		}
+
+		if( !labelFound ){
+			classLabelValidationPassed = false;
+			errorLog << "test(LabelledClassificationData &testData) - The test dataset contains a class label (" << testClassLabels[i] << ") that is not in the model!" << endl;
+		}
+	}
+
+	if( !classLabelValidationPassed ){
+        errorLog << "test(LabelledClassificationData &testData) -  Model Class Labels: ";
+        for(UINT k=0; k<classifier->getNumClasses(); k++){
+			errorLog << classifier->getClassLabels()[k] << "\t";
+		}
+        errorLog << endl;
+        return false;
+    }
+
+    unsigned int confusionMatrixSize = classifier->getNullRejectionEnabled() ? classifier->getNumClasses()+1 : classifier->getNumClasses();
+    rejectionPrecisionCounter = 0;
+    rejectionRecallCounter = 0;
+    precisionCounter.assign(classifier->getNumClasses(), 0);
+    recallCounter.assign(classifier->getNumClasses(), 0);
+    confusionMatrixCounter.assign(confusionMatrixSize,0);
+    
+    //Resize the test matrix
+    testConfusionMatrix.resize(confusionMatrixSize, confusionMatrixSize);
+    testConfusionMatrix.setAllValues(0);
+    
+    //Resize the precision and recall vectors
+    testPrecision.clear();
+    testRecall.clear();
+    testFMeasure.clear();
+    testPrecision.resize(getNumClassesInModel(), 0);
+    testRecall.resize(getNumClassesInModel(), 0);
+    testFMeasure.resize(getNumClassesInModel(), 0);
+
+    //Gather the test samples into one contiguous block and pass them through the pipeline in one batch
+    const UINT M = (UINT)testIndexs.size();
+    Matrix< double > testSampleData( M, inputVectorDimensions );
+    vector< UINT > predictedClassLabels;
+    Matrix< double > likelihoods;
+    Matrix< double > distances;
+    for(UINT i=0; i<M; i++){
+        LabelledClassificationSample &sample = testData[ testIndexs[i] ];
+        double *row = testSampleData[i];
+        for(UINT j=0; j<inputVectorDimensions; j++){
+            row[j] = sample[j];
+        }
+    }
+    
+    if( !predictBatch(testSampleData,predictedClassLabels,likelihoods,distances) ){
+        errorLog << "test(LabelledClassificationData &testData) - Failed to predict the test samples!" << endl;
+        return false;
+    }
+    
+    //Run the test
+    for(UINT i=0; i<M; i++){
+        UINT classLabel = testData[ testIndexs[i] ].getClassLabel();
+        
+        //Update the test metrics
+        UINT predictedClassLabel = predictedClassLabels[i];
+        
+        if( !updateTestMetrics(classLabel,predictedClassLabel,precisionCounter,recallCounter,rejectionPrecisionCounter,rejectionRecallCounter, confusionMatrixCounter) ){
+            errorLog << "test(LabelledClassificationData &testData) - Failed to update test metrics at test sample index: " << i << endl;
+            return false;
+        }
+    }
+    
+    return true;
+}
+    
 bool GestureRecognitionPipeline::computeTestMetrics(vector< double > &precisionCounter,vector< double > &recallCounter,double &rejectionPrecisionCounter,double &rejectionRecallCounter,vector< double > &confusionMatrixCounter,const UINT numTestSamples){
         
     //Compute the test metrics
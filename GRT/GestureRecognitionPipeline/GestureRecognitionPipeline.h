@@ -32,12 +32,36 @@ namespace GRT{
     
 #define INSERT_AT_END_INDEX 99999
 
+#define GRT_PIPELINE_BINARY_FILE_HEADER "GRT_PIPELINE_B\n"              //The first 16 bytes of a binary pipeline file, including the terminating 0
+#define GRT_PIPELINE_BINARY_FILE_HEADER_SIZE 16
+#define GRT_PIPELINE_BINARY_FILE_VERSION 1
+#define GRT_PIPELINE_BINARY_BYTE_ORDER_MARK 0x01020304
+#define GRT_PIPELINE_BINARY_SECTION_ALIGNMENT 64
+#define GRT_PIPELINE_BINARY_FILE_EXTENSION ".grtp"                      //savePipelineToFile uses the binary format for this extension
+
+//The location of one module in a binary pipeline file, the section table at the end of the file holds one of these for each module
+class PipelineFileSection{
+public:
+    UINT sectionType;                   //The type of module in the section (one of the PipelineSectionTypes)
+    UINT sectionFormat;                 //Whether the module was saved with its text or binary format (one of the PipelineSectionFormats)
+    string moduleType;                  //The type of the module, this is used to create the module when the file is loaded
+    unsigned long long offset;          //The start of the section from the start of the file, this is a multiple of 64
+    unsigned long long size;            //The size of the section in bytes
+    unsigned long long checksum;        //The FNV-1a checksum of the section
+};
+
 class GestureRecognitionPipeline
 {
 public:
 	GestureRecognitionPipeline(void);
+	GestureRecognitionPipeline(const GestureRecognitionPipeline &rhs);
 	~GestureRecognitionPipeline(void);
     
+    //Deep copies the modules of the rhs pipeline into this pipeline, context modules are not copied as they can not be created from their type.
+    //Classifiers that keep their trained model in a SharedModel (KNN and DTW) share it with the copy rather than copying it, so a copy of a
+    //trained pipeline can be used as a lightweight session for one input stream, with its own buffers, likelihoods and post processing state
+    GestureRecognitionPipeline& operator=(const GestureRecognitionPipeline &rhs);
+    
     //Main training functions
     bool train(LabelledClassificationData &trainingData);
     bool train(LabelledClassificationData &trainingData, UINT kFoldValue, bool useStratifiedSampling = false );
@@ -51,14 +75,34 @@ public:
     bool test(LabelledRegressionData &testData);
     
     //Main prediction functions
-    bool predict(vector< double > inputVector);
-    bool map(vector< double > inputVector);
+    bool predict(const vector< double > &inputVector);
+    bool map(const vector< double > &inputVector);
+    
+    //Prediction functions for data that is not held in a vector, such as a frame from a sensor driver. The input is copied once
+    //into a buffer owned by the pipeline, after that each module reads the output buffer of the module before it, so once every
+    //buffer has been sized by the first call no memory is allocated for each new sample
+    bool predict(const double *inputVector,const UINT inputVectorSize);
+    bool map(const double *inputVector,const UINT inputVectorSize);
+    
+    //Batch prediction function, this predicts the class of each row of the inputData and returns the predicted class label, class likelihoods and
+    //class distances of each row. The pre-processing, feature extraction and post-processing modules are stateful so the rows are run through them
+    //in order, but the classifier is given all the rows in one call so it can share work between them. If any context modules are set then each
+    //row is run through predict(...) instead, as a context module can stop a prediction part way through the pipeline
+    bool predictBatch(const Matrix<double> &inputData,vector< UINT > &predictedClassLabels,Matrix<double> &likelihoods,Matrix<double> &distances);
     
     //The main util functions
     bool reset();
     bool savePipelineToFile(string filename);
     bool loadPipelineFromFile(string filename);
     
+    //Saves the pipeline to a versioned binary file with one checksummed section per module, followed by a table of the sections.
+    //Classifiers and regressifiers that support binary models (such as the KNN and DTW) save their training data and templates as
+    //blocks of values that are copied straight from a memory mapping of the file when it is loaded, the other modules are saved in
+    //their text format inside their section. loadPipelineFromFile detects binary files from their header
+    bool savePipelineToBinaryFile(string filename);
+    bool loadPipelineFromBinaryFile(string filename);
+    static bool getIsBinaryPipelineFile(string filename);
+    
     //Some useful util functions for training and testing the pre-processing and feature extraction modules
     bool preProcessData(vector< double > inputVector,bool computeFeatures = true);
     
@@ -105,6 +149,7 @@ public:
     vector< double > getFeatureExtractionData();
     vector< double > getFeatureExtractionData(UINT moduleIndex);
     vector< UINT > getClassLabels();
+    UINT getNumTrainingThreads();
     
     template <class T> T* getPreProcessingModule(UINT moduleIndex){ 
         if( moduleIndex < preProcessingModules.size() ){
@@ -153,6 +198,9 @@ public:
     bool setRegressifier(const Regressifier &regressifier);
     bool addPostProcessingModule(const PostProcessing &postProcessingModule,UINT insertIndex = INSERT_AT_END_INDEX);
     
+    //Sets the number of threads used to train and test the folds of the k-fold cross validation, if this is 0 then one thread is used per CPU core
+    bool setNumTrainingThreads(UINT numTrainingThreads);
+    
     template <class T> bool addContextModule(T contextModule,UINT contextLevel,UINT insertIndex = INSERT_AT_END_INDEX){
         
         if( contextLevel >= contextModules.size() ){
@@ -224,7 +272,13 @@ protected:
     void deleteRegressifier();
     void deleteAllPostProcessingModules();
     void deleteAllContextModules();
+    void deleteAllModules();
+    void beginBinaryFileSection(fstream &file,BinaryWriter &writer,vector< PipelineFileSection > &sections,UINT sectionType,UINT sectionFormat,string moduleType);
+    bool endBinaryFileSection(fstream &file,PipelineFileSection &section);
+    bool computeFileChecksum(fstream &file,unsigned long long offset,unsigned long long size,unsigned long long &checksum);
     bool updateTestMetrics(const UINT classLabel,const UINT predictedClassLabel,vector< double > &precisionCounter,vector< double > &recallCounter,double &rejectionPrecisionCounter,double &rejectionRecallCounter,vector< double > &confusionMatrixCounter);
+    bool postProcessPredictedClassLabel();
+    bool testSamples(LabelledClassificationData &testData,const vector< UINT > &testIndexs,vector< double > &precisionCounter,vector< double > &recallCounter,double &rejectionPrecisionCounter,double &rejectionRecallCounter,vector< double > &confusionMatrixCounter);
     bool computeTestMetrics(vector< double > &precisionCounter,vector< double > &recallCounter,double &rejectionPrecisionCounter,double &rejectionRecallCounter,vector< double > &confusionMatrixCounter,const UINT numTestSamples);
     inline double SQR(double x){ return x*x; }
     
@@ -235,12 +289,15 @@ protected:
     UINT predictedClassLabel;
     UINT pipelineMode;
     UINT predictionModuleIndex;
+    UINT numTrainingThreads;
     double testAccuracy;
     double testRMSError;
     vector< double > testFMeasure;
     vector< double > testPrecision;
     vector< double > testRecall;
     vector< double > regressionData;
+    vector< double > inputBuffer;
+    vector< double > classLabelBuffer;
     double testRejectionPrecision;
     double testRejectionRecall;
     Matrix< double > testConfusionMatrix;
@@ -257,6 +314,10 @@ protected:
     WarningLog warningLog;
     
     enum PipelineModes{PIPELINE_MODE_NOT_SET=0,CLASSIFICATION_MODE,REGRESSION_MODE};
+    enum PipelineSectionTypes{PRE_PROCESSING_SECTION=0,FEATURE_EXTRACTION_SECTION,CLASSIFIER_SECTION,REGRESSIFIER_SECTION,POST_PROCESSING_SECTION};
+    enum PipelineSectionFormats{TEXT_SECTION=0,BINARY_SECTION};
+    
+    friend class PipelineKFoldJob;
     
 public:
     enum ContextLevels{START_OF_PIPELINE=0,AFTER_PREPROCESSING,AFTER_FEATURE_EXTRACTION,AFTER_CLASSIFIER,END_OF_PIPELINE,NUM_CONTEXT_LEVELS};
@@ -90,7 +90,7 @@ public:
      @param vector<double> inputVector: the new input vector for prediction
      @return returns true if the prediction was completed succesfully, false otherwise (the base class always returns false)
      */
-    virtual bool predict(vector<double> inputVector){ return false; }
+    virtual bool predict(const vector< double > &inputVector){ return false; }
     
     /**
      This is the main mapping interface for all the GRT machine learning algorithms. This should be overwritten by the derived class.
@@ -98,7 +98,7 @@ public:
      @param vector<double> inputVector: the new input vector for mapping/regression
      @return returns true if the mapping was completed succesfully, false otherwise (the base class always returns false)
      */
-    virtual bool map(vector<double> inputVector){ return false; }
+    virtual bool map(const vector< double > &inputVector){ return false; }
     
     /**
      This is the main reset interface for all the GRT machine learning algorithms. This should be overwritten by the derived class.
@@ -143,6 +143,34 @@ public:
      */
     virtual bool loadModelFromFile(fstream &file){ return false; }
     
+    /**
+     This saves the trained model to a binary file, using a BinaryWriter.
+     This function should be overwritten by any derived class with a large model, so the model can be loaded without being parsed.
+     
+     @param fstream &file: a reference to the binary file the model will be saved to
+     @return returns true if the model was saved successfully, false otherwise
+     */
+    virtual bool saveModelToBinaryFile(fstream &file){ return false; }
+    
+    /**
+     This loads a trained model saved by saveModelToBinaryFile, using a BinaryReader.  The data is normally a section of a memory mapped
+     file, so the large arrays in the model can be copied straight from the mapping.
+     This function should be overwritten by the derived class if it overwrites saveModelToBinaryFile.
+     
+     @param const char *data: a pointer to the start of the model, this should be aligned to 8 bytes
+     @param unsigned long long size: the size of the model in bytes
+     @return returns true if the model was loaded successfully, false otherwise
+     */
+    virtual bool loadModelFromBinaryData(const char *data,unsigned long long size){ return false; }
+    
+    /**
+     Gets if the derived class can save its model with saveModelToBinaryFile.  This should be overwritten by the derived class if it
+     overwrites saveModelToBinaryFile.
+     
+     @return returns true if the derived class supports binary models, false otherwise
+     */
+    virtual bool getSupportsBinaryModel() const{ return false; }
+    
     /**
      Computes the square of the input value.
      
@@ -111,7 +111,7 @@ bool PostProcessing::getIsPostProcessingOutputModeClassLikelihoods() const{
     return postProcessingOutputMode==OUTPUT_MODE_CLASS_LIKELIHOODS; 
 }
     
-vector< double > PostProcessing::getProcessedData() const{ 
+const vector< double >& PostProcessing::getProcessedData() const{ 
     return processedData; 
 }
 
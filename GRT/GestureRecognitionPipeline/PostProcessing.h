@@ -36,7 +36,7 @@ public:
     
 	virtual bool copyBaseVariables(PostProcessing *postProcessingA,const PostProcessing *postProcessingB);
 
-    virtual bool process(vector< double > inputVector){ return false; }
+    virtual bool process(const vector< double > &inputVector){ return false; }
     
     virtual bool reset(){ return false; }
     
@@ -56,7 +56,7 @@ public:
 	bool getIsPostProcessingInputModeClassLikelihoods() const;
 	bool getIsPostProcessingOutputModePredictedClassLabel() const;
 	bool getIsPostProcessingOutputModeClassLikelihoods() const;
-	vector< double > getProcessedData() const;
+	const vector< double >& getProcessedData() const;
     
     //Setters
     
@@ -84,7 +84,7 @@ bool PreProcessing::getInitialized() const{
     return initialized; 
 }
     
-vector< double > PreProcessing::getProcessedData() const{ 
+const vector< double >& PreProcessing::getProcessedData() const{ 
     return processedData; 
 }
 
@@ -37,7 +37,7 @@ public:
 	virtual bool copyBaseVariables(PreProcessing *preProcessingA,const PreProcessing *preProcessingB);
 
     //Training methods
-    virtual bool process(vector< double > inputVector){ return false; }
+    virtual bool process(const vector< double > &inputVector){ return false; }
     virtual bool reset(){ return false; }
     
     virtual bool saveSettingsToFile(string filename){ return false; }
@@ -50,7 +50,7 @@ public:
 	UINT getNumInputDimensions() const;
 	UINT getNumOutputDimensions() const;
 	bool getInitialized() const;
-	vector< double > getProcessedData() const;
+	const vector< double >& getProcessedData() const;
     
     //Setters
 
@@ -66,6 +66,34 @@ bool Regressifier::copyBaseVariables(Regressifier *regressifierA,const Regressif
     return true;
 }
     
+bool Regressifier::predictBatch(const Matrix<double> &inputData,Matrix<double> &outputData){
+    
+    if( !trained ){
+        errorLog << "predictBatch(const Matrix<double> &inputData,Matrix<double> &outputData) - The regressifier has not been trained!" << endl;
+        return false;
+    }
+    
+    const UINT M = inputData.getNumRows();
+    const UINT N = inputData.getNumCols();
+    outputData.resize( M, numOutputDimensions );
+    
+    vector< double > inputVector( N );
+    for(UINT i=0; i<M; i++){
+        std::copy(inputData[i],inputData[i]+N,inputVector.begin());
+        if( !predict( inputVector ) ){
+            errorLog << "predictBatch(const Matrix<double> &inputData,Matrix<double> &outputData) - Failed to predict the row at index: " << i << endl;
+            return false;
+        }
+        if( regressionData.size() != numOutputDimensions ){
+            errorLog << "predictBatch(const Matrix<double> &inputData,Matrix<double> &outputData) - The size of the regression data (" << regressionData.size() << ") does not match the number of output dimensions (" << numOutputDimensions << ")" << endl;
+            return false;
+        }
+        std::copy(regressionData.begin(),regressionData.end(),outputData[i]);
+    }
+    
+    return true;
+}
+    
 Regressifier* Regressifier::createNewInstance() const{
     return createInstanceFromString( regressifierType );
 }
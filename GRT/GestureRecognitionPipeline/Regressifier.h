@@ -43,6 +43,18 @@ public:
     //Training methods
     virtual bool train(LabelledRegressionData &trainingData){ return false; }
     
+    //Prediction methods
+    /**
+     Maps each row of the inputData to the regression output, the outputData will have one row per input row and one column per output
+     dimension.  The base function simply calls predict(...) for each row, regressifiers that can share work between the rows should
+     overwrite this function.
+     
+     @param const Matrix<double> &inputData: the input vectors, with one vector per row
+     @param Matrix<double> &outputData: returns the regression output of each row
+     @return returns true if every row was mapped, false otherwise
+     */
+    virtual bool predictBatch(const Matrix<double> &inputData,Matrix<double> &outputData);
+    
     //Getters
     string getRegressifierType() const;
 
@@ -80,7 +80,7 @@ bool ClassLabelChangeFilter::clone(const PostProcessing *postProcessing){
     return false;
 }
     
-bool ClassLabelChangeFilter::process(vector< double > inputVector){
+bool ClassLabelChangeFilter::process(const vector< double > &inputVector){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
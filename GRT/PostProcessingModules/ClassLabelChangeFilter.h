@@ -83,7 +83,7 @@ public:
      @param vector< double > inputVector: the inputVector that should be processed.  This should be a 1-dimensional vector containing a predicted class label
 	 @return true if the data was processed, false otherwise
      */
-    virtual bool process(vector< double > inputVector);
+    virtual bool process(const vector< double > &inputVector);
     
     /**
      Sets the PostProcessing reset function, overwriting the base PostProcessing function.
@@ -87,7 +87,7 @@ bool ClassLabelFilter::clone(const PostProcessing *postProcessing){
     return false;
 }
 
-bool ClassLabelFilter::process(vector< double > inputVector){
+bool ClassLabelFilter::process(const vector< double > &inputVector){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
@@ -159,7 +159,8 @@ UINT ClassLabelFilter::filter(UINT predictedClassLabel){
     buffer.push_back( predictedClassLabel );
     
     //Count the class values in the buffer, automatically start with the first value in the buffer
-    vector< ClassTracker > classTracker( 1, ClassTracker( buffer[0], 1 ) );
+    classTracker.clear();
+    classTracker.push_back( ClassTracker( buffer[0], 1 ) );
     
     UINT maxCount = classTracker[0].counter;
     UINT maxClass = classTracker[0].classLabel;
@@ -191,8 +192,6 @@ UINT ClassLabelFilter::filter(UINT predictedClassLabel){
         }
     }
     
-    printf("minimumCount: %i maxCount: %i maxClass: %i\n",minimumCount,maxCount,maxClass);
-    
     if( maxCount >= minimumCount ){
         filteredClassLabel = maxClass;
     }else filteredClassLabel = 0;
@@ -80,7 +80,7 @@ public:
      @param vector< double > inputVector: the inputVector that should be processed.  This should be a 1-dimensional vector containing a predicted class label
 	 @return true if the data was processed, false otherwise
      */
-    virtual bool process(vector< double > inputVector);
+    virtual bool process(const vector< double > &inputVector);
     
     /**
      Sets the PostProcessing reset function, overwriting the base PostProcessing function.
@@ -177,6 +177,7 @@ protected:
     UINT minimumCount;                  ///< The minimum count sets the minimum number of class label values that must be present in the class labels buffer for that class label value to be output by the Class Label Filter
     UINT bufferSize;                    ///< The size of the Class Label Filter buffer
     CircularBuffer< UINT > buffer;      ///< The class label filter buffer
+    vector< ClassTracker > classTracker;///< The count of each class label in the buffer, this is kept between calls so filter does not allocate memory
     
     static RegisterPostProcessingModule< ClassLabelFilter > registerModule;
 };
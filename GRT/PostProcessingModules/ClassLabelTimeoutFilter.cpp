@@ -86,7 +86,7 @@ bool ClassLabelTimeoutFilter::clone(const PostProcessing *postProcessing){
     return false;
 }
     
-bool ClassLabelTimeoutFilter::process(vector< double > inputVector){
+bool ClassLabelTimeoutFilter::process(const vector< double > &inputVector){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
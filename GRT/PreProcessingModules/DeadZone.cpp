@@ -52,13 +52,13 @@ DeadZone& DeadZone::operator=(const DeadZone &rhs){
 	return *this;
 }
 
-bool DeadZone::clone(PreProcessing *preProcessing){
+bool DeadZone::clone(const PreProcessing *preProcessing){
     
     if( preProcessing == NULL ) return false;
     
     if( this->getPreProcessingType() == preProcessing->getPreProcessingType() ){
         
-        DeadZone *ptr = (DeadZone*)preProcessing;
+        const DeadZone *ptr = (const DeadZone*)preProcessing;
         //Clone the DeadZone values 
         this->lowerLimit = ptr->lowerLimit;
         this->upperLimit = ptr->upperLimit;
@@ -67,12 +67,12 @@ bool DeadZone::clone(PreProcessing *preProcessing){
         return copyBaseVariables(this,preProcessing);
     }
     
-    errorLog << "clone(PreProcessing *preProcessing) -  PreProcessing Types Do Not Match!" << endl;
+    errorLog << "clone(const PreProcessing *preProcessing) -  PreProcessing Types Do Not Match!" << endl;
     
     return false;
 }
     
-bool DeadZone::process(vector< double > inputVector){
+bool DeadZone::process(const vector< double > &inputVector){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
@@ -86,10 +86,16 @@ bool DeadZone::process(vector< double > inputVector){
     }
 #endif
     
-    processedData = filter( inputVector );
+    for(UINT n=0; n<numInputDimensions; n++){
+        if( inputVector[n] > lowerLimit && inputVector[n] < upperLimit ){
+            processedData[n] = 0;
+        }else{
+            if( inputVector[n] >= upperLimit ) processedData[n] = inputVector[n] - upperLimit;
+            else processedData[n] = inputVector[n] - lowerLimit;
+        }
+    }
     
-    if( processedData.size() == numOutputDimensions ) return true;
-    return false;
+    return true;
 }
 
 bool DeadZone::reset(){
@@ -234,7 +240,7 @@ double DeadZone::filter(double x){
 	return y[0];
 }
     
-vector< double > DeadZone::filter(vector< double > x){
+vector< double > DeadZone::filter(const vector< double > &x){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
@@ -248,14 +254,7 @@ vector< double > DeadZone::filter(vector< double > x){
     }
 #endif
     
-    for(UINT n=0; n<numInputDimensions; n++){
-        if( x[n] > lowerLimit && x[n] < upperLimit ){
-            processedData[n] = 0;
-        }else{
-            if( x[n] >= upperLimit ) processedData[n] = x[n] - upperLimit;
-            else processedData[n] = x[n] - lowerLimit;
-        }
-    }
+    if( !process( x ) ) return vector< double >();
     return processedData;
 }
 
@@ -26,7 +26,7 @@ namespace GRT{
 RegisterPreProcessingModule< Derivative > Derivative::registerModule("Derivative");
     
 Derivative::Derivative(UINT derivativeOrder,double delta,UINT numDimensions,bool filterData,UINT filterSize){
-    preProcessingType = "DERIVATIVE";
+    preProcessingType = "Derivative";
     debugLog.setProceedingText("[DEBUG Derivative]");
     errorLog.setProceedingText("[ERROR Derivative]");
     warningLog.setProceedingText("[WARNING Derivative]");
@@ -64,13 +64,13 @@ Derivative& Derivative::operator=(const Derivative &rhs){
     return *this;
 }
     
-bool Derivative::clone(PreProcessing *preProcessing){
+bool Derivative::clone(const PreProcessing *preProcessing){
     
     if( preProcessing == NULL ) return false;
     
     if( this->getPreProcessingType() == preProcessing->getPreProcessingType() ){
         
-        Derivative *ptr = (Derivative*)preProcessing;
+        const Derivative *ptr = (const Derivative*)preProcessing;
         //Clone the Derivative values 
         this->derivativeOrder = ptr->derivativeOrder;
         this->filterSize = ptr->filterSize;
@@ -84,12 +84,12 @@ bool Derivative::clone(PreProcessing *preProcessing){
         return copyBaseVariables(this, preProcessing);
     }
     
-    errorLog << "clone(PreProcessing *preProcessing) -  PreProcessing Types Do Not Match!" << endl;
+    errorLog << "clone(const PreProcessing *preProcessing) -  PreProcessing Types Do Not Match!" << endl;
     
     return false;
 }
     
-bool Derivative::process(vector< double > inputVector){
+bool Derivative::process(const vector< double > &inputVector){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
@@ -103,10 +103,28 @@ bool Derivative::process(vector< double > inputVector){
     }
 #endif
     
-    processedData = computeDerivative( inputVector );
+    //Smooth the input if needed, the filter keeps its own output buffer so this does not copy the input
+    const vector< double > *x = &inputVector;
+    if( filterData ){
+        if( !filter.process( inputVector ) ) return false;
+        x = &filter.getProcessedData();
+    }
     
-    if( processedData.size() == numOutputDimensions ) return true;
-    return false;
+    for(UINT n=0; n<numInputDimensions; n++){
+        processedData[n] = ((*x)[n]-yy[n])/delta;
+        yy[n] = (*x)[n];
+    }
+    
+    if( derivativeOrder == SECOND_DERIVATIVE ){
+        double tmp = 0;
+        for(UINT n=0; n<numInputDimensions; n++){
+            tmp = processedData[n];
+            processedData[n] = (processedData[n]-yyy[n])/delta;
+            yyy[n] = tmp;
+        }
+    }
+    
+    return true;
 }
 
 bool Derivative::reset(){
@@ -297,7 +315,7 @@ double Derivative::computeDerivative(double x){
 	return y[0];
 }
     
-vector< double > Derivative::computeDerivative(vector< double > x){
+vector< double > Derivative::computeDerivative(const vector< double > &x){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
@@ -311,24 +329,7 @@ vector< double > Derivative::computeDerivative(vector< double > x){
     }
 #endif
     
-    if( filterData ){
-        x = filter.filter( x );
-    }
-    
-    for(UINT n=0; n<numInputDimensions; n++){
-        processedData[n] = (x[n]-yy[n])/delta;
-        yy[n] = x[n];
-    }
-    
-    if( derivativeOrder == SECOND_DERIVATIVE ){
-        double tmp = 0;
-        for(UINT n=0; n<numInputDimensions; n++){
-            tmp = processedData[n];
-            processedData[n] = (processedData[n]-yyy[n])/delta;
-            yyy[n] = tmp;
-        }
-    }
-    
+    if( !process( x ) ) return vector< double >();
     return processedData;
 }
     
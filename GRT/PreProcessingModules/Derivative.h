@@ -72,10 +72,10 @@ public:
      This function is used to clone the values from the input pointer to this instance of the PreProcessing module.
      This function is called by the GestureRecognitionPipeline when the user adds a new PreProcessing module to the pipeline.
      
-	 @param PreProcessing *preProcessing: a pointer to another instance of a Derivative, the values of that instance will be cloned to this instance
+	 @param const PreProcessing *preProcessing: a pointer to another instance of a Derivative, the values of that instance will be cloned to this instance
 	 @return true if the clone was successful, false otherwise
      */
-    virtual bool clone(PreProcessing *preProcessing);
+    virtual bool clone(const PreProcessing *preProcessing);
     
     /**
      Sets the PreProcessing process function, overwriting the base PreProcessing function.
@@ -85,7 +85,7 @@ public:
 	 @param vector< double > inputVector: the inputVector that should be processed.  Must have the same dimensionality as the PreProcessing module
 	 @return true if the data was processed, false otherwise
      */
-    virtual bool process(vector< double > inputVector);
+    virtual bool process(const vector< double > &inputVector);
     
     /**
      Sets the PreProcessing reset function, overwriting the base PreProcessing function.
@@ -159,7 +159,7 @@ public:
      @param vector< double > x: the values to compute the derivative of, the dimensionality of the input should match the number of inputs for the derivative
 	 @return the derivatives of the input.  An empty vector will be returned if the values were not filtered
      */
-    vector< double > computeDerivative(vector< double > x);
+    vector< double > computeDerivative(const vector< double > &x);
     
     /**
      Sets the derivative order.  This should either be FIRST_DERIVATIVE (1) or SECOND_DERIVATIVE (2).
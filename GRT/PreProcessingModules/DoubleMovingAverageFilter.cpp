@@ -35,7 +35,7 @@ namespace GRT{
 RegisterPreProcessingModule< DoubleMovingAverageFilter > DoubleMovingAverageFilter::registerModule("DoubleMovingAverageFilter");
 
 DoubleMovingAverageFilter::DoubleMovingAverageFilter(UINT filterSize,UINT numDimensions){
-    preProcessingType = "DOUBLE_MOVING_AVERAGE_FILTER";
+    preProcessingType = "DoubleMovingAverageFilter";
     debugLog.setProceedingText("[DEBUG DOUBLE MOVING AVERAGE FILTER]");
     errorLog.setProceedingText("[ERROR DOUBLE MOVING AVERAGE FILTER]");
     warningLog.setProceedingText("[WARNING DOUBLE MOVING AVERAGE FILTER]");
@@ -67,13 +67,13 @@ DoubleMovingAverageFilter& DoubleMovingAverageFilter::operator=(const DoubleMovi
     return *this;
 }
     
-bool DoubleMovingAverageFilter::clone(PreProcessing *preProcessing){
+bool DoubleMovingAverageFilter::clone(const PreProcessing *preProcessing){
     
     if( preProcessing == NULL ) return false;
     
     if( this->getPreProcessingType() == preProcessing->getPreProcessingType() ){
         
-        DoubleMovingAverageFilter *ptr = (DoubleMovingAverageFilter*)preProcessing;
+        const DoubleMovingAverageFilter *ptr = (const DoubleMovingAverageFilter*)preProcessing;
         //Clone the classLabelTimeoutFilter values 
         this->filterSize = ptr->filterSize;
         this->filter1 = ptr->filter1;
@@ -83,13 +83,13 @@ bool DoubleMovingAverageFilter::clone(PreProcessing *preProcessing){
         return copyBaseVariables(this, preProcessing);
     }
     
-    errorLog << "clone(PreProcessing *preProcessing) -  PreProcessing Types Do Not Match!" << endl;
+    errorLog << "clone(const PreProcessing *preProcessing) -  PreProcessing Types Do Not Match!" << endl;
     
     return false;
 }
 
     
-bool DoubleMovingAverageFilter::process(vector< double > inputVector){
+bool DoubleMovingAverageFilter::process(const vector< double > &inputVector){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
@@ -103,10 +103,20 @@ bool DoubleMovingAverageFilter::process(vector< double > inputVector){
     }
 #endif
     
-    processedData = filter( inputVector );
+    //Perform the first filter
+    if( !filter1.process( inputVector ) ) return false;
+    const vector< double > &y = filter1.getProcessedData();
     
-    if( processedData.size() == numOutputDimensions ) return true;
-    return false;
+    //Perform the second filter
+    if( !filter2.process( y ) ) return false;
+    const vector< double > &yy = filter2.getProcessedData();
+    
+    //Account for the filter lag
+    for(UINT i=0; i<numInputDimensions; i++){
+        processedData[i] = y[i] + (y[i] - yy[i]);
+    }
+    
+    return true;
 }
 
 bool DoubleMovingAverageFilter::reset(){
@@ -265,7 +275,7 @@ double DoubleMovingAverageFilter::filter(double x){
     return y[0];
 }
     
-vector< double > DoubleMovingAverageFilter::filter(vector< double > x){
+vector< double > DoubleMovingAverageFilter::filter(const vector< double > &x){
     
 #ifdef GRT_SAFE_CHECKING
     //If the filter has not been initialised then return 0, otherwise filter x and return y
@@ -280,23 +290,8 @@ vector< double > DoubleMovingAverageFilter::filter(vector< double > x){
     }
 #endif
     
-    //Perform the first filter
-    vector< double > y = filter1.filter( x );
-    
-    if( y.size() == 0 ) return y;
-    
-    //Perform the second filter
-    vector< double > yy = filter2.filter( y );
-    
-    if( yy.size() == 0 ) return y;
-    
-    //Account for the filter lag
-    for(UINT i=0; i<y.size(); i++){
-        yy[i] = y[i] + (y[i] - yy[i]); 
-        processedData[i] = yy[i];
-    }
-    
-    return yy;
+    if( !process( x ) ) return vector< double >();
+    return processedData;
 }
 
 }//End of namespace GRT
\ No newline at end of file
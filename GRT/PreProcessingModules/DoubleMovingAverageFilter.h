@@ -69,10 +69,10 @@ public:
      This function is used to clone the values from the input pointer to this instance of the PreProcessing module.
      This function is called by the GestureRecognitionPipeline when the user adds a new PreProcessing module to the pipeline.
      
-	 @param PreProcessing *preProcessing: a pointer to another instance of a DoubleMovingAverageFilter, the values of that instance will be cloned to this instance
+	 @param const PreProcessing *preProcessing: a pointer to another instance of a DoubleMovingAverageFilter, the values of that instance will be cloned to this instance
 	 @return true if the clone was successful, false otherwise
      */
-    virtual bool clone(PreProcessing *preProcessing);
+    virtual bool clone(const PreProcessing *preProcessing);
         
     /**
      Sets the PreProcessing process function, overwriting the base PreProcessing function.
@@ -82,7 +82,7 @@ public:
 	 @param vector< double > inputVector: the inputVector that should be processed.  Must have the same dimensionality as the PreProcessing module
 	 @return true if the data was processed, false otherwise
      */
-    virtual bool process(vector< double > inputVector);
+    virtual bool process(const vector< double > &inputVector);
     
     /**
      Sets the PreProcessing reset function, overwriting the base PreProcessing function.
@@ -153,7 +153,7 @@ public:
      @param vector< double >  x: the values to filter, the dimensionality of the input vector should match that of the filter
 	 @return the filtered values.  An empty vector will be returned if the values were not filtered
      */
-    vector< double > filter(vector< double > x);
+    vector< double > filter(const vector< double > &x);
     
     /**
      Returns the last value(s) that were filtered.
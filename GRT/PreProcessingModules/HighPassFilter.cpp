@@ -58,13 +58,13 @@ HighPassFilter& HighPassFilter::operator=(const HighPassFilter &rhs){
     return *this;
 }
     
-bool HighPassFilter::clone(PreProcessing *preProcessing){
+bool HighPassFilter::clone(const PreProcessing *preProcessing){
     
     if( preProcessing == NULL ) return false;
     
     if( this->getPreProcessingType() == preProcessing->getPreProcessingType() ){
         
-        HighPassFilter *ptr = (HighPassFilter*)preProcessing;
+        const HighPassFilter *ptr = (const HighPassFilter*)preProcessing;
         //Clone the HighPassFilter values 
         this->filterFactor = ptr->filterFactor;
         this->gain = ptr->gain;
@@ -75,12 +75,12 @@ bool HighPassFilter::clone(PreProcessing *preProcessing){
         return copyBaseVariables(this,preProcessing);
     }
     
-    errorLog << "clone(PreProcessing *preProcessing) -  PreProcessing Types Do Not Match!" << endl;
+    errorLog << "clone(const PreProcessing *preProcessing) -  PreProcessing Types Do Not Match!" << endl;
     
     return false;
 }
     
-bool HighPassFilter::process(vector< double > inputVector){
+bool HighPassFilter::process(const vector< double > &inputVector){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
@@ -94,10 +94,18 @@ bool HighPassFilter::process(vector< double > inputVector){
     }
 #endif
     
-    processedData = filter( inputVector );
+    for(UINT n=0; n<numInputDimensions; n++){
+        //Compute the new output
+        processedData[n] = filterFactor * (yy[n] + inputVector[n] - xx[n]) * gain;
+        
+        //Store the current input
+        xx[n] = inputVector[n];
+        
+        //Store the current output
+        yy[n] = processedData[n];
+    }
     
-    if( processedData.size() == numOutputDimensions ) return true;
-    return false;
+    return true;
 
 }
 
@@ -265,7 +273,7 @@ double HighPassFilter::filter(double x){
 
 }
     
-vector< double > HighPassFilter::filter(vector< double > x){
+vector< double > HighPassFilter::filter(const vector< double > &x){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
@@ -279,16 +287,7 @@ vector< double > HighPassFilter::filter(vector< double > x){
     }
 #endif
     
-    for(UINT n=0; n<numInputDimensions; n++){
-        //Compute the new output
-        processedData[n] = filterFactor * (yy[n] + x[n] - xx[n]) * gain;
-        
-        //Store the current input
-        xx[n] = x[n];
-        
-        //Store the current output
-        yy[n] = processedData[n];
-    }
+    if( !process( x ) ) return vector< double >();
     return processedData;
 }
     
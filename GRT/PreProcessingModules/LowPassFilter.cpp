@@ -56,13 +56,13 @@ LowPassFilter& LowPassFilter::operator=(const LowPassFilter &rhs){
 	return *this;
 }
     
-bool LowPassFilter::clone(PreProcessing *preProcessing){
+bool LowPassFilter::clone(const PreProcessing *preProcessing){
     
     if( preProcessing == NULL ) return false;
     
     if( this->getPreProcessingType() == preProcessing->getPreProcessingType() ){
         
-        LowPassFilter *ptr = (LowPassFilter*)preProcessing;
+        const LowPassFilter *ptr = (const LowPassFilter*)preProcessing;
         //Clone the HighPassFilter values 
         this->filterFactor = ptr->filterFactor;
         this->gain = ptr->gain;
@@ -71,12 +71,12 @@ bool LowPassFilter::clone(PreProcessing *preProcessing){
         return copyBaseVariables(this,preProcessing);
     }
     
-    errorLog << "clone(PreProcessing *preProcessing) -  PreProcessing Types Do Not Match!" << endl;
+    errorLog << "clone(const PreProcessing *preProcessing) -  PreProcessing Types Do Not Match!" << endl;
     
     return false;
 }
     
-bool LowPassFilter::process(vector< double > inputVector){
+bool LowPassFilter::process(const vector< double > &inputVector){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
@@ -90,10 +90,12 @@ bool LowPassFilter::process(vector< double > inputVector){
     }
 #endif
     
-    processedData = filter( inputVector );
+    for(UINT n=0; n<numInputDimensions; n++){
+        processedData[n] = (inputVector[n] * filterFactor) + (yy[n] * (1.0 - filterFactor)) * gain;
+        yy[n] = processedData[n];
+    }
     
-    if( processedData.size() == numOutputDimensions ) return true;
-    return false;
+    return true;
 
 }
 
@@ -259,7 +261,7 @@ double LowPassFilter::filter(double x){
 
 }
     
-vector< double > LowPassFilter::filter(vector< double > x){
+vector< double > LowPassFilter::filter(const vector< double > &x){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
@@ -273,10 +275,7 @@ vector< double > LowPassFilter::filter(vector< double > x){
     }
 #endif
     
-    for(UINT n=0; n<numInputDimensions; n++){
-        processedData[n] = (x[n] * filterFactor) + (yy[n] * (1.0 - filterFactor)) * gain;
-        yy[n] = processedData[n];
-    }
+    if( !process( x ) ) return vector< double >();
     return processedData;
 }
     
@@ -66,10 +66,10 @@ public:
      This function is used to clone the values from the input pointer to this instance of the PreProcessing module.
      This function is called by the GestureRecognitionPipeline when the user adds a new PreProcessing module to the pipeline.
      
-	 @param PreProcessing *preProcessing: a pointer to another instance of a LowPassFilter, the values of that instance will be cloned to this instance
+	 @param const PreProcessing *preProcessing: a pointer to another instance of a LowPassFilter, the values of that instance will be cloned to this instance
 	 @return true if the clone was successful, false otherwise
      */
-    bool clone(PreProcessing *preProcessing);
+    virtual bool clone(const PreProcessing *preProcessing);
     
     /**
      Sets the PreProcessing process function, overwriting the base PreProcessing function.
@@ -79,7 +79,7 @@ public:
 	 @param vector< double > inputVector: the inputVector that should be processed.  Must have the same dimensionality as the PreProcessing module
 	 @return true if the data was processed, false otherwise
      */
-    bool process(vector< double > inputVector);
+    bool process(const vector< double > &inputVector);
     
     /**
      Sets the PreProcessing reset function, overwriting the base PreProcessing function.
@@ -151,7 +151,7 @@ public:
      @param vector< double >  x: the values to filter, the dimensionality of the input vector should match that of the filter
 	 @return the filtered values.  An empty vector will be returned if the values were not filtered
      */
-    vector< double > filter(vector< double > x);
+    vector< double > filter(const vector< double > &x);
     
     /**
      Sets the gain of the low pass filter.
@@ -26,7 +26,7 @@ namespace GRT{
 RegisterPreProcessingModule< MovingAverageFilter > MovingAverageFilter::registerModule("MovingAverageFilter");
 
 MovingAverageFilter::MovingAverageFilter(UINT filterSize,UINT numDimensions){
-    preProcessingType = "MOVING_AVERAGE_FILTER";
+    preProcessingType = "MovingAverageFilter";
     debugLog.setProceedingText("[DEBUG MOVING AVERAGE FILTER]");
     errorLog.setProceedingText("[ERROR MOVING AVERAGE FILTER]");
     warningLog.setProceedingText("[WARNING MOVING AVERAGE FILTER]");
@@ -34,7 +34,7 @@ MovingAverageFilter::MovingAverageFilter(UINT filterSize,UINT numDimensions){
 }
     
 MovingAverageFilter::MovingAverageFilter(const MovingAverageFilter &rhs){
-    preProcessingType = "MOVING_AVERAGE_FILTER";
+    preProcessingType = "MovingAverageFilter";
     debugLog.setProceedingText("[DEBUG MOVING AVERAGE FILTER]");
     errorLog.setProceedingText("[ERROR MOVING AVERAGE FILTER]");
     warningLog.setProceedingText("[WARNING MOVING AVERAGE FILTER]");
@@ -42,6 +42,7 @@ MovingAverageFilter::MovingAverageFilter(const MovingAverageFilter &rhs){
     //Zero this instance
     this->filterSize = 0;
     this->inputSampleCounter = 0;
+    this->numSamplesSinceSumRecomputed = 0;
     
     //Copy from the rhs instance if needed
     if( rhs.initialized ){
@@ -62,6 +63,7 @@ MovingAverageFilter& MovingAverageFilter::operator=(const MovingAverageFilter &r
         //Clear this instance
         this->filterSize = 0;
         this->inputSampleCounter = 0;
+        this->numSamplesSinceSumRecomputed = 0;
         this->dataBuffer.clear();
         
         //Copy from the rhs instance
@@ -76,29 +78,31 @@ MovingAverageFilter& MovingAverageFilter::operator=(const MovingAverageFilter &r
     return *this;
 }
     
-bool MovingAverageFilter::clone(PreProcessing *preProcessing){
+bool MovingAverageFilter::clone(const PreProcessing *preProcessing){
     
     if( preProcessing == NULL ) return false;
     
     if( this->getPreProcessingType() == preProcessing->getPreProcessingType() ){
         
-        MovingAverageFilter *ptr = (MovingAverageFilter*)preProcessing;
+        const MovingAverageFilter *ptr = (const MovingAverageFilter*)preProcessing;
         //Clone the classLabelTimeoutFilter values 
         this->filterSize = ptr->filterSize;
         this->inputSampleCounter = ptr->inputSampleCounter;
         this->dataBuffer = ptr->dataBuffer;
+        this->runningSum = ptr->runningSum;
+        this->numSamplesSinceSumRecomputed = ptr->numSamplesSinceSumRecomputed;
         
         //Clone the classifier variables
         return copyBaseVariables(this, preProcessing);
     }
     
-    errorLog << "clone(PreProcessing *preProcessing) -  PreProcessing Types Do Not Match!" << endl;
+    errorLog << "clone(const PreProcessing *preProcessing) -  PreProcessing Types Do Not Match!" << endl;
     
     return false;
 }
 
     
-bool MovingAverageFilter::process(vector< double > inputVector){
+bool MovingAverageFilter::process(const vector< double > &inputVector){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
@@ -112,10 +116,35 @@ bool MovingAverageFilter::process(vector< double > inputVector){
     }
 #endif
     
-    processedData = filter( inputVector );
+    const UINT previousSampleCounter = inputSampleCounter;
+    if( ++inputSampleCounter > filterSize ) inputSampleCounter = filterSize;
     
-    if( processedData.size() == numOutputDimensions ) return true;
-    return false;
+    //The output is the mean of the first inputSampleCounter values in the buffer. Pushing a value shifts the buffer by one, so the
+    //running sum loses the value at the front and gains the values that move into (or are added to) the end of that range
+    if( previousSampleCounter > 0 ){
+        const vector< double > &oldestValue = dataBuffer[0];
+        for(unsigned int j=0; j<numInputDimensions; j++) runningSum[j] -= oldestValue[j];
+    }
+    
+    //Add the new value to the buffer
+    dataBuffer.push_back( inputVector );
+    
+    //Any rounding error in the running sum is removed by summing the buffer again once every filterSize samples, in between the
+    //output can differ from the mean of the buffer by around 1e-12 relative error
+    if( ++numSamplesSinceSumRecomputed >= filterSize ){
+        recomputeRunningSum();
+    }else{
+        for(unsigned int i=(previousSampleCounter > 0 ? previousSampleCounter-1 : 0); i<inputSampleCounter; i++){
+            const vector< double > &value = dataBuffer[i];
+            for(unsigned int j=0; j<numInputDimensions; j++) runningSum[j] += value[j];
+        }
+    }
+    
+    for(unsigned int j=0; j<numInputDimensions; j++){
+        processedData[j] = runningSum[j] / double(inputSampleCounter);
+    }
+    
+    return true;
 
 }
 
@@ -226,6 +255,7 @@ bool MovingAverageFilter::init(UINT filterSize,UINT numDimensions){
     //Cleanup the old memory
     initialized = false;
     inputSampleCounter = 0;
+    numSamplesSinceSumRecomputed = 0;
     
     if( filterSize == 0 ){
         errorLog << "init(UINT filterSize,UINT numDimensions) - Filter size can not be zero!" << endl;
@@ -243,6 +273,8 @@ bool MovingAverageFilter::init(UINT filterSize,UINT numDimensions){
     this->numOutputDimensions = numDimensions;
     processedData.clear();
     processedData.resize(numDimensions,0);
+    runningSum.clear();
+    runningSum.resize(numDimensions,0);
     initialized = dataBuffer.resize( filterSize, vector< double >(numInputDimensions,0) );
     
     if( !initialized ){
@@ -268,7 +300,7 @@ double MovingAverageFilter::filter(double x){
     return y[0];
 }
     
-vector< double > MovingAverageFilter::filter(vector< double > x){
+vector< double > MovingAverageFilter::filter(const vector< double > &x){
     
 #ifdef GRT_SAFE_CHECKING
     //If the filter has not been initialised then return 0, otherwise filter x and return y
@@ -283,20 +315,19 @@ vector< double > MovingAverageFilter::filter(vector< double > x){
     }
 #endif
     
-    if( ++inputSampleCounter > filterSize ) inputSampleCounter = filterSize;
+    if( !process( x ) ) return vector< double >();
+    return processedData;
+}
     
-    //Add the new value to the buffer
-    dataBuffer.push_back( x );
+void MovingAverageFilter::recomputeRunningSum(){
     
+    numSamplesSinceSumRecomputed = 0;
     for(unsigned int j=0; j<numInputDimensions; j++){
-        processedData[j] = 0;
+        runningSum[j] = 0;
         for(unsigned int i=0; i<inputSampleCounter; i++) {
-            processedData[j] += dataBuffer[i][j];
+            runningSum[j] += dataBuffer[i][j];
         }
-        processedData[j] /= double(inputSampleCounter);
     }
-    
-    return processedData;
 }
 
 }//End of namespace GRT
\ No newline at end of file
@@ -67,10 +67,10 @@ public:
      This function is used to clone the values from the input pointer to this instance of the PreProcessing module.
      This function is called by the GestureRecognitionPipeline when the user adds a new PreProcessing module to the pipeline.
      
-	 @param PreProcessing *preProcessing: a pointer to another instance of a MovingAverageFilter, the values of that instance will be cloned to this instance
+	 @param const PreProcessing *preProcessing: a pointer to another instance of a MovingAverageFilter, the values of that instance will be cloned to this instance
 	 @return true if the clone was successful, false otherwise
      */
-    bool clone(PreProcessing *preProcessing);
+    virtual bool clone(const PreProcessing *preProcessing);
     
     /**
      Sets the PreProcessing process function, overwriting the base PreProcessing function.
@@ -80,7 +80,7 @@ public:
 	 @param vector< double > inputVector: the inputVector that should be processed.  Must have the same dimensionality as the PreProcessing module
 	 @return true if the data was processed, false otherwise
      */
-    bool process(vector< double > inputVector);
+    bool process(const vector< double > &inputVector);
     
     /**
      Sets the PreProcessing reset function, overwriting the base PreProcessing function.
@@ -150,7 +150,7 @@ public:
      @param vector< double >  x: the values to filter, the dimensionality of the input vector should match that of the filter
 	 @return the filtered values.  An empty vector will be returned if the values were not filtered
      */
-    vector< double > filter(vector< double > x);
+    vector< double > filter(const vector< double > &x);
     
     /**
      Returns the last value(s) that were filtered.
@@ -160,9 +160,16 @@ public:
     vector< double > getFilteredData(){ return processedData; }
     
 protected:
+    /**
+     Sums the values used by the filter again, removing any rounding error that has built up in the running sum.
+     */
+    void recomputeRunningSum();
+    
     UINT filterSize;                                        ///< The size of the filter
     UINT inputSampleCounter;                                ///< A counter to keep track of the number of input samples
+    UINT numSamplesSinceSumRecomputed;                      ///< The number of samples filtered since the running sum was last recomputed
     CircularBuffer< vector< double > > dataBuffer;          ///< A buffer to store the previous N values, N = filterSize
+    vector< double > runningSum;                            ///< The sum of the values the filter is averaging, updated as each sample is added
     
     static RegisterPreProcessingModule< MovingAverageFilter > registerModule;
 };
@@ -64,13 +64,13 @@ SavitzkyGolayFilter& SavitzkyGolayFilter::operator=(const SavitzkyGolayFilter &r
 	return *this;
 }
 
-bool SavitzkyGolayFilter::clone(PreProcessing *preProcessing){
+bool SavitzkyGolayFilter::clone(const PreProcessing *preProcessing){
     
     if( preProcessing == NULL ) return false;
     
     if( this->getPreProcessingType() == preProcessing->getPreProcessingType() ){
         
-        SavitzkyGolayFilter *ptr = (SavitzkyGolayFilter*)preProcessing;
+        const SavitzkyGolayFilter *ptr = (const SavitzkyGolayFilter*)preProcessing;
         //Clone the SavitzkyGolayFilter values 
         this->numPoints = ptr->numPoints;
         this->numLeftHandPoints = ptr->numLeftHandPoints;
@@ -85,12 +85,12 @@ bool SavitzkyGolayFilter::clone(PreProcessing *preProcessing){
         return copyBaseVariables(this,preProcessing);
     }
     
-    errorLog << "clone(PreProcessing *preProcessing) -  PreProcessing Types Do Not Match!" << endl;
+    errorLog << "clone(const PreProcessing *preProcessing) -  PreProcessing Types Do Not Match!" << endl;
     
     return false;
 }
     
-bool SavitzkyGolayFilter::process(vector< double > inputVector){
+bool SavitzkyGolayFilter::process(const vector< double > &inputVector){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
@@ -104,10 +104,17 @@ bool SavitzkyGolayFilter::process(vector< double > inputVector){
     }
 #endif
     
-    processedData = filter( inputVector );
+    //Add the new input data to the data buffer
+    data.push_back( inputVector );
     
-    if( processedData.size() == numOutputDimensions ) return true;
-    return false;
+    //Filter the data
+    for(UINT j=0; j<inputVector.size(); j++){
+        processedData[j] = 0;
+        for(int i=0; i<numPoints; i++) 
+            processedData[j] += data[i][j] * coeff[i];
+    }
+    
+    return true;
 
 }
 
@@ -299,7 +306,7 @@ double SavitzkyGolayFilter::filter(double x){
 	return 0;
 }
     
-vector< double > SavitzkyGolayFilter::filter(vector< double > x){
+vector< double > SavitzkyGolayFilter::filter(const vector< double > &x){
     
 #ifdef GRT_SAFE_CHECKING
     if( !initialized ){
@@ -313,16 +320,7 @@ vector< double > SavitzkyGolayFilter::filter(vector< double > x){
     }
 #endif
     
-    //Add the new input data to the data buffer
-    data.push_back( x );
-    
-    //Filter the data
-    for(UINT j=0; j<x.size(); j++){
-        processedData[j] = 0;
-        for(int i=0; i<numPoints; i++) 
-            processedData[j] += data[i][j] * coeff[i];
-    }
-    
+    if( !process( x ) ) return vector< double >();
     return processedData;
 }
     
@@ -24,6 +24,9 @@ namespace GRT{
     
 //Register the MLP module with the Regressifier base class
 RegisterRegressifierModule< MLP > MLP::registerModule("MLP");
+    
+//The number of training examples whose gradients are summed together by one task of the mini-batch training
+#define MLP_GRADIENT_CHUNK_SIZE 32
 
 MLP::MLP(){
     inputLayerActivationFunction = Neuron::LINEAR;
@@ -43,12 +46,17 @@ MLP::MLP(){
 	useValidationSet = true;
 	randomiseTrainingOrder = false;
     useMultiThreadingTraining = false;
+    batchSize = 1;
 	useScaling = true;
 	trained = false;
     initialized = false;
     classificationModeActive = false;
     useNullRejection = true;
     clear();
+    
+    //Initialize the random seed, this is only done once so each call to init starts from new random weights
+    random.setSeed( (unsigned long long)time(NULL) );
+    
     regressifierType = "MLP";
     debugLog.setProceedingText("[DEBUG MLP]");
     errorLog.setProceedingText("[ERROR MLP]");
@@ -87,7 +95,7 @@ bool MLP::train(LabelledClassificationData &trainingData){
 }
     
 //Classifier interface
-bool MLP::predict(vector< double > inputVector){
+bool MLP::predict(const vector< double > &inputVector){
     
     if( !trained ){
         errorLog << "predict(vector< double > inputVector) - Model not trained!" << endl;
@@ -99,41 +107,117 @@ bool MLP::predict(vector< double > inputVector){
         return false;
     }
     
-    //Set the mapped data as the classLikelihoods
-    regressionData = feedforward(inputVector);
+    //Map the input vector through the network, the mapped data is also used as the classLikelihoods
+    regressionData.resize( numOutputNeurons );
+    feedforward(&inputVector[0],&regressionData[0]);
     
     if( classificationModeActive ){
-        double bestValue = classLikelihoods[0];
-        UINT bestIndex = 0;
-        for(UINT i=1; i<classLikelihoods.size(); i++){
-            if( classLikelihoods[i] > bestValue ){
-                bestValue = classLikelihoods[i];
-                bestIndex = i;
+        classLikelihoods = regressionData;
+        predictFromClassLikelihoods();
+    }
+    
+    return true;
+}
+    
+bool MLP::predictBatch(const Matrix<double> &inputData,Matrix<double> &outputData){
+    
+    if( !trained ){
+        errorLog << "predictBatch(const Matrix<double> &inputData,Matrix<double> &outputData) - Model not trained!" << endl;
+        return false;
+    }
+    
+    if( inputData.getNumCols() != numInputNeurons ){
+        errorLog << "predictBatch(const Matrix<double> &inputData,Matrix<double> &outputData) - The number of columns in the input data (" << inputData.getNumCols() << ") does not match that of the number of input dimensions (" << numInputNeurons << ") " << endl;
+        return false;
+    }
+    
+    const UINT TILE_SIZE = 64;
+    const UINT M = inputData.getNumRows();
+    outputData.resize( M, numOutputNeurons );
+    Matrix<double> inputNeuronsOutput( TILE_SIZE, numInputNeurons );
+    Matrix<double> hiddenNeuronsOutput( TILE_SIZE, numHiddenNeurons );
+    Matrix<double> outputNeuronsOutput( TILE_SIZE, numOutputNeurons );
+    
+    for(UINT tileStart=0; tileStart<M; tileStart+=TILE_SIZE){
+        const UINT tileSize = tileStart + TILE_SIZE <= M ? TILE_SIZE : M - tileStart;
+        
+        //Input layer, the input vector is scaled if required
+        for(UINT r=0; r<tileSize; r++){
+            for(UINT i=0; i<numInputNeurons; i++){
+                double x = inputData[tileStart+r][i];
+                if( useScaling ) x = scale(x,inputVectorRanges[i].minValue,inputVectorRanges[i].maxValue,0.0,1.0);
+                inputNeuronsOutput[r][i] = x;
             }
+            inputLayer.fireOneToOne( inputNeuronsOutput[r], inputNeuronsOutput[r] );
         }
         
-        //Set the maximum likelihood and predicted class label
-        maxLikelihood = bestValue;
-        predictedClassLabel = bestIndex+1;
+        //Hidden and output layers
+        hiddenLayer.fire( inputNeuronsOutput, tileSize, hiddenNeuronsOutput );
+        outputLayer.fire( hiddenNeuronsOutput, tileSize, outputNeuronsOutput );
         
-        if( useNullRejection ){
-            if( maxLikelihood < nullRejectionCoeff ){
-                predictedClassLabel = 0;
+        //The output vector is scaled if required
+        for(UINT r=0; r<tileSize; r++){
+            for(UINT i=0; i<numOutputNeurons; i++){
+                double y = outputNeuronsOutput[r][i];
+                if( useScaling ) y = scale(y,0.0,1.0,targetVectorRanges[i].minValue,targetVectorRanges[i].maxValue);
+                outputData[tileStart+r][i] = y;
             }
         }
     }
     
     return true;
 }
+    
+bool MLP::predictBatch(const Matrix<double> &inputData,vector< UINT > &predictedClassLabels,Matrix<double> &likelihoods){
+    
+    if( !classificationModeActive ){
+        errorLog << "predictBatch(const Matrix<double> &inputData,vector< UINT > &predictedClassLabels,Matrix<double> &likelihoods) - The MLP is not in classification mode!" << endl;
+        return false;
+    }
+    
+    if( !predictBatch(inputData,likelihoods) ){
+        return false;
+    }
+    
+    const UINT M = inputData.getNumRows();
+    predictedClassLabels.resize( M );
+    classLikelihoods.resize( numOutputNeurons );
+    for(UINT i=0; i<M; i++){
+        std::copy(likelihoods[i],likelihoods[i]+numOutputNeurons,classLikelihoods.begin());
+        predictFromClassLikelihoods();
+        predictedClassLabels[i] = predictedClassLabel;
+    }
+    
+    return true;
+}
+    
+void MLP::predictFromClassLikelihoods(){
+    
+    double bestValue = classLikelihoods[0];
+    UINT bestIndex = 0;
+    for(UINT i=1; i<classLikelihoods.size(); i++){
+        if( classLikelihoods[i] > bestValue ){
+            bestValue = classLikelihoods[i];
+            bestIndex = i;
+        }
+    }
+    
+    //Set the maximum likelihood and predicted class label
+    maxLikelihood = bestValue;
+    predictedClassLabel = bestIndex+1;
+    
+    if( useNullRejection ){
+        if( maxLikelihood < nullRejectionCoeff ){
+            predictedClassLabel = 0;
+        }
+    }
+}
 
 bool MLP::init(UINT numInputNeurons,UINT numHiddenNeurons,UINT numOutputNeurons,UINT inputLayerActivationFunction,
                    UINT hiddenLayerActivationFunction,UINT outputLayerActivationFunction){
     
     //Clear any previous models
     clear();
-
-	//Initialize the random seed
-	random.setSeed( (UINT)time(NULL) );
     
     if( numInputNeurons == 0 || numHiddenNeurons == 0 || numOutputNeurons == 0 ){
         if( numInputNeurons == 0 )  errorLog << "init(...) - The number of input neurons is zero!" << endl;
@@ -158,28 +242,14 @@ bool MLP::init(UINT numInputNeurons,UINT numHiddenNeurons,UINT numOutputNeurons,
     this->hiddenLayerActivationFunction = hiddenLayerActivationFunction;
     this->outputLayerActivationFunction = outputLayerActivationFunction;
     
-    //Setup the neurons for each of the layers
-    inputLayer.resize(numInputNeurons);
-    hiddenLayer.resize(numHiddenNeurons);
-    outputLayer.resize(numOutputNeurons);
-    
-    //Init the neuron memory for each of the layers
-    for(UINT i=0; i<numInputNeurons; i++){
-        inputLayer[i].init(1,inputLayerActivationFunction);
-        inputLayer[i].weights[0] = 1.0; //The weights for the input layer should always be 1
-		inputLayer[i].bias = 0.0; //The bias for the input layer should always be 0
-		inputLayer[i].gamma = gamma;
-    }
-    
-    for(UINT i=0; i<numHiddenNeurons; i++){
-        hiddenLayer[i].init(numInputNeurons,hiddenLayerActivationFunction);
-		hiddenLayer[i].gamma = gamma;
-    }
+    //Setup the neurons for each of the layers, the weights are drawn from the MLP's random generator so each neuron starts from different weights
+    inputLayer.init(numInputNeurons,1,inputLayerActivationFunction,gamma,random);
+    hiddenLayer.init(numHiddenNeurons,numInputNeurons,hiddenLayerActivationFunction,gamma,random);
+    outputLayer.init(numOutputNeurons,numHiddenNeurons,outputLayerActivationFunction,gamma,random);
     
-    for(UINT i=0; i<numOutputNeurons; i++){
-        outputLayer[i].init(numHiddenNeurons,outputLayerActivationFunction);
-		outputLayer[i].gamma = gamma;
-    }
+    //The weights for the input layer should always be 1 and the bias for the input layer should always be 0
+    inputLayer.weights.setAllValues(1.0);
+    std::fill(inputLayer.bias.begin(),inputLayer.bias.end(),0.0);
     
     initialized = true;
     
@@ -198,6 +268,61 @@ void MLP::clear(){
     initialized = false;
 }
 
+//Trains the random training iterations [startIndex endIndex), each iteration trains its own copy of the network
+class MLPTrainingJob : public ParallelJob{
+public:
+    MLPTrainingJob(vector< MLP* > &networks,const Matrix< double > &trainingInputs,const Matrix< double > &trainingTargets,
+                   const Matrix< double > &validationInputs,const Matrix< double > &validationTargets,UINT numThreads):
+        networks(networks),trainingInputs(trainingInputs),trainingTargets(trainingTargets),validationInputs(validationInputs),
+        validationTargets(validationTargets),numThreads(numThreads),errors(networks.size(),0),nanFound(networks.size(),0){}
+
+    virtual void run(unsigned int /*threadIndex*/,unsigned int startIndex,unsigned int endIndex){
+        for(UINT iter=startIndex; iter<endIndex; iter++){
+            bool nan = false;
+            errors[iter] = networks[iter]->trainNetwork(trainingInputs,trainingTargets,validationInputs,validationTargets,iter,numThreads,nan);
+            nanFound[iter] = nan ? 1 : 0;
+        }
+    }
+
+    vector< MLP* > &networks;
+    const Matrix< double > &trainingInputs;
+    const Matrix< double > &trainingTargets;
+    const Matrix< double > &validationInputs;
+    const Matrix< double > &validationTargets;
+    UINT numThreads;
+    vector< double > errors;
+    vector< UINT > nanFound;
+};
+
+//Sums the gradients of the chunks [startIndex endIndex) of one mini-batch, each chunk holds MLP_GRADIENT_CHUNK_SIZE examples
+class MLPGradientJob : public ParallelJob{
+public:
+    MLPGradientJob(const MLP *mlp,const Matrix< double > &inputs,const Matrix< double > &targets,const vector< UINT > &indexList,
+                   UINT batchStart,UINT batchEnd,vector< MLP::Gradient > &gradients):
+        mlp(mlp),inputs(inputs),targets(targets),indexList(indexList),batchStart(batchStart),batchEnd(batchEnd),gradients(gradients){}
+
+    virtual void run(unsigned int /*threadIndex*/,unsigned int startIndex,unsigned int endIndex){
+        for(UINT c=startIndex; c<endIndex; c++){
+            MLP::Gradient &gradient = gradients[c];
+            const UINT chunkStart = batchStart + c*MLP_GRADIENT_CHUNK_SIZE;
+            const UINT chunkEnd = std::min(chunkStart+MLP_GRADIENT_CHUNK_SIZE,batchEnd);
+
+            mlp->clearGradient( gradient );
+            for(UINT i=chunkStart; i<chunkEnd; i++){
+                gradient.error += mlp->computeGradient(inputs[ indexList[i] ],targets[ indexList[i] ],gradient);
+            }
+        }
+    }
+
+    const MLP *mlp;
+    const Matrix< double > &inputs;
+    const Matrix< double > &targets;
+    const vector< UINT > &indexList;
+    UINT batchStart;
+    UINT batchEnd;
+    vector< MLP::Gradient > &gradients;
+};
+
 bool MLP::train(LabelledRegressionData &trainingData_){
 
     trained = false;
@@ -260,400 +385,460 @@ bool MLP::train(LabelledRegressionData &trainingData_){
 		}
 	}
     
-    //Setup the training loop
+    //Copy the (scaled) training and validation data into contiguous matrices, with one example per row
+    Matrix< double > trainingInputs(M,N), trainingTargets(M,T);
+    Matrix< double > validationInputs, validationTargets;
+    for(UINT i=0; i<M; i++){
+        for(UINT j=0; j<N; j++) trainingInputs[i][j] = trainingData[i].getInputVectorValue(j);
+        for(UINT j=0; j<T; j++) trainingTargets[i][j] = trainingData[i].getTargetVectorValue(j);
+    }
+    if( useValidationSet ){
+        validationInputs.resize(numTestingExamples,N);
+        validationTargets.resize(numTestingExamples,T);
+        for(UINT i=0; i<numTestingExamples; i++){
+            for(UINT j=0; j<N; j++) validationInputs[i][j] = validationData[i].getInputVectorValue(j);
+            for(UINT j=0; j<T; j++) validationTargets[i][j] = validationData[i].getTargetVectorValue(j);
+        }
+    }
+
+    //Each random training iteration trains its own copy of the network from its own random seed, so the iterations can run in parallel
+    //and the result does not depend on the number of threads. The copies are created here as the Regressifier instance count is not thread safe
+    const UINT numIterations = numRandomTrainingIterations;
+    const UINT numThreads = useMultiThreadingTraining ? 0 : 1;
+    const UINT numIterationThreads = ParallelFor::getNumThreads(numIterations,numThreads);
+    vector< MLP* > networks(numIterations);
+    for(UINT iter=0; iter<numIterations; iter++){
+        networks[iter] = new MLP;
+        *networks[iter] = *this;
+        networks[iter]->random.setSeed( (unsigned long long)random.getRandomNumberInt(1,0x7FFFFFFF) );
+    }
+
+    //If the iterations run in parallel then each iteration computes its mini-batch gradients on a single thread
+    MLPTrainingJob job(networks,trainingInputs,trainingTargets,validationInputs,validationTargets,numIterationThreads > 1 ? 1 : numThreads);
+    ParallelFor::run(job,numIterations,numIterationThreads);
+
+    //Keep the network with the lowest error, any network that contains a NaN is ignored
+    UINT bestIter = 0;
+    bool bestFound = false;
+    double bestErr = 0;
+    for(UINT iter=0; iter<numIterations; iter++){
+        if( job.nanFound[iter] ) continue;
+        if( !bestFound || job.errors[iter] < bestErr ){
+            bestIter = iter;
+            bestErr = job.errors[iter];
+            bestFound = true;
+        }
+    }
+
+    if( bestFound ){
+        *this = *networks[bestIter];
+        trainingError = bestErr;
+    }
+
+    for(UINT iter=0; iter<numIterations; iter++){
+        delete networks[iter];
+    }
+
+    if( !bestFound ){
+        errorLog << "train(LabelledRegressionData trainingData) - NAN Found!" << endl;
+        return false;
+    }
+
+    trainingLog << "BestError: " << bestErr << " in Random Training Iteration: " << bestIter+1 << endl;
+
+    //Compute the rejection threshold
+    if( classificationModeActive ){
+        double averageValue = 0;
+        vector< double > classificationPredictions;
+        vector< double > y(T);
+        const Matrix< double > &testInputs = useValidationSet ? validationInputs : trainingInputs;
+        const Matrix< double > &testTargets = useValidationSet ? validationTargets : trainingTargets;
+
+        //We don't need to scale the data as it is already scaled, so make sure scaling is set to off
+        bool tempScalingState = useScaling;
+        useScaling = false;
+        for(UINT i=0; i<numTestingExamples; i++){
+            //Make the prediction
+            feedforward(testInputs[i],&y[0]);
+
+            //Get the class label and the predicted class label
+            UINT classLabel = getMaxIndex(testTargets[i],T) + 1;
+            predictedClassLabel = getMaxIndex(&y[0],T) + 1;
+
+            //Only add the max value if the prediction is correct
+            if( classLabel == predictedClassLabel ){
+                classificationPredictions.push_back( y[predictedClassLabel-1] );
+                averageValue += y[predictedClassLabel-1];
+            }
+        }
+        useScaling = tempScalingState;
+
+        averageValue /= double(classificationPredictions.size());
+        double stdDev = 0;
+        for(UINT i=0; i<classificationPredictions.size(); i++){
+            stdDev += SQR(classificationPredictions[i]-averageValue);
+        }
+        stdDev = sqrt( stdDev / double(classificationPredictions.size()-1) );
+
+        nullRejectionThreshold = averageValue-(stdDev*nullRejectionCoeff);
+    }
+
+    //Flag that the model has been successfully trained
+	trained = true;
+
+    return true;
+}
+
+double MLP::trainNetwork(const Matrix< double > &trainingInputs,const Matrix< double > &trainingTargets,const Matrix< double > &validationInputs,
+                         const Matrix< double > &validationTargets,UINT iter,UINT numThreads,bool &nanFound){
+
+    const UINT M = trainingInputs.getNumRows();
+    const UINT N = numInputNeurons;
+    const UINT T = numOutputNeurons;
+    const UINT numTestingExamples = useValidationSet ? validationInputs.getNumRows() : M;
+    const UINT numChunks = (std::min(batchSize,M) + MLP_GRADIENT_CHUNK_SIZE - 1) / MLP_GRADIENT_CHUNK_SIZE;
     bool keepTraining = true;
     UINT epoch = 0;
     double lastErr = 0;
     double alpha = trainingRate;
 	double beta = momentum;
-    UINT bestIter = 0;
-    MLP bestNetwork;
-    double bestErr = 99e+99;
 	vector< UINT > indexList(M);
-	vector< vector< double > > tempTrainingErrorLog;
-	trainingErrorLog.clear();
-	trainingError = 0;
+    vector< double > trainingExample(N);
+    vector< double > targetVector(T);
+    vector< double > y(T);
+    vector< Gradient > gradients( batchSize > 1 ? numChunks : 0 );
+
+    //The forward and backward pass of each example touches every weight a few times, this sets how many chunks of a mini-batch
+    //each thread needs so that starting it is worth it
+    const unsigned long long chunkWork = (unsigned long long)MLP_GRADIENT_CHUNK_SIZE * 3 * ((N+1)*numHiddenNeurons + (numHiddenNeurons+1)*T);
+    const UINT minChunksPerThread = ParallelFor::getMinTasksPerThread( chunkWork );
+
+    nanFound = false;
+    trainingErrorLog.clear();
+
+    //Randomise the start values of the neurons
+    init(numInputNeurons,numHiddenNeurons,numOutputNeurons,inputLayerActivationFunction,hiddenLayerActivationFunction,outputLayerActivationFunction);
+
+    for(UINT i=0; i<gradients.size(); i++){
+        initGradient( gradients[i] );
+    }
 
     //Reset the indexList, this is used to randomize the order of the training examples, if needed
 	for(UINT i=0; i<M; i++) indexList[i] = i;
-	
-    for(UINT iter=0; iter<numRandomTrainingIterations; iter++){
 
-        lastErr = 0;
-        epoch = 0;
-        keepTraining = true;
-		tempTrainingErrorLog.clear();
-        
-		//Randomise the start values of the neurons
-        init(numInputNeurons,numHiddenNeurons,numOutputNeurons);
-        
-        while( keepTraining ){
-
-			if( randomiseTrainingOrder ){
-				for(UINT i=0; i<M*100; i++){
-					UINT indexA = random.getRandomNumberInt(0, M*2)%M;
-					UINT indexB = random.getRandomNumberInt(0, M*2)%M;
-					UINT temp = indexList[ indexA ];
-					indexList[ indexA ] = indexList[ indexB ];
-					indexList[ indexB ] = temp;
-				}
-			}
-            
-            //Perform one training epoch
-            double error = 0;
+    while( keepTraining ){
+
+        //Shuffle the order of the training examples
+        if( randomiseTrainingOrder ){
+            for(UINT i=M-1; i>0; i--){
+                std::swap( indexList[i], indexList[ random.getRandomNumberInt(0,i+1) ] );
+            }
+        }
+
+        double error = 0;
+        if( batchSize <= 1 ){
+            //Online back propagation, the weights are updated after every example
             for(UINT i=0; i<M; i++){
-                vector< double > trainingExample(N);
-                vector< double > targetVector(T);
-                for(UINT j=0; j<N; j++) trainingExample[j] = trainingData[ indexList[i] ].getInputVectorValue(j);
-                for(UINT j=0; j<T; j++) targetVector[j] = trainingData[ indexList[i] ].getTargetVectorValue(j);
-                
+                std::copy(trainingInputs[ indexList[i] ],trainingInputs[ indexList[i] ]+N,trainingExample.begin());
+                std::copy(trainingTargets[ indexList[i] ],trainingTargets[ indexList[i] ]+T,targetVector.begin());
+
                 double backPropError = back_prop(trainingExample,targetVector,alpha,beta);
 
-				if( classificationModeActive ){
-                    vector< double > y = feedforward(trainingExample);
-                    
-                    //Get the class label
-                    double bestValue = targetVector[0];
-                    UINT bestIndex = 0;
-                    for(UINT i=1; i<targetVector.size(); i++){
-                        if( targetVector[i] > bestValue ){
-                            bestValue = targetVector[i];
-                            bestIndex = i;
-                        }
-                    }
-                    UINT classLabel = bestIndex + 1;
-                    
-                    //Get the predicted class label
-                    bestValue = y[0];
-                    bestIndex = 0;
-                    for(UINT i=1; i<y.size(); i++){
-                        if( y[i] > bestValue ){
-                            bestValue = y[i];
-                            bestIndex = i;
-                        }
-                    }
-                    predictedClassLabel = bestIndex+1;
-                    
-                    if( classLabel != predictedClassLabel ){
+                //In classification mode the error is the number of misclassified examples, using the output of the forward pass in back_prop
+                if( classificationModeActive ){
+                    if( getMaxIndex(&targetVector[0],T) != getMaxIndex(&outputNeuronsOutput[0],T) ){
                         error++;
                     }
-                    
                 }else{
                     error += backPropError;
                 }
 
-				if( checkForNAN() ){
-					keepTraining = false;
-                    errorLog << "train(LabelledRegressionData trainingData) - NaN found!" << endl;
-					break;
-				}
+                if( checkForNAN() ){
+                    nanFound = true;
+                    break;
+                }
             }
+        }else{
+            //Mini-batch gradient descent, the gradient of each batch is summed in chunks (which can be computed in parallel) and the chunks
+            //are then added together in order, so the update does not depend on the number of threads
+            for(UINT batchStart=0; batchStart<M; batchStart+=batchSize){
+                const UINT batchEnd = std::min(batchStart+batchSize,M);
+                const UINT numBatchChunks = (batchEnd - batchStart + MLP_GRADIENT_CHUNK_SIZE - 1) / MLP_GRADIENT_CHUNK_SIZE;
+
+                MLPGradientJob gradientJob(this,trainingInputs,trainingTargets,indexList,batchStart,batchEnd,gradients);
+                ParallelFor::run(gradientJob,numBatchChunks,numThreads,minChunksPerThread);
+
+                for(UINT c=1; c<numBatchChunks; c++){
+                    addGradient(gradients[0],gradients[c]);
+                }
+                error += gradients[0].error;
 
-            double trainingSetClassificationError = 0;
-			double trainingSetRmsError = 0;
-            
-            if( classificationModeActive ) trainingSetClassificationError = (M-error)/double(M);
-            else trainingSetRmsError = sqrt( error / double(M) );
-            
-			if( useValidationSet ){
-				error = 0;
-				//We don't need to scale the validation data as it is already scaled, so make sure scaling is set to off
-				bool tempScalingState = useScaling;
-				useScaling = false;
-				for(UINT i=0; i<validationData.getNumSamples(); i++){
-					vector< double > trainingExample(N);
-					vector< double > targetVector(T);
-					for(UINT j=0; j<N; j++) trainingExample[j] = validationData[i].getInputVectorValue(j);
-					for(UINT j=0; j<T; j++) targetVector[j] = validationData[i].getTargetVectorValue(j);
-                    
-                    vector< double > y = feedforward(trainingExample);
-                    
-                    if( classificationModeActive ){
-                        //Get the class label
-                        double bestValue = targetVector[0];
-                        UINT bestIndex = 0;
-                        for(UINT i=1; i<targetVector.size(); i++){
-                            if( targetVector[i] > bestValue ){
-                                bestValue = targetVector[i];
-                                bestIndex = i;
-                            }
-                        }
-                        UINT classLabel = bestIndex + 1;
-                        
-                        //Get the predicted class label
-                        bestValue = y[0];
-                        bestIndex = 0;
-                        for(UINT i=1; i<y.size(); i++){
-                            if( y[i] > bestValue ){
-                                bestValue = y[i];
-                                bestIndex = i;
-                            }
-                        }
-                        predictedClassLabel = bestIndex+1;
-                        
-                        if( classLabel != predictedClassLabel ){
-                            error++;
-                        }
-                        
-                    }else{
-                        //Update the rms error
-                        for(UINT j=0; j<T; j++){
-                            error += (targetVector[j]-y[j])*(targetVector[j]-y[j]);
-                        }
-                    }
-				}
-                //Reset the scaling flag
-				useScaling = tempScalingState;
-			}
-            
-            //Compute the error of all the training data
-            if( classificationModeActive ){
-                //Compute the classification error
-                double classificationErr = (numTestingExamples-error)/double(numTestingExamples);
-                vector< double > temp(2);
-                temp[0] = trainingSetClassificationError;
-                temp[1] = classificationErr;
-                tempTrainingErrorLog.push_back( temp );
-                
-                if( ++epoch >= maxNumEpochs ){
-                    keepTraining = false;
-                }else{
-                    if( fabs( classificationErr - lastErr ) <= minChange && epoch >= minNumEpochs ){
-                        keepTraining = false;
-                    }
+                //Update the weights with the mean gradient of the batch
+                const double gradientScale = 1.0 / double(batchEnd - batchStart);
+                hiddenLayer.update(gradients[0].hiddenWeights,&gradients[0].hiddenBias[0],alpha,beta,gradientScale);
+                outputLayer.update(gradients[0].outputWeights,&gradients[0].outputBias[0],alpha,beta,gradientScale);
+
+                if( checkForNAN() ){
+                    nanFound = true;
+                    break;
                 }
-                
-                //Update the last error
-                lastErr = classificationErr;
-            }else{
-                //We are in regression mode, so compute the RMS Error
-                double rmsErr = sqrt( error / double(numTestingExamples) );
-                vector< double > temp(2);
-                temp[0] = trainingSetRmsError;
-                temp[1] = rmsErr;
-                tempTrainingErrorLog.push_back( temp );
-                
-                if( ++epoch >= maxNumEpochs ){
-                    keepTraining = false;
+            }
+        }
+
+        if( nanFound ){
+            errorLog << "train(LabelledRegressionData trainingData) - NaN found!" << endl;
+            break;
+        }
+
+        double trainingSetClassificationError = 0;
+        double trainingSetRmsError = 0;
+
+        if( classificationModeActive ) trainingSetClassificationError = error/double(M);
+        else trainingSetRmsError = sqrt( error / double(M) );
+
+        if( useValidationSet ){
+            error = 0;
+            //We don't need to scale the validation data as it is already scaled, so make sure scaling is set to off
+            bool tempScalingState = useScaling;
+            useScaling = false;
+            for(UINT i=0; i<numTestingExamples; i++){
+                const double *target = validationTargets[i];
+
+                feedforward(validationInputs[i],&y[0]);
+
+                if( classificationModeActive ){
+                    if( getMaxIndex(target,T) != getMaxIndex(&y[0],T) ){
+                        error++;
+                    }
                 }else{
-                    if( fabs( rmsErr - lastErr ) <= minChange && epoch >= minNumEpochs ){
-                        keepTraining = false;
+                    //Update the rms error
+                    for(UINT j=0; j<T; j++){
+                        error += (target[j]-y[j])*(target[j]-y[j]);
                     }
                 }
-                
-                //Update the last error
-                lastErr = rmsErr;
             }
-            
-            trainingLog << "Random Training Iteration: " << iter+1 << " Epoch: " << epoch-1 << " Error: " << lastErr << endl;
-            
-        }//End of While( keepTraining )
-        
-        if( lastErr < bestErr ){
-            bestIter = iter;
-			trainingError = bestErr;
-            bestErr = lastErr;
-            bestNetwork = *this;
-			trainingErrorLog = tempTrainingErrorLog;
+            //Reset the scaling flag
+            useScaling = tempScalingState;
         }
 
-    }//End of For( numRandomTrainingIterations )
-    
-    trainingLog << "BestError: " << bestErr << " in Random Training Iteration: " << bestIter+1 << endl;
-
-	//Check to make sure the best network has not got any NaNs in it
-	if( checkForNAN() ){
-        errorLog << "train(LabelledRegressionData trainingData) - NAN Found!" << endl;
-		return false;
-	}
-    
-    //Set the MLP model to the model that best during training
-    *this = bestNetwork;
-    
-    //Compute the rejection threshold
-    if( classificationModeActive ){
-        double averageValue = 0;
-        vector< double > classificationPredictions;
-        
-        for(UINT i=0; i<numTestingExamples; i++){
-            vector< double > inputVector = useValidationSet ? validationData[i].getInputVector() : trainingData[i].getInputVector();
-            vector< double > targetVector = useValidationSet ? validationData[i].getTargetVector() : trainingData[i].getTargetVector();
-            
-            //Make the prediction
-            vector< double > y = feedforward(inputVector);
-            
-            //Get the class label
-            double bestValue = targetVector[0];
-            UINT bestIndex = 0;
-            for(UINT i=1; i<targetVector.size(); i++){
-                if( targetVector[i] > bestValue ){
-                    bestValue = targetVector[i];
-                    bestIndex = i;
+        //Compute the error of the validation data (or the training data if the validation set is not used)
+        if( classificationModeActive ){
+            //Compute the classification error
+            double classificationErr = error/double(numTestingExamples);
+            vector< double > temp(2);
+            temp[0] = trainingSetClassificationError;
+            temp[1] = classificationErr;
+            trainingErrorLog.push_back( temp );
+
+            if( ++epoch >= maxNumEpochs ){
+                keepTraining = false;
+            }else{
+                if( fabs( classificationErr - lastErr ) <= minChange && epoch >= minNumEpochs ){
+                    keepTraining = false;
                 }
             }
-            UINT classLabel = bestIndex + 1;
-            
-            //Get the predicted class label
-            bestValue = y[0];
-            bestIndex = 0;
-            for(UINT i=1; i<y.size(); i++){
-                if( y[i] > bestValue ){
-                    bestValue = y[i];
-                    bestIndex = i;
+
+            //Update the last error
+            lastErr = classificationErr;
+        }else{
+            //We are in regression mode, so compute the RMS Error
+            double rmsErr = sqrt( error / double(numTestingExamples) );
+            vector< double > temp(2);
+            temp[0] = trainingSetRmsError;
+            temp[1] = rmsErr;
+            trainingErrorLog.push_back( temp );
+
+            if( ++epoch >= maxNumEpochs ){
+                keepTraining = false;
+            }else{
+                if( fabs( rmsErr - lastErr ) <= minChange && epoch >= minNumEpochs ){
+                    keepTraining = false;
                 }
             }
-            predictedClassLabel = bestIndex+1;
-            
-            //Only add the max value if the prediction is correct
-            if( classLabel == predictedClassLabel ){
-                classificationPredictions.push_back( bestValue );
-                averageValue += bestValue;
-            }
-        }
-        
-        averageValue /= double(classificationPredictions.size());
-        double stdDev = 0;
-        for(UINT i=0; i<classificationPredictions.size(); i++){
-            stdDev += SQR(classificationPredictions[i]-averageValue);
+
+            //Update the last error
+            lastErr = rmsErr;
         }
-        stdDev = sqrt( stdDev / double(classificationPredictions.size()-1) );
-        
-        nullRejectionThreshold = averageValue-(stdDev*nullRejectionCoeff);
-    }
-    
-    //Flag that the model has been successfully trained
-	trained = true;
 
-    return true;
+        trainingLog << "Random Training Iteration: " << iter+1 << " Epoch: " << epoch-1 << " Error: " << lastErr << endl;
+
+    }//End of While( keepTraining )
+
+    return lastErr;
 }
 
 double MLP::back_prop(vector< double > &trainingExample,vector< double > &targetVector,double alpha,double beta){
     
-    double update = 0;
-    vector< double > inputNeuronsOuput;
-    vector< double > hiddenNeuronsOutput;
-    vector< double > outputNeuronsOutput;
-    vector< double > deltaO(numOutputNeurons);
-    vector< double > deltaH(numHiddenNeurons);
+    deltaO.resize(numOutputNeurons);
+    deltaH.resize(numHiddenNeurons);
     
     //Forward propagation
-    feedforward(trainingExample,inputNeuronsOuput,hiddenNeuronsOutput,outputNeuronsOutput);
+    feedforward(trainingExample,inputNeuronsOutput,hiddenNeuronsOutput,outputNeuronsOutput);
+    
+    //Compute the error of the output and hidden layers
+    computeDeltas(&targetVector[0],&hiddenNeuronsOutput[0],&outputNeuronsOutput[0],&deltaH[0],&deltaO[0]);
+    
+    //Update the hidden and output weights and biases
+    hiddenLayer.update(&inputNeuronsOutput[0],&deltaH[0],alpha,beta);
+    outputLayer.update(&hiddenNeuronsOutput[0],&deltaO[0],alpha,beta);
+    
+    //Compute the error 
+    double error = 0;
+    for(UINT i=0; i<numOutputNeurons; i++){
+        error += (targetVector[i]-outputNeuronsOutput[i]) * (targetVector[i]-outputNeuronsOutput[i]);
+    }
+
+    return error;
+}
+
+void MLP::computeDeltas(const double *targetVector,const double *hiddenNeuronsOutput,const double *outputNeuronsOutput,double *deltaH,double *deltaO) const{
     
     //Compute the error of the output layer: the derivative of the function times the error of the output
     for(UINT i=0; i<numOutputNeurons; i++){
-		deltaO[i] = outputLayer[i].der(outputNeuronsOutput[i]) * (targetVector[i]-outputNeuronsOutput[i]);
+		deltaO[i] = outputLayer.der(i,outputNeuronsOutput[i]) * (targetVector[i]-outputNeuronsOutput[i]);
     }
     
-    //Compute the error of the hidden layer
-    for(UINT i=0; i<numHiddenNeurons; i++){
-        double sum = 0;
-        for(UINT j=0; j<numOutputNeurons; j++){
-            sum += outputLayer[j].weights[i] * deltaO[j];
+    //Compute the error of the hidden layer, the output weights are read one row at a time so the error of every hidden neuron is summed together
+    std::fill(deltaH,deltaH+numHiddenNeurons,0.0);
+    for(UINT j=0; j<numOutputNeurons; j++){
+        const double *w = outputLayer.weights[j];
+        for(UINT i=0; i<numHiddenNeurons; i++){
+            deltaH[i] += w[i] * deltaO[j];
         }
-		deltaH[i] = hiddenLayer[i].der(hiddenNeuronsOutput[i]) * sum;
     }
+    for(UINT i=0; i<numHiddenNeurons; i++){
+		deltaH[i] *= hiddenLayer.der(i,hiddenNeuronsOutput[i]);
+    }
+}
+    
+void MLP::initGradient(Gradient &gradient) const{
+    gradient.hiddenWeights.resize(numHiddenNeurons,numInputNeurons);
+    gradient.hiddenBias.resize(numHiddenNeurons);
+    gradient.outputWeights.resize(numOutputNeurons,numHiddenNeurons);
+    gradient.outputBias.resize(numOutputNeurons);
+    gradient.inputNeuronsOutput.resize(numInputNeurons);
+    gradient.hiddenNeuronsOutput.resize(numHiddenNeurons);
+    gradient.outputNeuronsOutput.resize(numOutputNeurons);
+    gradient.deltaO.resize(numOutputNeurons);
+    gradient.deltaH.resize(numHiddenNeurons);
+    clearGradient(gradient);
+}
+    
+void MLP::clearGradient(Gradient &gradient) const{
+    gradient.hiddenWeights.setAllValues(0);
+    std::fill(gradient.hiddenBias.begin(),gradient.hiddenBias.end(),0.0);
+    gradient.outputWeights.setAllValues(0);
+    std::fill(gradient.outputBias.begin(),gradient.outputBias.end(),0.0);
+    gradient.error = 0;
+}
+    
+void MLP::addGradient(Gradient &gradient,const Gradient &rhs) const{
+    
+    const UINT numHiddenWeights = numHiddenNeurons*numInputNeurons;
+    const UINT numOutputWeights = numOutputNeurons*numHiddenNeurons;
+    double *hiddenWeights = gradient.hiddenWeights.getData();
+    double *outputWeights = gradient.outputWeights.getData();
+    const double *rhsHiddenWeights = rhs.hiddenWeights.getData();
+    const double *rhsOutputWeights = rhs.outputWeights.getData();
+    
+    for(UINT i=0; i<numHiddenWeights; i++) hiddenWeights[i] += rhsHiddenWeights[i];
+    for(UINT i=0; i<numHiddenNeurons; i++) gradient.hiddenBias[i] += rhs.hiddenBias[i];
+    for(UINT i=0; i<numOutputWeights; i++) outputWeights[i] += rhsOutputWeights[i];
+    for(UINT i=0; i<numOutputNeurons; i++) gradient.outputBias[i] += rhs.outputBias[i];
+    gradient.error += rhs.error;
+}
+    
+double MLP::computeGradient(const double *inputVector,const double *targetVector,Gradient &gradient) const{
+    
+    double *inputNeuronsOutput = &gradient.inputNeuronsOutput[0];
+    double *hiddenNeuronsOutput = &gradient.hiddenNeuronsOutput[0];
+    double *outputNeuronsOutput = &gradient.outputNeuronsOutput[0];
     
-    //Update the hidden weights: old hidden weights + (learningRate * inputToTheHiddenNeuron * deltaHidden )
+    //Forward propagation, the network is only read so the gradients of several chunks can be computed at once
+    inputLayer.fireOneToOne(inputVector,inputNeuronsOutput);
+    hiddenLayer.fire(inputNeuronsOutput,hiddenNeuronsOutput);
+    outputLayer.fire(hiddenNeuronsOutput,outputNeuronsOutput);
+    
+    //Compute the error of the output and hidden layers
+    computeDeltas(targetVector,hiddenNeuronsOutput,outputNeuronsOutput,&gradient.deltaH[0],&gradient.deltaO[0]);
+    
+    //Add the gradient of this example to the summed gradients
     for(UINT i=0; i<numHiddenNeurons; i++){
+        double *g = gradient.hiddenWeights[i];
+        const double d = gradient.deltaH[i];
         for(UINT j=0; j<numInputNeurons; j++){
-			//Compute the update
-            update = alpha * (beta * hiddenLayer[i].previousUpdate[j] + (1.0 - beta) * inputNeuronsOuput[j] * deltaH[i]);
-
-			//Update the weights
-			hiddenLayer[i].weights[j] += update;
-
-			//Store the previous update
-			hiddenLayer[i].previousUpdate[j] = update; 
+            g[j] += inputNeuronsOutput[j] * d;
         }
+        gradient.hiddenBias[i] += d;
     }
-    
-    //Update the output weights
     for(UINT i=0; i<numOutputNeurons; i++){
+        double *g = gradient.outputWeights[i];
+        const double d = gradient.deltaO[i];
         for(UINT j=0; j<numHiddenNeurons; j++){
-			//Compute the update
-            update = alpha * (beta * outputLayer[i].previousUpdate[j] + (1.0 - beta) * hiddenNeuronsOutput[j] * deltaO[i]);
-
-			//Update the weights
-			outputLayer[i].weights[j] += update;
-
-			//Store the update
-			outputLayer[i].previousUpdate[j] = update;
-
+            g[j] += hiddenNeuronsOutput[j] * d;
         }
+        gradient.outputBias[i] += d;
     }
     
-    //Update the hidden bias
-    for(UINT i=0; i<numHiddenNeurons; i++){
-		//Compute the update
-		update = alpha * (beta * hiddenLayer[i].previousBiasUpdate + (1.0 - beta) * deltaH[i]);
-
-		//Update the bias
-        hiddenLayer[i].bias += update;
-
-		//Store the update
-		hiddenLayer[i].previousBiasUpdate = update;
-    }
-    
-    //Update the output bias
-    for(UINT i=0; i<numOutputNeurons; i++){
-		//Compute the update
-		update = alpha * (beta * outputLayer[i].previousBiasUpdate + (1.0 - beta) * deltaO[i]);
-
-		//Update the bias
-        outputLayer[i].bias += update;
-		
-		//Stire the update
-		outputLayer[i].previousBiasUpdate = update;
+    //In classification mode the error is the number of misclassified examples, otherwise it is the squared error
+    if( classificationModeActive ){
+        return getMaxIndex(targetVector,numOutputNeurons) != getMaxIndex(outputNeuronsOutput,numOutputNeurons) ? 1.0 : 0.0;
     }
     
-    //Compute the error 
     double error = 0;
     for(UINT i=0; i<numOutputNeurons; i++){
         error += (targetVector[i]-outputNeuronsOutput[i]) * (targetVector[i]-outputNeuronsOutput[i]);
     }
-
     return error;
 }
-
-vector< double > MLP::feedforward(vector< double > trainingExample){
     
-    vector< double > inputNeuronsOuput(numInputNeurons,0);
-    vector< double > hiddenNeuronsOutput(numHiddenNeurons,0);
-    vector< double > outputNeuronsOutput(numOutputNeurons,0);
+UINT MLP::getMaxIndex(const double *x,UINT N){
+    UINT bestIndex = 0;
+    for(UINT i=1; i<N; i++){
+        if( x[i] > x[bestIndex] ){
+            bestIndex = i;
+        }
+    }
+    return bestIndex;
+}
 
-	//Scale the input vector if required
+vector< double > MLP::feedforward(const vector< double > &trainingExample){
+    
+    vector< double > outputVector(numOutputNeurons,0);
+    
+    feedforward(&trainingExample[0],&outputVector[0]);
+    
+    return outputVector;
+}
+    
+void MLP::feedforward(const double *inputVector,double *outputVector){
+    
+    inputNeuronsOutput.resize(numInputNeurons);
+    hiddenNeuronsOutput.resize(numHiddenNeurons);
+    
+    //Scale the input vector if required, the input layer is then fired in place
 	if( useScaling ){
 		for(UINT i=0; i<numInputNeurons; i++){
-			trainingExample[i] = scale(trainingExample[i],inputVectorRanges[i].minValue,inputVectorRanges[i].maxValue,0.0,1.0);
+			inputNeuronsOutput[i] = scale(inputVector[i],inputVectorRanges[i].minValue,inputVectorRanges[i].maxValue,0.0,1.0);
 		}
-	}
+	}else std::copy(inputVector,inputVector+numInputNeurons,inputNeuronsOutput.begin());
     
     //Input layer
-	vector< double > input(1);
-    for(UINT i=0; i<numInputNeurons; i++){
-        input[0] = trainingExample[i];
-        inputNeuronsOuput[i] = inputLayer[i].fire(input);
-    }
+    inputLayer.fireOneToOne(&inputNeuronsOutput[0],&inputNeuronsOutput[0]);
     
     //Hidden Layer
-    for(UINT i=0; i<numHiddenNeurons; i++){
-        hiddenNeuronsOutput[i] = hiddenLayer[i].fire(inputNeuronsOuput);
-    }
+    hiddenLayer.fire(&inputNeuronsOutput[0],&hiddenNeuronsOutput[0]);
     
     //Output Layer
-    for(UINT i=0; i<numOutputNeurons; i++){
-        outputNeuronsOutput[i] = outputLayer[i].fire(hiddenNeuronsOutput);
-    }
+    outputLayer.fire(&hiddenNeuronsOutput[0],outputVector);
 
 	//Scale the output vector if required
 	if( useScaling ){
-		for(unsigned int i=0; i<numOutputNeurons; i++){
-			outputNeuronsOutput[i] = scale(outputNeuronsOutput[i],0.0,1.0,targetVectorRanges[i].minValue,targetVectorRanges[i].maxValue);
+		for(UINT i=0; i<numOutputNeurons; i++){
+			outputVector[i] = scale(outputVector[i],0.0,1.0,targetVectorRanges[i].minValue,targetVectorRanges[i].maxValue);
 		}
 	}
     
-    return outputNeuronsOutput;
-    
 }
 
 void MLP::feedforward(vector< double > &trainingExample,vector< double > &inputNeuronsOuput,
@@ -664,21 +849,13 @@ void MLP::feedforward(vector< double > &trainingExample,vector< double > &inputN
     outputNeuronsOutput.resize(numOutputNeurons,0);
     
     //Input layer
-	vector< double > input(1);
-    for(UINT i=0; i<numInputNeurons; i++){
-        input[0] = trainingExample[i];
-        inputNeuronsOuput[i] = inputLayer[i].fire(input);
-    }
+    inputLayer.fireOneToOne(&trainingExample[0],&inputNeuronsOuput[0]);
     
     //Hidden Layer
-    for(UINT i=0; i<numHiddenNeurons; i++){
-        hiddenNeuronsOutput[i] = hiddenLayer[i].fire(inputNeuronsOuput);
-    }
+    hiddenLayer.fire(&inputNeuronsOuput[0],&hiddenNeuronsOutput[0]);
     
     //Output Layer
-    for(UINT i=0; i<numOutputNeurons; i++){
-        outputNeuronsOutput[i] = outputLayer[i].fire(hiddenNeuronsOutput);
-    }
+    outputLayer.fire(&hiddenNeuronsOutput[0],&outputNeuronsOutput[0]);
     
 }
 
@@ -690,25 +867,25 @@ void MLP::printNetwork(){
     
     cout<<"InputWeights:\n";
     for(UINT i=0; i<numInputNeurons; i++){
-        cout<<"Neuron: "<<i<<" Bias: " << inputLayer[i].bias << " Weights: ";
-        for(UINT j=0; j<inputLayer[i].weights.size(); j++){
-            cout<<inputLayer[i].weights[j]<<"\t";
+        cout<<"Neuron: "<<i<<" Bias: " << inputLayer.bias[i] << " Weights: ";
+        for(UINT j=0; j<inputLayer.numInputs; j++){
+            cout<<inputLayer.weights[i][j]<<"\t";
         }cout<<endl;
     }
     
     cout<<"HiddenWeights:\n";
     for(UINT i=0; i<numHiddenNeurons; i++){
-        cout<<"Neuron: "<<i<<" Bias: " << hiddenLayer[i].bias << " Weights: ";
-        for(UINT j=0; j<hiddenLayer[i].weights.size(); j++){
-            cout<<hiddenLayer[i].weights[j]<<"\t";
+        cout<<"Neuron: "<<i<<" Bias: " << hiddenLayer.bias[i] << " Weights: ";
+        for(UINT j=0; j<hiddenLayer.numInputs; j++){
+            cout<<hiddenLayer.weights[i][j]<<"\t";
         }cout<<endl;
     }
     
     cout<<"OutputWeights:\n";
     for(UINT i=0; i<numOutputNeurons; i++){
-        cout<<"Neuron: "<<i<<" Bias: " << outputLayer[i].bias << " Weights: ";
-        for(UINT j=0; j<outputLayer[i].weights.size(); j++){
-            cout<<outputLayer[i].weights[j]<<"\t";
+        cout<<"Neuron: "<<i<<" Bias: " << outputLayer.bias[i] << " Weights: ";
+        for(UINT j=0; j<outputLayer.numInputs; j++){
+            cout<<outputLayer.weights[i][j]<<"\t";
         }cout<<endl;
     }
     
@@ -716,26 +893,9 @@ void MLP::printNetwork(){
 
 bool MLP::checkForNAN(){
     
-    for(UINT i=0; i<numInputNeurons; i++){
-        if( isNAN(inputLayer[i].bias) ) return true;
-        for(UINT j=0; j<inputLayer[i].weights.size(); j++){
-            if( isNAN(inputLayer[i].weights[j]) ) return true;
-        }
-    }
-    
-    for(UINT i=0; i<numHiddenNeurons; i++){
-        if( isNAN(hiddenLayer[i].bias) ) return true;
-        for(UINT j=0; j<hiddenLayer[i].weights.size(); j++){
-            if( isNAN(hiddenLayer[i].weights[j]) ) return true;
-        }
-    }
-    
-    for(UINT i=0; i<numOutputNeurons; i++){
-        if( isNAN(outputLayer[i].bias) ) return true;
-        for(UINT j=0; j<outputLayer[i].weights.size(); j++){
-            if( isNAN(outputLayer[i].weights[j]) ) return true;
-        }
-    }
+    if( inputLayer.checkForNAN() ) return true;
+    if( hiddenLayer.checkForNAN() ) return true;
+    if( outputLayer.checkForNAN() ) return true;
     
     return false;
 }
@@ -785,12 +945,12 @@ bool MLP::saveMLPToFile(string fileName){
 	file << "InputLayer: \n";
 	for(UINT i=0; i<numInputNeurons; i++){
 		file << "InputNeuron: " << i+1 << endl;
-		file << "NumInputs: " << inputLayer[i].numInputs << endl;
-		file << "Bias: " << inputLayer[i].bias << endl;
-		file << "Gamma: " << inputLayer[i].gamma << endl;
+		file << "NumInputs: " << inputLayer.numInputs << endl;
+		file << "Bias: " << inputLayer.bias[i] << endl;
+		file << "Gamma: " << inputLayer.gamma[i] << endl;
 		file << "Weights: " << endl;
-		for(UINT j=0; j<inputLayer[i].numInputs; j++){
-			file << inputLayer[i].weights[j] << "\t";
+		for(UINT j=0; j<inputLayer.numInputs; j++){
+			file << inputLayer.weights[i][j] << "\t";
 		}
 		file << endl;
 	}
@@ -799,12 +959,12 @@ bool MLP::saveMLPToFile(string fileName){
 	file << "HiddenLayer: \n";
 	for(UINT i=0; i<numHiddenNeurons; i++){
 		file << "HiddenNeuron: " << i+1 << endl;
-		file << "NumInputs: " << hiddenLayer[i].numInputs << endl;
-		file << "Bias: " << hiddenLayer[i].bias << endl;
-		file << "Gamma: " << hiddenLayer[i].gamma << endl;
+		file << "NumInputs: " << hiddenLayer.numInputs << endl;
+		file << "Bias: " << hiddenLayer.bias[i] << endl;
+		file << "Gamma: " << hiddenLayer.gamma[i] << endl;
 		file << "Weights: " << endl;
-		for(UINT j=0; j<hiddenLayer[i].numInputs; j++){
-			file << hiddenLayer[i].weights[j] << "\t";
+		for(UINT j=0; j<hiddenLayer.numInputs; j++){
+			file << hiddenLayer.weights[i][j] << "\t";
 		}
 		file << endl;
 	}
@@ -813,12 +973,12 @@ bool MLP::saveMLPToFile(string fileName){
 	file << "OutputLayer: \n";
 	for(UINT i=0; i<numOutputNeurons; i++){
 		file << "OutputNeuron: " << i+1 << endl;
-		file << "NumInputs: " << outputLayer[i].numInputs << endl;
-		file << "Bias: " << outputLayer[i].bias << endl;
-		file << "Gamma: " << outputLayer[i].gamma << endl;
+		file << "NumInputs: " << outputLayer.numInputs << endl;
+		file << "Bias: " << outputLayer.bias[i] << endl;
+		file << "Gamma: " << outputLayer.gamma[i] << endl;
 		file << "Weights: " << endl;
-		for(UINT j=0; j<outputLayer[i].numInputs; j++){
-			file << outputLayer[i].weights[j] << "\t";
+		for(UINT j=0; j<outputLayer.numInputs; j++){
+			file << outputLayer.weights[i][j] << "\t";
 		}
 		file << endl;
 	}
@@ -1030,10 +1190,10 @@ bool MLP::loadMLPFromFile(string fileName){
 	}
 	file >> nullRejectionThreshold;
 
-	//Resize the layers
-	inputLayer.resize( numInputNeurons );
-	hiddenLayer.resize( numHiddenNeurons );
-	outputLayer.resize( numOutputNeurons );
+	//Resize the layers, each input neuron has one input, each hidden neuron is connected to every input neuron and each output neuron to every hidden neuron
+	inputLayer.resize( numInputNeurons, 1, inputLayerActivationFunction, gamma );
+	hiddenLayer.resize( numHiddenNeurons, numInputNeurons, hiddenLayerActivationFunction, gamma );
+	outputLayer.resize( numOutputNeurons, numHiddenNeurons, outputLayerActivationFunction, gamma );
 
 	//Load the neuron data
 	file >> word;
@@ -1066,10 +1226,13 @@ bool MLP::loadMLPFromFile(string fileName){
 			cout<<"ERROR: FAILED TO FIND NumInputs\n";
 			return false;
 		}
-		file >> inputLayer[i].numInputs;
-
-		//Resize the buffers
-		inputLayer[i].weights.resize( inputLayer[i].numInputs );
+		UINT numInputs = 0;
+		file >> numInputs;
+		if( numInputs != inputLayer.numInputs ){
+			file.close();
+			cout<<"ERROR: NumInputs does not match the size of the network!\n";
+			return false;
+		}
 
 		file >> word;
 		if(word != "Bias:"){
@@ -1077,7 +1240,7 @@ bool MLP::loadMLPFromFile(string fileName){
 			cout<<"ERROR: FAILED TO FIND Bias\n";
 			return false;
 		}
-		file >> inputLayer[i].bias;
+		file >> inputLayer.bias[i];
 
 		file >> word;
 		if(word != "Gamma:"){
@@ -1085,7 +1248,7 @@ bool MLP::loadMLPFromFile(string fileName){
 			cout<<"ERROR: FAILED TO FIND Gamma\n";
 			return false;
 		}
-		file >> inputLayer[i].gamma;
+		file >> inputLayer.gamma[i];
 
 		file >> word;
 		if(word != "Weights:"){
@@ -1094,8 +1257,8 @@ bool MLP::loadMLPFromFile(string fileName){
 			return false;
 		}
 
-		for(UINT j=0; j<inputLayer[i].numInputs; j++){
-			file >> inputLayer[i].weights[j];
+		for(UINT j=0; j<inputLayer.numInputs; j++){
+			file >> inputLayer.weights[i][j];
 		}
 	}
 
@@ -1130,10 +1293,13 @@ bool MLP::loadMLPFromFile(string fileName){
 			cout<<"ERROR: FAILED TO FIND NumInputs\n";
 			return false;
 		}
-		file >> hiddenLayer[i].numInputs;
-
-		//Resize the buffers
-		hiddenLayer[i].weights.resize( hiddenLayer[i].numInputs );
+		UINT numInputs = 0;
+		file >> numInputs;
+		if( numInputs != hiddenLayer.numInputs ){
+			file.close();
+			cout<<"ERROR: NumInputs does not match the size of the network!\n";
+			return false;
+		}
 
 		file >> word;
 		if(word != "Bias:"){
@@ -1141,7 +1307,7 @@ bool MLP::loadMLPFromFile(string fileName){
 			cout<<"ERROR: FAILED TO FIND Bias\n";
 			return false;
 		}
-		file >> hiddenLayer[i].bias;
+		file >> hiddenLayer.bias[i];
 
 		file >> word;
 		if(word != "Gamma:"){
@@ -1149,7 +1315,7 @@ bool MLP::loadMLPFromFile(string fileName){
 			cout<<"ERROR: FAILED TO FIND Gamma\n";
 			return false;
 		}
-		file >> hiddenLayer[i].gamma;
+		file >> hiddenLayer.gamma[i];
 
 		file >> word;
 		if(word != "Weights:"){
@@ -1158,8 +1324,8 @@ bool MLP::loadMLPFromFile(string fileName){
 			return false;
 		}
 
-		for(unsigned int j=0; j<hiddenLayer[i].numInputs; j++){
-			file >> hiddenLayer[i].weights[j];
+		for(UINT j=0; j<hiddenLayer.numInputs; j++){
+			file >> hiddenLayer.weights[i][j];
 		}
 	}
 
@@ -1194,10 +1360,13 @@ bool MLP::loadMLPFromFile(string fileName){
 			cout<<"ERROR: FAILED TO FIND NumInputs\n";
 			return false;
 		}
-		file >> outputLayer[i].numInputs;
-
-		//Resize the buffers
-		outputLayer[i].weights.resize( outputLayer[i].numInputs );
+		UINT numInputs = 0;
+		file >> numInputs;
+		if( numInputs != outputLayer.numInputs ){
+			file.close();
+			cout<<"ERROR: NumInputs does not match the size of the network!\n";
+			return false;
+		}
 
 		file >> word;
 		if(word != "Bias:"){
@@ -1205,7 +1374,7 @@ bool MLP::loadMLPFromFile(string fileName){
 			cout<<"ERROR: FAILED TO FIND Bias\n";
 			return false;
 		}
-		file >> outputLayer[i].bias;
+		file >> outputLayer.bias[i];
 
 		file >> word;
 		if(word != "Gamma:"){
@@ -1213,7 +1382,7 @@ bool MLP::loadMLPFromFile(string fileName){
 			cout<<"ERROR: FAILED TO FIND Gamma\n";
 			return false;
 		}
-		file >> outputLayer[i].gamma;
+		file >> outputLayer.gamma[i];
 
 		file >> word;
 		if(word != "Weights:"){
@@ -1222,8 +1391,8 @@ bool MLP::loadMLPFromFile(string fileName){
 			return false;
 		}
 
-		for(UINT j=0; j<outputLayer[i].numInputs; j++){
-			file >> outputLayer[i].weights[j];
+		for(UINT j=0; j<outputLayer.numInputs; j++){
+			file >> outputLayer.weights[i][j];
 		}
 	}
 
@@ -1347,6 +1516,15 @@ bool MLP::setUseMultiThreadingTraining(bool useMultiThreadingTraining){
     this->useMultiThreadingTraining = useMultiThreadingTraining;
     return true;
 }
+
+bool MLP::setBatchSize(UINT batchSize){
+    if( batchSize > 0 ){
+        this->batchSize = batchSize;
+        return true;
+    }
+    return false;
+}
+    
 bool MLP::setMinNumEpochs(UINT minNumEpochs){
     if( minNumEpochs > 0 ){
         this->minNumEpochs = minNumEpochs;
@@ -20,7 +20,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-#include "Neuron.h"
+#include "NeuronLayer.h"
 #include "../../../DataStructures/LabelledRegressionData.h"
 #include "../../../GestureRecognitionPipeline/Regressifier.h"
 
@@ -51,6 +51,7 @@ public:
             this->useValidationSet = rhs.useValidationSet;
             this->randomiseTrainingOrder = rhs.randomiseTrainingOrder;
             this->useMultiThreadingTraining = rhs.useMultiThreadingTraining;
+            this->batchSize = rhs.batchSize;
             this->initialized = rhs.initialized;
             this->inputLayer = rhs.inputLayer;
             this->hiddenLayer = rhs.hiddenLayer;
@@ -106,6 +107,7 @@ public:
         this->useValidationSet = ptr->useValidationSet;
         this->randomiseTrainingOrder = ptr->randomiseTrainingOrder;
         this->useMultiThreadingTraining = ptr->useMultiThreadingTraining;
+        this->batchSize = ptr->batchSize;
         this->initialized = ptr->initialized;
         this->classificationModeActive = ptr->classificationModeActive;
         this->useNullRejection = ptr->useNullRejection;
@@ -131,7 +133,14 @@ public:
     }
     bool train(LabelledClassificationData &trainingData);
     bool train(LabelledRegressionData &trainingData);
-    bool predict(vector< double > inputVector);
+    bool predict(const vector< double > &inputVector);
+    
+    //Maps each row of the inputData through the network.  The rows are run in tiles, and each layer is computed for every row of
+    //the tile before moving on to the next layer, so the weights of each neuron are read once per tile rather than once per row
+    bool predictBatch(const Matrix<double> &inputData,Matrix<double> &outputData);
+    
+    //Predicts the class of each row of the inputData, this can only be used if the MLP was trained in classification mode
+    bool predictBatch(const Matrix<double> &inputData,vector< UINT > &predictedClassLabels,Matrix<double> &likelihoods);
     bool saveModelToFile(string filename){ return saveMLPToFile(filename); }
     bool loadModelFromFile(string filename){ return loadMLPFromFile(filename); }
     UINT getNumClasses(){ if( classificationModeActive ){ return numOutputNeurons; } else return 0; }
@@ -141,7 +150,7 @@ public:
     void clear();
     
     double back_prop(vector< double > &trainingExample,vector< double > &targetVector,double alpha,double beta);
-    vector< double > feedforward(vector< double > trainingExample);
+    vector< double > feedforward(const vector< double > &trainingExample);
     void feedforward(vector< double > &trainingExample,vector< double > &inputNeuronsOuput,
                      vector< double > &hiddenNeuronsOutput,vector< double > &outputNeuronsOutput);
     void printNetwork();
@@ -171,13 +180,15 @@ public:
 	double getTrainingError(){ return trainingError; }
 	bool getUseValidationSet(){ return useValidationSet; }
 	bool getRandomiseTrainingOrder(){ return randomiseTrainingOrder; }
+    bool getUseMultiThreadingTraining(){ return useMultiThreadingTraining; }
+    UINT getBatchSize(){ return batchSize; }
     bool getUseNullRejection(){ return useNullRejection; }
 	bool getTrainingStatus(){ return trained; }
     bool getClassificationModeActive(){ return classificationModeActive; }
     bool getRegressionModeActive(){ return !classificationModeActive; }
-	vector< Neuron > getInputLayer(){ return inputLayer; }
-	vector< Neuron > getHiddenLayer(){ return hiddenLayer; }
-	vector< Neuron > getOutputLayer(){ return outputLayer; }
+	vector< Neuron > getInputLayer(){ return inputLayer.getNeurons(); }
+	vector< Neuron > getHiddenLayer(){ return hiddenLayer.getNeurons(); }
+	vector< Neuron > getOutputLayer(){ return outputLayer.getNeurons(); }
 	vector< MinMax > getInputRanges(){ return inputVectorRanges; }
 	vector< MinMax > getOutputRanges(){ return targetVectorRanges; }
 	vector< vector< double > > getTrainingLog(){ return trainingErrorLog; }
@@ -211,7 +222,14 @@ public:
 	bool setGamma(double gamma);
 	bool setUseValidationSet(bool useValidationSet);
 	bool setRandomiseTrainingOrder(bool randomiseTrainingOrder);
+    
+    //If multi threading is used then the random training iterations are trained in parallel, if there is only one random training
+    //iteration then the gradients of each mini-batch are computed in parallel instead
     bool setUseMultiThreadingTraining(bool useMultiThreadingTraining);
+    
+    //Sets the number of training examples used for each weight update, a batch size of 1 updates the weights after every example
+    //(online back propagation), a larger batch size averages the gradients of the batch before each update
+    bool setBatchSize(UINT batchSize);
     bool setMinNumEpochs(UINT minNumEpochs);
     bool setMaxNumEpochs(UINT maxNumEpochs);
     bool setNumRandomTrainingIterations(UINT numRandomTrainingIterations);
@@ -222,6 +240,35 @@ public:
     bool setNullRejectionCoeff(double nullRejectionCoeff){ if( nullRejectionCoeff > 0 ){ this->nullRejectionCoeff = nullRejectionCoeff; return true; } return false; }
     
 private:
+    void predictFromClassLikelihoods();
+    
+    //Maps the inputVector through the network into the outputVector, scaling the input and output if required
+    void feedforward(const double *inputVector,double *outputVector);
+    
+    //The summed gradients of a chunk of training examples, along with the buffers used to compute them
+    struct Gradient{
+        Matrix< double > hiddenWeights;
+        vector< double > hiddenBias;
+        Matrix< double > outputWeights;
+        vector< double > outputBias;
+        vector< double > inputNeuronsOutput;
+        vector< double > hiddenNeuronsOutput;
+        vector< double > outputNeuronsOutput;
+        vector< double > deltaO;
+        vector< double > deltaH;
+        double error;
+    };
+    
+    //Trains this network from new random weights, this is run once for each random training iteration and returns the final error
+    double trainNetwork(const Matrix< double > &trainingInputs,const Matrix< double > &trainingTargets,const Matrix< double > &validationInputs,
+                        const Matrix< double > &validationTargets,UINT iter,UINT numThreads,bool &nanFound);
+    void initGradient(Gradient &gradient) const;
+    void clearGradient(Gradient &gradient) const;
+    void addGradient(Gradient &gradient,const Gradient &rhs) const;
+    double computeGradient(const double *inputVector,const double *targetVector,Gradient &gradient) const;
+    void computeDeltas(const double *targetVector,const double *hiddenNeuronsOutput,const double *outputNeuronsOutput,double *deltaH,double *deltaO) const;
+    static UINT getMaxIndex(const double *x,UINT N);
+    
     UINT numInputNeurons;
     UINT numHiddenNeurons;
     UINT numOutputNeurons;
@@ -241,15 +288,23 @@ private:
 	bool useValidationSet;
 	bool randomiseTrainingOrder;
     bool useMultiThreadingTraining;
+    UINT batchSize;
     Random random;
     
-    vector< Neuron > inputLayer;
-    vector< Neuron > hiddenLayer;
-    vector< Neuron > outputLayer;
+    NeuronLayer inputLayer;
+    NeuronLayer hiddenLayer;
+    NeuronLayer outputLayer;
 	vector< MinMax > inputVectorRanges;
 	vector< MinMax > targetVectorRanges;
 	vector< vector< double > > trainingErrorLog;
     
+    //The outputs and errors of each layer, these are kept between calls so feedforward and back_prop do not allocate memory
+    vector< double > inputNeuronsOutput;
+    vector< double > hiddenNeuronsOutput;
+    vector< double > outputNeuronsOutput;
+    vector< double > deltaO;
+    vector< double > deltaH;
+    
     //Classifier Variables
     bool classificationModeActive;
     bool useNullRejection;
@@ -261,6 +316,9 @@ private:
     
     static RegisterRegressifierModule< MLP > registerModule;
     
+    friend class MLPTrainingJob;
+    friend class MLPGradientJob;
+    
 };
 
 } //End of namespace GRT
\ No newline at end of file
@@ -60,6 +60,10 @@ void Neuron::clear(){
 }
 
 double Neuron::fire(vector< double > &inputs){
+    return fire( &inputs[0] );
+}
+    
+double Neuron::fire(const double *inputs) const{
     
     double y = 0;
     for(UINT i=0; i<numInputs; i++){
@@ -68,6 +72,15 @@ double Neuron::fire(vector< double > &inputs){
     
     y += bias;
     
+    return activation(y,activationFunction,gamma);
+}
+
+double Neuron::der(double y){
+    return derivative(y,activationFunction,gamma);
+}
+    
+double Neuron::activation(double y,UINT activationFunction,double gamma){
+    
     switch( activationFunction ){
         case(LINEAR):
             break;
@@ -91,7 +104,7 @@ double Neuron::fire(vector< double > &inputs){
     
 }
 
-double Neuron::der(double y){
+double Neuron::derivative(double y,UINT activationFunction,double gamma){
 
 	double yy = 0;
 	switch( activationFunction ){
@@ -32,9 +32,14 @@ public:
     void init(UINT numInputs,UINT actvationFunction);
     void clear();
     double fire(vector< double > &inputs);
+    double fire(const double *inputs) const;
 	double der(double y);
 	bool validateActivationFunction(UINT actvationFunction);
     
+    //The activation functions and their derivatives, these are shared with the NeuronLayer so both compute the same values
+    static double activation(double y,UINT activationFunction,double gamma);
+    static double derivative(double y,UINT activationFunction,double gamma);
+    
 	double gamma;
     double bias;
 	double previousBiasUpdate;
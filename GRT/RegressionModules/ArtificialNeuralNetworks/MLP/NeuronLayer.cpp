@@ -0,0 +1,219 @@
+/*
+GRT MIT License
+Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without restriction, 
+including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial 
+portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT 
+LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "NeuronLayer.h"
+#include "../../../Util/DistanceKernels.h"
+
+namespace GRT{
+    
+//The number of neurons whose weights are kept in the cache while a batch of inputs is run through them
+#define NEURON_LAYER_BLOCK_SIZE 32
+
+NeuronLayer::NeuronLayer():numNeurons(0),numInputs(0),activationFunction(Neuron::LINEAR){
+    
+}
+
+NeuronLayer::~NeuronLayer(){}
+
+bool NeuronLayer::init(UINT numNeurons,UINT numInputs,UINT activationFunction,double gamma,Random &random){
+    
+    if( !resize(numNeurons,numInputs,activationFunction,gamma) ) return false;
+    
+    for(UINT i=0; i<numNeurons; i++){
+        //Randomise the weights between [-0.1 0.1]
+        for(UINT j=0; j<numInputs; j++){
+            weights[i][j] = random.getRandomNumberUniform(-0.1,0.1);
+        }
+        
+        //Randomise the bias between [-1.0 1.0]
+        bias[i] = random.getRandomNumberUniform(-1.0,1.0);
+    }
+    
+    return true;
+}
+
+bool NeuronLayer::resize(UINT numNeurons,UINT numInputs,UINT activationFunction,double gamma){
+    
+    clear();
+    
+    if( numNeurons == 0 || numInputs == 0 ) return false;
+    
+    this->numNeurons = numNeurons;
+    this->numInputs = numInputs;
+    this->activationFunction = activationFunction;
+    
+    weights.resize(numNeurons,numInputs);
+    weights.setAllValues(0);
+    previousUpdate.resize(numNeurons,numInputs);
+    previousUpdate.setAllValues(0);
+    bias.resize(numNeurons,0);
+    this->gamma.resize(numNeurons,gamma);
+    previousBiasUpdate.resize(numNeurons,0);
+    
+    return true;
+}
+
+void NeuronLayer::clear(){
+    numNeurons = 0;
+    numInputs = 0;
+    weights.clear();
+    previousUpdate.clear();
+    bias.clear();
+    gamma.clear();
+    previousBiasUpdate.clear();
+}
+
+void NeuronLayer::fire(const double *inputs,double *outputs) const{
+    
+    for(UINT i=0; i<numNeurons; i++){
+        outputs[i] = DistanceKernels::dot(inputs,weights[i],numInputs) + bias[i];
+    }
+    
+    applyActivationFunction( outputs );
+}
+
+void NeuronLayer::fire(const Matrix< double > &inputs,UINT numRows,Matrix< double > &outputs) const{
+    
+    //Each block of neurons is run over every row before moving to the next block, so the weights of the block are only loaded once
+    for(UINT blockStart=0; blockStart<numNeurons; blockStart+=NEURON_LAYER_BLOCK_SIZE){
+        const UINT blockEnd = blockStart + NEURON_LAYER_BLOCK_SIZE < numNeurons ? blockStart + NEURON_LAYER_BLOCK_SIZE : numNeurons;
+        for(UINT r=0; r<numRows; r++){
+            const double *x = inputs[r];
+            double *y = outputs[r];
+            for(UINT i=blockStart; i<blockEnd; i++){
+                y[i] = DistanceKernels::dot(x,weights[i],numInputs) + bias[i];
+            }
+        }
+    }
+    
+    for(UINT r=0; r<numRows; r++){
+        applyActivationFunction( outputs[r] );
+    }
+}
+
+void NeuronLayer::fireOneToOne(const double *inputs,double *outputs) const{
+    
+    for(UINT i=0; i<numNeurons; i++){
+        outputs[i] = inputs[i] * weights[i][0] + bias[i];
+    }
+    
+    applyActivationFunction( outputs );
+}
+
+void NeuronLayer::applyActivationFunction(double *y) const{
+    
+    //The linear activation function leaves y unchanged, so there is nothing to do
+    if( activationFunction == Neuron::LINEAR ) return;
+    
+    for(UINT i=0; i<numNeurons; i++){
+        y[i] = Neuron::activation(y[i],activationFunction,gamma[i]);
+    }
+}
+
+//Applies w += update and stores the update, where update = a * previous + b * x
+static inline void updateRow(double *w,double *previous,const double *x,const double a,const double b,const UINT N){
+    UINT j = 0;
+#ifdef __GRT_SSE2__
+    const __m128d va = _mm_set1_pd( a );
+    const __m128d vb = _mm_set1_pd( b );
+    for(; j+2<=N; j+=2){
+        const __m128d update = _mm_add_pd( _mm_mul_pd( va, _mm_loadu_pd(previous+j) ), _mm_mul_pd( vb, _mm_loadu_pd(x+j) ) );
+        _mm_storeu_pd( w+j, _mm_add_pd( _mm_loadu_pd(w+j), update ) );
+        _mm_storeu_pd( previous+j, update );
+    }
+#endif
+    for(; j<N; j++){
+        const double update = a * previous[j] + b * x[j];
+        w[j] += update;
+        previous[j] = update;
+    }
+}
+
+void NeuronLayer::update(const double *inputs,const double *delta,double alpha,double beta){
+    
+    const double a = alpha * beta;
+    
+    for(UINT i=0; i<numNeurons; i++){
+        const double b = alpha * (1.0 - beta) * delta[i];
+        
+        //Update the weights: old weights + (learningRate * inputToTheNeuron * delta), with the momentum of the previous update
+        updateRow(weights[i],previousUpdate[i],inputs,a,b,numInputs);
+        
+        //Update the bias
+        const double update = a * previousBiasUpdate[i] + b;
+        bias[i] += update;
+        previousBiasUpdate[i] = update;
+    }
+}
+    
+void NeuronLayer::update(const Matrix< double > &weightGradients,const double *biasGradients,double alpha,double beta,double gradientScale){
+    
+    const double a = alpha * beta;
+    const double b = alpha * (1.0 - beta) * gradientScale;
+    
+    for(UINT i=0; i<numNeurons; i++){
+        //Update the weights: old weights + (learningRate * gradient), with the momentum of the previous update
+        updateRow(weights[i],previousUpdate[i],weightGradients[i],a,b,numInputs);
+        
+        //Update the bias
+        const double update = a * previousBiasUpdate[i] + b * biasGradients[i];
+        bias[i] += update;
+        previousBiasUpdate[i] = update;
+    }
+}
+
+bool NeuronLayer::checkForNAN() const{
+    
+    for(UINT i=0; i<numNeurons; i++){
+        if( bias[i] != bias[i] ) return true;
+        for(UINT j=0; j<numInputs; j++){
+            if( weights[i][j] != weights[i][j] ) return true;
+        }
+    }
+    
+    return false;
+}
+
+Neuron NeuronLayer::getNeuron(UINT neuronIndex) const{
+    
+    Neuron neuron;
+    neuron.numInputs = numInputs;
+    neuron.activationFunction = activationFunction;
+    neuron.bias = bias[neuronIndex];
+    neuron.gamma = gamma[neuronIndex];
+    neuron.previousBiasUpdate = previousBiasUpdate[neuronIndex];
+    neuron.weights.assign(weights[neuronIndex],weights[neuronIndex]+numInputs);
+    neuron.previousUpdate.assign(previousUpdate[neuronIndex],previousUpdate[neuronIndex]+numInputs);
+    
+    return neuron;
+}
+
+vector< Neuron > NeuronLayer::getNeurons() const{
+    
+    vector< Neuron > neurons(numNeurons);
+    for(UINT i=0; i<numNeurons; i++){
+        neurons[i] = getNeuron(i);
+    }
+    
+    return neurons;
+}
+
+}//End of namespace GRT
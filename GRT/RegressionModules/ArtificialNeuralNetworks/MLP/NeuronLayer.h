@@ -0,0 +1,81 @@
+/*
+GRT MIT License
+Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without restriction, 
+including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial 
+portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT 
+LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "Neuron.h"
+#include "../../../DataStructures/Matrix.h"
+
+namespace GRT{
+
+/**
+ A NeuronLayer stores every neuron in one layer of an MLP.  The weights of the layer are kept in one contiguous matrix, with one row
+ per neuron, so the outputs of the whole layer are computed as a matrix-vector product (or a matrix-matrix product for a batch of
+ inputs) rather than by firing each neuron on its own.
+*/
+class NeuronLayer{
+public:
+    NeuronLayer();
+    ~NeuronLayer();
+    
+    //Sets the size of the layer and randomises the weights and biases
+    bool init(UINT numNeurons,UINT numInputs,UINT activationFunction,double gamma,Random &random);
+    
+    //Sets the size of the layer without setting the weights, this is used when the weights are loaded from a file
+    bool resize(UINT numNeurons,UINT numInputs,UINT activationFunction,double gamma);
+    void clear();
+    
+    //Computes outputs[i] = f( weights[i] . inputs + bias[i] ) for each neuron i
+    void fire(const double *inputs,double *outputs) const;
+    
+    //Computes the outputs for the first numRows rows of the inputs, with one output row per input row
+    void fire(const Matrix< double > &inputs,UINT numRows,Matrix< double > &outputs) const;
+    
+    //Computes outputs[i] = f( weights[i][0] * inputs[i] + bias[i] ), this is used by the input layer where each neuron only sees one input
+    void fireOneToOne(const double *inputs,double *outputs) const;
+    
+    double der(UINT neuronIndex,double y) const{ return Neuron::derivative(y,activationFunction,gamma[neuronIndex]); }
+    
+    //Applies one momentum update to the weights and biases, delta holds the error of each neuron and inputs the input to the layer
+    void update(const double *inputs,const double *delta,double alpha,double beta);
+    
+    //Applies one momentum update from the summed gradients of a mini-batch, the gradients are multiplied by gradientScale (one over the batch size)
+    void update(const Matrix< double > &weightGradients,const double *biasGradients,double alpha,double beta,double gradientScale);
+    bool checkForNAN() const;
+    
+    //Gets a copy of one neuron in the layer, or of every neuron in the layer
+    Neuron getNeuron(UINT neuronIndex) const;
+    vector< Neuron > getNeurons() const;
+    
+    UINT numNeurons;
+    UINT numInputs;
+    UINT activationFunction;
+    Matrix< double > weights;               //The weights of the layer, with one row of numInputs weights per neuron
+    vector< double > bias;
+    vector< double > gamma;
+    Matrix< double > previousUpdate;        //The last weight update of each neuron, used for the momentum term of back_prop
+    vector< double > previousBiasUpdate;
+    
+protected:
+    void applyActivationFunction(double *y) const;
+};
+
+}//End of namespace GRT
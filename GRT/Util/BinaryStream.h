@@ -0,0 +1,174 @@
+/*
+GRT MIT License
+Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <string.h>
+
+#define GRT_BINARY_CHECKSUM_SEED 14695981039346656037ULL        //The FNV-1a 64 bit offset basis, the checksum of an empty block
+#define GRT_BINARY_CHECKSUM_PRIME 1099511628211ULL              //The FNV-1a 64 bit prime
+
+namespace GRT{
+
+/**
+ A BinaryWriter writes values to a binary file in the byte order of the machine. Strings and vectors are written as a 32 bit length
+ followed by their values, and arrays of doubles are aligned to 8 bytes from the position the writer was created at, so a BinaryReader
+ can return them as pointers into a memory mapped copy of the file (as long as the writer was created at an aligned position).
+*/
+class BinaryWriter{
+public:
+    BinaryWriter(std::fstream &file):file(file){ startPosition = file.tellp(); }
+    ~BinaryWriter(){}
+
+    void write(const void *data,unsigned long long numBytes){ file.write((const char*)data,(std::streamsize)numBytes); }
+    void write(unsigned int value){ write(&value,sizeof(value)); }
+    void write(double value){ write(&value,sizeof(value)); }
+    void write(bool value){ write( (unsigned int)(value ? 1 : 0) ); }
+
+    void write(const std::string &value){
+        write( (unsigned int)value.size() );
+        write(value.c_str(),value.size());
+    }
+
+    void write(const std::vector< unsigned int > &values){
+        write( (unsigned int)values.size() );
+        if( values.size() > 0 ) write(&values[0],values.size()*sizeof(unsigned int));
+    }
+
+    void write(const std::vector< double > &values){
+        write( (unsigned int)values.size() );
+        writeArray(values.size() > 0 ? &values[0] : NULL,(unsigned long long)values.size());
+    }
+
+    //Writes the values without a length, after padding the file to the next 8 byte boundary
+    void writeArray(const double *values,unsigned long long numValues){
+        align( sizeof(double) );
+        if( numValues > 0 ) write(values,numValues*sizeof(double));
+    }
+
+    void align(unsigned int alignment){
+        const unsigned long long position = (unsigned long long)(file.tellp() - startPosition);
+        const char padding[8] = {0};
+        unsigned long long numPaddingBytes = (alignment - position % alignment) % alignment;
+        while( numPaddingBytes > 0 ){
+            const unsigned long long n = numPaddingBytes < sizeof(padding) ? numPaddingBytes : sizeof(padding);
+            write(padding,n);
+            numPaddingBytes -= n;
+        }
+    }
+
+    bool good() const{ return file.good(); }
+
+private:
+    std::fstream &file;
+    std::streampos startPosition;
+};
+
+/**
+ A BinaryReader reads the values written by a BinaryWriter from a block of memory, such as a memory mapped file. Every read checks
+ that the value is inside the block, and once a read has failed all the reads that follow fail too, so a block can be read in full
+ and then checked once with good().
+*/
+class BinaryReader{
+public:
+    BinaryReader(const char *data,unsigned long long size):data(data),size(size),position(0),valid(true){}
+    ~BinaryReader(){}
+
+    bool read(void *value,unsigned long long numBytes){
+        if( !valid || numBytes > size - position ){ valid = false; return false; }
+        memcpy(value,data+position,(size_t)numBytes);
+        position += numBytes;
+        return true;
+    }
+
+    bool read(unsigned int &value){ return read(&value,sizeof(value)); }
+    bool read(double &value){ return read(&value,sizeof(value)); }
+
+    bool read(bool &value){
+        unsigned int flag = 0;
+        if( !read(flag) ) return false;
+        value = flag != 0;
+        return true;
+    }
+
+    bool read(std::string &value){
+        unsigned int length = 0;
+        if( !read(length) || length > size - position ){ valid = false; return false; }
+        value.assign(data+position,length);
+        position += length;
+        return true;
+    }
+
+    bool read(std::vector< unsigned int > &values){
+        unsigned int length = 0;
+        if( !read(length) || length > (size - position) / sizeof(unsigned int) ){ valid = false; return false; }
+        values.resize( length );
+        return length == 0 || read(&values[0],length*sizeof(unsigned int));
+    }
+
+    bool read(std::vector< double > &values){
+        unsigned int length = 0;
+        if( !read(length) ) return false;
+        const double *array = readArray( length );
+        if( array == NULL ) return false;
+        values.assign(array,array+length);
+        return true;
+    }
+
+    //Returns the values written by BinaryWriter::writeArray without copying them, or NULL if they are not inside the block
+    const double* readArray(unsigned long long numValues){
+        align( sizeof(double) );
+        if( !valid || numValues > (size - position) / sizeof(double) ){ valid = false; return NULL; }
+        const double *values = (const double*)(data + position);
+        position += numValues*sizeof(double);
+        return values;
+    }
+
+    void align(unsigned int alignment){
+        const unsigned long long numPaddingBytes = (alignment - position % alignment) % alignment;
+        if( numPaddingBytes > size - position ){ valid = false; return; }
+        position += numPaddingBytes;
+    }
+
+    bool good() const{ return valid; }
+    unsigned long long getPosition() const{ return position; }
+
+    //Computes the FNV-1a 64 bit checksum of a block, a block read in parts can be checked by passing the checksum of each part to updateChecksum
+    static unsigned long long computeChecksum(const char *data,unsigned long long size){ return updateChecksum(GRT_BINARY_CHECKSUM_SEED,data,size); }
+
+    static unsigned long long updateChecksum(unsigned long long checksum,const char *data,unsigned long long size){
+        for(unsigned long long i=0; i<size; i++){
+            checksum ^= (unsigned char)data[i];
+            checksum *= GRT_BINARY_CHECKSUM_PRIME;
+        }
+        return checksum;
+    }
+
+private:
+    const char *data;
+    unsigned long long size;
+    unsigned long long position;
+    bool valid;
+};
+
+}//End of namespace GRT
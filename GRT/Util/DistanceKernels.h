@@ -0,0 +1,182 @@
+/*
+GRT MIT License
+Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <math.h>
+
+//SSE2 is always available on x86-64, and on 32-bit x86 if the compiler has been told to use it
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define __GRT_SSE2__
+    #include <emmintrin.h>
+#endif
+
+namespace GRT{
+
+/**
+ The DistanceKernels compute the distance between two contiguous blocks of doubles.  They use SSE2 when it is available,
+ otherwise they fall back to loops with independent accumulators.  The inputs do not need to be aligned, but keeping the rows
+ of a matrix 16-byte aligned (an even number of doubles per row) avoids loads that span two cache lines.
+*/
+class DistanceKernels{
+public:
+
+    /**
+     Computes the squared Euclidean distance between a and b.
+    */
+    static inline double squaredEuclidean(const double *a,const double *b,unsigned int N){
+        unsigned int j = 0;
+#ifdef __GRT_SSE2__
+        __m128d sum0 = _mm_setzero_pd();
+        __m128d sum1 = _mm_setzero_pd();
+        for(; j+4<=N; j+=4){
+            __m128d d0 = _mm_sub_pd( _mm_loadu_pd(a+j), _mm_loadu_pd(b+j) );
+            __m128d d1 = _mm_sub_pd( _mm_loadu_pd(a+j+2), _mm_loadu_pd(b+j+2) );
+            sum0 = _mm_add_pd( sum0, _mm_mul_pd(d0,d0) );
+            sum1 = _mm_add_pd( sum1, _mm_mul_pd(d1,d1) );
+        }
+        for(; j+2<=N; j+=2){
+            __m128d d0 = _mm_sub_pd( _mm_loadu_pd(a+j), _mm_loadu_pd(b+j) );
+            sum0 = _mm_add_pd( sum0, _mm_mul_pd(d0,d0) );
+        }
+        double dist = horizontalSum( _mm_add_pd(sum0,sum1) );
+#else
+        double sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+        for(; j+4<=N; j+=4){
+            const double d0 = a[j]-b[j], d1 = a[j+1]-b[j+1], d2 = a[j+2]-b[j+2], d3 = a[j+3]-b[j+3];
+            sum0 += d0*d0; sum1 += d1*d1; sum2 += d2*d2; sum3 += d3*d3;
+        }
+        double dist = (sum0 + sum1) + (sum2 + sum3);
+#endif
+        for(; j<N; j++){
+            const double d = a[j]-b[j];
+            dist += d*d;
+        }
+        return dist;
+    }
+
+    /**
+     Computes the Manhattan distance between a and b.
+    */
+    static inline double manhattan(const double *a,const double *b,unsigned int N){
+        unsigned int j = 0;
+#ifdef __GRT_SSE2__
+        //Clearing the sign bit gives the absolute value
+        const __m128d signMask = _mm_set1_pd( -0.0 );
+        __m128d sum0 = _mm_setzero_pd();
+        __m128d sum1 = _mm_setzero_pd();
+        for(; j+4<=N; j+=4){
+            __m128d d0 = _mm_sub_pd( _mm_loadu_pd(a+j), _mm_loadu_pd(b+j) );
+            __m128d d1 = _mm_sub_pd( _mm_loadu_pd(a+j+2), _mm_loadu_pd(b+j+2) );
+            sum0 = _mm_add_pd( sum0, _mm_andnot_pd(signMask,d0) );
+            sum1 = _mm_add_pd( sum1, _mm_andnot_pd(signMask,d1) );
+        }
+        for(; j+2<=N; j+=2){
+            __m128d d0 = _mm_sub_pd( _mm_loadu_pd(a+j), _mm_loadu_pd(b+j) );
+            sum0 = _mm_add_pd( sum0, _mm_andnot_pd(signMask,d0) );
+        }
+        double dist = horizontalSum( _mm_add_pd(sum0,sum1) );
+#else
+        double sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+        for(; j+4<=N; j+=4){
+            sum0 += fabs(a[j]-b[j]); sum1 += fabs(a[j+1]-b[j+1]); sum2 += fabs(a[j+2]-b[j+2]); sum3 += fabs(a[j+3]-b[j+3]);
+        }
+        double dist = (sum0 + sum1) + (sum2 + sum3);
+#endif
+        for(; j<N; j++){
+            dist += fabs(a[j]-b[j]);
+        }
+        return dist;
+    }
+
+    /**
+     Computes the squared Euclidean distance between a and b, with the squared difference of each dimension scaled by w.
+    */
+    static inline double weightedSquaredEuclidean(const double *a,const double *b,const double *w,unsigned int N){
+        unsigned int j = 0;
+#ifdef __GRT_SSE2__
+        __m128d sum0 = _mm_setzero_pd();
+        __m128d sum1 = _mm_setzero_pd();
+        for(; j+4<=N; j+=4){
+            __m128d d0 = _mm_sub_pd( _mm_loadu_pd(a+j), _mm_loadu_pd(b+j) );
+            __m128d d1 = _mm_sub_pd( _mm_loadu_pd(a+j+2), _mm_loadu_pd(b+j+2) );
+            sum0 = _mm_add_pd( sum0, _mm_mul_pd( _mm_mul_pd(d0,d0), _mm_loadu_pd(w+j) ) );
+            sum1 = _mm_add_pd( sum1, _mm_mul_pd( _mm_mul_pd(d1,d1), _mm_loadu_pd(w+j+2) ) );
+        }
+        for(; j+2<=N; j+=2){
+            __m128d d0 = _mm_sub_pd( _mm_loadu_pd(a+j), _mm_loadu_pd(b+j) );
+            sum0 = _mm_add_pd( sum0, _mm_mul_pd( _mm_mul_pd(d0,d0), _mm_loadu_pd(w+j) ) );
+        }
+        double dist = horizontalSum( _mm_add_pd(sum0,sum1) );
+#else
+        double sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+        for(; j+4<=N; j+=4){
+            const double d0 = a[j]-b[j], d1 = a[j+1]-b[j+1], d2 = a[j+2]-b[j+2], d3 = a[j+3]-b[j+3];
+            sum0 += d0*d0*w[j]; sum1 += d1*d1*w[j+1]; sum2 += d2*d2*w[j+2]; sum3 += d3*d3*w[j+3];
+        }
+        double dist = (sum0 + sum1) + (sum2 + sum3);
+#endif
+        for(; j<N; j++){
+            const double d = a[j]-b[j];
+            dist += d*d*w[j];
+        }
+        return dist;
+    }
+
+    /**
+     Computes the dot product of a and b.
+    */
+    static inline double dot(const double *a,const double *b,unsigned int N){
+        unsigned int j = 0;
+#ifdef __GRT_SSE2__
+        __m128d sum0 = _mm_setzero_pd();
+        __m128d sum1 = _mm_setzero_pd();
+        for(; j+4<=N; j+=4){
+            sum0 = _mm_add_pd( sum0, _mm_mul_pd( _mm_loadu_pd(a+j), _mm_loadu_pd(b+j) ) );
+            sum1 = _mm_add_pd( sum1, _mm_mul_pd( _mm_loadu_pd(a+j+2), _mm_loadu_pd(b+j+2) ) );
+        }
+        for(; j+2<=N; j+=2){
+            sum0 = _mm_add_pd( sum0, _mm_mul_pd( _mm_loadu_pd(a+j), _mm_loadu_pd(b+j) ) );
+        }
+        double sum = horizontalSum( _mm_add_pd(sum0,sum1) );
+#else
+        double sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+        for(; j+4<=N; j+=4){
+            sum0 += a[j]*b[j]; sum1 += a[j+1]*b[j+1]; sum2 += a[j+2]*b[j+2]; sum3 += a[j+3]*b[j+3];
+        }
+        double sum = (sum0 + sum1) + (sum2 + sum3);
+#endif
+        for(; j<N; j++){
+            sum += a[j]*b[j];
+        }
+        return sum;
+    }
+
+private:
+#ifdef __GRT_SSE2__
+    static inline double horizontalSum(__m128d x){
+        double values[2];
+        _mm_storeu_pd(values,x);
+        return values[0] + values[1];
+    }
+#endif
+};
+
+}; //End of namespace GRT
@@ -42,7 +42,12 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "WarningLog.h"
 #include "CircularBuffer.h"
 #include "Timer.h"
+#include "ParallelFor.h"
+#include "DistanceKernels.h"
 #include "Random.h"
+#include "BinaryStream.h"
+#include "MemoryMappedFile.h"
+#include "SharedModel.h"
 #include "Util.h"
 
 using namespace std;
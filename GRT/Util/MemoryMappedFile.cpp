@@ -0,0 +1,108 @@
+/*
+GRT MIT License
+Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "MemoryMappedFile.h"
+
+namespace GRT{
+
+MemoryMappedFile::MemoryMappedFile(){
+    data = NULL;
+    size = 0;
+#if defined(__GRT_WINDOWS_BUILD__)
+    fileHandle = INVALID_HANDLE_VALUE;
+    mappingHandle = NULL;
+#endif
+}
+
+MemoryMappedFile::~MemoryMappedFile(){
+    close();
+}
+
+bool MemoryMappedFile::open(const std::string &filename){
+
+    close();
+
+#if defined(__GRT_WINDOWS_BUILD__)
+    fileHandle = CreateFileA(filename.c_str(),GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,NULL);
+    if( fileHandle == INVALID_HANDLE_VALUE ) return false;
+
+    LARGE_INTEGER fileSize;
+    if( !GetFileSizeEx(fileHandle,&fileSize) || fileSize.QuadPart == 0 ){
+        close();
+        return false;
+    }
+
+    mappingHandle = CreateFileMappingA(fileHandle,NULL,PAGE_READONLY,0,0,NULL);
+    if( mappingHandle == NULL ){
+        close();
+        return false;
+    }
+
+    data = (const char*)MapViewOfFile(mappingHandle,FILE_MAP_READ,0,0,0);
+    if( data == NULL ){
+        close();
+        return false;
+    }
+    size = (unsigned long long)fileSize.QuadPart;
+    return true;
+#endif
+
+#if defined(__GRT_OSX_BUILD__) || defined(__GRT_LINUX_BUILD__)
+    int fd = ::open(filename.c_str(),O_RDONLY);
+    if( fd < 0 ) return false;
+
+    struct stat fileStats;
+    if( fstat(fd,&fileStats) != 0 || fileStats.st_size == 0 ){
+        ::close(fd);
+        return false;
+    }
+
+    //The mapping keeps its own reference to the file, so the file can be closed straight away
+    void *mapping = mmap(NULL,(size_t)fileStats.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+    ::close(fd);
+    if( mapping == MAP_FAILED ) return false;
+
+    data = (const char*)mapping;
+    size = (unsigned long long)fileStats.st_size;
+    return true;
+#endif
+
+    return false;
+}
+
+void MemoryMappedFile::close(){
+
+#if defined(__GRT_WINDOWS_BUILD__)
+    if( data != NULL ) UnmapViewOfFile(data);
+    if( mappingHandle != NULL ) CloseHandle(mappingHandle);
+    if( fileHandle != INVALID_HANDLE_VALUE ) CloseHandle(fileHandle);
+    mappingHandle = NULL;
+    fileHandle = INVALID_HANDLE_VALUE;
+#endif
+
+#if defined(__GRT_OSX_BUILD__) || defined(__GRT_LINUX_BUILD__)
+    if( data != NULL ) munmap((void*)data,(size_t)size);
+#endif
+
+    data = NULL;
+    size = 0;
+}
+
+}//End of namespace GRT
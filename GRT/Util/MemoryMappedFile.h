@@ -0,0 +1,80 @@
+/*
+GRT MIT License
+Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "GRTVersionInfo.h"
+#include <string>
+
+//Include the platform specific file mapping headers
+#if defined(__GRT_WINDOWS_BUILD__)
+	#include <windows.h>
+#endif
+
+#if defined(__GRT_OSX_BUILD__) || defined(__GRT_LINUX_BUILD__)
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace GRT{
+
+/**
+ A MemoryMappedFile maps a whole file into memory as read only, so the contents of the file can be used in place without being
+ read into a buffer. The pages of the file are only loaded by the operating system when they are used, and can be dropped again
+ when memory is low. The mapping is removed when the MemoryMappedFile is closed or destroyed, after which any pointer into it is invalid.
+*/
+class MemoryMappedFile{
+public:
+    MemoryMappedFile();
+    ~MemoryMappedFile();
+
+    /**
+     Maps the file into memory, any file that was already mapped is closed first.
+
+     @param const std::string &filename: the name of the file to map
+     @return returns true if the file was mapped, false otherwise
+    */
+    bool open(const std::string &filename);
+
+    /**
+     Removes the mapping of the file, if one exists.
+    */
+    void close();
+
+    bool isOpen() const{ return data != NULL; }
+    const char* getData() const{ return data; }
+    unsigned long long getSize() const{ return size; }
+
+private:
+    //A mapping can not be shared, so the file can not be copied
+    MemoryMappedFile(const MemoryMappedFile &rhs);
+    MemoryMappedFile& operator= (const MemoryMappedFile &rhs);
+
+    const char *data;                   //The start of the mapped file, or NULL if no file is mapped
+    unsigned long long size;            //The size of the mapped file in bytes
+#if defined(__GRT_WINDOWS_BUILD__)
+    HANDLE fileHandle;
+    HANDLE mappingHandle;
+#endif
+};
+
+}//End of namespace GRT
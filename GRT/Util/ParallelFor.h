@@ -0,0 +1,208 @@
+/*
+GRT MIT License
+Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "../Util/GRTVersionInfo.h"
+#include <vector>
+
+//Include the platform specific thread headers
+#if defined(__GRT_WINDOWS_BUILD__)
+	#include <windows.h>
+#endif
+
+#if defined(__GRT_OSX_BUILD__)
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+
+#if defined(__GRT_LINUX_BUILD__)
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+
+namespace GRT{
+
+/**
+ A ParallelJob is the work run by ParallelFor. The tasks [0 numTasks-1] are split into one contiguous block per thread,
+ and run(threadIndex,startIndex,endIndex) is called once per block. The blocks only depend on the number of tasks and the
+ number of threads, so a job that keeps one accumulator per threadIndex and sums them in order gets the same result every time
+ it is run with the same number of threads.
+
+ A ParallelFor that is run from inside one of the blocks of another ParallelFor (such as a classifier trained by each fold of a
+ parallel cross validation) runs on the calling thread, so nested loops do not start one thread per core for every outer thread.
+*/
+class ParallelJob{
+public:
+    ParallelJob(){}
+    virtual ~ParallelJob(){}
+
+    virtual void run(unsigned int threadIndex,unsigned int startIndex,unsigned int endIndex) = 0;
+};
+
+class ParallelFor{
+public:
+    ParallelFor(){}
+    ~ParallelFor(){}
+
+    //The number of operations a thread should have to do before it is worth starting it, this is used by getMinTasksPerThread
+    enum{ MIN_WORK_PER_THREAD = 100000 };
+
+    /**
+     Runs the job over the tasks [0 numTasks-1], using up to numThreads threads. If numThreads is 0 then one thread is used per CPU core.
+     Each thread gets at least minTasksPerThread tasks, so a small loop is run on fewer threads (or just the calling thread).
+     The calling thread runs the first block and returns once every block has finished.
+
+     @return returns the number of threads that were used
+    */
+    static unsigned int run(ParallelJob &job,unsigned int numTasks,unsigned int numThreads,unsigned int minTasksPerThread = 1){
+        numThreads = getNumThreads(numTasks,numThreads,minTasksPerThread);
+        if( numTasks == 0 ) return 0;
+        if( numThreads == 1 ){
+            job.run(0,0,numTasks);
+            return 1;
+        }
+
+        std::vector< Block > blocks(numThreads);
+        for(unsigned int t=0; t<numThreads; t++){
+            blocks[t].job = &job;
+            blocks[t].threadIndex = t;
+            blocks[t].startIndex = (unsigned int)( ((unsigned long long)numTasks * t) / numThreads );
+            blocks[t].endIndex = (unsigned int)( ((unsigned long long)numTasks * (t+1)) / numThreads );
+            blocks[t].threadStarted = false;
+        }
+
+        //Start a thread for every block but the first, if a thread can not be started its block is run on this thread instead
+        for(unsigned int t=1; t<numThreads; t++){
+            blocks[t].threadStarted = startThread( blocks[t] );
+        }
+        runBlock( &blocks[0] );
+        for(unsigned int t=1; t<numThreads; t++){
+            if( blocks[t].threadStarted ) joinThread( blocks[t] );
+            else runBlock( &blocks[t] );
+        }
+
+        return numThreads;
+    }
+
+    /**
+     Gets the number of threads run() would use for the number of tasks and the number of threads requested. This is 1 if it is called
+     from inside a block of another ParallelFor.
+    */
+    static unsigned int getNumThreads(unsigned int numTasks,unsigned int numThreads,unsigned int minTasksPerThread = 1){
+        if( getIsInsideBlock() ) return 1;
+        if( numThreads == 0 ) numThreads = getNumCPUCores();
+        if( minTasksPerThread > 1 ) numTasks /= minTasksPerThread;
+        if( numThreads > numTasks ) numThreads = numTasks;
+        if( numThreads == 0 ) numThreads = 1;
+        return numThreads;
+    }
+
+    /**
+     Gets the smallest number of tasks each thread should get so that starting the thread is worth it, given the number of operations
+     in each task.
+    */
+    static unsigned int getMinTasksPerThread(unsigned long long workPerTask){
+        if( workPerTask == 0 ) workPerTask = 1;
+        return workPerTask >= MIN_WORK_PER_THREAD ? 1 : (unsigned int)( (MIN_WORK_PER_THREAD + workPerTask - 1) / workPerTask );
+    }
+
+    static unsigned int getNumCPUCores(){
+#ifdef __GRT_WINDOWS_BUILD__
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo( &systemInfo );
+        return systemInfo.dwNumberOfProcessors > 0 ? (unsigned int)systemInfo.dwNumberOfProcessors : 1;
+#endif
+#if defined(__GRT_OSX_BUILD__) || defined(__GRT_LINUX_BUILD__)
+        long numCores = sysconf( _SC_NPROCESSORS_ONLN );
+        return numCores > 0 ? (unsigned int)numCores : 1;
+#endif
+        return 1;
+    }
+
+private:
+    struct Block{
+        ParallelJob *job;
+        unsigned int threadIndex;
+        unsigned int startIndex;
+        unsigned int endIndex;
+        bool threadStarted;
+#ifdef __GRT_WINDOWS_BUILD__
+        HANDLE thread;
+#endif
+#if defined(__GRT_OSX_BUILD__) || defined(__GRT_LINUX_BUILD__)
+        pthread_t thread;
+#endif
+    };
+
+    static void runBlock(Block *block){
+        if( block->startIndex < block->endIndex ){
+            bool &insideBlock = getIsInsideBlock();
+            const bool wasInsideBlock = insideBlock;
+            insideBlock = true;
+            block->job->run(block->threadIndex,block->startIndex,block->endIndex);
+            insideBlock = wasInsideBlock;
+        }
+    }
+
+    //Flags if the current thread is running a block of a ParallelFor that was split over several threads
+    static bool& getIsInsideBlock(){
+#if defined(__GRT_WINDOWS_BUILD__)
+        __declspec(thread) static bool insideBlock = false;
+#elif defined(__GRT_OSX_BUILD__) || defined(__GRT_LINUX_BUILD__)
+        static __thread bool insideBlock = false;
+#else
+        static bool insideBlock = false;
+#endif
+        return insideBlock;
+    }
+
+#ifdef __GRT_WINDOWS_BUILD__
+    static DWORD WINAPI threadFunction(LPVOID data){
+        runBlock( (Block*)data );
+        return 0;
+    }
+    static bool startThread(Block &block){
+        block.thread = CreateThread(NULL,0,threadFunction,&block,0,NULL);
+        return block.thread != NULL;
+    }
+    static void joinThread(Block &block){
+        WaitForSingleObject(block.thread,INFINITE);
+        CloseHandle(block.thread);
+    }
+#elif defined(__GRT_OSX_BUILD__) || defined(__GRT_LINUX_BUILD__)
+    static void* threadFunction(void *data){
+        runBlock( (Block*)data );
+        return NULL;
+    }
+    static bool startThread(Block &block){
+        return pthread_create(&block.thread,NULL,threadFunction,&block) == 0;
+    }
+    static void joinThread(Block &block){
+        pthread_join(block.thread,NULL);
+    }
+#else
+    static bool startThread(Block &block){ return false; }
+    static void joinThread(Block &block){}
+#endif
+
+};
+
+}; //End of namespace GRT
@@ -0,0 +1,140 @@
+/*
+GRT MIT License
+Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "GRTVersionInfo.h"
+#include <stddef.h>
+
+#if defined(__GRT_WINDOWS_BUILD__)
+	#include <windows.h>
+#endif
+
+namespace GRT{
+
+/**
+ A SharedModel holds the trained part of a classifier, such as the training data of a KNN or the templates of a DTW, so it can be
+ shared by copies of the classifier rather than copied to each of them. Copying a SharedModel only adds a reference to the model,
+ which is deleted when its last reference is removed. The model is read through the const operators, and edit() must be called
+ before it is changed: if the model is shared, edit() first makes a private copy of it, so changing a model never changes the
+ copies that share it. The reference count is updated atomically, so copies of a model can be made and removed on any thread.
+*/
+template <class T>
+class SharedModel{
+public:
+    SharedModel(){
+        model = new T;
+        referenceCount = new long(1);
+    }
+
+    SharedModel(const SharedModel &rhs){
+        model = rhs.model;
+        referenceCount = rhs.referenceCount;
+        incrementReferenceCount( referenceCount );
+    }
+
+    ~SharedModel(){
+        release();
+    }
+
+    SharedModel& operator=(const SharedModel &rhs){
+        if( this != &rhs && model != rhs.model ){
+            incrementReferenceCount( rhs.referenceCount );
+            release();
+            model = rhs.model;
+            referenceCount = rhs.referenceCount;
+        }
+        return *this;
+    }
+
+    const T& operator*() const{ return *model; }
+    const T* operator->() const{ return model; }
+
+    /**
+     Gets the model so it can be changed, if the model is shared with another SharedModel it is copied first.
+
+     @return returns a reference to the model, this is only valid until this SharedModel is changed
+    */
+    T& edit(){
+        if( getIsShared() ){
+            T *copy = new T( *model );
+            release();
+            model = copy;
+            referenceCount = new long(1);
+        }
+        return *model;
+    }
+
+    /**
+     Replaces the model with a new default model, without copying the current model. This is used when a model is retrained or cleared.
+
+     @return returns a reference to the new model, this is only valid until this SharedModel is changed
+    */
+    T& reset(){
+        if( getIsShared() ){
+            release();
+            model = new T;
+            referenceCount = new long(1);
+        }else *model = T();
+        return *model;
+    }
+
+    bool getIsShared() const{ return getReferenceCount() > 1; }
+    long getReferenceCount() const{ return loadReferenceCount( referenceCount ); }
+
+private:
+    void release(){
+        if( decrementReferenceCount( referenceCount ) == 0 ){
+            delete model;
+            delete referenceCount;
+        }
+        model = NULL;
+        referenceCount = NULL;
+    }
+
+    static long loadReferenceCount(long *count){
+#if defined(__GRT_WINDOWS_BUILD__)
+        return InterlockedCompareExchange( (volatile LONG*)count, 0, 0 );
+#else
+        return __atomic_load_n( count, __ATOMIC_ACQUIRE );
+#endif
+    }
+
+    static long incrementReferenceCount(long *count){
+#if defined(__GRT_WINDOWS_BUILD__)
+        return InterlockedIncrement( (volatile LONG*)count );
+#else
+        return __sync_add_and_fetch( count, 1 );
+#endif
+    }
+
+    static long decrementReferenceCount(long *count){
+#if defined(__GRT_WINDOWS_BUILD__)
+        return InterlockedDecrement( (volatile LONG*)count );
+#else
+        return __sync_sub_and_fetch( count, 1 );
+#endif
+    }
+
+    T *model;                           //The model, this is shared by every SharedModel that was copied from the same model
+    long *referenceCount;               //The number of SharedModels that share the model
+};
+
+}//End of namespace GRT
@@ -0,0 +1,235 @@
+/*
+GRT MIT License
+Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SlidingWindowStatistics.h"
+
+namespace GRT{
+
+SlidingWindowStatistics::SlidingWindowStatistics(UINT windowSize,UINT numDimensions):errorLog("[ERROR SlidingWindowStatistics]"){
+    initialized = false;
+    this->windowSize = 0;
+    this->numDimensions = 0;
+    numSamples = 0;
+    numSamplesSinceRecomputed = 0;
+    sampleCounter = 0;
+    if( windowSize > 0 && numDimensions > 0 ) init(windowSize,numDimensions);
+}
+
+SlidingWindowStatistics::SlidingWindowStatistics(const SlidingWindowStatistics &rhs):errorLog("[ERROR SlidingWindowStatistics]"){
+    *this = rhs;
+}
+
+SlidingWindowStatistics::~SlidingWindowStatistics(){}
+
+SlidingWindowStatistics& SlidingWindowStatistics::operator= (const SlidingWindowStatistics &rhs){
+    if( this != &rhs ){
+        this->initialized = rhs.initialized;
+        this->windowSize = rhs.windowSize;
+        this->numDimensions = rhs.numDimensions;
+        this->numSamples = rhs.numSamples;
+        this->numSamplesSinceRecomputed = rhs.numSamplesSinceRecomputed;
+        this->sampleCounter = rhs.sampleCounter;
+        this->dataBuffer = rhs.dataBuffer;
+        this->mean = rhs.mean;
+        this->sumOfSquaredDifferences = rhs.sumOfSquaredDifferences;
+        this->shift = rhs.shift;
+        this->shiftedSum = rhs.shiftedSum;
+        this->shiftedSumOfSquares = rhs.shiftedSumOfSquares;
+        this->sum = rhs.sum;
+        this->sumOfSquares = rhs.sumOfSquares;
+        this->minQueue = rhs.minQueue;
+        this->maxQueue = rhs.maxQueue;
+    }
+    return *this;
+}
+
+bool SlidingWindowStatistics::init(UINT windowSize,UINT numDimensions){
+
+    initialized = false;
+
+    if( windowSize == 0 ){
+        errorLog << "init(UINT windowSize,UINT numDimensions) - The window size must be greater than zero!" << endl;
+        return false;
+    }
+
+    if( numDimensions == 0 ){
+        errorLog << "init(UINT windowSize,UINT numDimensions) - The number of dimensions must be greater than zero!" << endl;
+        return false;
+    }
+
+    this->windowSize = windowSize;
+    this->numDimensions = numDimensions;
+    initialized = true;
+    clear();
+
+    return true;
+}
+
+void SlidingWindowStatistics::clear(){
+    numSamples = 0;
+    numSamplesSinceRecomputed = 0;
+    sampleCounter = 0;
+    mean.assign(numDimensions,0);
+    sumOfSquaredDifferences.assign(numDimensions,0);
+    shift.assign(numDimensions,0);
+    shiftedSum.assign(numDimensions,0);
+    shiftedSumOfSquares.assign(numDimensions,0);
+    sum.assign(numDimensions,0);
+    sumOfSquares.assign(numDimensions,0);
+    minQueue.assign(numDimensions,std::deque< IndexedDouble >());
+    maxQueue.assign(numDimensions,std::deque< IndexedDouble >());
+    if( initialized ) dataBuffer.resize( windowSize, vector< double >(numDimensions,0) );
+    else dataBuffer.clear();
+}
+
+bool SlidingWindowStatistics::push_back(const vector< double > &sample){
+
+    if( !initialized ){
+        errorLog << "push_back(const vector< double > &sample) - Not initialized!" << endl;
+        return false;
+    }
+
+    if( sample.size() != numDimensions ){
+        errorLog << "push_back(const vector< double > &sample) - The size of the sample (" << sample.size() << ") does not match the number of dimensions (" << numDimensions << ")!" << endl;
+        return false;
+    }
+
+    //The first sample of an empty window is used as the shift until the statistics are computed from the window
+    if( numSamples == 0 ) shift = sample;
+
+    if( numSamples == windowSize ){
+        //The window is full, so the oldest sample (which is at the front of the buffer) is replaced by the new sample
+        const vector< double > &oldestSample = dataBuffer[0];
+        for(UINT j=0; j<numDimensions; j++){
+            const double x = sample[j];
+            const double y = oldestSample[j];
+            const double dx = x - shift[j];
+            const double dy = y - shift[j];
+            shiftedSum[j] += dx - dy;
+            shiftedSumOfSquares[j] += dx*dx - dy*dy;
+            sum[j] += x - y;
+            sumOfSquares[j] += x*x - y*y;
+        }
+    }else{
+        numSamples++;
+        for(UINT j=0; j<numDimensions; j++){
+            const double x = sample[j];
+            const double dx = x - shift[j];
+            shiftedSum[j] += dx;
+            shiftedSumOfSquares[j] += dx*dx;
+            sum[j] += x;
+            sumOfSquares[j] += x*x;
+        }
+    }
+
+    //The sum of the squared differences from the mean is the shifted sum of squares less the part due to the distance of the mean from the shift
+    for(UINT j=0; j<numDimensions; j++){
+        mean[j] = shift[j] + shiftedSum[j] / numSamples;
+        sumOfSquaredDifferences[j] = shiftedSumOfSquares[j] - shiftedSum[j] * shiftedSum[j] / numSamples;
+        if( sumOfSquaredDifferences[j] < 0 ) sumOfSquaredDifferences[j] = 0;
+    }
+
+    dataBuffer.push_back( sample );
+
+    //Add the sample to the min and max queues, any sample that is not smaller (or larger) than it can no longer be the minimum (or maximum)
+    //of the window, and the front of each queue is removed once it has left the window
+    for(UINT j=0; j<numDimensions; j++){
+        const double x = sample[j];
+        std::deque< IndexedDouble > &minValues = minQueue[j];
+        while( !minValues.empty() && minValues.back().value >= x ) minValues.pop_back();
+        minValues.push_back( IndexedDouble(sampleCounter,x) );
+        if( sampleCounter - minValues.front().index >= windowSize ) minValues.pop_front();
+
+        std::deque< IndexedDouble > &maxValues = maxQueue[j];
+        while( !maxValues.empty() && maxValues.back().value <= x ) maxValues.pop_back();
+        maxValues.push_back( IndexedDouble(sampleCounter,x) );
+        if( sampleCounter - maxValues.front().index >= windowSize ) maxValues.pop_front();
+    }
+    sampleCounter++;
+
+    //The rounding error of the sum of the squared differences grows with the shifted sum of squares, so once that is much larger than
+    //the result the statistics are computed again from the window, which moves the shift to the mean.  This is not needed if every
+    //sample has the same value, as the variance is then zero
+    const double MAX_SHIFTED_SUM_OF_SQUARES_RATIO = 16;
+    bool shiftTooFarFromMean = false;
+    for(UINT j=0; j<numDimensions; j++){
+        if( shiftedSumOfSquares[j] > MAX_SHIFTED_SUM_OF_SQUARES_RATIO * sumOfSquaredDifferences[j] && getMinimum(j) != getMaximum(j) ){
+            shiftTooFarFromMean = true;
+            break;
+        }
+    }
+
+    if( ++numSamplesSinceRecomputed >= windowSize || shiftTooFarFromMean ) recomputeStatistics();
+
+    return true;
+}
+
+vector< double > SlidingWindowStatistics::getVariance() const{
+    vector< double > variance(numDimensions);
+    for(UINT j=0; j<numDimensions; j++) variance[j] = getVariance(j);
+    return variance;
+}
+
+vector< double > SlidingWindowStatistics::getStdDev() const{
+    vector< double > stdDev(numDimensions);
+    for(UINT j=0; j<numDimensions; j++) stdDev[j] = getStdDev(j);
+    return stdDev;
+}
+
+vector< MinMax > SlidingWindowStatistics::getRanges() const{
+    vector< MinMax > ranges(numDimensions);
+    for(UINT j=0; j<numDimensions; j++){
+        ranges[j].minValue = getMinimum(j);
+        ranges[j].maxValue = getMaximum(j);
+    }
+    return ranges;
+}
+
+void SlidingWindowStatistics::recomputeStatistics(){
+
+    //The samples in the window are at the end of the buffer until it is full
+    numSamplesSinceRecomputed = 0;
+    if( numSamples == 0 ) return;
+    const UINT firstIndex = windowSize - numSamples;
+    for(UINT j=0; j<numDimensions; j++){
+        sum[j] = 0;
+        sumOfSquares[j] = 0;
+        for(UINT i=firstIndex; i<windowSize; i++){
+            const double x = dataBuffer[i][j];
+            sum[j] += x;
+            sumOfSquares[j] += x*x;
+        }
+        mean[j] = sum[j] / numSamples;
+
+        //The shift is moved to the mean, so the shifted sums start again from the exact sum of the squared differences
+        shift[j] = mean[j];
+        shiftedSum[j] = 0;
+        shiftedSumOfSquares[j] = 0;
+        for(UINT i=firstIndex; i<windowSize; i++){
+            const double difference = dataBuffer[i][j] - shift[j];
+            shiftedSum[j] += difference;
+            shiftedSumOfSquares[j] += difference * difference;
+        }
+        sumOfSquaredDifferences[j] = shiftedSumOfSquares[j] - shiftedSum[j] * shiftedSum[j] / numSamples;
+        if( sumOfSquaredDifferences[j] < 0 ) sumOfSquaredDifferences[j] = 0;
+    }
+}
+
+} //End of namespace GRT
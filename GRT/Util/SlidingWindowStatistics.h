@@ -0,0 +1,153 @@
+/**
+ @file
+ @author  Nicholas Gillian <ngillian@media.mit.edu>
+ @version 1.0
+
+ @section LICENSE
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ @section DESCRIPTION
+ The SlidingWindowStatistics keeps the mean, variance, sum, sum of squares, minimum and maximum of each dimension of the last
+ windowSize samples. The statistics are updated as each sample enters the window and the oldest sample leaves it, so the cost of
+ adding a sample does not depend on the size of the window: the mean and variance are kept as the sum and sum of squares of the
+ difference of each sample from a shift value (the mean of the window when the statistics were last computed), and the minimum and
+ maximum are kept in a queue of the samples that can still become the minimum (or maximum) of the window.
+
+ The running values are computed again from the samples in the window once every windowSize samples, so any rounding error does not
+ build up over a long stream.  They are also computed again (and the shift moved to the new mean) as soon as the mean of the window
+ has moved so far from the shift that the variance would lose its precision, such as after a large step in the data.
+ */
+
+#pragma once
+
+#include "GRTCommon.h"
+#include <deque>
+
+namespace GRT{
+
+class SlidingWindowStatistics{
+public:
+	/**
+     Constructor, sets the size of the window and the number of dimensions of the data.
+
+     @param UINT windowSize: the number of samples in the window, should be greater than zero. Default windowSize = 0 (not initialized)
+	 @param UINT numDimensions: the number of dimensions of the data, should be greater than zero. Default numDimensions = 0 (not initialized)
+    */
+	SlidingWindowStatistics(UINT windowSize = 0,UINT numDimensions = 0);
+
+    /**
+     Copy Constructor, copies the SlidingWindowStatistics from the rhs instance to this instance
+
+	 @param const SlidingWindowStatistics &rhs: another instance of the SlidingWindowStatistics class from which the data will be copied to this instance
+	*/
+	SlidingWindowStatistics(const SlidingWindowStatistics &rhs);
+
+	/**
+     Default Destructor
+    */
+	~SlidingWindowStatistics();
+
+	/**
+     Sets the equals operator, copies the data from the rhs instance to this instance
+
+	 @param const SlidingWindowStatistics &rhs: another instance of the SlidingWindowStatistics class from which the data will be copied to this instance
+	 @return a reference to this instance of the SlidingWindowStatistics
+	*/
+	SlidingWindowStatistics& operator= (const SlidingWindowStatistics &rhs);
+
+    /**
+     Sets the size of the window and the number of dimensions of the data, this removes any samples from the window.
+
+     @param UINT windowSize: the number of samples in the window, must be greater than zero
+	 @param UINT numDimensions: the number of dimensions of the data, must be greater than zero
+     @return true if the SlidingWindowStatistics was initialized, false otherwise
+    */
+    bool init(UINT windowSize,UINT numDimensions);
+
+	/**
+     Removes all the samples from the window, the window size and number of dimensions are not changed.
+    */
+	void clear();
+
+    /**
+     Adds a sample to the window, if the window is full the oldest sample is removed from it.
+     The dimensionality of the sample must match the number of dimensions set by init.
+
+     @param const vector< double > &sample: the sample to add to the window
+	 @return true if the sample was added, false otherwise
+     */
+	bool push_back(const vector< double > &sample);
+
+    bool getInitialized() const{ return initialized; }
+    bool getBufferFilled() const{ return initialized && numSamples == windowSize; }
+    UINT getWindowSize() const{ return windowSize; }
+    UINT getNumDimensions() const{ return numDimensions; }
+    UINT getNumSamples() const{ return numSamples; }
+
+    /**
+     The statistics of dimension j of the samples in the window. These are zero if the window is empty.
+     The variance is the population variance (the sum of the squared differences divided by the number of samples), it is exactly
+     zero if every sample in the window has the same value.
+
+     @param UINT j: the dimension, must be less than the number of dimensions
+    */
+    double getMean(UINT j) const{ return mean[j]; }
+    double getVariance(UINT j) const{ return numSamples > 0 && sumOfSquaredDifferences[j] > 0 && getMinimum(j) != getMaximum(j) ? sumOfSquaredDifferences[j] / numSamples : 0; }
+    double getStdDev(UINT j) const{ return sqrt( getVariance(j) ); }
+    double getSum(UINT j) const{ return sum[j]; }
+    double getSumOfSquares(UINT j) const{ return sumOfSquares[j]; }
+    double getMinimum(UINT j) const{ return minQueue[j].empty() ? 0 : minQueue[j].front().value; }
+    double getMaximum(UINT j) const{ return maxQueue[j].empty() ? 0 : maxQueue[j].front().value; }
+
+    vector< double > getMean() const{ return mean; }
+    vector< double > getVariance() const;
+    vector< double > getStdDev() const;
+    vector< MinMax > getRanges() const;
+
+    /**
+     Gets the samples in the window, the oldest sample is at index 0 once the window is full.
+
+     @return a CircularBuffer containing the samples in the window
+    */
+    CircularBuffer< vector< double > > getData() const{ return dataBuffer; }
+
+private:
+    void recomputeStatistics();
+
+    bool initialized;                                       ///< Flags if the window size and dimensions have been set
+    UINT windowSize;                                        ///< The number of samples in the window
+    UINT numDimensions;                                     ///< The number of dimensions of the data
+    UINT numSamples;                                        ///< The number of samples currently in the window
+    UINT numSamplesSinceRecomputed;                         ///< The number of samples added since the statistics were last computed from the window
+    UINT sampleCounter;                                     ///< The position of the next sample in the stream, used to remove samples from the min and max queues
+    CircularBuffer< vector< double > > dataBuffer;          ///< The samples in the window
+    vector< double > mean;                                  ///< The mean of each dimension
+    vector< double > sumOfSquaredDifferences;               ///< The sum of the squared differences from the mean of each dimension
+    vector< double > shift;                                 ///< The value subtracted from each dimension before it is added to the shifted sums
+    vector< double > shiftedSum;                            ///< The sum of the differences from the shift of each dimension
+    vector< double > shiftedSumOfSquares;                   ///< The sum of the squared differences from the shift of each dimension
+    vector< double > sum;                                   ///< The sum of each dimension
+    vector< double > sumOfSquares;                          ///< The sum of the squared values of each dimension
+    vector< std::deque< IndexedDouble > > minQueue;         ///< For each dimension, the samples that can still be the minimum, in increasing order of value
+    vector< std::deque< IndexedDouble > > maxQueue;         ///< For each dimension, the samples that can still be the maximum, in decreasing order of value
+
+    ErrorLog errorLog;
+};
+
+} //End of namespace GRT
@@ -0,0 +1,133 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ GRT DTW Example
+ This examples demonstrates how to train a DTW classifier, save and load the model, and use the loaded model to spot gestures in a
+ continuous stream of data with the streaming prediction.
+
+ The Dynamic Time Warping (DTW) algorithm matches a time series against a template of each gesture, even if the time series is
+ performed faster or slower than the template. With the streaming prediction, each template is matched against the input stream
+ one sample at a time, and a match is reported once the end of a gesture has been found.
+
+ In this example we create some synthetic gestures (a sine wave and a triangle wave with some noise) and train the DTW with them.
+ The model is then saved to a file and loaded into a second DTW, and a stream containing several gestures is passed to both the
+ trained and the loaded DTW. The loaded model should report exactly the same matches as the model it was saved from.
+
+ This example shows you how to:
+ - Create some LabelledTimeSeriesClassificationData and train a DTW classifier with it
+ - Enable null rejection and the streaming prediction
+ - Save the DTW model to a file and load it again
+ - Spot the gestures in a continuous stream of data
+*/
+
+#include "GRT.h"
+using namespace GRT;
+
+//Creates an example of a gesture, the gesture is stretched to the given length and some noise is added to it
+Matrix< double > createGesture(UINT classLabel,UINT length,Random &random){
+    Matrix< double > gesture(length,1);
+    for(UINT i=0; i<length; i++){
+        double t = i / double(length-1);
+        double value = classLabel == 1 ? sin( t * 2 * PI ) : (t < 0.5 ? 4*t : 4 - 4*t) - 1;
+        gesture[i][0] = value + random.getRandomNumberUniform(-0.05,0.05);
+    }
+    return gesture;
+}
+
+//Passes every sample of the stream to the DTW and counts the number of matches it reports
+UINT countMatches(DTW &dtw,const vector< double > &stream,vector< UINT > &matchLabels){
+    matchLabels.clear();
+    for(UINT i=0; i<stream.size(); i++){
+        if( !dtw.predict( vector< double >(1,stream[i]) ) ){
+            cout << "Failed to perform prediction for sample: " << i << endl;
+            return 0;
+        }
+        if( dtw.getPredictedClassLabel() != 0 ) matchLabels.push_back( dtw.getPredictedClassLabel() );
+    }
+    return (UINT)matchLabels.size();
+}
+
+int main (int argc, const char * argv[])
+{
+    Random random;
+
+    //Create the training data, 10 examples of each gesture with a length between 40 and 60 samples
+    LabelledTimeSeriesClassificationData trainingData;
+    trainingData.setNumDimensions( 1 );
+    for(UINT classLabel=1; classLabel<=2; classLabel++){
+        for(UINT n=0; n<10; n++){
+            trainingData.addSample( classLabel, createGesture( classLabel, random.getRandomNumberInt(40,60), random ) );
+        }
+    }
+
+    //Create a new DTW classifier with null rejection and the streaming prediction enabled
+    DTW dtw;
+    dtw.enableNullRejection( true );
+    dtw.setNullRejectionCoeff( 3 );
+    dtw.enableStreamingPrediction( true );
+
+    //Train the classifier
+    if( !dtw.train( trainingData ) ){
+        cout << "Failed to train classifier!\n";
+        return EXIT_FAILURE;
+    }
+
+    //Save the DTW model to a file
+    if( !dtw.saveModelToFile("DTWModel.txt") ){
+        cout << "Failed to save the classifier model!\n";
+        return EXIT_FAILURE;
+    }
+
+    //Load the DTW model into a new DTW
+    DTW loadedDTW;
+    if( !loadedDTW.loadModelFromFile("DTWModel.txt") ){
+        cout << "Failed to load the classifier model!\n";
+        return EXIT_FAILURE;
+    }
+
+    //The streaming prediction is not part of the model, so it has to be enabled again on the loaded DTW
+    loadedDTW.enableStreamingPrediction( true );
+
+    //Create a stream with some gestures, with a pause between each gesture
+    vector< double > stream;
+    for(UINT n=0; n<10; n++){
+        for(UINT i=0; i<30; i++) stream.push_back( random.getRandomNumberUniform(-0.05,0.05) );
+        Matrix< double > gesture = createGesture( n%2 + 1, random.getRandomNumberInt(40,60), random );
+        for(UINT i=0; i<gesture.getNumRows(); i++) stream.push_back( gesture[i][0] );
+    }
+    for(UINT i=0; i<30; i++) stream.push_back( random.getRandomNumberUniform(-0.05,0.05) );
+
+    //Spot the gestures in the stream with both the trained model and the loaded model
+    vector< UINT > matchLabels;
+    vector< UINT > loadedMatchLabels;
+    UINT numMatches = countMatches( dtw, stream, matchLabels );
+    UINT numLoadedMatches = countMatches( loadedDTW, stream, loadedMatchLabels );
+
+    cout << "Matches found by the trained model: " << numMatches << endl;
+    cout << "Matches found by the loaded model: " << numLoadedMatches << endl;
+
+    if( numMatches == 0 || matchLabels != loadedMatchLabels ){
+        cout << "The loaded model does not match the trained model!\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}